@@ -0,0 +1,71 @@
+#include "process.h"
+
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+#include "vrt/vrt_types.h"
+
+#include "Progress-CPP/ProgressBar.hpp"
+#include "common/duplicate_filter.h"
+#include "common/input_stream.h"
+#include "common/output_stream.h"
+#include "common/timestamp.h"
+#include "program_arguments.h"
+
+namespace vrt::dedup {
+
+/**
+ * Process file contents. Packets that are identical to one earlier in the file, within the time window, are not
+ * written.
+ *
+ * \param args Program arguments.
+ *
+ * \throw std::runtime_error If there's an error.
+ */
+void process(const ProgramArguments& args) {
+    common::InputStream  input_stream(args.file_path_in, args.do_byte_swap);
+    common::OutputStream output_stream(args.file_path_out);
+
+    common::DuplicateFilter filter(static_cast<uint64_t>(std::llround(args.window_s * common::PS_PER_S)));
+
+    progresscpp::ProgressBar progress(static_cast<uint64_t>(input_stream.get_file_size()), 70);
+
+    try {
+        uint64_t i{0};
+        for (; input_stream.read_next_packet(); ++i) {
+            const vrt_packet& packet{*input_stream.get_packet()};
+            if (!filter.is_duplicate(packet, input_stream.get_buffer().data())) {
+                output_stream.write(input_stream.get_buffer(), packet.header.packet_size);
+            }
+
+            // Handle progress bar
+            progress += sizeof(uint32_t) * packet.header.packet_size;
+            if (progress.get_ticks() % 65536 == 0) {
+                progress.display();
+            }
+        }
+
+        progress.done();
+
+        if (i == 0) {
+            std::cerr << "Warning: No packets in file" << std::endl;
+        } else {
+            uint64_t        n_duplicates{filter.get_number_of_duplicates()};
+            std::streamsize initial_prec{std::cout.precision()};
+            std::cout << std::fixed << std::setprecision(2) << n_duplicates << " out of " << i << " packets ("
+                      << 100.0 * static_cast<double>(n_duplicates) / static_cast<double>(i)
+                      << " %) were duplicates and removed" << std::endl;
+
+            // Reset streams to default
+            std::cout << std::setprecision(initial_prec) << std::defaultfloat;
+        }
+    } catch (...) {
+        // Cleanup and rethrow
+        output_stream.remove_file();
+        throw;
+    }
+}
+
+}  // namespace vrt::dedup
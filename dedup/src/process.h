@@ -0,0 +1,14 @@
+#ifndef VRT_DEDUP_SRC_PROCESS_H_
+#define VRT_DEDUP_SRC_PROCESS_H_
+
+namespace vrt::dedup {
+struct ProgramArguments;
+}
+
+namespace vrt::dedup {
+
+void process(const ProgramArguments& args);
+
+}  // namespace vrt::dedup
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef VRT_DEDUP_SRC_PROGRAM_ARGUMENTS_H_
+#define VRT_DEDUP_SRC_PROGRAM_ARGUMENTS_H_
+
+#include <filesystem>
+
+namespace vrt::dedup {
+
+/**
+ * Input arguments to program.
+ */
+struct ProgramArguments {
+    std::filesystem::path file_path_in{};      /**< Input file path */
+    std::filesystem::path file_path_out{};     /**< Output file path */
+    bool                  do_byte_swap{false}; /**< True if byte swap is enabled */
+    double                window_s{1.0};       /**< Time window in which duplicates are found [s] */
+};
+
+}  // namespace vrt::dedup
+
+#endif
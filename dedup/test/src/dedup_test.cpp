@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "../../src/process.h"
+#include "../../src/program_arguments.h"
+#include "common/duplicate_filter.h"
+#include "common/generate_packet_sequence.h"
+#include "common/input_stream.h"
+#include "common/packet_hash.h"
+#include "common/timestamp.h"
+
+using namespace vrt;
+
+namespace fs = ::std::filesystem;
+
+static const fs::path TMP_DIR{"test_tmp"};
+static const fs::path TMP_FILE_IN_PATH{TMP_DIR / "dedup_in.vrt"};
+static const fs::path TMP_FILE_OUT_PATH{TMP_DIR / "dedup_out.vrt"};
+
+/**
+ * Packet in input file.
+ */
+struct TestPacket {
+    uint64_t time;         /**< Time [ms]. */
+    uint32_t id;           /**< Stream ID. */
+    uint8_t  packet_count; /**< Packet count. */
+    uint32_t body;         /**< Body word. */
+};
+
+/**
+ * Remove duplicates from input file.
+ */
+static void process(double window_s = 1.0) {
+    vrt::dedup::ProgramArguments args;
+    args.file_path_in  = TMP_FILE_IN_PATH;
+    args.file_path_out = TMP_FILE_OUT_PATH;
+    args.window_s      = window_s;
+    vrt::dedup::process(args);
+}
+
+/**
+ * \return Body words of packets in output file.
+ */
+static std::vector<uint32_t> read_output() {
+    std::vector<uint32_t> bodies;
+    common::InputStream   input_stream(TMP_FILE_OUT_PATH, false);
+    while (input_stream.read_next_packet()) {
+        bodies.push_back(static_cast<const uint32_t*>(input_stream.get_packet()->body)[0]);
+    }
+    return bodies;
+}
+
+class DedupTest : public ::testing::Test {
+   protected:
+    DedupTest() : p_() {}
+
+    void SetUp() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+        fs::create_directory(TMP_DIR);
+        vrt_init_packet(&p_);
+        p_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+        p_.header.tsi         = VRT_TSI_UTC;
+        p_.header.tsf         = VRT_TSF_REAL_TIME;
+        p_.words_body         = 1;
+    }
+    void TearDown() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+    }
+
+    /**
+     * Write input file with packets.
+     */
+    void generate(const std::vector<TestPacket>& packets) {
+        uint32_t body{0};
+        p_.body = &body;
+        common::generate_packet_sequence(TMP_FILE_IN_PATH, &p_, packets.size(), [&](uint64_t i) {
+            p_.header.packet_count                 = packets[i].packet_count;
+            p_.fields.stream_id                    = packets[i].id;
+            p_.fields.integer_seconds_timestamp    = static_cast<uint32_t>(packets[i].time / 1000);
+            p_.fields.fractional_seconds_timestamp = (packets[i].time % 1000) * 1000000000;
+            body                                   = packets[i].body;
+        });
+        p_.body = nullptr;
+    }
+
+    vrt_packet p_;
+};
+
+TEST_F(DedupTest, Hash) {
+    std::vector<uint32_t> a{1, 2, 3, 4, 5};
+    std::vector<uint32_t> b{1, 2, 3, 4, 6};
+    ASSERT_EQ(common::hash_words(a.data(), a.size()), common::hash_words(a.data(), a.size()));
+    ASSERT_NE(common::hash_words(a.data(), a.size()), common::hash_words(b.data(), b.size()));
+    ASSERT_NE(common::hash_words(a.data(), 4), common::hash_words(a.data(), 5));
+    ASSERT_NE(common::hash_words(a.data(), 0), common::hash_words(a.data(), 1));
+}
+
+TEST_F(DedupTest, Filter) {
+    common::DuplicateFilter filter(1000000000);
+    std::vector<uint32_t>   buf{1, 2, 3};
+    common::Timestamp       time;
+    time.tsi     = VRT_TSI_UTC;
+    time.tsf     = VRT_TSF_REAL_TIME;
+    time.integer = 1;
+
+    common::StreamId id;
+    ASSERT_FALSE(filter.is_duplicate(id, time, 0, buf.data(), 3));
+    ASSERT_TRUE(filter.is_duplicate(id, time, 0, buf.data(), 3));
+    ASSERT_FALSE(filter.is_duplicate(id, time, 1, buf.data(), 3));
+    ASSERT_FALSE(filter.is_duplicate(id, time, 0, buf.data(), 2));
+    buf[2] = 4;
+    ASSERT_FALSE(filter.is_duplicate(id, time, 0, buf.data(), 3));
+    ASSERT_EQ(filter.size(), 4);
+
+    // Later packets push earlier ones out of the window
+    common::Timestamp later{time};
+    later.fractional = 2000000000;
+    ASSERT_FALSE(filter.is_duplicate(id, later, 0, buf.data(), 3));
+    ASSERT_EQ(filter.size(), 1);
+    ASSERT_FALSE(filter.is_duplicate(id, time, 0, buf.data(), 3));
+    ASSERT_EQ(filter.get_number_of_duplicates(), 1);
+
+    // No timestamp
+    common::Timestamp none;
+    ASSERT_FALSE(filter.is_duplicate(id, none, 0, buf.data(), 3));
+    ASSERT_FALSE(filter.is_duplicate(id, none, 0, buf.data(), 3));
+}
+
+TEST_F(DedupTest, FilterOutOfOrder) {
+    common::DuplicateFilter filter(common::PS_PER_S);
+    std::vector<uint32_t>   buf{1, 2, 3};
+    common::StreamId        id;
+    common::Timestamp       time;
+    time.tsi = VRT_TSI_UTC;
+    time.tsf = VRT_TSF_REAL_TIME;
+
+    // A packet far in the future doesn't keep later packets from being forgotten
+    common::Timestamp future{time};
+    future.integer = 1000;
+    ASSERT_FALSE(filter.is_duplicate(id, future, 0, buf.data(), 3));
+    for (uint32_t i{0}; i < 100; ++i) {
+        time.integer = i;
+        ASSERT_FALSE(filter.is_duplicate(id, time, 0, buf.data(), 3));
+    }
+    ASSERT_EQ(filter.size(), 1);
+
+    // Packets a bit out of order are remembered until the window has passed them
+    for (uint32_t i{0}; i < 10; ++i) {
+        time.integer    = 2000;
+        time.fractional = 100000000000 * ((i * 7) % 10);
+        ASSERT_FALSE(filter.is_duplicate(id, time, 0, buf.data(), 3));
+    }
+    time.fractional = 300000000000;
+    ASSERT_TRUE(filter.is_duplicate(id, time, 0, buf.data(), 3));
+    ASSERT_EQ(filter.size(), 10);
+    time.integer    = 2001;
+    time.fractional = 500000000000;
+    ASSERT_FALSE(filter.is_duplicate(id, time, 0, buf.data(), 3));
+    ASSERT_EQ(filter.size(), 6);
+}
+
+TEST_F(DedupTest, Interleaved) {
+    // Two captures of the same stream, merged
+    generate({{0, 1, 0, 10}, {0, 1, 0, 10}, {0, 2, 0, 20}, {1, 1, 1, 11}, {0, 2, 0, 20}, {1, 1, 1, 11}, {2, 1, 2, 12}});
+    process();
+    ASSERT_EQ(read_output(), (std::vector<uint32_t>{10, 20, 11, 12}));
+}
+
+TEST_F(DedupTest, Different) {
+    // Same time, but different stream, packet count or contents
+    generate({{0, 1, 0, 10}, {0, 2, 0, 10}, {0, 1, 1, 10}, {0, 1, 0, 11}});
+    process();
+    ASSERT_EQ(read_output(), (std::vector<uint32_t>{10, 10, 10, 11}));
+}
+
+TEST_F(DedupTest, Window) {
+    generate({{0, 1, 0, 10}, {3000, 1, 1, 11}, {0, 1, 0, 10}});
+    process(1.0);
+    ASSERT_EQ(read_output(), (std::vector<uint32_t>{10, 11, 10}));
+    process(5.0);
+    ASSERT_EQ(read_output(), (std::vector<uint32_t>{10, 11}));
+}
@@ -0,0 +1,14 @@
+#include <gtest/gtest.h>
+
+/**
+ * Test application starting point.
+ *
+ * \param argc Number of input arguments.
+ * \param argv Input arguments [argc].
+ *
+ * \return Execution status.
+ */
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
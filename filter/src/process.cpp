@@ -0,0 +1,66 @@
+#include "process.h"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "vrt/vrt_types.h"
+
+#include "Progress-CPP/ProgressBar.hpp"
+#include "common/filter.h"
+#include "common/input_stream.h"
+#include "common/output_stream.h"
+#include "program_arguments.h"
+
+namespace vrt::filter {
+
+// For convenience
+using PacketPtr = std::shared_ptr<vrt_packet>;
+
+/**
+ * Process file contents.
+ *
+ * \param args Program arguments.
+ *
+ * \throw std::runtime_error If there's an error.
+ */
+void process(const ProgramArguments& args) {
+    common::Filter       filter(args.do_invert ? "!(" + args.expression + ")" : args.expression);
+    common::InputStream  input_stream(args.file_path_in, args.do_byte_swap);
+    common::OutputStream output_stream(args.file_path_out);
+
+    uint64_t n_packets{0};
+    uint64_t written{0};
+
+    // Progress bar
+    progresscpp::ProgressBar progress(static_cast<uint64_t>(input_stream.get_file_size()), 70);
+
+    // Go over all packets in input file
+    for (;; ++n_packets) {
+        bool is_match{false};
+        if (!input_stream.read_next_header() || !common::read_remainder_if_match(filter, &input_stream, &is_match)) {
+            break;
+        }
+
+        PacketPtr packet{input_stream.get_packet()};
+        if (is_match) {
+            output_stream.write(input_stream.get_buffer(), packet->header.packet_size);
+            written++;
+        }
+
+        // Handle progress bar
+        progress += sizeof(uint32_t) * packet->header.packet_size;
+        if (progress.get_ticks() % 65536 == 0) {
+            progress.display();
+        }
+    }
+
+    progress.done();
+
+    if (written == 0 && n_packets != 0) {
+        std::cerr << "Warning: None of " << n_packets << " packet(s) matched" << std::endl;
+    }
+}
+
+}  // namespace vrt::filter
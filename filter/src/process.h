@@ -0,0 +1,14 @@
+#ifndef VRT_FILTER_SRC_PROCESS_H_
+#define VRT_FILTER_SRC_PROCESS_H_
+
+namespace vrt::filter {
+struct ProgramArguments;
+}
+
+namespace vrt::filter {
+
+void process(const ProgramArguments& args);
+
+}  // namespace vrt::filter
+
+#endif
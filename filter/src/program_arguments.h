@@ -0,0 +1,22 @@
+#ifndef VRT_FILTER_SRC_PROGRAM_ARGUMENTS_H_
+#define VRT_FILTER_SRC_PROGRAM_ARGUMENTS_H_
+
+#include <filesystem>
+#include <string>
+
+namespace vrt::filter {
+
+/**
+ * Input arguments to program.
+ */
+struct ProgramArguments {
+    std::filesystem::path file_path_in{};
+    std::filesystem::path file_path_out{};
+    std::string           expression{};
+    bool                  do_invert{false};
+    bool                  do_byte_swap{false};
+};
+
+}  // namespace vrt::filter
+
+#endif
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "common/filter.h"
+
+using vrt::common::Filter;
+
+class FilterTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        vrt_init_packet(&p_);
+        p_.header.packet_type                = VRT_PT_IF_DATA_WITH_STREAM_ID;
+        p_.header.has.class_id               = true;
+        p_.header.tsi                        = VRT_TSI_UTC;
+        p_.header.packet_count               = 7;
+        p_.header.packet_size                = 12;
+        p_.fields.stream_id                  = 0xDEADBEEF;
+        p_.fields.class_id.oui               = 0xABCDEF;
+        p_.fields.integer_seconds_timestamp  = 1600000000;
+        p_.fields.class_id.packet_class_code = 0x12;
+    }
+
+    vrt_packet p_;
+};
+
+TEST_F(FilterTest, Empty) {
+    Filter f;
+    ASSERT_TRUE(f.empty());
+    ASSERT_TRUE(f.matches(p_));
+    ASSERT_TRUE(Filter("  ").empty());
+}
+
+TEST_F(FilterTest, HeaderOnly) {
+    ASSERT_TRUE(Filter("type==data && packet_count<8 && !has_trailer").is_header_only());
+    ASSERT_FALSE(Filter("type==data && stream_id==0xDEADBEEF").is_header_only());
+    ASSERT_FALSE(Filter("sample_rate>1M").is_header_only());
+}
+
+TEST_F(FilterTest, Compare) {
+    ASSERT_TRUE(Filter("stream_id==0xDEADBEEF").matches(p_));
+    ASSERT_TRUE(Filter("stream_id==3735928559").matches(p_));
+    ASSERT_FALSE(Filter("stream_id!=0xDEADBEEF").matches(p_));
+    ASSERT_TRUE(Filter("packet_count<8").matches(p_));
+    ASSERT_TRUE(Filter("packet_count<=7").matches(p_));
+    ASSERT_FALSE(Filter("packet_count>7").matches(p_));
+    ASSERT_TRUE(Filter("packet_count>=7").matches(p_));
+    ASSERT_TRUE(Filter("tsi>=1600000000").matches(p_));
+    ASSERT_TRUE(Filter("integer_seconds_timestamp==1600000000").matches(p_));
+    ASSERT_TRUE(Filter("tsi_type==utc").matches(p_));
+    ASSERT_TRUE(Filter("class_id.oui==0xABCDEF && pcc==0x12").matches(p_));
+}
+
+TEST_F(FilterTest, Type) {
+    ASSERT_TRUE(Filter("type==data").matches(p_));
+    ASSERT_FALSE(Filter("type==context").matches(p_));
+    ASSERT_TRUE(Filter("packet_type==if_data_with_stream_id").matches(p_));
+    p_.header.packet_type = VRT_PT_IF_CONTEXT;
+    ASSERT_TRUE(Filter("type==context").matches(p_));
+}
+
+TEST_F(FilterTest, Logic) {
+    ASSERT_TRUE(Filter("stream_id==0xDEADBEEF && type==data && tsi>=1600000000").matches(p_));
+    ASSERT_TRUE(Filter("stream_id==1 || type==data").matches(p_));
+    ASSERT_FALSE(Filter("!(stream_id==1 || type==data)").matches(p_));
+    ASSERT_TRUE(Filter("stream_id==1 && type==context || packet_count==7").matches(p_));
+    ASSERT_FALSE(Filter("stream_id==1 && (type==context || packet_count==7)").matches(p_));
+    ASSERT_TRUE(Filter("has_class_id && !has_trailer").matches(p_));
+}
+
+TEST_F(FilterTest, Absent) {
+    p_.header.packet_type = VRT_PT_IF_DATA_WITHOUT_STREAM_ID;
+    p_.header.tsi         = VRT_TSI_NONE;
+    ASSERT_FALSE(Filter("stream_id==0xDEADBEEF").matches(p_));
+    ASSERT_FALSE(Filter("stream_id!=0xDEADBEEF").matches(p_));
+    ASSERT_FALSE(Filter("tsi>=0").matches(p_));
+    ASSERT_FALSE(Filter("valid_data").matches(p_));
+    ASSERT_FALSE(Filter("sample_rate>0").matches(p_));
+}
+
+TEST_F(FilterTest, Context) {
+    p_.header.packet_type         = VRT_PT_IF_CONTEXT;
+    p_.if_context.has.sample_rate = true;
+    p_.if_context.sample_rate     = 20e6;
+    ASSERT_TRUE(Filter("sample_rate>=10M").matches(p_));
+    ASSERT_TRUE(Filter("sample_rate==2e7").matches(p_));
+    ASSERT_FALSE(Filter("sample_rate<1.5e7").matches(p_));
+    ASSERT_FALSE(Filter("bandwidth>0").matches(p_));
+}
+
+TEST_F(FilterTest, Trailer) {
+    p_.header.has.trailer       = true;
+    p_.trailer.has.valid_data   = true;
+    p_.trailer.valid_data       = true;
+    p_.trailer.has.sample_loss  = true;
+    p_.trailer.sample_loss      = false;
+    ASSERT_TRUE(Filter("valid_data").matches(p_));
+    ASSERT_TRUE(Filter("valid_data==true && sample_loss==false").matches(p_));
+    ASSERT_FALSE(Filter("sample_loss").matches(p_));
+}
+
+TEST_F(FilterTest, SyntaxError) {
+    ASSERT_THROW(Filter("stream_id=="), std::runtime_error);
+    ASSERT_THROW(Filter("stream_id=1"), std::runtime_error);
+    ASSERT_THROW(Filter("no_such_field==1"), std::runtime_error);
+    ASSERT_THROW(Filter("type==no_such_type"), std::runtime_error);
+    ASSERT_THROW(Filter("stream_id==-1"), std::runtime_error);
+    ASSERT_THROW(Filter("stream_id==1.5"), std::runtime_error);
+    ASSERT_THROW(Filter("(type==data"), std::runtime_error);
+    ASSERT_THROW(Filter("type==data)"), std::runtime_error);
+    ASSERT_THROW(Filter("type==data &&"), std::runtime_error);
+    ASSERT_THROW(Filter("stream_id==0x1FFFFFFFFFFFFFFFFF"), std::runtime_error);
+    ASSERT_THROW(Filter("sample_rate>k"), std::runtime_error);
+    ASSERT_THROW(Filter("sample_rate>M"), std::runtime_error);
+    ASSERT_THROW(Filter("sample_rate>G"), std::runtime_error);
+    ASSERT_THROW(Filter("\xA0"), std::runtime_error);
+}
+
+TEST_F(FilterTest, TooDeep) {
+    std::string expr;
+    for (int i{0}; i < 100; ++i) {
+        expr += "type==data || (";
+    }
+    expr += "type==data";
+    expr += std::string(100, ')');
+    ASSERT_THROW(Filter{expr}, std::runtime_error);
+
+    // Fails while parsing, before recursion overflows the stack
+    const size_t n{1000000};
+    ASSERT_THROW(Filter(std::string(n, '(') + "type==data" + std::string(n, ')')), std::runtime_error);
+    ASSERT_THROW(Filter(std::string(n, '!') + "type==data"), std::runtime_error);
+
+    const size_t n_ok{Filter::MAX_DEPTH / 2};
+    ASSERT_TRUE(Filter(std::string(n_ok, '(') + "type==data" + std::string(n_ok, ')')).matches(p_));
+    ASSERT_TRUE(Filter(std::string(2 * n_ok, '!') + "type==data").matches(p_));
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "../../src/process.h"
+#include "../../src/program_arguments.h"
+#include "common/generate_packet_sequence.h"
+#include "common/input_stream.h"
+
+namespace fs = ::std::filesystem;
+
+static const uint64_t N_PACKETS{100};
+static const fs::path TMP_DIR{"test_tmp"};
+static const fs::path TMP_FILE_IN{TMP_DIR / "in.vrt"};
+static const fs::path TMP_FILE_OUT{TMP_DIR / "out.vrt"};
+
+class ProcessTest : public ::testing::Test {
+   protected:
+    ProcessTest() : p_() {}
+
+    void SetUp() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+        fs::create_directory(TMP_DIR);
+
+        // Every third packet is context, every other has a trailer
+        vrt_init_packet(&p_);
+        p_.header.tsi = VRT_TSI_UTC;
+        vrt::common::generate_packet_sequence(TMP_FILE_IN, &p_, N_PACKETS, [&](uint64_t i) {
+            p_.header.packet_type               = i % 3 == 0 ? VRT_PT_IF_CONTEXT : VRT_PT_IF_DATA_WITH_STREAM_ID;
+            p_.header.has.trailer               = i % 2 == 0 && p_.header.packet_type != VRT_PT_IF_CONTEXT;
+            p_.fields.stream_id                 = i % 5 == 0 ? 0xDEADBEEF : 0x12345678;
+            p_.fields.integer_seconds_timestamp = static_cast<uint32_t>(i);
+        });
+    }
+
+    void TearDown() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+    }
+
+    /**
+     * Run filter and read integer timestamps of output packets.
+     */
+    static std::vector<uint32_t> run(const std::string& expression, bool do_invert = false) {
+        vrt::filter::ProgramArguments args;
+        args.file_path_in  = TMP_FILE_IN;
+        args.file_path_out = TMP_FILE_OUT;
+        args.expression    = expression;
+        args.do_invert     = do_invert;
+        vrt::filter::process(args);
+
+        std::vector<uint32_t>    ret;
+        vrt::common::InputStream input_stream(TMP_FILE_OUT, false);
+        while (input_stream.read_next_packet()) {
+            ret.push_back(input_stream.get_packet()->fields.integer_seconds_timestamp);
+        }
+        return ret;
+    }
+
+    vrt_packet p_;
+};
+
+TEST_F(ProcessTest, HeaderOnly) {
+    std::vector<uint32_t> v{run("has_trailer")};
+    ASSERT_EQ(v.size(), 33);
+    for (uint32_t t : v) {
+        ASSERT_EQ(t % 2, 0);
+        ASSERT_NE(t % 3, 0);
+    }
+}
+
+TEST_F(ProcessTest, Fields) {
+    std::vector<uint32_t> v{run("stream_id==0xDEADBEEF && type==context && tsi>=10")};
+    ASSERT_EQ(v, (std::vector<uint32_t>{15, 30, 45, 60, 75, 90}));
+}
+
+TEST_F(ProcessTest, Invert) {
+    ASSERT_EQ(run("type==data", true).size(), 34);
+    ASSERT_EQ(run("tsi<50", true).size(), 50);
+}
+
+TEST_F(ProcessTest, None) {
+    ASSERT_TRUE(run("stream_id==0").empty());
+}
+
+TEST_F(ProcessTest, Invalid) {
+    ASSERT_THROW(run("stream_id=="), std::runtime_error);
+}
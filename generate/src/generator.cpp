@@ -0,0 +1,223 @@
+#include "generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_string.h"
+#include "vrt/vrt_types.h"
+#include "vrt/vrt_words.h"
+#include "vrt/vrt_write.h"
+
+#include "common/byte_swap.h"
+#include "common/timestamp.h"
+#include "program_arguments.h"
+
+namespace vrt::gen {
+
+/**
+ * Largest packet size [words].
+ */
+static constexpr uint32_t MAX_PACKET_WORDS{0xFFFF};
+
+/**
+ * Parts of the counter range of random numbers.
+ */
+enum Draw : unsigned { STREAM, SIZE, LOSS, PAYLOAD, NOISE };
+
+/**
+ * Constructor.
+ *
+ * \param args Program arguments.
+ * \param seed Seed of random numbers.
+ *
+ * \throw std::runtime_error If arguments are invalid.
+ */
+Generator::Generator(const ProgramArguments& args, uint64_t seed) : args_{args}, random_{seed}, data_(), context_() {
+    vrt_init_packet(&data_);
+    data_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    data_.header.tsi         = args.tsi;
+    data_.header.tsf         = args.tsf;
+    data_.words_body         = 0;
+    words_overhead_          = static_cast<uint32_t>(vrt_words_packet(&data_));
+
+    vrt_init_packet(&context_);
+    context_.header.packet_type = VRT_PT_IF_CONTEXT;
+    context_.header.tsi         = args.tsi;
+    context_.header.tsf         = args.tsf;
+
+    words_data_min_ = args.size;
+    words_data_max_ = std::max(args.size, args.size_max);
+    if (words_data_min_ < words_overhead_ || words_data_max_ > MAX_PACKET_WORDS) {
+        std::stringstream ss;
+        ss << "Data packet size must be between " << words_overhead_ << " and " << MAX_PACKET_WORDS << " words";
+        throw std::runtime_error(ss.str());
+    }
+    if (args.n_streams == 0 || args.block == 0) {
+        throw std::runtime_error("Number of streams and block size must be positive");
+    }
+    if (!(args.rate > 0.0) || std::llround(common::PS_PER_S / args.rate) < 1) {
+        std::stringstream ss;
+        ss << "Invalid packet rate " << args.rate << " Hz";
+        throw std::runtime_error(ss.str());
+    }
+
+    interval_ps_        = static_cast<uint64_t>(std::llround(common::PS_PER_S / args.rate));
+    samples_per_packet_ = words_data_min_ - words_overhead_;
+
+    // Sample rate follows from packet rate, with one sample per word in the smallest packet
+    if (samples_per_packet_ != 0) {
+        context_.if_context.has.sample_rate = true;
+        context_.if_context.sample_rate =
+            static_cast<double>(samples_per_packet_) * common::PS_PER_S / static_cast<double>(interval_ps_);
+    }
+    words_context_ = args.context_interval != 0 ? static_cast<uint32_t>(vrt_words_packet(&context_)) : 0;
+
+    noise_.resize(NOISE_WORDS + MAX_PACKET_WORDS);
+    for (uint64_t j{0}; j < noise_.size(); ++j) {
+        noise_[j] = static_cast<uint32_t>(random_.get((static_cast<uint64_t>(NOISE) << 60U) + j));
+    }
+}
+
+/**
+ * \param i Slot index.
+ *
+ * \return Stream index of slot.
+ */
+uint32_t Generator::get_stream(uint64_t i) const {
+    uint64_t b{i / args_.block};
+    if (args_.interleave == interleave_type::RANDOM) {
+        return static_cast<uint32_t>(random_.get((static_cast<uint64_t>(STREAM) << 60U) + b) % args_.n_streams);
+    }
+    return static_cast<uint32_t>(b % args_.n_streams);
+}
+
+/**
+ * \param i   Slot index.
+ * \param seq Sequence number of data packet in its stream.
+ *
+ * \return Size of slot [words].
+ */
+uint32_t Generator::get_words(uint64_t i, uint64_t seq) const {
+    return (has_context(seq) ? words_context_ : 0) + (is_lost(i) ? 0 : get_words_data(i));
+}
+
+/**
+ * \param i Slot index.
+ *
+ * \return True if data packet of slot is lost.
+ */
+bool Generator::is_lost(uint64_t i) const {
+    return args_.prob_loss > 0.0 && random_.uniform((static_cast<uint64_t>(LOSS) << 60U) + i) < args_.prob_loss;
+}
+
+/**
+ * \param seq Sequence number of data packet in its stream.
+ *
+ * \return True if data packet is preceded by a context packet.
+ */
+bool Generator::has_context(uint64_t seq) const {
+    return args_.context_interval != 0 && seq % args_.context_interval == 0;
+}
+
+/**
+ * \param i Slot index.
+ *
+ * \return Size of data packet of slot, whether lost or not [words].
+ */
+uint32_t Generator::get_words_data(uint64_t i) const {
+    if (words_data_max_ == words_data_min_) {
+        return words_data_min_;
+    }
+    uint64_t r{random_.get((static_cast<uint64_t>(SIZE) << 60U) + i)};
+    return words_data_min_ + static_cast<uint32_t>(r % (words_data_max_ - words_data_min_ + 1));
+}
+
+/**
+ * Set timestamp of packet. Packets of a stream are an exact number of picoseconds apart.
+ *
+ * \param seq    Sequence number of data packet in its stream.
+ * \param packet Packet.
+ */
+void Generator::set_time(uint64_t seq, vrt_packet* packet) const {
+    common::Int128 t_ps{static_cast<common::Int128>(seq) * interval_ps_};
+    auto           ps{static_cast<uint64_t>(t_ps % common::PS_PER_S)};
+    packet->fields.integer_seconds_timestamp = args_.start_time + static_cast<uint32_t>(t_ps / common::PS_PER_S);
+    switch (args_.tsf) {
+        case VRT_TSF_SAMPLE_COUNT:
+            packet->fields.fractional_seconds_timestamp = ps * samples_per_packet_ / interval_ps_;
+            break;
+        case VRT_TSF_REAL_TIME:
+            packet->fields.fractional_seconds_timestamp = ps;
+            break;
+        case VRT_TSF_FREE_RUNNING_COUNT:
+            packet->fields.fractional_seconds_timestamp = seq * samples_per_packet_;
+            break;
+        default:
+            packet->fields.fractional_seconds_timestamp = 0;
+            break;
+    }
+}
+
+/**
+ * Write slot to buffer.
+ *
+ * \param i      Slot index.
+ * \param stream Stream index of slot.
+ * \param seq    Sequence number of data packet in its stream.
+ * \param buf    Buffer of at least get_words() words.
+ *
+ * \return Number of words written.
+ *
+ * \throw std::runtime_error If a packet fails to be written.
+ */
+uint32_t Generator::write(uint64_t i, uint32_t stream, uint64_t seq, uint32_t* buf) const {
+    uint32_t words{0};
+    int32_t  rv{0};
+
+    if (has_context(seq)) {
+        vrt_packet p{context_};
+        p.header.packet_count                       = static_cast<uint8_t>((seq / args_.context_interval) % 16);
+        p.header.packet_size                        = static_cast<uint16_t>(words_context_);
+        p.fields.stream_id                          = stream;
+        p.if_context.context_field_change_indicator = seq == 0;
+        set_time(seq, &p);
+        rv = vrt_write_packet(&p, buf, words_context_, false);
+        words += words_context_;
+    }
+
+    if (rv >= 0 && !is_lost(i)) {
+        uint32_t   words_data{get_words_data(i)};
+        vrt_packet p{data_};
+        p.header.packet_count = static_cast<uint8_t>(seq % 16);
+        p.header.packet_size  = static_cast<uint16_t>(words_data);
+        p.fields.stream_id    = stream;
+        p.words_body          = static_cast<int32_t>(words_data - words_overhead_);
+        // Body is only read when writing
+        p.body = const_cast<uint32_t*>(noise_.data()) +
+                 random_.get((static_cast<uint64_t>(PAYLOAD) << 60U) + i) % NOISE_WORDS;
+        set_time(seq, &p);
+        rv = vrt_write_packet(&p, buf + words, words_data, false);
+        words += words_data;
+    }
+
+    if (rv < 0) {
+        std::stringstream ss;
+        ss << "Failed to write VRT packet to buffer: " << vrt_string_error(rv);
+        throw std::runtime_error(ss.str());
+    }
+
+    if (args_.do_byte_swap) {
+        for (uint32_t j{0}; j < words; ++j) {
+            buf[j] = bswap_32(buf[j]);
+        }
+    }
+
+    return words;
+}
+
+}  // namespace vrt::gen
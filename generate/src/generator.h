@@ -0,0 +1,63 @@
+#ifndef VRT_GENERATE_SRC_GENERATOR_H_
+#define VRT_GENERATE_SRC_GENERATOR_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "vrt/vrt_types.h"
+
+#include "common/counter_random.h"
+
+namespace vrt::gen {
+struct ProgramArguments;
+}
+
+namespace vrt::gen {
+
+/**
+ * Generator of the packets of a synthetic corpus. The corpus is a sequence of slots, where slot i holds data packet i,
+ * unless it is lost, preceded by a context packet at every context interval of its stream. A slot only depends on the
+ * seed, its index, and the sequence number of its data packet in its stream, so slots can be generated in any order by
+ * several threads, once the sequence numbers are known.
+ */
+class Generator {
+   public:
+    Generator(const ProgramArguments& args, uint64_t seed);
+
+    uint32_t get_stream(uint64_t i) const;
+    uint32_t get_words(uint64_t i, uint64_t seq) const;
+    uint32_t write(uint64_t i, uint32_t stream, uint64_t seq, uint32_t* buf) const;
+
+    /**
+     * \return Largest size of a slot [words].
+     */
+    uint32_t get_max_words() const { return words_context_ + words_data_max_; }
+
+    /**
+     * Number of pseudo random words that packet bodies are copied from.
+     */
+    static constexpr uint32_t NOISE_WORDS{1 << 16};
+
+   private:
+    bool     is_lost(uint64_t i) const;
+    bool     has_context(uint64_t seq) const;
+    uint32_t get_words_data(uint64_t i) const;
+    void     set_time(uint64_t seq, vrt_packet* packet) const;
+
+    const ProgramArguments&     args_;
+    const common::CounterRandom random_;
+
+    vrt_packet            data_;                  /**< Data packet, without stream, time, and body. */
+    vrt_packet            context_;               /**< Context packet, without stream and time. */
+    uint32_t              words_overhead_{0};     /**< Size of a data packet without body [words]. */
+    uint32_t              words_context_{0};      /**< Size of a context packet [words]. */
+    uint32_t              words_data_min_{0};     /**< Smallest size of a data packet [words]. */
+    uint32_t              words_data_max_{0};     /**< Largest size of a data packet [words]. */
+    uint64_t              interval_ps_{0};        /**< Time between packets of a stream [ps]. */
+    uint64_t              samples_per_packet_{0}; /**< Samples per packet, the body size of the smallest packet. */
+    std::vector<uint32_t> noise_;                 /**< Pseudo random words. */
+};
+
+}  // namespace vrt::gen
+
+#endif
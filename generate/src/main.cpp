@@ -0,0 +1,157 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include "vrt/vrt_types.h"
+#include "vrt/vrt_util.h"
+
+#include "CLI/CLI.hpp"
+
+#include "process.h"
+#include "program_arguments.h"
+
+#ifndef CMAKE_PROJECT_NAME
+#error "No project name definition from CMake"
+#endif
+#ifndef CMAKE_PROJECT_DESCRIPTION
+#error "No project definition from CMake"
+#endif
+
+/**
+ * Setup program command line argument parsing.
+ *
+ * \param app CLI11 app.
+ *
+ * \return Program input arguments.
+ */
+static vrt::gen::ProgramArguments setup_arg_parse(CLI::App* app) {
+    vrt::gen::ProgramArguments args;
+
+    const std::map<std::string, uint64_t> decimal_units{
+        {"T", 1000000000000}, {"G", 1000000000}, {"M", 1000000}, {"k", 1000}};
+
+    // Output file
+    CLI::Option* opt_file_out{app->add_option("-o,--output-file", args.file_path_out, "Output file path")};
+    opt_file_out->required(true);
+
+    // Packets
+    CLI::Option* opt_packets{app->add_option("-n,--packets", args.n_packets,
+                                             "Number of data packets of all streams, including lost ones. Default is "
+                                             "1000.")};
+    opt_packets->transform(CLI::AsNumberWithUnit(decimal_units, CLI::AsNumberWithUnit::CASE_SENSITIVE));
+
+    // Streams
+    CLI::Option* opt_streams{app->add_option(
+        "-S,--streams", args.n_streams, "Number of streams, with Stream IDs from 0 and up. Default is 1.")};
+    opt_streams->check(CLI::PositiveNumber);
+
+    // Size
+    CLI::Option* opt_size{
+        app->add_option("-w,--size", args.size, "Size of data packets, including header [words]. Default is 1024.")};
+    opt_size->check(CLI::Range(1, 0xFFFF));
+    CLI::Option* opt_size_max{app->add_option(
+        "--max-size", args.size_max,
+        "Largest size of data packets [words]. Sizes are then uniformly distributed between --size and this.")};
+    opt_size_max->check(CLI::Range(1, 0xFFFF));
+
+    // Rate
+    CLI::Option* opt_rate{app->add_option(
+        "-r,--rate", args.rate,
+        "Packet rate of each stream [Hz]. Default is 1000. The sample rate is this times the body size of the "
+        "smallest data packet, with one sample per word.")};
+    opt_rate->check(CLI::PositiveNumber);
+    opt_rate->transform(CLI::AsNumberWithUnit(decimal_units, CLI::AsNumberWithUnit::CASE_SENSITIVE));
+
+    // Timestamps
+    std::map<std::string, vrt_tsi> map_tsi{
+        {"none", VRT_TSI_NONE}, {"utc", VRT_TSI_UTC}, {"gps", VRT_TSI_GPS}, {"other", VRT_TSI_OTHER}};
+    CLI::Option* opt_tsi{app->add_option("--tsi", args.tsi, "Integer timestamp type. Default is utc.")};
+    opt_tsi->transform(CLI::CheckedTransformer(map_tsi, CLI::ignore_case));
+    std::map<std::string, vrt_tsf> map_tsf{{"none", VRT_TSF_NONE},
+                                           {"sample_count", VRT_TSF_SAMPLE_COUNT},
+                                           {"real_time", VRT_TSF_REAL_TIME},
+                                           {"free_running_count", VRT_TSF_FREE_RUNNING_COUNT}};
+    CLI::Option* opt_tsf{app->add_option("--tsf", args.tsf, "Fractional timestamp type. Default is real_time.")};
+    opt_tsf->transform(CLI::CheckedTransformer(map_tsf, CLI::ignore_case));
+    app->add_option("--start-time", args.start_time, "Integer timestamp of first packet [s]. Default is 1600000000.");
+
+    // Context
+    app->add_option("-c,--context", args.context_interval,
+                    "Number of data packets of a stream per context packet, which is written before the data packet. "
+                    "Default is 0, i.e. no context packets.");
+
+    // Interleaving
+    std::map<std::string, vrt::gen::interleave_type> map_interleave{
+        {"round-robin", vrt::gen::interleave_type::ROUND_ROBIN}, {"random", vrt::gen::interleave_type::RANDOM}};
+    CLI::Option* opt_interleave{
+        app->add_option("--interleave", args.interleave, "Order of streams. Default is round-robin.")};
+    opt_interleave->transform(CLI::CheckedTransformer(map_interleave, CLI::ignore_case));
+    CLI::Option* opt_block{app->add_option(
+        "--block", args.block, "Number of data packets of a stream in a row, before the next stream. Default is 1.")};
+    opt_block->check(CLI::PositiveNumber);
+
+    // Loss
+    CLI::Option* opt_loss{app->add_option(
+        "--loss", args.prob_loss,
+        "Probability that a data packet is lost, leaving a gap in the packet count and timestamps of its stream")};
+    opt_loss->check(CLI::Range(0.0, 1.0));
+
+    // Seed
+    app->add_option("--seed", args.seed,
+                    "Seed of random numbers, for reproducible output. Default is a random seed, which is printed.");
+
+    // Jobs
+    CLI::Option* opt_jobs{app->add_option("-j,--jobs", args.n_jobs,
+                                          "Number of threads generating packets. 0 means one per CPU core. Output is "
+                                          "the same as with one thread.")};
+    opt_jobs->check(CLI::NonNegativeNumber);
+
+    // Byte swap
+    app->add_flag("-b,--byte-swap", args.do_byte_swap,
+                  "Apply byte swap to written packets, to write big endian packets on a little endian platform");
+
+    return args;
+}
+
+/**
+ * Starting point.
+ *
+ * \param argc Number of input arguments.
+ * \param argv Input arguments [argc].
+ *
+ * \return EXIT_SUCCESS if success, and EXIT_FAILURE otherwise.
+ */
+int main(int argc, const char** argv) {
+    // Parse arguments
+    CLI::App                   app(CMAKE_PROJECT_DESCRIPTION, CMAKE_PROJECT_NAME);
+    vrt::gen::ProgramArguments program_args{setup_arg_parse(&app)};
+    CLI11_PARSE(app, argc, argv)
+    program_args.has_seed = app.count("--seed") != 0;
+
+    // Check that endianness of platform compared to byte swap parameter makes sense
+    if (vrt_is_platform_little_endian() && !program_args.do_byte_swap) {
+        std::cerr << "Warning: Detected little endian platform, but byte swap is NOT enabled. This will write "
+                     "non-conforming VRT packets."
+                  << std::endl;
+    } else if (!vrt_is_platform_little_endian() && program_args.do_byte_swap) {
+        std::cerr << "Warning: Detected big endian platform, but byte swap IS enabled. This will write "
+                     "non-conforming VRT packets."
+                  << std::endl;
+    }
+
+    // Process
+    try {
+        vrt::gen::process(program_args);
+    } catch (const std::exception& exc) {
+        std::cerr << exc.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (...) {
+        std::cerr << "Unknown error" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,177 @@
+#include "process.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Progress-CPP/ProgressBar.hpp"
+#include "common/counter_random.h"
+#include "common/positional_output_stream.h"
+#include "generator.h"
+#include "program_arguments.h"
+
+namespace vrt::gen {
+
+/**
+ * Size of output written at a time by a thread [words].
+ */
+static constexpr uint64_t BUFFER_WORDS{1 << 21};
+
+/**
+ * Approximate size of a segment [B].
+ */
+static constexpr uint64_t SEGMENT_BYTES{1 << 26};
+
+/**
+ * Smallest number of slots in a segment.
+ */
+static constexpr uint64_t MIN_SEGMENT_SLOTS{1024};
+
+/**
+ * Consecutive slots, generated by one thread into its own region of the output file.
+ */
+struct Segment {
+    uint64_t              begin{0};    /**< First slot. */
+    uint64_t              end{0};      /**< Last slot (exclusive). */
+    uint64_t              position{0}; /**< Position in output file [B]. */
+    uint64_t              bytes{0};    /**< Size [B]. */
+    std::vector<uint64_t> seqs;        /**< Sequence number of next data packet of each stream, set when dispatched. */
+};
+
+/**
+ * Divide slots into segments, and find where each segment begins in the output file. Only sizes are calculated, so
+ * this is much faster than generating the packets.
+ *
+ * \param args      Program arguments.
+ * \param generator Generator.
+ * \param n_jobs    Number of threads.
+ *
+ * \return Segments.
+ */
+static std::vector<Segment> FindSegments(const ProgramArguments& args, const Generator& generator, unsigned n_jobs) {
+    // Segments are large, but there are several per thread for small outputs
+    uint64_t words_mean{(args.size + std::max(args.size, args.size_max)) / 2};
+    uint64_t slots_by_size{SEGMENT_BYTES / (sizeof(uint32_t) * words_mean)};
+    uint64_t n_min{4 * static_cast<uint64_t>(n_jobs)};
+    uint64_t slots_by_jobs{(args.n_packets + n_min - 1) / n_min};
+    uint64_t slots{std::max(std::min(slots_by_size, slots_by_jobs), MIN_SEGMENT_SLOTS)};
+
+    std::vector<Segment>  segments;
+    std::vector<uint64_t> seqs(args.n_streams, 0);
+    uint64_t              position{0};
+    for (uint64_t i{0}; i < args.n_packets; ++i) {
+        if (i % slots == 0) {
+            if (!segments.empty()) {
+                segments.back().bytes = position - segments.back().position;
+            }
+            Segment segment;
+            segment.begin    = i;
+            segment.end      = std::min(args.n_packets, i + slots);
+            segment.position = position;
+            segments.push_back(std::move(segment));
+        }
+        uint32_t stream{generator.get_stream(i)};
+        position += sizeof(uint32_t) * generator.get_words(i, seqs[stream]++);
+    }
+    if (!segments.empty()) {
+        segments.back().bytes = position - segments.back().position;
+    }
+
+    return segments;
+}
+
+/**
+ * Generate segment, and write it to its region of the output file in large blocks.
+ *
+ * \param generator Generator.
+ * \param segment   Segment.
+ * \param output    Output file.
+ *
+ * \throw std::runtime_error On error.
+ */
+static void GenerateSegment(const Generator& generator, Segment segment, common::PositionalOutputStream* output) {
+    std::vector<uint32_t> buf(BUFFER_WORDS + generator.get_max_words());
+    uint64_t              words{0};
+    uint64_t              position{segment.position};
+    for (uint64_t i{segment.begin}; i < segment.end; ++i) {
+        uint32_t stream{generator.get_stream(i)};
+        words += generator.write(i, stream, segment.seqs[stream]++, buf.data() + words);
+        if (words >= BUFFER_WORDS || i + 1 == segment.end) {
+            output->write(buf.data(), words, position);
+            position += sizeof(uint32_t) * words;
+            words = 0;
+        }
+    }
+}
+
+/**
+ * Generate corpus. Slots are divided into segments, whose positions in the output file are found from the packet sizes
+ * first. Segments are then generated by several threads at once, each into its own region of the output file. The
+ * output only depends on the seed and the other arguments, not on the number of threads.
+ *
+ * \param args Program arguments.
+ *
+ * \throw std::runtime_error If there's an error.
+ */
+void process(const ProgramArguments& args) {
+    uint64_t  seed{common::get_seed(args.has_seed, args.seed)};
+    Generator generator(args, seed);
+
+    unsigned             n_jobs{args.n_jobs != 0 ? args.n_jobs : std::max(std::thread::hardware_concurrency(), 1U)};
+    std::vector<Segment> segments{FindSegments(args, generator, n_jobs)};
+    uint64_t             size_bytes{segments.empty() ? 0 : segments.back().position + segments.back().bytes};
+
+    common::PositionalOutputStream output(args.file_path_out, size_bytes);
+    progresscpp::ProgressBar       progress(size_bytes, 70);
+
+    std::deque<std::pair<std::future<void>, uint64_t>> generating;
+    std::vector<uint64_t>                              seqs(args.n_streams, 0);
+    try {
+        for (Segment& segment : segments) {
+            // Sequence numbers at the start of a segment follow from the streams of the slots before it. Only
+            // segments being generated hold a copy of them.
+            segment.seqs = seqs;
+            for (uint64_t i{segment.begin}; i < segment.end; ++i) {
+                seqs[generator.get_stream(i)]++;
+            }
+
+            if (generating.size() == n_jobs) {
+                generating.front().first.get();
+                progress += generating.front().second;
+                progress.display();
+                generating.pop_front();
+            }
+            uint64_t bytes{segment.bytes};
+            generating.emplace_back(
+                std::async(std::launch::async, GenerateSegment, std::cref(generator), std::move(segment), &output),
+                bytes);
+        }
+        while (!generating.empty()) {
+            generating.front().first.get();
+            progress += generating.front().second;
+            progress.display();
+            generating.pop_front();
+        }
+        output.close();
+
+        progress.done();
+    } catch (...) {
+        // Wait for threads still writing, then cleanup and rethrow
+        for (auto& g : generating) {
+            g.first.wait();
+        }
+        output.remove_file();
+        throw;
+    }
+
+    if (!args.has_seed) {
+        std::cout << "Seed: " << seed << std::endl;
+    }
+}
+
+}  // namespace vrt::gen
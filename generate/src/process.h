@@ -0,0 +1,14 @@
+#ifndef VRT_GENERATE_SRC_PROCESS_H_
+#define VRT_GENERATE_SRC_PROCESS_H_
+
+namespace vrt::gen {
+struct ProgramArguments;
+}
+
+namespace vrt::gen {
+
+void process(const ProgramArguments& args);
+
+}  // namespace vrt::gen
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef VRT_GENERATE_SRC_PROGRAM_ARGUMENTS_H_
+#define VRT_GENERATE_SRC_PROGRAM_ARGUMENTS_H_
+
+#include <cstdint>
+#include <filesystem>
+
+#include "vrt/vrt_types.h"
+
+namespace vrt::gen {
+
+enum class interleave_type { ROUND_ROBIN, RANDOM };
+
+/**
+ * Input arguments to program.
+ */
+struct ProgramArguments {
+    std::filesystem::path file_path_out{};                          /**< Output file path */
+    uint64_t              n_packets{1000};                          /**< Number of data packets, including lost ones */
+    uint32_t              n_streams{1};                             /**< Number of streams */
+    uint32_t              size{1024};                               /**< Smallest data packet size [words] */
+    uint32_t              size_max{0};                              /**< Largest data packet size, or 0 [words] */
+    double                rate{1000.0};                             /**< Packet rate of each stream [Hz] */
+    vrt_tsi               tsi{VRT_TSI_UTC};                         /**< Integer timestamp type */
+    vrt_tsf               tsf{VRT_TSF_REAL_TIME};                   /**< Fractional timestamp type */
+    uint32_t              start_time{1600000000};                   /**< Time of first packet [s] */
+    uint64_t              context_interval{0};                      /**< Data packets per context packet, or 0 */
+    interleave_type       interleave{interleave_type::ROUND_ROBIN}; /**< Order of streams */
+    uint64_t              block{1};                                 /**< Packets of a stream in a row */
+    double                prob_loss{0.0};                           /**< Probability that a data packet is lost */
+    uint64_t              seed{0};                                  /**< Seed of random numbers */
+    bool                  has_seed{false};                          /**< True if seed is given */
+    unsigned              n_jobs{0};                                /**< Number of threads, or 0 for one per core */
+    bool                  do_byte_swap{false};                      /**< True if byte swap is enabled */
+};
+
+}  // namespace vrt::gen
+
+#endif
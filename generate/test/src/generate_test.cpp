@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include "vrt/vrt_types.h"
+
+#include "../../src/process.h"
+#include "../../src/program_arguments.h"
+#include "common/input_stream.h"
+#include "common/timestamp.h"
+
+using namespace vrt;
+
+namespace fs = ::std::filesystem;
+
+static const fs::path TMP_DIR{"test_tmp"};
+static const fs::path TMP_FILE_OUT_PATH{TMP_DIR / "gen.vrt"};
+
+class GenerateTest : public ::testing::Test {
+   protected:
+    GenerateTest() : args_() {}
+
+    void SetUp() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+        fs::create_directory(TMP_DIR);
+        args_.file_path_out = TMP_FILE_OUT_PATH;
+        args_.size          = 16;
+        args_.seed          = 1;
+        args_.has_seed      = true;
+        args_.n_jobs        = 1;
+    }
+    void TearDown() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+    }
+
+    gen::ProgramArguments args_;
+};
+
+/**
+ * Packet read from output, without body.
+ */
+struct Packet {
+    vrt_packet_type type;
+    uint32_t        stream;
+    uint16_t        words;
+    uint8_t         count;
+    common::Int128  time_ps;
+};
+
+static std::vector<Packet> read_output(bool do_byte_swap = false) {
+    std::vector<Packet> packets;
+    common::InputStream input_stream(TMP_FILE_OUT_PATH, do_byte_swap);
+    while (input_stream.read_next_packet()) {
+        const vrt_packet& p{*input_stream.get_packet()};
+        Packet            packet{};
+        packet.type    = p.header.packet_type;
+        packet.stream  = p.fields.stream_id;
+        packet.words   = p.header.packet_size;
+        packet.count   = p.header.packet_count;
+        packet.time_ps = static_cast<common::Int128>(p.fields.integer_seconds_timestamp) * 1000000000000 +
+                         p.fields.fractional_seconds_timestamp;
+        packets.push_back(packet);
+    }
+    return packets;
+}
+
+static std::vector<char> read_bytes(const fs::path& file_path) {
+    std::ifstream file(file_path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST_F(GenerateTest, RoundRobin) {
+    args_.n_packets = 12;
+    args_.n_streams = 3;
+    args_.rate      = 4.0;
+    gen::process(args_);
+
+    std::vector<Packet> packets{read_output()};
+    ASSERT_EQ(packets.size(), 12);
+    for (uint64_t i{0}; i < packets.size(); ++i) {
+        EXPECT_EQ(packets[i].type, VRT_PT_IF_DATA_WITH_STREAM_ID);
+        EXPECT_EQ(packets[i].stream, i % 3);
+        EXPECT_EQ(packets[i].words, 16);
+        EXPECT_EQ(packets[i].count, (i / 3) % 16);
+        EXPECT_EQ(packets[i].time_ps, static_cast<common::Int128>(1600000000) * 1000000000000 + (i / 3) * 250000000000);
+    }
+    EXPECT_EQ(fs::file_size(TMP_FILE_OUT_PATH), 12 * 16 * sizeof(uint32_t));
+}
+
+TEST_F(GenerateTest, Block) {
+    args_.n_packets = 12;
+    args_.n_streams = 2;
+    args_.block     = 3;
+    gen::process(args_);
+
+    std::vector<Packet> packets{read_output()};
+    ASSERT_EQ(packets.size(), 12);
+    for (uint64_t i{0}; i < packets.size(); ++i) {
+        EXPECT_EQ(packets[i].stream, (i / 3) % 2);
+    }
+}
+
+TEST_F(GenerateTest, Jobs) {
+    // Many small segments, written by different numbers of threads
+    args_.n_packets        = 100000;
+    args_.n_streams        = 7;
+    args_.size_max         = 40;
+    args_.prob_loss        = 0.1;
+    args_.interleave       = gen::interleave_type::RANDOM;
+    args_.context_interval = 5;
+    gen::process(args_);
+    std::vector<char> bytes_1{read_bytes(TMP_FILE_OUT_PATH)};
+
+    args_.n_jobs = 4;
+    gen::process(args_);
+    std::vector<char> bytes_4{read_bytes(TMP_FILE_OUT_PATH)};
+
+    ASSERT_FALSE(bytes_1.empty());
+    EXPECT_EQ(bytes_1, bytes_4);
+
+    args_.seed = 2;
+    gen::process(args_);
+    EXPECT_NE(read_bytes(TMP_FILE_OUT_PATH), bytes_1);
+}
+
+TEST_F(GenerateTest, Context) {
+    args_.n_packets        = 20;
+    args_.n_streams        = 2;
+    args_.context_interval = 4;
+    gen::process(args_);
+
+    std::vector<Packet> packets{read_output()};
+    ASSERT_EQ(packets.size(), 20 + 2 * 3);
+    std::map<uint32_t, uint64_t> n_data;
+    for (uint64_t i{0}; i < packets.size(); ++i) {
+        const Packet& p{packets[i]};
+        if (p.type == VRT_PT_IF_CONTEXT) {
+            // Context packet precedes data packet of same stream and time
+            ASSERT_LT(i + 1, packets.size());
+            EXPECT_EQ(packets[i + 1].type, VRT_PT_IF_DATA_WITH_STREAM_ID);
+            EXPECT_EQ(packets[i + 1].stream, p.stream);
+            EXPECT_EQ(packets[i + 1].time_ps, p.time_ps);
+            EXPECT_EQ(n_data[p.stream] % 4, 0);
+        } else {
+            n_data[p.stream]++;
+        }
+    }
+    EXPECT_EQ(n_data[0], 10);
+    EXPECT_EQ(n_data[1], 10);
+}
+
+TEST_F(GenerateTest, Loss) {
+    args_.n_packets = 10000;
+    args_.n_streams = 4;
+    args_.prob_loss = 0.2;
+    gen::process(args_);
+
+    std::vector<Packet> packets{read_output()};
+    EXPECT_GT(packets.size(), 7500);
+    EXPECT_LT(packets.size(), 8500);
+
+    // Lost packets leave gaps in packet count
+    std::map<uint32_t, uint8_t> count;
+    uint64_t                    n_gaps{0};
+    for (const Packet& p : packets) {
+        auto it{count.find(p.stream)};
+        if (it != count.end() && p.count != ((it->second + 1) & 0x0F)) {
+            n_gaps++;
+        }
+        count[p.stream] = p.count;
+    }
+    EXPECT_GT(n_gaps, 0);
+}
+
+TEST_F(GenerateTest, RandomInterleave) {
+    args_.n_packets  = 1000;
+    args_.n_streams  = 5;
+    args_.interleave = gen::interleave_type::RANDOM;
+    gen::process(args_);
+
+    std::vector<Packet> packets{read_output()};
+    ASSERT_EQ(packets.size(), 1000);
+    std::map<uint32_t, common::Int128> time;
+    bool                               is_round_robin{true};
+    for (uint64_t i{0}; i < packets.size(); ++i) {
+        const Packet& p{packets[i]};
+        ASSERT_LT(p.stream, 5);
+        auto it{time.find(p.stream)};
+        if (it != time.end()) {
+            EXPECT_GT(p.time_ps, it->second);
+        }
+        time[p.stream] = p.time_ps;
+        is_round_robin = is_round_robin && p.stream == i % 5;
+    }
+    EXPECT_EQ(time.size(), 5);
+    EXPECT_FALSE(is_round_robin);
+}
+
+TEST_F(GenerateTest, Size) {
+    args_.n_packets = 1000;
+    args_.size_max  = 20;
+    gen::process(args_);
+
+    std::vector<Packet> packets{read_output()};
+    ASSERT_EQ(packets.size(), 1000);
+    std::map<uint16_t, uint64_t> n_words;
+    for (const Packet& p : packets) {
+        EXPECT_GE(p.words, 16);
+        EXPECT_LE(p.words, 20);
+        n_words[p.words]++;
+    }
+    EXPECT_EQ(n_words.size(), 5);
+}
+
+TEST_F(GenerateTest, ByteSwap) {
+    args_.n_packets    = 10;
+    args_.do_byte_swap = true;
+    gen::process(args_);
+
+    std::vector<Packet> packets{read_output(true)};
+    ASSERT_EQ(packets.size(), 10);
+    EXPECT_EQ(packets[9].count, 9);
+}
+
+TEST_F(GenerateTest, Invalid) {
+    args_.size = 1;
+    EXPECT_THROW(gen::process(args_), std::runtime_error);
+    args_.size = 0x10000;
+    EXPECT_THROW(gen::process(args_), std::runtime_error);
+    args_.size      = 16;
+    args_.n_streams = 0;
+    EXPECT_THROW(gen::process(args_), std::runtime_error);
+    args_.n_streams = 1;
+    args_.rate      = 0.0;
+    EXPECT_THROW(gen::process(args_), std::runtime_error);
+}
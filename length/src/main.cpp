@@ -43,6 +43,17 @@ static vrt::length::ProgramArguments setup_arg_parse(CLI::App* app) {
         std::map<std::string, uint64_t>{{"T", 1000000000000}, {"G", 1000000000}, {"M", 1000000}, {"k", 1000}},
         CLI::AsNumberWithUnit::CASE_SENSITIVE));
 
+    // Jobs
+    CLI::Option* opt_jobs{app->add_option("-j,--jobs", args.n_jobs,
+                                          "Number of threads going through the file. 0 means one per CPU core. Output "
+                                          "is the same as with one thread.")};
+    opt_jobs->check(CLI::NonNegativeNumber);
+
+    // Statistics
+    app->add_flag("--statistics", args.do_statistics,
+                  "Print statistics of each stream: packet sizes, intervals between packets, data rate, gaps, context "
+                  "packet intervals and trailer indicators");
+
     return args;
 }
 
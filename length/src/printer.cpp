@@ -1,5 +1,7 @@
 #include "printer.h"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <iomanip>
 #include <iostream>
@@ -7,40 +9,44 @@
 
 #include "vrt/vrt_time.h"
 #include "vrt/vrt_types.h"
-#include "vrt/vrt_util.h"
 
 #include "common/packet_id_differences.h"
+#include "common/quantile_sketch.h"
+#include "common/sample_rate_timeline.h"
 #include "common/stream_history.h"
+#include "common/stream_id.h"
+#include "common/timestamp.h"
+#include "stream_statistics.h"
 
 namespace vrt::length {
 
 /**
  * Print Class and Stream ID information.
  *
- * \param p A packet in stream.
+ * \param id          Stream ID.
+ * \param differences Differences between streams.
  */
-static void print_ids(vrt_packet* p, const common::PacketIdDiffs& differences) {
+static void print_ids(const common::StreamId& id, const common::PacketIdDiffs& differences) {
     std::cout << std::hex << std::setfill('0');
-    if (p->header.has.class_id) {
+    if (id.has_class_id) {
         if (differences.diff_oui || differences.diff_icc || differences.diff_pcc) {
             std::cout << "Class ID\n";
             if (differences.diff_oui) {
-                std::cout << "  OUI: 0x" << std::setw(6) << p->fields.class_id.oui << '\n';
+                std::cout << "  OUI: 0x" << std::setw(6) << id.oui << '\n';
             }
             if (differences.diff_icc) {
-                std::cout << "  Information class code: 0x" << std::setw(4) << p->fields.class_id.information_class_code
-                          << '\n';
+                std::cout << "  Information class code: 0x" << std::setw(4) << id.information_class_code << '\n';
             }
             if (differences.diff_pcc) {
-                std::cout << "  Packet class code: 0x" << std::setw(4) << p->fields.class_id.packet_class_code << '\n';
+                std::cout << "  Packet class code: 0x" << std::setw(4) << id.packet_class_code << '\n';
             }
         }
     } else if (differences.any_has_class_id) {
         std::cout << "Class ID: None\n";
     }
-    if (vrt_has_stream_id(&p->header)) {
+    if (id.has_stream_id) {
         if (differences.diff_sid) {
-            std::cout << "Stream ID: 0x" << std::setw(8) << p->fields.stream_id << '\n';
+            std::cout << "Stream ID: 0x" << std::setw(8) << id.stream_id << '\n';
         }
     } else if (differences.any_has_stream_id) {
         std::cout << "Stream ID: None\n";
@@ -54,20 +60,23 @@ static void print_ids(vrt_packet* p, const common::PacketIdDiffs& differences) {
  * Print differences between first and last packets in a specific stream.
  *
  * \param stream_history Stream history.
+ * \param slot           Slot of stream.
  * \param differences    Differences between streams.
  */
-void print_difference(const common::StreamHistory& stream_history, const common::PacketIdDiffs& differences) {
-    vrt_packet* fir{stream_history.get_packet_first().get()};
-    vrt_packet* cur{stream_history.get_packet_current().get()};
-    double      sample_rate{stream_history.get_sample_rate()};
+void print_difference(const common::StreamHistory& stream_history,
+                      size_t                       slot,
+                      const common::PacketIdDiffs& differences) {
+    print_ids(stream_history.get_id(slot), differences);
 
-    print_ids(fir, differences);
+    std::cout << "Number of packets: " << stream_history.get_number_of_packets(slot) << '\n';
 
-    std::cout << "Number of packets: " << stream_history.get_number_of_packets() << '\n';
-
-    vrt_time diff;
-    int      rv{vrt_time_difference_fields(&cur->header, &cur->fields, &fir->header, &fir->fields, sample_rate, &diff)};
-    if (rv == 0) {
+    const common::SampleRateTimeline& timeline{stream_history.get_timeline(slot)};
+    common::TimeKey                   first{timeline.key(stream_history.get_time_first(slot))};
+    common::TimeKey                   current{timeline.key(stream_history.get_time_current(slot))};
+    common::Int128  ps;
+    if (common::time_difference(current, first, &ps)) {
+        vrt_time diff;
+        common::to_vrt_time(ps, &diff);
         std::cout << "Time difference: " << diff.s << '.' << std::setfill('0') << std::setw(11) << diff.ps << " s\n";
 
         // Reset stream manipulators
@@ -75,4 +84,79 @@ void print_difference(const common::StreamHistory& stream_history, const common:
     }
 }
 
+/**
+ * Print distribution of intervals between packets.
+ *
+ * \param intervals Intervals.
+ */
+static void print_intervals(const Intervals& intervals) {
+    const common::QuantileSketch& sketch{intervals.sketch};
+    uint64_t                      n{sketch.get_count() + intervals.n_backwards};
+    if (n == 0) {
+        return;
+    }
+    std::cout << "  Mean: " << common::to_seconds(intervals.sum) / static_cast<double>(n) << " s\n";
+    if (sketch.get_count() != 0) {
+        std::cout << "  Min: " << sketch.get_min() << " s\n";
+        std::cout << "  Median: " << sketch.quantile(0.5) << " s\n";
+        std::cout << "  90th percentile: " << sketch.quantile(0.9) << " s\n";
+        std::cout << "  99th percentile: " << sketch.quantile(0.99) << " s\n";
+        std::cout << "  99.9th percentile: " << sketch.quantile(0.999) << " s\n";
+        std::cout << "  Max: " << sketch.get_max() << " s\n";
+    }
+    if (intervals.n_backwards != 0) {
+        std::cout << "  Going backwards: " << intervals.n_backwards << '\n';
+    }
+}
+
+/**
+ * Print statistics of a specific stream.
+ *
+ * \param statistics Stream statistics.
+ */
+void print_statistics(const StreamStatistics& statistics) {
+    std::cout << "Packet sizes [words]:\n";
+    for (const auto& el : statistics.get_packet_sizes()) {
+        std::cout << "  " << el.first << ": " << el.second << '\n';
+    }
+
+    const Intervals& data{statistics.get_data()};
+    std::cout << "Data packets: " << statistics.get_number_of_data_packets() << '\n';
+    std::cout << "Data body size: " << statistics.get_data_bytes() << " B\n";
+    if (data.sum > 0) {
+        std::cout << "Data rate: " << static_cast<double>(statistics.get_data_bytes()) / common::to_seconds(data.sum)
+                  << " B/s\n";
+    }
+    if (data.n_packets >= 2) {
+        std::cout << "Data packet interval:\n";
+        print_intervals(data);
+        std::cout << "Gaps: " << data.n_gaps << '\n';
+        if (data.n_gaps != 0) {
+            std::cout << "  Total: " << common::to_seconds(data.gap_sum) << " s\n";
+            std::cout << "  Largest: " << common::to_seconds(data.gap_max) << " s\n";
+        }
+    }
+
+    const Intervals& context{statistics.get_context()};
+    std::cout << "Context packets: " << statistics.get_number_of_context_packets() << '\n';
+    if (context.n_packets >= 2) {
+        std::cout << "Context packet interval:\n";
+        print_intervals(context);
+    }
+
+    if (statistics.get_number_of_trailers() != 0) {
+        static const std::array<const char*, StreamStatistics::N_TRAILER_FLAGS> NAMES{
+            "Calibrated time", "Valid data", "Reference lock", "Detected signal", "Spectral inversion", "Over-range",
+            "Sample loss"};
+        std::cout << "Trailers: " << statistics.get_number_of_trailers() << '\n';
+        for (size_t i{0}; i < NAMES.size(); ++i) {
+            auto flag{static_cast<StreamStatistics::TrailerFlag>(i)};
+            if (statistics.get_trailer_flag_present(flag) != 0) {
+                std::cout << "  " << NAMES[i] << ": " << statistics.get_trailer_flag_set(flag) << " set of "
+                          << statistics.get_trailer_flag_present(flag) << '\n';
+            }
+        }
+    }
+}
+
 }  // namespace vrt::length
@@ -1,6 +1,8 @@
 #ifndef VRT_LENGTH_SRC_PRINTER_H_
 #define VRT_LENGTH_SRC_PRINTER_H_
 
+#include <cstddef>
+
 namespace vrt::common {
 class StreamHistory;
 }
@@ -10,7 +12,12 @@ struct PacketIdDiffs;
 
 namespace vrt::length {
 
-void print_difference(const common::StreamHistory& stream_history, const common::PacketIdDiffs& differences);
+class StreamStatistics;
+
+void print_difference(const common::StreamHistory& stream_history,
+                      size_t                       slot,
+                      const common::PacketIdDiffs& differences);
+void print_statistics(const StreamStatistics& statistics);
 
 }  // namespace vrt::length
 
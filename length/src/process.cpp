@@ -1,84 +1,288 @@
 #include "process.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <exception>
 #include <iostream>
-#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "vrt/vrt_types.h"
 
 #include "Progress-CPP/ProgressBar.hpp"
-#include "common/comparator_id.h"
 #include "common/input_stream.h"
 #include "common/packet_id_differences.h"
 #include "common/stream_history.h"
+#include "common/stream_id.h"
+#include "common/time_search.h"
 #include "printer.h"
 #include "program_arguments.h"
+#include "stream_statistics.h"
 
 namespace vrt::length {
 
 // For convenience
-using PacketPtr        = ::std::shared_ptr<vrt_packet>;
-using StreamHistoryPtr = ::std::unique_ptr<common::StreamHistory>;
+using PacketPtr = ::std::shared_ptr<vrt_packet>;
 
 /**
- * Process file contents.
+ * Summary of streams.
+ */
+struct Streams {
+    common::StreamHistory         history;
+    std::vector<StreamStatistics> statistics; /**< Statistics per stream slot, if enabled. */
+
+    explicit Streams(double sample_rate) : history(sample_rate) {}
+};
+
+/**
+ * Smallest chunk of the file processed by a worker [B].
+ */
+static constexpr uint64_t MIN_CHUNK_BYTES{16 * 1024 * 1024};
+
+/**
+ * Number of bytes processed between progress updates from a worker [B].
+ */
+static constexpr uint64_t PROGRESS_BYTES{1024 * 1024};
+
+/**
+ * Part of the file, with a summary of the streams in it.
+ */
+struct Chunk {
+    uint64_t           begin{0};            /**< Nominal start [B]. Packets starting here or later are in it. */
+    uint64_t           end{0};              /**< Nominal end [B]. Packets starting before this are in it. */
+    uint64_t           position{0};         /**< Position of first packet [B]. */
+    uint64_t           position_end{0};     /**< Position of first packet after chunk [B]. */
+    uint64_t           n_packets{0};        /**< Number of packets in chunk. */
+    bool               is_truncated{false}; /**< True if file ends in the middle of the packet after chunk. */
+    Streams            streams{0.0};        /**< Summary of streams in chunk. */
+    std::exception_ptr error;               /**< Error while processing chunk, if any. */
+};
+
+/**
+ * Go through the packets in a chunk, starting at chunk->position.
  *
- * \param args Program arguments.
+ * \param args     Program arguments.
+ * \param previous Streams in the chunks before, if known. Their latest sample rates are used for new streams in the
+ *                 chunk.
+ * \param chunk    Chunk.
+ * \param n_read   Incremented with number of bytes read, for progress.
+ * \param pkt_idx  Index of first packet in chunk, for messages.
+ * \param do_warn  True if warnings about packets shall be printed.
  *
  * \throw std::runtime_error If there's an error.
  */
-void process(const ProgramArguments& args) {
-    common::InputStream input_stream(args.file_path_in, args.do_byte_swap);
+static void process_chunk(const ProgramArguments& args,
+                          const Streams*          previous,
+                          Chunk*                  chunk,
+                          std::atomic<uint64_t>*  n_read,
+                          uint64_t                pkt_idx,
+                          bool                    do_warn) {
+    common::InputStream input_stream(args.file_path_in, args.do_byte_swap, true, do_warn);
+    input_stream.seek(static_cast<std::streamoff>(chunk->position), pkt_idx);
 
-    std::map<PacketPtr, StreamHistoryPtr, common::ComparatorId> id_streams;
+    uint64_t position{chunk->position};
+    uint64_t n_unreported{0};
+    chunk->n_packets    = 0;
+    chunk->is_truncated = false;
+    while (position < chunk->end) {
+        if (!input_stream.read_next_header()) {
+            break;
+        }
+        if (!input_stream.read_remainder()) {
+            chunk->is_truncated = true;
+            break;
+        }
 
-    // Progress bar
-    progresscpp::ProgressBar progress(static_cast<uint64_t>(input_stream.get_file_size()), 70);
+        // Find Class ID, Stream ID combination, or add new stream if needed
+        PacketPtr       packet{input_stream.get_packet()};
+        common::StreamId id(*packet);
+        size_t           slot{chunk->streams.history.find(id)};
+        if (slot == common::StreamHistory::NONE) {
+            size_t slot_previous{previous != nullptr ? previous->history.find(id) : common::StreamHistory::NONE};
+            if (slot_previous != common::StreamHistory::NONE) {
+                slot = chunk->streams.history.add(id, previous->history.get_timeline(slot_previous).tail());
+            } else {
+                slot = chunk->streams.history.add(id, args.sample_rate);
+            }
+            if (args.do_statistics) {
+                chunk->streams.statistics.emplace_back();
+            }
+        }
 
-    // Go over all packets in input file
-    uint64_t i{0};
-    for (;; ++i) {
-        if (!input_stream.read_next_packet()) {
-            break;
+        chunk->streams.history.update(slot, *packet);
+        if (args.do_statistics) {
+            chunk->streams.statistics[slot].update(*packet, chunk->streams.history.get_timeline(slot));
         }
 
-        // Find Class ID, Stream ID combination in map, or construct new output ID if needed
-        PacketPtr packet{input_stream.get_packet()};
-        auto      it{id_streams.find(packet)};
-        if (it == id_streams.end()) {
-            auto pair{id_streams.emplace(packet, std::make_unique<common::StreamHistory>(args.sample_rate))};
+        uint64_t size{sizeof(uint32_t) * packet->header.packet_size};
+        position += size;
+        n_unreported += size;
+        chunk->n_packets++;
+        if (n_unreported >= PROGRESS_BYTES) {
+            *n_read += n_unreported;
+            n_unreported = 0;
+        }
+    }
+    *n_read += n_unreported;
+
+    chunk->position_end = position;
+}
 
-            it = pair.first;
+/**
+ * Check if statistics of any stream in a chunk were calculated with the wrong sample rates, since the sample rates at
+ * the start of the chunk weren't known.
+ *
+ * \param previous Streams in the chunks before.
+ * \param chunk    Chunk.
+ *
+ * \return True if so.
+ */
+static bool depends_on_sample_rate(const Streams& previous, const Chunk& chunk) {
+    for (size_t slot{0}; slot < chunk.streams.statistics.size(); ++slot) {
+        size_t slot_previous{previous.history.find(chunk.streams.history.get_id(slot))};
+        if (slot_previous != common::StreamHistory::NONE && !previous.history.get_timeline(slot_previous).empty() &&
+            chunk.streams.statistics[slot].depends_on_start()) {
+            return true;
         }
+    }
+    return false;
+}
+
+/**
+ * Process file contents. The file is divided into chunks at byte offsets, and workers resynchronize to the first packet
+ * in their chunk and summarize the streams in it. Summaries are then merged in order. Intervals between the first
+ * packets of a stream in a chunk, before its sample rate is known there, are found when merged. A chunk is processed
+ * again if its first packet doesn't match where the previous chunk ended, which only happens if the resynchronization
+ * is wrong, or if its statistics still depend on a sample rate that was only known from the chunks before. Workers
+ * don't know the number of packets before their chunk, so they print no warnings, and a chunk with an error is
+ * processed again from where the previous chunk ended, which reports it with the packet index in the file.
+ *
+ * \param args Program arguments.
+ *
+ * \return Number of chunks processed again.
+ *
+ * \throw std::runtime_error If there's an error.
+ */
+uint64_t process(const ProgramArguments& args) {
+    uint64_t file_size{
+        static_cast<uint64_t>(common::InputStream(args.file_path_in, args.do_byte_swap).get_file_size())};
+
+    // Divide file into chunks at word aligned offsets
+    unsigned n_jobs{args.n_jobs != 0 ? args.n_jobs : std::max(std::thread::hardware_concurrency(), 1U)};
+    uint64_t n_chunks{std::max<uint64_t>(std::min<uint64_t>(4 * n_jobs, file_size / MIN_CHUNK_BYTES), 1)};
+    std::vector<Chunk> chunks(n_chunks);
+    for (uint64_t k{0}; k < n_chunks; ++k) {
+        chunks[k].begin = (file_size * k / n_chunks) & ~static_cast<uint64_t>(3);
+        chunks[k].end   = k + 1 < n_chunks ? (file_size * (k + 1) / n_chunks) & ~static_cast<uint64_t>(3) : file_size;
+    }
 
-        it->second->update(packet);
+    std::mutex              mutex;
+    std::condition_variable cv;
+    std::atomic<uint64_t>   next_chunk{0};
+    std::atomic<uint64_t>   n_read{0};
+    uint64_t                n_done{0};
 
-        // Handle progress bar
-        progress += sizeof(uint32_t) * packet->header.packet_size;
-        if (progress.get_ticks() % 65536 == 0) {
+    std::vector<std::thread> workers;
+    for (uint64_t j{0}; j < std::min<uint64_t>(n_jobs, n_chunks); ++j) {
+        workers.emplace_back([&]() {
+            for (uint64_t k{next_chunk++}; k < n_chunks; k = next_chunk++) {
+                Chunk& chunk{chunks[k]};
+                try {
+                    if (chunk.begin != 0) {
+                        chunk.position = common::TimeSearch(args.file_path_in, args.do_byte_swap).resync(chunk.begin);
+                    }
+                    process_chunk(args, nullptr, &chunk, &n_read, 0, false);
+                } catch (...) {
+                    chunk.error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                n_done++;
+                cv.notify_all();
+            }
+        });
+    }
+
+    // Progress bar
+    progresscpp::ProgressBar progress(file_size, 70);
+    {
+        uint64_t                     n_shown{0};
+        std::unique_lock<std::mutex> lock(mutex);
+        while (n_done < n_chunks) {
+            cv.wait_for(lock, std::chrono::milliseconds(100));
+            uint64_t n{n_read};
+            progress += n - n_shown;
+            n_shown = n;
             progress.display();
         }
     }
-
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
     progress.done();
 
-    // Make vector from map
-    std::vector<PacketPtr> v;
-    v.reserve(id_streams.size());
-    for (const auto& el : id_streams) {
-        v.push_back(el.first);
+    // Merge chunks in order
+    Streams  streams(args.sample_rate);
+    uint64_t position{0};
+    uint64_t n_packets{0};
+    uint64_t n_redone{0};
+    for (Chunk& chunk : chunks) {
+        if (chunk.error || chunk.position != position || depends_on_sample_rate(streams, chunk)) {
+            // Redo from where previous chunk ended. Throws any error again, with the packet index in the file.
+            chunk.streams  = Streams(args.sample_rate);
+            chunk.position = position;
+            process_chunk(args, &streams, &chunk, &n_read, n_packets, true);
+            n_redone++;
+        } else if (chunk.is_truncated) {
+            // Read the packet again, to warn about it with the packet index in the file
+            common::InputStream input_stream(args.file_path_in, args.do_byte_swap);
+            input_stream.seek(static_cast<std::streamoff>(chunk.position_end), n_packets + chunk.n_packets);
+            input_stream.read_next_packet();
+        }
+        position = chunk.position_end;
+        n_packets += chunk.n_packets;
+
+        // Statistics are merged with the merged sample rates. New streams get slots after existing ones, in the same
+        // order as in the history merge.
+        size_t size{streams.history.size()};
+        streams.history.merge(chunk.streams.history);
+        for (size_t slot{0}; slot < chunk.streams.statistics.size(); ++slot) {
+            size_t slot_merged{streams.history.find(chunk.streams.history.get_id(slot))};
+            if (slot_merged >= size) {
+                streams.statistics.push_back(std::move(chunk.streams.statistics[slot]));
+            } else {
+                streams.statistics[slot_merged].merge(chunk.streams.statistics[slot],
+                                                      streams.history.get_timeline(slot_merged));
+            }
+        }
+    }
+
+    // Print streams ordered by ID
+    std::vector<size_t>           slots{streams.history.get_slots_sorted()};
+    std::vector<common::StreamId> ids;
+    ids.reserve(slots.size());
+    for (size_t slot : slots) {
+        ids.push_back(streams.history.get_id(slot));
     }
 
     // Print differences between packets
-    common::PacketIdDiffs packet_diffs{common::packet_id_differences(v)};
-    for (const auto& el : id_streams) {
-        print_difference(*el.second, packet_diffs);
+    common::PacketIdDiffs packet_diffs{common::packet_id_differences(ids)};
+    for (size_t slot : slots) {
+        print_difference(streams.history, slot, packet_diffs);
+        if (args.do_statistics) {
+            print_statistics(streams.statistics[slot]);
+        }
     }
 
     std::cout.flush();
+
+    return n_redone;
 }
 
 }  // namespace vrt::length
@@ -1,11 +1,13 @@
 #ifndef VRT_LENGTH_SRC_PROCESS_H_
 #define VRT_LENGTH_SRC_PROCESS_H_
 
+#include <cstdint>
+
 namespace vrt::length {
 
 struct ProgramArguments;
 
-void process(const ProgramArguments& args);
+uint64_t process(const ProgramArguments& args);
 
 }  // namespace vrt::length
 
@@ -10,9 +10,11 @@ namespace vrt::length {
  * Input arguments to program.
  */
 struct ProgramArguments {
-    std::filesystem::path file_path_in{};      /**< Input file path */
-    bool                  do_byte_swap{false}; /**< True if byte swap is enabled */
-    double                sample_rate{0.0};    /**< Sample rate [Hz] */
+    std::filesystem::path file_path_in{};       /**< Input file path */
+    bool                  do_byte_swap{false};  /**< True if byte swap is enabled */
+    double                sample_rate{0.0};     /**< Sample rate [Hz] */
+    unsigned              n_jobs{0};            /**< Number of worker threads, or 0 for one per CPU core */
+    bool                  do_statistics{false}; /**< True if statistics of each stream are printed */
 };
 
 }  // namespace vrt::length
@@ -0,0 +1,210 @@
+#include "stream_statistics.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "vrt/vrt_types.h"
+
+#include "common/sample_rate_timeline.h"
+#include "common/timestamp.h"
+
+namespace vrt::length {
+
+/**
+ * Check if packet has a timestamp.
+ *
+ * \param header Packet header.
+ *
+ * \return True if so.
+ */
+static bool HasTimestamp(const vrt_header& header) {
+    return header.tsi != VRT_TSI_NONE || header.tsf != VRT_TSF_NONE;
+}
+
+/**
+ * Add packet, if it has a timestamp. Times of the first packets that depend on the sample rates before them are kept
+ * as timestamps, and their intervals are found when merged with the part before.
+ *
+ * \param packet   Packet.
+ * \param timeline Sample rates of stream, updated with packet.
+ *
+ * \return True if an interval was calculated with the initial sample rates of the timeline.
+ */
+bool Intervals::add(const vrt_packet& packet, const common::SampleRateTimeline& timeline) {
+    if (!HasTimestamp(packet.header)) {
+        return false;
+    }
+
+    common::Timestamp time(packet);
+    bool              depends_on_start{false};
+    common::TimeKey   key{timeline.key(time, &depends_on_start)};
+    if (depends_on_start && n_packets == times_start.size() && times_start.size() < MAX_TIMES_START) {
+        times_start.push_back(time);
+        n_packets++;
+        return false;
+    }
+    add_key(key);
+
+    return depends_on_start;
+}
+
+/**
+ * Merge intervals of a later part of the same stream into this, as if its packets had been passed to add().
+ *
+ * \param later    Intervals of the packets following the ones in this.
+ * \param timeline Sample rates of stream, already merged with the later part.
+ */
+void Intervals::merge(const Intervals& later, const common::SampleRateTimeline& timeline) {
+    // Times of the first packets in later can be found with the sample rates in this
+    for (const common::Timestamp& time : later.times_start) {
+        add_key(timeline.key(time));
+    }
+    if (later.n_packets == later.times_start.size()) {
+        return;
+    }
+
+    // Interval between last packet in this and first packet in later
+    add_key(later.key_first);
+
+    // The first interval in later had no previous interval to find gaps with
+    if (later.has_interval_first) {
+        check_gap(later.interval_first);
+        if (!has_interval_first) {
+            has_interval_first = true;
+            interval_first     = later.interval_first;
+        }
+        interval_last = later.interval_last;
+    }
+
+    key_last = later.key_last;
+    n_packets += later.n_packets - later.times_start.size() - 1;
+    sketch.merge(later.sketch);
+    sum += later.sum;
+    n_backwards += later.n_backwards;
+    n_gaps += later.n_gaps;
+    gap_sum += later.gap_sum;
+    gap_max = std::max(gap_max, later.gap_max);
+}
+
+/**
+ * Add time of packet after the last one.
+ *
+ * \param key Time of packet.
+ */
+void Intervals::add_key(const common::TimeKey& key) {
+    if (n_packets == times_start.size()) {
+        key_first = key;
+    } else {
+        common::Int128 interval;
+        if (common::time_difference(key, key_last, &interval)) {
+            add_interval(interval);
+        }
+    }
+    key_last = key;
+    n_packets++;
+}
+
+/**
+ * Add interval between two consecutive packets.
+ *
+ * \param interval Interval [ps].
+ */
+void Intervals::add_interval(common::Int128 interval) {
+    sum += interval;
+    if (interval < 0) {
+        n_backwards++;
+        return;
+    }
+
+    sketch.add(common::to_seconds(interval));
+    if (has_interval_first) {
+        check_gap(interval);
+    } else {
+        has_interval_first = true;
+        interval_first     = interval;
+    }
+    interval_last = interval;
+}
+
+/**
+ * Count interval as a gap, if it is one compared to the last non-negative interval.
+ *
+ * \param interval Non-negative interval [ps].
+ */
+void Intervals::check_gap(common::Int128 interval) {
+    if (has_interval_first &&
+        interval * StreamStatistics::GAP_DENOMINATOR > interval_last * StreamStatistics::GAP_NUMERATOR) {
+        n_gaps++;
+        gap_sum += interval;
+        gap_max = std::max(gap_max, interval);
+    }
+}
+
+/**
+ * Update statistics with new packet.
+ *
+ * \param packet   New packet.
+ * \param timeline Sample rates of stream, already updated with packet.
+ */
+void StreamStatistics::update(const vrt_packet& packet, const common::SampleRateTimeline& timeline) {
+    packet_sizes_[packet.header.packet_size]++;
+
+    if (packet.header.packet_type == VRT_PT_IF_CONTEXT || packet.header.packet_type == VRT_PT_EXT_CONTEXT) {
+        n_context_packets_++;
+        depends_on_start_ |= context_.add(packet, timeline);
+    } else {
+        n_data_packets_++;
+        n_data_bytes_ += sizeof(uint32_t) * static_cast<uint64_t>(std::max(packet.words_body, 0));
+        depends_on_start_ |= data_.add(packet, timeline);
+    }
+
+    if (packet.header.has.trailer) {
+        const vrt_trailer& t{packet.trailer};
+        n_trailers_++;
+
+        // Has indicator, and indicator value
+        const std::array<std::pair<bool, bool>, N_TRAILER_FLAGS> flags{
+            {{t.has.calibrated_time, t.calibrated_time},
+             {t.has.valid_data, t.valid_data},
+             {t.has.reference_lock, t.reference_lock},
+             {t.has.detected_signal, t.detected_signal},
+             {t.has.spectral_inversion, t.spectral_inversion},
+             {t.has.over_range, t.over_range},
+             {t.has.sample_loss, t.sample_loss}}};
+        for (size_t i{0}; i < flags.size(); ++i) {
+            if (flags[i].first) {
+                n_flag_present_[i]++;
+                if (flags[i].second) {
+                    n_flag_set_[i]++;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Merge statistics of a later part of the same stream into this, as if its packets had been passed to update().
+ *
+ * \param later    Statistics of the packets following the ones in this.
+ * \param timeline Sample rates of stream, already merged with the later part.
+ */
+void StreamStatistics::merge(const StreamStatistics& later, const common::SampleRateTimeline& timeline) {
+    for (const auto& el : later.packet_sizes_) {
+        packet_sizes_[el.first] += el.second;
+    }
+    data_.merge(later.data_, timeline);
+    context_.merge(later.context_, timeline);
+    n_data_packets_ += later.n_data_packets_;
+    n_context_packets_ += later.n_context_packets_;
+    n_data_bytes_ += later.n_data_bytes_;
+    n_trailers_ += later.n_trailers_;
+    for (size_t i{0}; i < N_TRAILER_FLAGS; ++i) {
+        n_flag_present_[i] += later.n_flag_present_[i];
+        n_flag_set_[i] += later.n_flag_set_[i];
+    }
+}
+
+}  // namespace vrt::length
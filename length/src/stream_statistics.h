@@ -0,0 +1,124 @@
+#ifndef VRT_LENGTH_SRC_STREAM_STATISTICS_H_
+#define VRT_LENGTH_SRC_STREAM_STATISTICS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "vrt/vrt_types.h"
+
+#include "common/quantile_sketch.h"
+#include "common/sample_rate_timeline.h"
+#include "common/timestamp.h"
+
+namespace vrt::length {
+
+/**
+ * Intervals between consecutive timestamped packets of some kind in a stream.
+ */
+struct Intervals {
+    uint64_t                       n_packets{0};         /**< Number of timestamped packets. */
+    std::vector<common::Timestamp> times_start;          /**< Timestamps of first packets, if their times depend on
+                                                              the sample rates before them. */
+    common::TimeKey                key_first;            /**< Time of first packet after times_start. */
+    common::TimeKey                key_last;             /**< Time of last packet after times_start. */
+    common::QuantileSketch         sketch;               /**< Non-negative intervals [s]. */
+    common::Int128                 sum{0};               /**< Sum of all intervals [ps]. */
+    uint64_t                       n_backwards{0};       /**< Number of negative intervals. */
+    bool                           has_interval_first{}; /**< If there is a non-negative interval. */
+    common::Int128                 interval_first{0};    /**< First non-negative interval [ps]. */
+    common::Int128                 interval_last{0};     /**< Last non-negative interval [ps]. */
+    uint64_t                       n_gaps{0};            /**< Number of intervals that are gaps. */
+    common::Int128                 gap_sum{0};           /**< Sum of gap intervals [ps]. */
+    common::Int128                 gap_max{0};           /**< Largest gap [ps]. */
+
+    /**
+     * Largest number of first packets whose intervals are found when merged. Later packets whose times depend on the
+     * sample rates before them make the intervals depend on the start.
+     */
+    static constexpr size_t MAX_TIMES_START{1 << 16};
+
+    bool add(const vrt_packet& packet, const common::SampleRateTimeline& timeline);
+    void merge(const Intervals& later, const common::SampleRateTimeline& timeline);
+    void add_key(const common::TimeKey& key);
+    void add_interval(common::Int128 interval);
+    void check_gap(common::Int128 interval);
+};
+
+/**
+ * Statistics of a stream, gathered in a single pass with memory that doesn't grow with the number of packets.
+ * Statistics of consecutive parts of a stream can be merged.
+ */
+class StreamStatistics {
+   public:
+    void update(const vrt_packet& packet, const common::SampleRateTimeline& timeline);
+    void merge(const StreamStatistics& later, const common::SampleRateTimeline& timeline);
+
+    /**
+     * \return True if an interval would differ if the sample rates before the first packet were other ones, since
+     *         they weren't known when the statistics were gathered.
+     */
+    bool depends_on_start() const { return depends_on_start_; }
+
+    const std::map<uint16_t, uint64_t>& get_packet_sizes() const { return packet_sizes_; }
+    const Intervals&                    get_data() const { return data_; }
+    const Intervals&                    get_context() const { return context_; }
+    uint64_t                            get_number_of_data_packets() const { return n_data_packets_; }
+    uint64_t                            get_number_of_context_packets() const { return n_context_packets_; }
+    uint64_t                            get_data_bytes() const { return n_data_bytes_; }
+    uint64_t                            get_number_of_trailers() const { return n_trailers_; }
+
+    /**
+     * Trailer state and event indicator.
+     */
+    enum TrailerFlag {
+        CALIBRATED_TIME,
+        VALID_DATA,
+        REFERENCE_LOCK,
+        DETECTED_SIGNAL,
+        SPECTRAL_INVERSION,
+        OVER_RANGE,
+        SAMPLE_LOSS,
+        N_TRAILER_FLAGS
+    };
+
+    /**
+     * \param flag Trailer flag.
+     *
+     * \return Number of trailers where the flag has an indicator.
+     */
+    uint64_t get_trailer_flag_present(TrailerFlag flag) const { return n_flag_present_[flag]; }
+
+    /**
+     * \param flag Trailer flag.
+     *
+     * \return Number of trailers where the flag has an indicator that is set.
+     */
+    uint64_t get_trailer_flag_set(TrailerFlag flag) const { return n_flag_set_[flag]; }
+
+    /**
+     * An interval is a gap if it is longer than the previous non-negative interval times GAP_NUMERATOR /
+     * GAP_DENOMINATOR.
+     */
+    static constexpr int GAP_NUMERATOR{3};
+    static constexpr int GAP_DENOMINATOR{2};
+
+   private:
+    bool depends_on_start_{false}; /**< If an interval was calculated with the initial sample rates. */
+
+    std::map<uint16_t, uint64_t>          packet_sizes_; /**< Number of packets per packet size [words]. */
+    Intervals                             data_;
+    Intervals                             context_;
+    uint64_t                              n_data_packets_{0};
+    uint64_t                              n_context_packets_{0};
+    uint64_t                              n_data_bytes_{0}; /**< Size of data packet bodies [B]. */
+    uint64_t                              n_trailers_{0};
+    std::array<uint64_t, N_TRAILER_FLAGS> n_flag_present_{};
+    std::array<uint64_t, N_TRAILER_FLAGS> n_flag_set_{};
+};
+
+}  // namespace vrt::length
+
+#endif
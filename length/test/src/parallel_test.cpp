@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "../../src/process.h"
+#include "../../src/program_arguments.h"
+#include "common/generate_packet_sequence.h"
+#include "common/input_stream.h"
+#include "common/stream_history.h"
+
+namespace fs = ::std::filesystem;
+
+// Large enough for several chunks
+static const uint64_t N_PACKETS{120000};
+static const fs::path TMP_DIR{"test_tmp"};
+static const fs::path TMP_FILE_PATH{TMP_DIR / "parallel.vrt"};
+
+class ParallelTest : public ::testing::Test {
+   protected:
+    ParallelTest() : p_() {}
+
+    void SetUp() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+        fs::create_directory(TMP_DIR);
+        vrt_init_packet(&p_);
+    }
+    void TearDown() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+    }
+
+    /**
+     * Generate three streams with sample count timestamps, whose sample rates change in context packets.
+     */
+    void generate_sample_count() {
+        std::vector<uint32_t> body(80);
+        p_.body                                = body.data();
+        p_.header.tsi                          = VRT_TSI_UTC;
+        p_.header.tsf                          = VRT_TSF_SAMPLE_COUNT;
+        p_.fields.fractional_seconds_timestamp = 0;
+        vrt::common::generate_packet_sequence(TMP_FILE_PATH, &p_, N_PACKETS, [&](uint64_t i) {
+            bool is_context{i % 1000 == 3};
+            p_.header.packet_type                  = is_context ? VRT_PT_IF_CONTEXT : VRT_PT_IF_DATA_WITH_STREAM_ID;
+            p_.words_body                          = is_context ? 0 : 80;
+            p_.fields.stream_id                    = static_cast<uint32_t>(i % 3);
+            p_.fields.integer_seconds_timestamp    = static_cast<uint32_t>(i / 3000);
+            p_.fields.fractional_seconds_timestamp = (i % 3000) * 40;
+            p_.if_context.has.sample_rate          = true;
+            p_.if_context.sample_rate              = 1e5 * static_cast<double>(1 + i / 30000);
+        });
+        ASSERT_GT(fs::file_size(TMP_FILE_PATH), 32 * 1024 * 1024);
+    }
+
+    /**
+     * Find position of a packet in file.
+     *
+     * \param pkt_idx Packet index.
+     *
+     * \return Position [B].
+     */
+    static std::streamoff find_packet(uint64_t pkt_idx) {
+        vrt::common::InputStream input_stream(TMP_FILE_PATH, false);
+        for (uint64_t i{0}; i < pkt_idx; ++i) {
+            input_stream.skip_next_packet();
+        }
+        return input_stream.tell();
+    }
+
+    vrt_packet p_;
+};
+
+/**
+ * Run length and capture output, without the progress bar.
+ */
+static std::string run(unsigned n_jobs, bool do_statistics = false, uint64_t* n_redone = nullptr) {
+    vrt::length::ProgramArguments args;
+    args.file_path_in  = TMP_FILE_PATH;
+    args.n_jobs        = n_jobs;
+    args.do_statistics = do_statistics;
+    ::testing::internal::CaptureStdout();
+    uint64_t n{0};
+    try {
+        n = vrt::length::process(args);
+    } catch (const std::runtime_error&) {
+        ::testing::internal::GetCapturedStdout();
+        throw;
+    }
+    if (n_redone != nullptr) {
+        *n_redone = n;
+    }
+    std::string out{::testing::internal::GetCapturedStdout()};
+    return out.substr(std::min(out.find("Stream ID"), out.size()));
+}
+
+TEST_F(ParallelTest, SameAsSerial) {
+    generate_sample_count();
+
+    std::string serial{run(1)};
+    ASSERT_NE(serial.find("Number of packets: 40000"), std::string::npos);
+    ASSERT_EQ(run(4), serial);
+    ASSERT_EQ(run(3), serial);
+
+    std::string serial_statistics{run(1, true)};
+    ASSERT_NE(serial_statistics.find("Data packets: 39960"), std::string::npos);
+    ASSERT_NE(serial_statistics.find("Context packets: 40\n"), std::string::npos);
+    ASSERT_EQ(run(4, true), serial_statistics);
+    ASSERT_EQ(run(3, true), serial_statistics);
+}
+
+TEST_F(ParallelTest, NoRedo) {
+    // Intervals before the sample rate is known in a chunk are found when merged, without processing it again
+    generate_sample_count();
+    uint64_t    n_redone{1};
+    std::string serial_statistics{run(1, true, &n_redone)};
+    ASSERT_EQ(n_redone, 0);
+    ASSERT_EQ(run(4, true, &n_redone), serial_statistics);
+    ASSERT_EQ(n_redone, 0);
+    ASSERT_EQ(run(3, true, &n_redone), serial_statistics);
+    ASSERT_EQ(n_redone, 0);
+}
+
+TEST_F(ParallelTest, EndOfFileInPacket) {
+    // Warned about once, with the packet index in the file
+    generate_sample_count();
+    {
+        std::ofstream file(TMP_FILE_PATH, std::ios::binary | std::ios::app);
+        uint32_t      header{0x1000FFFF};  // Data packet with Stream ID of maximum size
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    for (unsigned n_jobs : {1U, 4U}) {
+        ::testing::internal::CaptureStderr();
+        run(n_jobs);
+        std::string err{::testing::internal::GetCapturedStderr()};
+        ASSERT_EQ(err, "Warning: End of file in middle of packet #" + std::to_string(N_PACKETS) + '\n');
+    }
+}
+
+TEST_F(ParallelTest, ErrorPacketIndex) {
+    // Error in a later chunk is reported with the packet index in the file
+    generate_sample_count();
+    uint64_t pkt_idx{100000};
+    {
+        std::fstream file(TMP_FILE_PATH, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(find_packet(pkt_idx));
+        uint32_t header{0};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        header |= 0xF0000000;  // Reserved packet type
+        file.seekp(find_packet(pkt_idx));
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    for (unsigned n_jobs : {1U, 4U}) {
+        ::testing::internal::CaptureStderr();
+        try {
+            run(n_jobs);
+            FAIL();
+        } catch (const std::runtime_error& e) {
+            ASSERT_EQ(std::string(e.what()).rfind("Packet #" + std::to_string(pkt_idx) + " in ", 0), 0);
+        }
+        ASSERT_EQ(::testing::internal::GetCapturedStderr(), "");
+    }
+}
+
+TEST_F(ParallelTest, MergeHistory) {
+    vrt_packet p1;
+    vrt_packet p2;
+    vrt_packet p3;
+    vrt_init_packet(&p1);
+    vrt_init_packet(&p2);
+    vrt_init_packet(&p3);
+    p1.header.packet_type               = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    p1.header.tsi                       = VRT_TSI_UTC;
+    p1.fields.integer_seconds_timestamp = 1;
+    p2.header.packet_type               = VRT_PT_IF_CONTEXT;
+    p2.if_context.has.sample_rate       = true;
+    p2.if_context.sample_rate           = 2.0;
+    p3.header.packet_type               = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    p3.header.tsi                       = VRT_TSI_UTC;
+    p3.fields.integer_seconds_timestamp = 3;
+
+    vrt::common::StreamHistory a(1.0);
+    vrt::common::StreamHistory b(1.0);
+    vrt::common::StreamHistory c(1.0);
+    vrt::common::StreamHistory empty(1.0);
+    a.update(p1);
+    b.update(p2);
+    c.update(p3);
+
+    a.merge(b);
+    a.merge(empty);
+    ASSERT_EQ(a.size(), 1);
+    ASSERT_EQ(a.get_sample_rate(0), 2.0);
+    a.merge(c);
+    ASSERT_EQ(a.get_number_of_packets(0), 3);
+    ASSERT_EQ(a.get_time_first(0).integer, 1);
+    ASSERT_EQ(a.get_time_current(0).integer, 3);
+    // Sample rate from context packet is not overwritten by a part without one
+    ASSERT_EQ(a.get_sample_rate(0), 2.0);
+
+    empty.merge(a);
+    ASSERT_EQ(empty.get_number_of_packets(0), 3);
+    ASSERT_EQ(empty.get_time_first(0).integer, 1);
+}
+
+TEST_F(ParallelTest, MergeHistoryNewStreams) {
+    vrt_packet p;
+    vrt_init_packet(&p);
+    p.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+
+    vrt::common::StreamHistory a(1.0);
+    vrt::common::StreamHistory b(1.0);
+    p.fields.stream_id = 2;
+    a.update(p);
+    p.fields.stream_id = 3;
+    b.update(p);
+    p.fields.stream_id = 1;
+    b.update(p);
+    p.fields.stream_id = 2;
+    b.update(p);
+
+    a.merge(b);
+    ASSERT_EQ(a.size(), 3);
+    ASSERT_EQ(a.get_id(0).stream_id, 2);
+    ASSERT_EQ(a.get_number_of_packets(0), 2);
+    ASSERT_EQ(a.get_id(1).stream_id, 3);
+    ASSERT_EQ(a.get_id(2).stream_id, 1);
+    ASSERT_EQ(a.find(vrt::common::StreamId(p)), 0);
+    ASSERT_EQ(a.get_slots_sorted(), (std::vector<size_t>{2, 0, 1}));
+}
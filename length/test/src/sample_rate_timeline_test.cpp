@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "common/sample_rate_timeline.h"
+#include "common/stream_history.h"
+#include "common/timestamp.h"
+
+using namespace vrt;
+
+static constexpr int64_t PS{1000000000000};
+
+/**
+ * Make timestamp.
+ */
+static common::Timestamp make(vrt_tsi tsi, vrt_tsf tsf, uint32_t integer, uint64_t fractional) {
+    common::Timestamp t;
+    t.tsi        = static_cast<uint8_t>(tsi);
+    t.tsf        = static_cast<uint8_t>(tsf);
+    t.integer    = integer;
+    t.fractional = fractional;
+    return t;
+}
+
+/**
+ * Make sample count timestamp.
+ */
+static common::Timestamp count(uint32_t integer, uint64_t fractional) {
+    return make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, integer, fractional);
+}
+
+/**
+ * Time in picoseconds.
+ */
+static int64_t ps(const common::SampleRateTimeline& timeline, const common::Timestamp& t) {
+    return static_cast<int64_t>(timeline.key(t).picoseconds());
+}
+
+TEST(SampleRateTimelineTest, Initial) {
+    common::SampleRateTimeline timeline(1000.0);
+    bool                       depends_on_start{false};
+    ASSERT_EQ(timeline.key(count(2, 500), &depends_on_start).picoseconds(), common::Int128{2500000000000});
+    ASSERT_TRUE(depends_on_start);
+    ASSERT_TRUE(timeline.empty());
+    ASSERT_EQ(timeline.get_sample_rate(), 1000.0);
+
+    // Real time doesn't need a sample rate
+    timeline.key(make(VRT_TSI_UTC, VRT_TSF_REAL_TIME, 2, 5), &depends_on_start);
+    ASSERT_FALSE(depends_on_start);
+}
+
+TEST(SampleRateTimelineTest, ChangeWithinSecond) {
+    common::SampleRateTimeline timeline(1000.0);
+    timeline.append(count(5, 500), 2000.0);
+    ASSERT_EQ(timeline.size(), 1);
+    ASSERT_EQ(timeline.get_sample_rate(count(5, 250)), 1000.0);
+    ASSERT_EQ(timeline.get_sample_rate(count(5, 500)), 2000.0);
+
+    ASSERT_EQ(ps(timeline, count(5, 250)), 5 * PS + PS / 4);
+    ASSERT_EQ(ps(timeline, count(5, 500)), 5 * PS + PS / 2);
+    ASSERT_EQ(ps(timeline, count(5, 1500)), 6 * PS);
+    ASSERT_EQ(ps(timeline, count(6, 0)), 6 * PS);
+    ASSERT_EQ(ps(timeline, count(6, 1000)), 6 * PS + PS / 2);
+
+    // The start of the segment was converted with the initial sample rate, but later seconds weren't
+    bool depends_on_start{false};
+    timeline.key(count(5, 1500), &depends_on_start);
+    ASSERT_TRUE(depends_on_start);
+    timeline.key(count(6, 1000), &depends_on_start);
+    ASSERT_FALSE(depends_on_start);
+}
+
+TEST(SampleRateTimelineTest, FreeRunning) {
+    common::SampleRateTimeline timeline(1000.0);
+    timeline.append(make(VRT_TSI_NONE, VRT_TSF_FREE_RUNNING_COUNT, 0, 1000), 2000.0);
+    timeline.append(make(VRT_TSI_NONE, VRT_TSF_FREE_RUNNING_COUNT, 0, 3000), 4000.0);
+    ASSERT_EQ(ps(timeline, make(VRT_TSI_NONE, VRT_TSF_FREE_RUNNING_COUNT, 0, 500)), PS / 2);
+    ASSERT_EQ(ps(timeline, make(VRT_TSI_NONE, VRT_TSF_FREE_RUNNING_COUNT, 0, 3000)), 2 * PS);
+    ASSERT_EQ(ps(timeline, make(VRT_TSI_NONE, VRT_TSF_FREE_RUNNING_COUNT, 0, 7000)), 3 * PS);
+}
+
+TEST(SampleRateTimelineTest, OnlyChanges) {
+    common::SampleRateTimeline timeline(1000.0);
+    timeline.append(count(1, 0), 1000.0);
+    timeline.append(count(2, 0), 1000.0);
+    ASSERT_EQ(timeline.size(), 1);
+
+    // Starts before the last one are moved to it
+    timeline.append(count(3, 0), 2000.0);
+    timeline.append(count(2, 0), 4000.0);
+    ASSERT_EQ(timeline.size(), 2);
+    ASSERT_EQ(timeline.get_sample_rate(count(2, 0)), 1000.0);
+    ASSERT_EQ(timeline.get_sample_rate(count(3, 0)), 4000.0);
+}
+
+TEST(SampleRateTimelineTest, Append) {
+    // Same sample rates, in one part and in two parts where the second one starts with an unknown sample rate
+    common::SampleRateTimeline whole(1000.0);
+    common::SampleRateTimeline first(1000.0);
+    common::SampleRateTimeline second(0.0);
+    whole.append(count(1, 100), 2000.0);
+    first.append(count(1, 100), 2000.0);
+    whole.append(count(1, 300), 4000.0);
+    second.append(count(1, 300), 4000.0);
+    whole.append(count(3, 10), 8000.0);
+    second.append(count(3, 10), 8000.0);
+
+    bool depends_on_start{false};
+    second.key(count(1, 500), &depends_on_start);
+    ASSERT_TRUE(depends_on_start);
+
+    first.append(second);
+    ASSERT_EQ(first.size(), whole.size());
+    for (const common::Timestamp& t : {count(1, 50), count(1, 200), count(1, 1000), count(3, 20), count(4, 0)}) {
+        ASSERT_EQ(ps(first, t), ps(whole, t));
+    }
+
+    // Tail gives the same times after its start
+    common::SampleRateTimeline tail{whole.tail()};
+    ASSERT_EQ(tail.size(), 1);
+    ASSERT_EQ(ps(tail, count(3, 4010)), ps(whole, count(3, 4010)));
+}
+
+TEST(SampleRateTimelineTest, StreamHistory) {
+    common::StreamHistory history(1000.0);
+    vrt_packet            p;
+    vrt_init_packet(&p);
+    p.header.packet_type                  = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    p.header.tsi                          = VRT_TSI_UTC;
+    p.header.tsf                          = VRT_TSF_SAMPLE_COUNT;
+    p.fields.integer_seconds_timestamp    = 1;
+    p.fields.fractional_seconds_timestamp = 0;
+    size_t slot{history.update(p)};
+
+    // Sample rate doubles half a second in
+    p.header.packet_type                  = VRT_PT_IF_CONTEXT;
+    p.fields.fractional_seconds_timestamp = 500;
+    p.if_context.has.sample_rate          = true;
+    p.if_context.sample_rate              = 2000.0;
+    ASSERT_EQ(history.update(p), slot);
+
+    p.header.packet_type                  = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    p.fields.fractional_seconds_timestamp = 1500;
+    history.update(p);
+
+    const common::SampleRateTimeline& timeline{history.get_timeline(slot)};
+    common::Int128                    d;
+    ASSERT_TRUE(common::time_difference(timeline.key(history.get_time_current(slot)),
+                                        timeline.key(history.get_time_first(slot)), &d));
+    ASSERT_EQ(static_cast<int64_t>(d), PS);
+    ASSERT_EQ(history.get_sample_rate(slot), 2000.0);
+}
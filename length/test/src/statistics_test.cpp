@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "../../src/stream_statistics.h"
+#include "common/quantile_sketch.h"
+#include "common/stream_history.h"
+
+using namespace vrt;
+
+static constexpr int64_t PS{1000000000000};
+
+class StatisticsTest : public ::testing::Test {
+   protected:
+    StatisticsTest() : history_(0.0) {}
+
+    void SetUp() override {
+        packet_ = std::make_shared<vrt_packet>();
+        vrt_init_packet(packet_.get());
+        packet_->header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+        packet_->header.tsi         = VRT_TSI_UTC;
+        packet_->header.tsf         = VRT_TSF_REAL_TIME;
+        packet_->header.packet_size = 10;
+        packet_->words_body         = 5;
+    }
+
+    /**
+     * Update statistics with packet at a time.
+     */
+    void update(uint32_t s, uint64_t ps) {
+        packet_->fields.integer_seconds_timestamp    = s;
+        packet_->fields.fractional_seconds_timestamp = ps;
+        size_t slot{history_.update(*packet_)};
+        statistics_.update(*packet_, history_.get_timeline(slot));
+    }
+
+    std::shared_ptr<vrt_packet> packet_;
+    common::StreamHistory       history_;
+    length::StreamStatistics    statistics_;
+};
+
+TEST(QuantileSketchTest, Empty) {
+    common::QuantileSketch sketch;
+    ASSERT_EQ(sketch.get_count(), 0);
+    ASSERT_TRUE(std::isnan(sketch.quantile(0.5)));
+}
+
+TEST(QuantileSketchTest, RelativeAccuracy) {
+    common::QuantileSketch sketch;
+    for (int i{1}; i <= 10000; ++i) {
+        sketch.add(1e-3 * i);
+    }
+    ASSERT_EQ(sketch.get_count(), 10000);
+    ASSERT_DOUBLE_EQ(sketch.get_min(), 1e-3);
+    ASSERT_DOUBLE_EQ(sketch.get_max(), 10.0);
+    for (double q : {0.0, 0.1, 0.5, 0.9, 0.99, 1.0}) {
+        double expected{1e-3 * (1.0 + std::floor(q * 9999))};
+        ASSERT_NEAR(sketch.quantile(q), expected, expected * common::QuantileSketch::RELATIVE_ACCURACY);
+    }
+}
+
+TEST(QuantileSketchTest, Zero) {
+    common::QuantileSketch sketch;
+    sketch.add(0.0);
+    sketch.add(0.0);
+    sketch.add(1.0);
+    ASSERT_EQ(sketch.quantile(0.0), 0.0);
+    ASSERT_EQ(sketch.quantile(0.5), 0.0);
+    ASSERT_EQ(sketch.quantile(1.0), 1.0);
+}
+
+TEST(QuantileSketchTest, Merge) {
+    common::QuantileSketch all;
+    common::QuantileSketch a;
+    common::QuantileSketch b;
+    for (int i{0}; i < 1000; ++i) {
+        double value{std::exp(0.01 * i)};
+        all.add(value);
+        (i % 3 == 0 ? a : b).add(value);
+    }
+    a.merge(b);
+    ASSERT_EQ(a.get_count(), all.get_count());
+    ASSERT_EQ(a.get_min(), all.get_min());
+    ASSERT_EQ(a.get_max(), all.get_max());
+    for (double q : {0.0, 0.25, 0.5, 0.75, 1.0}) {
+        ASSERT_EQ(a.quantile(q), all.quantile(q));
+    }
+}
+
+TEST_F(StatisticsTest, Intervals) {
+    for (uint32_t i{0}; i < 10; ++i) {
+        update(i, 0);
+    }
+    const length::Intervals& data{statistics_.get_data()};
+    ASSERT_EQ(statistics_.get_number_of_data_packets(), 10);
+    ASSERT_EQ(statistics_.get_data_bytes(), 10 * 5 * sizeof(uint32_t));
+    ASSERT_EQ(statistics_.get_packet_sizes().at(10), 10);
+    ASSERT_EQ(data.sketch.get_count(), 9);
+    ASSERT_EQ(static_cast<int64_t>(data.sum), 9 * PS);
+    ASSERT_EQ(data.n_gaps, 0);
+    ASSERT_EQ(data.n_backwards, 0);
+    ASSERT_DOUBLE_EQ(data.sketch.get_min(), 1.0);
+    ASSERT_DOUBLE_EQ(data.sketch.get_max(), 1.0);
+}
+
+TEST_F(StatisticsTest, GapAndBackwards) {
+    update(0, 0);
+    update(0, 500000000000);
+    update(1, 0);
+    update(3, 0);
+    update(3, 500000000000);
+    update(3, 0);
+    update(3, 500000000000);
+    const length::Intervals& data{statistics_.get_data()};
+    ASSERT_EQ(data.n_gaps, 1);
+    ASSERT_EQ(static_cast<int64_t>(data.gap_max), 2 * PS);
+    ASSERT_EQ(static_cast<int64_t>(data.gap_sum), 2 * PS);
+    ASSERT_EQ(data.n_backwards, 1);
+    ASSERT_EQ(static_cast<int64_t>(data.sum), 3 * PS + PS / 2);
+}
+
+TEST_F(StatisticsTest, Context) {
+    update(0, 0);
+    packet_->header.packet_type = VRT_PT_IF_CONTEXT;
+    update(1, 0);
+    update(3, 0);
+    ASSERT_EQ(statistics_.get_number_of_data_packets(), 1);
+    ASSERT_EQ(statistics_.get_number_of_context_packets(), 2);
+    ASSERT_EQ(static_cast<int64_t>(statistics_.get_context().sum), 2 * PS);
+    ASSERT_EQ(statistics_.get_data().sketch.get_count(), 0);
+}
+
+TEST_F(StatisticsTest, Trailer) {
+    packet_->header.has.trailer         = true;
+    packet_->trailer.has.valid_data     = true;
+    packet_->trailer.valid_data         = true;
+    packet_->trailer.has.reference_lock = true;
+    update(0, 0);
+    packet_->trailer.valid_data = false;
+    update(1, 0);
+    ASSERT_EQ(statistics_.get_number_of_trailers(), 2);
+    ASSERT_EQ(statistics_.get_trailer_flag_present(length::StreamStatistics::VALID_DATA), 2);
+    ASSERT_EQ(statistics_.get_trailer_flag_set(length::StreamStatistics::VALID_DATA), 1);
+    ASSERT_EQ(statistics_.get_trailer_flag_present(length::StreamStatistics::REFERENCE_LOCK), 2);
+    ASSERT_EQ(statistics_.get_trailer_flag_set(length::StreamStatistics::REFERENCE_LOCK), 0);
+    ASSERT_EQ(statistics_.get_trailer_flag_present(length::StreamStatistics::SAMPLE_LOSS), 0);
+}
+
+TEST_F(StatisticsTest, Merge) {
+    // Same packets, in one part and in two parts
+    length::StreamStatistics a;
+    length::StreamStatistics b;
+    common::StreamHistory    history_a(0.0);
+    common::StreamHistory    history_b(0.0);
+    const uint64_t           times[]{0, 1, 2, 5, 6, 4, 7, 8, 20, 21};
+    for (size_t i{0}; i < std::size(times); ++i) {
+        update(static_cast<uint32_t>(times[i]), 0);
+        common::StreamHistory&    history{i < 4 ? history_a : history_b};
+        length::StreamStatistics& statistics{i < 4 ? a : b};
+        size_t                    slot{history.update(*packet_)};
+        statistics.update(*packet_, history.get_timeline(slot));
+    }
+    history_a.merge(history_b);
+    a.merge(b, history_a.get_timeline(0));
+
+    const length::Intervals& expected{statistics_.get_data()};
+    const length::Intervals& actual{a.get_data()};
+    ASSERT_EQ(actual.n_packets, expected.n_packets);
+    ASSERT_EQ(actual.n_gaps, expected.n_gaps);
+    ASSERT_TRUE(actual.gap_sum == expected.gap_sum);
+    ASSERT_TRUE(actual.gap_max == expected.gap_max);
+    ASSERT_EQ(actual.n_backwards, expected.n_backwards);
+    ASSERT_TRUE(actual.sum == expected.sum);
+    ASSERT_EQ(actual.sketch.get_count(), expected.sketch.get_count());
+    ASSERT_EQ(actual.sketch.quantile(0.5), expected.sketch.quantile(0.5));
+    ASSERT_EQ(a.get_number_of_data_packets(), statistics_.get_number_of_data_packets());
+}
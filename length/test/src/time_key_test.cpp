@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_time.h"
+#include "vrt/vrt_types.h"
+
+#include "common/timestamp.h"
+
+using namespace vrt;
+
+/**
+ * Make timestamp.
+ */
+static common::Timestamp make(vrt_tsi tsi, vrt_tsf tsf, uint32_t integer, uint64_t fractional) {
+    common::Timestamp t;
+    t.tsi        = static_cast<uint8_t>(tsi);
+    t.tsf        = static_cast<uint8_t>(tsf);
+    t.integer    = integer;
+    t.fractional = fractional;
+    return t;
+}
+
+/**
+ * Time difference a - b in picoseconds, or -1 if there is none.
+ */
+static int64_t diff(const common::TimeKey& a, const common::TimeKey& b) {
+    common::Int128 d;
+    if (!common::time_difference(a, b, &d)) {
+        return -1;
+    }
+    return static_cast<int64_t>(d);
+}
+
+TEST(TimeKeyTest, None) {
+    common::TimeKey a(make(VRT_TSI_NONE, VRT_TSF_NONE, 1, 2), 0.0);
+    ASSERT_FALSE(a.is_valid());
+    ASSERT_EQ(diff(a, a), -1);
+}
+
+TEST(TimeKeyTest, Packet) {
+    vrt_packet p;
+    vrt_init_packet(&p);
+    p.header.tsi                          = VRT_TSI_UTC;
+    p.header.tsf                          = VRT_TSF_REAL_TIME;
+    p.fields.integer_seconds_timestamp    = 3;
+    p.fields.fractional_seconds_timestamp = 4;
+    ASSERT_EQ(common::TimeKey(p, 0.0).picoseconds(), common::Int128{3000000000004});
+}
+
+TEST(TimeKeyTest, RealTime) {
+    common::TimeKey a(make(VRT_TSI_UTC, VRT_TSF_REAL_TIME, 10, 999999999999), 0.0);
+    common::TimeKey b(make(VRT_TSI_UTC, VRT_TSF_REAL_TIME, 11, 0), 0.0);
+    ASSERT_TRUE(a.is_exact());
+    ASSERT_TRUE(a < b);
+    ASSERT_FALSE(b < a);
+    ASSERT_EQ(diff(b, a), 1);
+    ASSERT_EQ(diff(a, b), -1);
+}
+
+TEST(TimeKeyTest, IntegerOnly) {
+    common::TimeKey a(make(VRT_TSI_GPS, VRT_TSF_NONE, 10, 0), 0.0);
+    common::TimeKey b(make(VRT_TSI_GPS, VRT_TSF_NONE, 12, 5), 0.0);
+    ASSERT_TRUE(a < b);
+    ASSERT_EQ(diff(b, a), 2000000000000);
+}
+
+TEST(TimeKeyTest, SampleCountExact) {
+    // A third of a second is rounded once, regardless of the time
+    common::TimeKey a(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 86400, 1), 3.0);
+    common::TimeKey b(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 0, 0), 3.0);
+    ASSERT_EQ(diff(a, b), 86400 * 1000000000000 + 333333333333);
+
+    // No drift after a day, unlike when converting with floating point
+    common::TimeKey c(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 1700086399, 30719999), 30.72e6);
+    common::TimeKey d(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 1700000000, 30719998), 30.72e6);
+    ASSERT_EQ(diff(c, d), 86399 * 1000000000000 + 32552);
+}
+
+TEST(TimeKeyTest, SampleCountFractionalRate) {
+    common::TimeKey a(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 0, 1), 0.5);
+    common::TimeKey b(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 0, 0), 0.5);
+    ASSERT_EQ(diff(a, b), 2000000000000);
+}
+
+TEST(TimeKeyTest, DifferentSampleRates) {
+    common::TimeKey a(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 1, 1), 2.0);
+    common::TimeKey b(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 1, 4), 8.0);
+    ASSERT_TRUE(a == b);
+    ASSERT_FALSE(a < b);
+    ASSERT_FALSE(b < a);
+    ASSERT_EQ(diff(a, b), 0);
+}
+
+TEST(TimeKeyTest, UnknownSampleRate) {
+    // Only ordered, by integer and fractional parts
+    common::TimeKey a(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 1, 100), 0.0);
+    common::TimeKey b(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 1, 101), 0.0);
+    common::TimeKey c(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 2, 0), 0.0);
+    ASSERT_TRUE(a.is_valid());
+    ASSERT_FALSE(a.is_exact());
+    ASSERT_TRUE(a < b);
+    ASSERT_TRUE(b < c);
+    ASSERT_EQ(diff(b, a), -1);
+}
+
+TEST(TimeKeyTest, MixedOrder) {
+    // Ordering is transitive, also when times can't be compared
+    common::TimeKey a(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 3, 5), 1.0);
+    common::TimeKey b(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 4, 0), 0.0);
+    common::TimeKey c(make(VRT_TSI_UTC, VRT_TSF_REAL_TIME, 4, 0), 0.0);
+    common::TimeKey d(make(VRT_TSI_UTC, VRT_TSF_SAMPLE_COUNT, 2, 0), 0.0);
+    std::vector<common::TimeKey> keys{a, b, c, d};
+    for (const common::TimeKey& x : keys) {
+        ASSERT_FALSE(x < x);
+        for (const common::TimeKey& y : keys) {
+            ASSERT_FALSE(x < y && y < x);
+            ASSERT_EQ(x == y, !(x < y) && !(y < x));
+            for (const common::TimeKey& z : keys) {
+                if (x < y && y < z) {
+                    ASSERT_TRUE(x < z);
+                }
+            }
+        }
+    }
+
+    // Exact times after the ones that aren't, and by time among them
+    std::sort(keys.begin(), keys.end());
+    ASSERT_TRUE(keys[0] == d);
+    ASSERT_TRUE(keys[1] == b);
+    ASSERT_TRUE(keys[2] == c);
+    ASSERT_TRUE(keys[3] == a);
+}
+
+TEST(TimeKeyTest, Mismatch) {
+    common::TimeKey a(make(VRT_TSI_UTC, VRT_TSF_REAL_TIME, 1, 0), 0.0);
+    common::TimeKey b(make(VRT_TSI_GPS, VRT_TSF_REAL_TIME, 1, 0), 0.0);
+    common::TimeKey c(make(VRT_TSI_UTC, VRT_TSF_NONE, 1, 0), 0.0);
+    ASSERT_EQ(diff(a, b), -1);
+    ASSERT_EQ(diff(a, c), -1);
+}
+
+TEST(TimeKeyTest, ToVrtTime) {
+    vrt_time t;
+    common::to_vrt_time(-1, &t);
+    ASSERT_EQ(t.s, -1);
+    ASSERT_EQ(t.ps, 999999999999);
+    common::to_vrt_time(2000000000001, &t);
+    ASSERT_EQ(t.s, 2);
+    ASSERT_EQ(t.ps, 1);
+    ASSERT_DOUBLE_EQ(common::to_seconds(-500000000000), -0.5);
+}
@@ -0,0 +1,47 @@
+#ifndef LIB_COMMON_INCLUDE_COMMON_COUNTER_RANDOM_H_
+#define LIB_COMMON_INCLUDE_COMMON_COUNTER_RANDOM_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vrt::common {
+
+/**
+ * Counter-based pseudo random number generator, where number i only depends on the seed and i. Numbers can thus be
+ * drawn in any order, in batches or on several threads, with the same result. Number i is the SplitMix64 output
+ * function applied to the seeded key plus i times the golden ratio increment.
+ */
+class CounterRandom {
+   public:
+    explicit CounterRandom(uint64_t seed);
+
+    /**
+     * \param counter Index of number.
+     *
+     * \return Pseudo random number.
+     */
+    uint64_t get(uint64_t counter) const {
+        uint64_t z{key_ + counter * 0x9E3779B97F4A7C15ULL};
+        z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31U);
+    }
+
+    /**
+     * \param counter Index of number.
+     *
+     * \return Pseudo random number in [0, 1).
+     */
+    double uniform(uint64_t counter) const { return static_cast<double>(get(counter) >> 11U) * 0x1.0p-53; }
+
+    void uniform(uint64_t counter, double* values, size_t n) const;
+
+   private:
+    const uint64_t key_; /**< Key from seed. */
+};
+
+uint64_t get_seed(bool has_seed, uint64_t seed);
+
+}  // namespace vrt::common
+
+#endif
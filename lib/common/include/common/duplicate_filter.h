@@ -0,0 +1,94 @@
+#ifndef LIB_COMMON_INCLUDE_COMMON_DUPLICATE_FILTER_H_
+#define LIB_COMMON_INCLUDE_COMMON_DUPLICATE_FILTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_set>
+#include <vector>
+
+#include "common/stream_id.h"
+#include "common/timestamp.h"
+
+struct vrt_packet;
+
+namespace vrt::common {
+
+/**
+ * Finds packets that are identical to one seen before, e.g. the same packet recorded on redundant capture nodes.
+ * Packets are identical if they have the same stream, timestamp, packet count and contents. Only packets within a
+ * time window of the latest one are remembered, so memory use doesn't grow with the number of packets. Packets are
+ * forgotten in time order, so a packet out of order doesn't keep later ones in memory.
+ */
+class DuplicateFilter {
+   public:
+    explicit DuplicateFilter(uint64_t window_ps);
+
+    bool is_duplicate(const StreamId&  id,
+                      const Timestamp& time,
+                      uint8_t          packet_count,
+                      const uint32_t*  buf,
+                      uint16_t         words);
+    bool is_duplicate(const vrt_packet& packet, const uint32_t* buf);
+
+    /**
+     * \return Number of duplicates found.
+     */
+    uint64_t get_number_of_duplicates() const { return n_duplicates_; }
+
+    /**
+     * \return Number of packets remembered.
+     */
+    size_t size() const { return entries_.size(); }
+
+   private:
+    /**
+     * What identifies a packet.
+     */
+    struct Entry {
+        StreamId  id;              /**< Stream. */
+        Timestamp time;            /**< Timestamp. */
+        uint64_t  hash{0};         /**< Hash of packet words. */
+        uint16_t  words{0};        /**< Packet size [words]. */
+        uint8_t   packet_count{0}; /**< Packet count. */
+
+        bool operator==(const Entry& other) const;
+    };
+
+    /**
+     * Hash of Entry, for unordered containers.
+     */
+    struct EntryHash {
+        size_t operator()(const Entry& entry) const { return static_cast<size_t>(entry.hash); }
+    };
+
+    /**
+     * Remembered packet, with its time.
+     */
+    struct Remembered {
+        TimeKey key;   /**< Time. */
+        Entry   entry; /**< Packet. */
+
+        /**
+         * \return True if this is later than other, for a min-heap.
+         */
+        bool operator>(const Remembered& other) const { return other.key < key; }
+    };
+
+    using MinHeap = std::priority_queue<Remembered, std::vector<Remembered>, std::greater<>>;
+
+    bool is_outside_window(const Timestamp& time) const;
+
+    const uint64_t window_ps_;
+
+    std::unordered_set<Entry, EntryHash> entries_;         /**< Remembered packets. */
+    MinHeap                              order_;           /**< Remembered packets, earliest on top. */
+    Timestamp                            latest_;          /**< Latest time seen. */
+    TimeKey                              key_latest_;      /**< Latest time seen. */
+    uint64_t                             n_duplicates_{0}; /**< Number of duplicates found. */
+};
+
+}  // namespace vrt::common
+
+#endif
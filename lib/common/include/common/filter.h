@@ -0,0 +1,108 @@
+#ifndef LIB_COMMON_INCLUDE_COMMON_FILTER_H_
+#define LIB_COMMON_INCLUDE_COMMON_FILTER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct vrt_packet;
+
+namespace vrt::common {
+
+class InputStream;
+
+/**
+ * Packet filter, compiled from an expression such as
+ *
+ *     stream_id==0xDEADBEEF && type==context && tsi>=1600000000
+ *
+ * Comparisons (==, !=, <, <=, >, >=) between a field and a constant are combined with &&, || and !, and grouped with
+ * parentheses. A field on its own, e.g. has_trailer, is true if it is present and non-zero. Comparisons with a field
+ * that the packet doesn't have, such as stream_id in a packet without Stream ID, are false.
+ *
+ * The expression is parsed once into a flat program in postfix order, which is evaluated for each packet. Filters that
+ * only use header fields can be evaluated before the rest of the packet is read and parsed.
+ */
+class Filter {
+   public:
+    Filter() = default;
+    explicit Filter(const std::string& expression);
+
+    bool matches(const vrt_packet& packet) const;
+
+    /**
+     * \return True if filter has no expression, i.e. matches every packet.
+     */
+    bool empty() const { return program_.empty(); }
+
+    /**
+     * \return True if filter only needs the packet header to be evaluated.
+     */
+    bool is_header_only() const { return is_header_only_; }
+
+    /**
+     * Packet field that can be used in expressions.
+     */
+    enum class Field {
+        TYPE,
+        PACKET_TYPE,
+        HAS_STREAM_ID,
+        HAS_CLASS_ID,
+        HAS_TRAILER,
+        TSM,
+        TSI_TYPE,
+        TSF_TYPE,
+        PACKET_COUNT,
+        PACKET_SIZE,
+        STREAM_ID,
+        OUI,
+        INFORMATION_CLASS_CODE,
+        PACKET_CLASS_CODE,
+        INTEGER_SECONDS_TIMESTAMP,
+        FRACTIONAL_SECONDS_TIMESTAMP,
+        BODY_SIZE,
+        BANDWIDTH,
+        IF_REFERENCE_FREQUENCY,
+        RF_REFERENCE_FREQUENCY,
+        SAMPLE_RATE,
+        CALIBRATED_TIME,
+        VALID_DATA,
+        REFERENCE_LOCK,
+        DETECTED_SIGNAL,
+        SPECTRAL_INVERSION,
+        OVER_RANGE,
+        SAMPLE_LOSS
+    };
+
+    /**
+     * Comparison operator.
+     */
+    enum class Compare { EQ, NE, LT, LE, GT, GE };
+
+    /**
+     * Program instruction.
+     */
+    struct Instruction {
+        enum class Op { TEST, COMPARE, AND, OR, NOT } op;
+        Field    field{Field::TYPE};
+        Compare  compare{Compare::EQ};
+        uint64_t value_int{0};     // Constant for integer fields
+        double   value_float{0.0};  // Constant for floating point fields
+    };
+
+    /**
+     * Maximum nesting of an expression.
+     */
+    static constexpr size_t MAX_DEPTH{64};
+
+   private:
+    std::vector<Instruction> program_;
+    bool                     is_header_only_{true};
+};
+
+bool read_remainder_if_match(const Filter& filter, InputStream* input_stream, bool* is_match);
+bool read_next_matching_packet(const Filter& filter, InputStream* input_stream, uint64_t* n_packets);
+
+}  // namespace vrt::common
+
+#endif
@@ -16,11 +16,17 @@ namespace vrt::common {
  */
 class InputStream {
    public:
-    InputStream(std::filesystem::path file_path, bool do_byte_swap, bool do_validate = true);
+    InputStream(std::filesystem::path file_path, bool do_byte_swap, bool do_validate = true, bool do_warn = true);
 
-    bool read_next_packet();
-    bool skip_next_packet();
-    void reset();
+    bool           read_next_packet();
+    bool           read_next_header();
+    bool           read_remainder();
+    bool           read_fields();
+    bool           skip_remainder();
+    bool           skip_next_packet();
+    void           reset();
+    std::streampos tell();
+    void           seek(std::streampos position, uint64_t pkt_idx);
 
     /**
      * \return Output file path.
@@ -53,6 +59,7 @@ class InputStream {
     const std::filesystem::path file_path_;
     const bool                  do_byte_swap_;
     const bool                  do_validate_;
+    const bool                  do_warn_;
 
     std::shared_ptr<vrt_packet> packet_;
     std::ifstream               file_;
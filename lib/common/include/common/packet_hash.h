@@ -0,0 +1,14 @@
+#ifndef LIB_COMMON_INCLUDE_COMMON_PACKET_HASH_H_
+#define LIB_COMMON_INCLUDE_COMMON_PACKET_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vrt::common {
+
+uint64_t mix_bits(uint64_t h);
+uint64_t hash_words(const uint32_t* words, size_t n);
+
+}  // namespace vrt::common
+
+#endif
@@ -8,6 +8,8 @@ struct vrt_packet;
 
 namespace vrt::common {
 
+struct StreamId;
+
 /**
  * Describe differences between packets, as booleans.
  */
@@ -21,6 +23,7 @@ struct PacketIdDiffs {
 };
 
 PacketIdDiffs packet_id_differences(const std::vector<std::shared_ptr<vrt_packet>>& packets);
+PacketIdDiffs packet_id_differences(const std::vector<StreamId>& ids);
 
 }  // namespace vrt::common
 
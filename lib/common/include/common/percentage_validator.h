@@ -1,8 +1,16 @@
-#ifndef VRT_PACKET_LOSS_SRC_PERCENTAGE_VALIDATOR_H_
-#define VRT_PACKET_LOSS_SRC_PERCENTAGE_VALIDATOR_H_
+#ifndef LIB_COMMON_INCLUDE_COMMON_PERCENTAGE_VALIDATOR_H_
+#define LIB_COMMON_INCLUDE_COMMON_PERCENTAGE_VALIDATOR_H_
+
+#include <algorithm>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 
 #include "CLI/Validators.hpp"
 
+namespace vrt::common {
+
 /**
  * Ensure that ratios with a percentage symbol after are parsed accordingly.
  */
@@ -75,4 +83,6 @@ class PercentageValidator : public CLI::Validator {
     }
 };
 
+}  // namespace vrt::common
+
 #endif
@@ -0,0 +1,33 @@
+#ifndef LIB_COMMON_INCLUDE_COMMON_POSITIONAL_OUTPUT_STREAM_H_
+#define LIB_COMMON_INCLUDE_COMMON_POSITIONAL_OUTPUT_STREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace vrt::common {
+
+/**
+ * Output file of known size, where threads write separate regions at known positions at the same time.
+ */
+class PositionalOutputStream {
+   public:
+    PositionalOutputStream(std::filesystem::path file_path, uint64_t size_bytes);
+    ~PositionalOutputStream();
+
+    PositionalOutputStream(const PositionalOutputStream&) = delete;
+    PositionalOutputStream& operator=(const PositionalOutputStream&) = delete;
+
+    void write(const uint32_t* buf, size_t words, uint64_t position);
+    void close();
+    void remove_file();
+
+   private:
+    const std::filesystem::path file_path_;
+
+    int fd_{-1}; /**< File descriptor, or -1 if closed. */
+};
+
+}  // namespace vrt::common
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef LIB_COMMON_INCLUDE_COMMON_QUANTILE_SKETCH_H_
+#define LIB_COMMON_INCLUDE_COMMON_QUANTILE_SKETCH_H_
+
+#include <cstdint>
+#include <limits>
+#include <map>
+
+namespace vrt::common {
+
+/**
+ * Sketch of a distribution of non-negative values, for estimating quantiles in a single pass. Values are counted in
+ * logarithmically spaced bins, so any quantile is estimated with a bounded relative error, and memory only grows with
+ * the logarithm of the value range. Sketches of different parts of the data can be merged, and the result is the same
+ * as if all values had been added to one sketch.
+ */
+class QuantileSketch {
+   public:
+    QuantileSketch();
+
+    void   add(double value);
+    void   merge(const QuantileSketch& other);
+    double quantile(double q) const;
+
+    /**
+     * \return Number of values added.
+     */
+    uint64_t get_count() const { return count_; }
+
+    /**
+     * \return Smallest value added, or infinity if there is none.
+     */
+    double get_min() const { return min_; }
+
+    /**
+     * \return Largest value added, or negative infinity if there is none.
+     */
+    double get_max() const { return max_; }
+
+    /**
+     * Largest relative error of quantile estimates.
+     */
+    static constexpr double RELATIVE_ACCURACY{0.01};
+
+    /**
+     * Values smaller than this are counted as zero.
+     */
+    static constexpr double MIN_VALUE{1e-15};
+
+   private:
+    double                      log_gamma_;
+    std::map<int32_t, uint64_t> bins_;       /**< Count per bin index. Bin i holds values in (gamma^(i-1), gamma^i]. */
+    uint64_t                    n_zero_{0};  /**< Number of values counted as zero. */
+    uint64_t                    count_{0};
+    double                      min_{std::numeric_limits<double>::infinity()};
+    double                      max_{-std::numeric_limits<double>::infinity()};
+};
+
+}  // namespace vrt::common
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef LIB_COMMON_INCLUDE_COMMON_SAMPLE_RATE_TIMELINE_H_
+#define LIB_COMMON_INCLUDE_COMMON_SAMPLE_RATE_TIMELINE_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "common/timestamp.h"
+
+namespace vrt::common {
+
+/**
+ * Sample rate of a stream over time, as segments of constant sample rate that start at the timestamps of the IF
+ * context packets that changed it. Appending is amortized constant time, and finding the segment of a timestamp is a
+ * binary search.
+ *
+ * Sample count and free running count timestamps are converted to time with the sample rate in effect at them. Within
+ * the integer second where a segment starts, or anywhere for free running counts, time is counted from the start of
+ * the segment, so that durations across a sample rate change are right.
+ */
+class SampleRateTimeline {
+   public:
+    explicit SampleRateTimeline(double sample_rate) : sample_rate_initial_{sample_rate} {}
+
+    void               append(const Timestamp& time, double sample_rate);
+    void               append(const SampleRateTimeline& later);
+    TimeKey            key(const Timestamp& time, bool* depends_on_start = nullptr) const;
+    double             get_sample_rate(const Timestamp& time) const;
+    SampleRateTimeline tail() const;
+
+    /**
+     * \return Latest sample rate [Hz].
+     */
+    double get_sample_rate() const { return segments_.empty() ? sample_rate_initial_ : segments_.back().sample_rate; }
+
+    /**
+     * \return True if no IF context packet has had a sample rate, so the initial one is used everywhere.
+     */
+    bool empty() const { return segments_.empty(); }
+
+    /**
+     * \return Number of segments.
+     */
+    size_t size() const { return segments_.size(); }
+
+   private:
+    /**
+     * Part of timeline with constant sample rate.
+     */
+    struct Segment {
+        Timestamp start;                   /**< Timestamp where segment starts. */
+        double    sample_rate{0.0};        /**< Sample rate [Hz]. */
+        Int128    start_ps{0};             /**< Time of start, with the sample rate before it [ps]. */
+        bool      has_start_ps{false};     /**< If time of start is known. */
+        bool      depends_on_start{false}; /**< If time of start was calculated with the initial sample rate. */
+    };
+
+    const Segment* find(const Timestamp& time) const;
+
+    double               sample_rate_initial_; /**< Sample rate before first segment [Hz]. */
+    std::vector<Segment> segments_;            /**< Segments, ordered by start. */
+};
+
+}  // namespace vrt::common
+
+#endif
@@ -1,35 +1,74 @@
 #ifndef VRT_COMMON_SRC_STREAM_HISTORY_H_
 #define VRT_COMMON_SRC_STREAM_HISTORY_H_
 
+#include <cstddef>
 #include <cstdint>
-#include <memory>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "common/sample_rate_timeline.h"
+#include "common/stream_id.h"
+#include "common/timestamp.h"
 
 struct vrt_packet;
 
 namespace vrt::common {
 
 /**
- * History of a stream.
+ * History of streams. Only a compact state is kept for each stream, in a table with one column per value and one row,
+ * or slot, per stream. The values needed for every packet are kept together, so an update touches little memory even
+ * with many streams.
  */
 class StreamHistory {
    public:
     explicit StreamHistory(double sample_rate) : sample_rate_{sample_rate} {}
 
-    void update(const std::shared_ptr<vrt_packet>& packet);
+    size_t find(const StreamId& id) const;
+    size_t add(const StreamId& id, double sample_rate) { return add(id, SampleRateTimeline(sample_rate)); }
+    size_t add(const StreamId& id, const SampleRateTimeline& timeline);
+    size_t add(const StreamId& id) { return add(id, sample_rate_); }
+    void   update(size_t slot, const vrt_packet& packet);
+    size_t update(const vrt_packet& packet);
+    void   merge(const StreamHistory& later);
+
+    std::vector<size_t> get_slots_sorted() const;
 
-    std::shared_ptr<vrt_packet> get_packet_first() const { return packet_first_; }
-    std::shared_ptr<vrt_packet> get_packet_current() const { return packet_cur_; }
+    /**
+     * \return Number of streams.
+     */
+    size_t size() const { return ids_.size(); }
 
-    uint64_t get_number_of_packets() const { return n_packets_; }
+    const StreamId&           get_id(size_t slot) const { return ids_[slot]; }
+    const Timestamp&          get_time_first(size_t slot) const { return time_first_[slot]; }
+    const Timestamp&          get_time_current(size_t slot) const { return current_[slot].time; }
+    uint64_t                  get_number_of_packets(size_t slot) const { return current_[slot].n_packets; }
+    const SampleRateTimeline& get_timeline(size_t slot) const { return timelines_[slot]; }
+    double                    get_sample_rate(size_t slot) const { return timelines_[slot].get_sample_rate(); }
 
-    double get_sample_rate() const { return sample_rate_; }
+    /**
+     * Slot returned by find() when there is no such stream.
+     */
+    static constexpr size_t NONE{std::numeric_limits<size_t>::max()};
 
    private:
-    std::shared_ptr<vrt_packet> packet_first_;
-    std::shared_ptr<vrt_packet> packet_cur_;
-    double                      sample_rate_{0}; /**< Sample rate in last IF context packet. */
+    /**
+     * State updated by every packet.
+     */
+    struct Current {
+        Timestamp time;         /**< Timestamp of last packet. */
+        uint64_t  n_packets{0}; /**< Number of packets. */
+    };
+
+    double                                             sample_rate_;     /**< Sample rate of new streams. */
+    std::unordered_map<StreamId, size_t, StreamIdHash> slots_;           /**< Slot of each stream. */
+    size_t                                             slot_last_{NONE}; /**< Slot of last found stream. */
 
-    uint64_t n_packets_{0};
+    // Columns
+    std::vector<StreamId>           ids_;
+    std::vector<Current>            current_;
+    std::vector<Timestamp>          time_first_;
+    std::vector<SampleRateTimeline> timelines_;
 };
 
 }  // namespace vrt::common
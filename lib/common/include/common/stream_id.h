@@ -0,0 +1,79 @@
+#ifndef LIB_COMMON_INCLUDE_COMMON_STREAM_ID_H_
+#define LIB_COMMON_INCLUDE_COMMON_STREAM_ID_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+#include "vrt/vrt_types.h"
+#include "vrt/vrt_util.h"
+
+namespace vrt::common {
+
+/**
+ * Class and Stream ID combination identifying a stream, without the rest of the packet. Ordered in the same way as by
+ * ComparatorId.
+ */
+struct StreamId {
+    uint32_t oui{0};
+    uint32_t stream_id{0};
+    uint16_t information_class_code{0};
+    uint16_t packet_class_code{0};
+    bool     has_class_id{false};
+    bool     has_stream_id{false};
+
+    StreamId() = default;
+
+    /**
+     * Constructor.
+     *
+     * \param packet Packet in stream.
+     */
+    explicit StreamId(const vrt_packet& packet)
+        : has_class_id{packet.header.has.class_id}, has_stream_id{vrt_has_stream_id(&packet.header)} {
+        if (has_class_id) {
+            oui                    = packet.fields.class_id.oui;
+            information_class_code = packet.fields.class_id.information_class_code;
+            packet_class_code      = packet.fields.class_id.packet_class_code;
+        }
+        if (has_stream_id) {
+            stream_id = packet.fields.stream_id;
+        }
+    }
+
+    /**
+     * \return Tuple to compare by.
+     */
+    auto tie() const {
+        return std::tie(has_class_id, oui, information_class_code, packet_class_code, has_stream_id, stream_id);
+    }
+};
+
+inline bool operator<(const StreamId& a, const StreamId& b) {
+    return a.tie() < b.tie();
+}
+
+inline bool operator==(const StreamId& a, const StreamId& b) {
+    return a.tie() == b.tie();
+}
+
+inline bool operator!=(const StreamId& a, const StreamId& b) {
+    return !(a == b);
+}
+
+/**
+ * Hash of StreamId, for unordered containers.
+ */
+struct StreamIdHash {
+    size_t operator()(const StreamId& id) const {
+        uint64_t h{(static_cast<uint64_t>(id.oui) << 32U) ^ (static_cast<uint64_t>(id.information_class_code) << 16U) ^
+                   id.packet_class_code};
+        h ^= (static_cast<uint64_t>(id.stream_id) + 0x9E3779B97F4A7C15ULL + (h << 6U) + (h >> 2U));
+        h ^= (static_cast<uint64_t>(id.has_class_id) << 1U) | static_cast<uint64_t>(id.has_stream_id);
+        return static_cast<size_t>(h * 0xFF51AFD7ED558CCDULL);
+    }
+};
+
+}  // namespace vrt::common
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef LIB_COMMON_INCLUDE_COMMON_TIME_SEARCH_H_
+#define LIB_COMMON_INCLUDE_COMMON_TIME_SEARCH_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <tuple>
+#include <vector>
+
+struct vrt_header;
+struct vrt_fields;
+
+namespace vrt::common {
+
+/**
+ * Packet time. Picoseconds are only used when the fractional timestamp is real time.
+ */
+struct PacketTime {
+    uint64_t seconds{0};
+    uint64_t picoseconds{0};
+};
+
+inline bool operator<(const PacketTime& a, const PacketTime& b) {
+    return std::tie(a.seconds, a.picoseconds) < std::tie(b.seconds, b.picoseconds);
+}
+
+/**
+ * Find packets by time in a file, without reading it from the start. Packets are assumed to be ordered by time. The
+ * file is binary searched by probing at byte offsets, resynchronizing to the next packet header at each probe, so only
+ * a small part of the file is read.
+ */
+class TimeSearch {
+   public:
+    TimeSearch(std::filesystem::path file_path, bool do_byte_swap);
+
+    bool     first_time(PacketTime* time);
+    uint64_t find(const PacketTime& time);
+    uint64_t resync(uint64_t position);
+    uint64_t find_end();
+
+    /**
+     * \return Input file size [B].
+     */
+    uint64_t get_file_size() const { return file_size_bytes_; }
+
+    /**
+     * \return Number of bytes read from file so far [B].
+     */
+    uint64_t get_bytes_read() const { return bytes_read_; }
+
+    /**
+     * Number of consecutive valid packet headers needed to accept a position as a packet start, unless the file ends
+     * before that.
+     */
+    static constexpr unsigned CHAIN_PACKETS{4};
+
+    /**
+     * Binary search ends, and a linear scan begins, when the search range is smaller than this [B].
+     */
+    static constexpr uint64_t LINEAR_BYTES{65536};
+
+    /**
+     * Size of block read when scanning for a packet header [words].
+     */
+    static constexpr uint32_t BLOCK_WORDS{4096};
+
+   private:
+    bool read_words(uint64_t position, uint32_t n, uint32_t* words);
+    bool parse(uint64_t position, vrt_header* header, vrt_fields* fields);
+    bool is_packet_start(uint64_t position);
+    bool next_timed_packet(uint64_t* position, uint64_t end, PacketTime* time, uint64_t* size);
+
+    const std::filesystem::path file_path_;
+    const bool                  do_byte_swap_;
+
+    std::ifstream         file_;
+    uint64_t              file_size_bytes_{0};
+    uint64_t              bytes_read_{0};
+    std::vector<uint32_t> block_;
+    uint64_t              block_position_{0};
+};
+
+}  // namespace vrt::common
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef LIB_COMMON_INCLUDE_COMMON_TIMESTAMP_H_
+#define LIB_COMMON_INCLUDE_COMMON_TIMESTAMP_H_
+
+#include <cstdint>
+
+struct vrt_packet;
+struct vrt_time;
+
+namespace vrt::common {
+
+/**
+ * Signed 128-bit integer, for times in picoseconds and intermediate products.
+ */
+__extension__ typedef __int128 Int128;
+
+/**
+ * Picoseconds per second.
+ */
+static constexpr uint64_t PS_PER_S{1000000000000};
+
+/**
+ * Timestamp of a packet, without the rest of it.
+ */
+struct Timestamp {
+    uint64_t fractional{0}; /**< Fractional seconds timestamp. */
+    uint32_t integer{0};    /**< Integer seconds timestamp. */
+    uint8_t  tsi{0};        /**< Integer seconds timestamp type, as vrt_tsi. */
+    uint8_t  tsf{0};        /**< Fractional seconds timestamp type, as vrt_tsf. */
+
+    Timestamp() = default;
+    explicit Timestamp(const vrt_packet& packet);
+};
+
+/**
+ * Timestamp converted to an exact number of seconds, numerator / denominator, so that it can be compared and
+ * subtracted without looking at timestamp types again, and without rounding errors accumulating.
+ *
+ * Real time timestamps are in picoseconds. Sample count and free running count timestamps are in units of 1/1000
+ * sample, which is exact for any sample rate with at most three decimals. If the sample rate isn't known, these are
+ * only ordered by their integer and fractional parts, and can't be subtracted.
+ */
+class TimeKey {
+   public:
+    TimeKey() = default;  // No timestamp
+    TimeKey(const Timestamp& timestamp, double sample_rate);
+    TimeKey(const vrt_packet& packet, double sample_rate) : TimeKey(Timestamp(packet), sample_rate) {}
+
+    static TimeKey from_picoseconds(Int128 ps, const Timestamp& timestamp);
+
+    /**
+     * \return True if packet has a timestamp.
+     */
+    bool is_valid() const { return tsi_ != 0 || tsf_ != 0; }
+
+    /**
+     * \return True if time can be converted to seconds, i.e. sample rate is known if needed.
+     */
+    bool is_exact() const { return is_valid() && denominator_ != 0; }
+
+    bool operator<(const TimeKey& other) const;
+    bool operator==(const TimeKey& other) const;
+    bool operator!=(const TimeKey& other) const { return !(*this == other); }
+
+    Int128 picoseconds() const;
+
+    /**
+     * Fraction of a sample, in which count timestamps with known sample rate are expressed.
+     */
+    static constexpr uint64_t SAMPLE_FRACTION{1000};
+
+   private:
+    Int128   numerator_{0};   /**< Time in units, or integer and fractional parts if denominator is unknown. */
+    uint64_t denominator_{0}; /**< Units per second, or 0 if unknown. */
+    uint32_t integer_{0};     /**< Integer seconds timestamp. */
+    uint8_t  tsi_{0};         /**< Integer seconds timestamp type, as vrt_tsi. */
+    uint8_t  tsf_{0};         /**< Fractional seconds timestamp type, as vrt_tsf. */
+
+    friend bool time_difference(const TimeKey& a, const TimeKey& b, Int128* diff);
+};
+
+bool   time_difference(const TimeKey& a, const TimeKey& b, Int128* diff);
+Int128 divide_round(Int128 n, Int128 d);
+void   to_vrt_time(Int128 ps, vrt_time* t);
+double to_seconds(Int128 ps);
+
+}  // namespace vrt::common
+
+#endif
@@ -0,0 +1,48 @@
+#include "common/counter_random.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include "common/packet_hash.h"
+
+namespace vrt::common {
+
+/**
+ * Constructor. Bits of the seed are mixed, so that nearby seeds give unrelated sequences.
+ *
+ * \param seed Seed.
+ */
+CounterRandom::CounterRandom(uint64_t seed) : key_{mix_bits(seed)} {}
+
+/**
+ * Draw a batch of numbers in [0, 1). The loop has no dependencies between iterations, so the compiler can vectorize
+ * it.
+ *
+ * \param counter Index of first number.
+ * \param values  Numbers (out) [n].
+ * \param n       Number of numbers.
+ */
+void CounterRandom::uniform(uint64_t counter, double* values, size_t n) const {
+    for (size_t i{0}; i < n; ++i) {
+        values[i] = uniform(counter + i);
+    }
+}
+
+/**
+ * Get seed from program arguments, or a random one if none is given.
+ *
+ * \param has_seed If a seed is given.
+ * \param seed     Seed given.
+ *
+ * \return Seed.
+ */
+uint64_t get_seed(bool has_seed, uint64_t seed) {
+    if (has_seed) {
+        return seed;
+    }
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32U) | rd();
+}
+
+}  // namespace vrt::common
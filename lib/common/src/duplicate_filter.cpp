@@ -0,0 +1,116 @@
+#include "common/duplicate_filter.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "vrt/vrt_types.h"
+
+#include "common/packet_hash.h"
+#include "common/stream_id.h"
+#include "common/timestamp.h"
+
+namespace vrt::common {
+
+/**
+ * Compare entries.
+ *
+ * \param other Other entry.
+ *
+ * \return True if packets are identical.
+ */
+bool DuplicateFilter::Entry::operator==(const Entry& other) const {
+    return hash == other.hash && words == other.words && packet_count == other.packet_count && id == other.id &&
+           time.integer == other.time.integer && time.fractional == other.time.fractional &&
+           time.tsi == other.time.tsi && time.tsf == other.time.tsf;
+}
+
+/**
+ * Constructor.
+ *
+ * \param window_ps Time window [ps]. Packets that are more than this earlier than the latest one are forgotten.
+ */
+DuplicateFilter::DuplicateFilter(uint64_t window_ps) : window_ps_{window_ps} {}
+
+/**
+ * Check if a packet is identical to one within the window, and remember it if not. Packets without timestamp are
+ * never duplicates, since there is no window to remember them in.
+ *
+ * \param id           Stream of packet.
+ * \param time         Timestamp of packet.
+ * \param packet_count Packet count of packet.
+ * \param buf          Non-byte swapped packet words [words].
+ * \param words        Packet size [words].
+ *
+ * \return True if duplicate.
+ */
+bool DuplicateFilter::is_duplicate(const StreamId&  id,
+                                   const Timestamp& time,
+                                   uint8_t          packet_count,
+                                   const uint32_t*  buf,
+                                   uint16_t         words) {
+    if (time.tsi == VRT_TSI_NONE && time.tsf == VRT_TSF_NONE) {
+        return false;
+    }
+    Entry entry;
+    entry.id           = id;
+    entry.time         = time;
+    entry.hash         = hash_words(buf, words);
+    entry.words        = words;
+    entry.packet_count = packet_count;
+
+    if (entries_.count(entry) != 0) {
+        n_duplicates_++;
+        return true;
+    }
+
+    TimeKey key(entry.time, 0.0);
+    if (order_.empty() || key_latest_ < key) {
+        latest_     = entry.time;
+        key_latest_ = key;
+    }
+    entries_.insert(entry);
+    order_.push({key, entry});
+
+    // Forget packets outside window, earliest first
+    while (!order_.empty() && is_outside_window(order_.top().entry.time)) {
+        entries_.erase(order_.top().entry);
+        order_.pop();
+    }
+
+    return false;
+}
+
+/**
+ * Check if a packet is identical to one within the window, and remember it if not.
+ *
+ * \param packet Packet.
+ * \param buf    Non-byte swapped packet words [packet.header.packet_size].
+ *
+ * \return True if duplicate.
+ */
+bool DuplicateFilter::is_duplicate(const vrt_packet& packet, const uint32_t* buf) {
+    return is_duplicate(StreamId(packet), Timestamp(packet), packet.header.packet_count, buf,
+                        packet.header.packet_size);
+}
+
+/**
+ * Check if a time is earlier than the window before the latest time. Times that can't be subtracted, since the
+ * sample rate isn't known, are compared by integer seconds, with the window rounded up to whole seconds.
+ *
+ * \param time Time.
+ *
+ * \return True if so.
+ */
+bool DuplicateFilter::is_outside_window(const Timestamp& time) const {
+    Int128 diff;
+    if (time_difference(key_latest_, TimeKey(time, 0.0), &diff)) {
+        return diff > window_ps_;
+    }
+    if (time.tsi != latest_.tsi) {
+        return true;
+    }
+    uint64_t window_s{(window_ps_ + PS_PER_S - 1) / PS_PER_S};
+    return latest_.integer > time.integer && latest_.integer - time.integer > window_s;
+}
+
+}  // namespace vrt::common
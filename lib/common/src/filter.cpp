@@ -0,0 +1,629 @@
+#include "common/filter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "vrt/vrt_types.h"
+#include "vrt/vrt_util.h"
+
+#include "common/input_stream.h"
+
+namespace vrt::common {
+
+using Field       = Filter::Field;
+using Compare     = Filter::Compare;
+using Instruction = Filter::Instruction;
+using Op          = Filter::Instruction::Op;
+
+/**
+ * Named constant of a field.
+ */
+struct Symbol {
+    const char* name;
+    uint64_t    value;
+};
+
+/**
+ * Description of a field that can be used in expressions.
+ */
+struct FieldInfo {
+    const char*         name;
+    Field               field;
+    bool                is_header;  // If available from header alone
+    bool                is_float;   // If floating point, otherwise integer
+    std::vector<Symbol> symbols;    // Named constants
+};
+
+static const std::vector<Symbol> SYMBOLS_BOOL{{"false", 0}, {"true", 1}};
+
+/**
+ * Fields. Some have several names, where the long ones are the same as the keys in vrt_print.
+ */
+static const std::vector<FieldInfo> FIELDS{
+    {"type", Field::TYPE, true, false, {{"data", 0}, {"ext_data", 1}, {"context", 2}, {"ext_context", 3}}},
+    {"packet_type",
+     Field::PACKET_TYPE,
+     true,
+     false,
+     {{"if_data_without_stream_id", VRT_PT_IF_DATA_WITHOUT_STREAM_ID},
+      {"if_data_with_stream_id", VRT_PT_IF_DATA_WITH_STREAM_ID},
+      {"ext_data_without_stream_id", VRT_PT_EXT_DATA_WITHOUT_STREAM_ID},
+      {"ext_data_with_stream_id", VRT_PT_EXT_DATA_WITH_STREAM_ID},
+      {"if_context", VRT_PT_IF_CONTEXT},
+      {"ext_context", VRT_PT_EXT_CONTEXT}}},
+    {"has_stream_id", Field::HAS_STREAM_ID, true, false, SYMBOLS_BOOL},
+    {"has_class_id", Field::HAS_CLASS_ID, true, false, SYMBOLS_BOOL},
+    {"has_trailer", Field::HAS_TRAILER, true, false, SYMBOLS_BOOL},
+    {"tsm", Field::TSM, true, false, {{"fine", VRT_TSM_FINE}, {"coarse", VRT_TSM_COARSE}}},
+    {"tsi_type",
+     Field::TSI_TYPE,
+     true,
+     false,
+     {{"none", VRT_TSI_NONE}, {"utc", VRT_TSI_UTC}, {"gps", VRT_TSI_GPS}, {"other", VRT_TSI_OTHER}}},
+    {"tsf_type",
+     Field::TSF_TYPE,
+     true,
+     false,
+     {{"none", VRT_TSF_NONE},
+      {"sample_count", VRT_TSF_SAMPLE_COUNT},
+      {"real_time", VRT_TSF_REAL_TIME},
+      {"free_running_count", VRT_TSF_FREE_RUNNING_COUNT}}},
+    {"packet_count", Field::PACKET_COUNT, true, false, {}},
+    {"packet_size", Field::PACKET_SIZE, true, false, {}},
+    {"stream_id", Field::STREAM_ID, false, false, {}},
+    {"oui", Field::OUI, false, false, {}},
+    {"class_id.oui", Field::OUI, false, false, {}},
+    {"icc", Field::INFORMATION_CLASS_CODE, false, false, {}},
+    {"class_id.information_class_code", Field::INFORMATION_CLASS_CODE, false, false, {}},
+    {"pcc", Field::PACKET_CLASS_CODE, false, false, {}},
+    {"class_id.packet_class_code", Field::PACKET_CLASS_CODE, false, false, {}},
+    {"tsi", Field::INTEGER_SECONDS_TIMESTAMP, false, false, {}},
+    {"integer_seconds_timestamp", Field::INTEGER_SECONDS_TIMESTAMP, false, false, {}},
+    {"tsf", Field::FRACTIONAL_SECONDS_TIMESTAMP, false, false, {}},
+    {"fractional_seconds_timestamp", Field::FRACTIONAL_SECONDS_TIMESTAMP, false, false, {}},
+    {"body_size", Field::BODY_SIZE, false, false, {}},
+    {"bandwidth", Field::BANDWIDTH, false, true, {}},
+    {"if_reference_frequency", Field::IF_REFERENCE_FREQUENCY, false, true, {}},
+    {"rf_reference_frequency", Field::RF_REFERENCE_FREQUENCY, false, true, {}},
+    {"sample_rate", Field::SAMPLE_RATE, false, true, {}},
+    {"calibrated_time", Field::CALIBRATED_TIME, false, false, SYMBOLS_BOOL},
+    {"valid_data", Field::VALID_DATA, false, false, SYMBOLS_BOOL},
+    {"reference_lock", Field::REFERENCE_LOCK, false, false, SYMBOLS_BOOL},
+    {"detected_signal", Field::DETECTED_SIGNAL, false, false, SYMBOLS_BOOL},
+    {"spectral_inversion", Field::SPECTRAL_INVERSION, false, false, SYMBOLS_BOOL},
+    {"over_range", Field::OVER_RANGE, false, false, SYMBOLS_BOOL},
+    {"sample_loss", Field::SAMPLE_LOSS, false, false, SYMBOLS_BOOL}};
+
+/**
+ * Get value of an integer field.
+ *
+ * \param p     Packet.
+ * \param field Field.
+ * \param value Field value (out).
+ *
+ * \return True if the packet has the field.
+ */
+static bool GetInt(const vrt_packet& p, Field field, uint64_t* value) {
+    const auto& t{p.trailer};
+    switch (field) {
+        case Field::TYPE:
+            switch (p.header.packet_type) {
+                case VRT_PT_IF_DATA_WITHOUT_STREAM_ID:
+                case VRT_PT_IF_DATA_WITH_STREAM_ID:
+                    *value = 0;
+                    break;
+                case VRT_PT_EXT_DATA_WITHOUT_STREAM_ID:
+                case VRT_PT_EXT_DATA_WITH_STREAM_ID:
+                    *value = 1;
+                    break;
+                case VRT_PT_IF_CONTEXT:
+                    *value = 2;
+                    break;
+                case VRT_PT_EXT_CONTEXT:
+                default:
+                    *value = 3;
+                    break;
+            }
+            return true;
+        case Field::PACKET_TYPE:
+            *value = p.header.packet_type;
+            return true;
+        case Field::HAS_STREAM_ID:
+            *value = vrt_has_stream_id(&p.header) ? 1 : 0;
+            return true;
+        case Field::HAS_CLASS_ID:
+            *value = p.header.has.class_id ? 1 : 0;
+            return true;
+        case Field::HAS_TRAILER:
+            *value = p.header.has.trailer ? 1 : 0;
+            return true;
+        case Field::TSM:
+            *value = p.header.tsm;
+            return true;
+        case Field::TSI_TYPE:
+            *value = p.header.tsi;
+            return true;
+        case Field::TSF_TYPE:
+            *value = p.header.tsf;
+            return true;
+        case Field::PACKET_COUNT:
+            *value = p.header.packet_count;
+            return true;
+        case Field::PACKET_SIZE:
+            *value = p.header.packet_size;
+            return true;
+        case Field::STREAM_ID:
+            *value = p.fields.stream_id;
+            return vrt_has_stream_id(&p.header);
+        case Field::OUI:
+            *value = p.fields.class_id.oui;
+            return p.header.has.class_id;
+        case Field::INFORMATION_CLASS_CODE:
+            *value = p.fields.class_id.information_class_code;
+            return p.header.has.class_id;
+        case Field::PACKET_CLASS_CODE:
+            *value = p.fields.class_id.packet_class_code;
+            return p.header.has.class_id;
+        case Field::INTEGER_SECONDS_TIMESTAMP:
+            *value = p.fields.integer_seconds_timestamp;
+            return p.header.tsi != VRT_TSI_NONE;
+        case Field::FRACTIONAL_SECONDS_TIMESTAMP:
+            *value = p.fields.fractional_seconds_timestamp;
+            return p.header.tsf != VRT_TSF_NONE;
+        case Field::BODY_SIZE:
+            *value = static_cast<uint64_t>(p.words_body);
+            return true;
+        case Field::CALIBRATED_TIME:
+            *value = t.calibrated_time ? 1 : 0;
+            return p.header.has.trailer && t.has.calibrated_time;
+        case Field::VALID_DATA:
+            *value = t.valid_data ? 1 : 0;
+            return p.header.has.trailer && t.has.valid_data;
+        case Field::REFERENCE_LOCK:
+            *value = t.reference_lock ? 1 : 0;
+            return p.header.has.trailer && t.has.reference_lock;
+        case Field::DETECTED_SIGNAL:
+            *value = t.detected_signal ? 1 : 0;
+            return p.header.has.trailer && t.has.detected_signal;
+        case Field::SPECTRAL_INVERSION:
+            *value = t.spectral_inversion ? 1 : 0;
+            return p.header.has.trailer && t.has.spectral_inversion;
+        case Field::OVER_RANGE:
+            *value = t.over_range ? 1 : 0;
+            return p.header.has.trailer && t.has.over_range;
+        case Field::SAMPLE_LOSS:
+            *value = t.sample_loss ? 1 : 0;
+            return p.header.has.trailer && t.has.sample_loss;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Get value of a floating point field.
+ *
+ * \param p     Packet.
+ * \param field Field.
+ * \param value Field value (out).
+ *
+ * \return True if the packet has the field.
+ */
+static bool GetFloat(const vrt_packet& p, Field field, double* value) {
+    if (p.header.packet_type != VRT_PT_IF_CONTEXT) {
+        return false;
+    }
+    const auto& c{p.if_context};
+    switch (field) {
+        case Field::BANDWIDTH:
+            *value = c.bandwidth;
+            return c.has.bandwidth;
+        case Field::IF_REFERENCE_FREQUENCY:
+            *value = c.if_reference_frequency;
+            return c.has.if_reference_frequency;
+        case Field::RF_REFERENCE_FREQUENCY:
+            *value = c.rf_reference_frequency;
+            return c.has.rf_reference_frequency;
+        case Field::SAMPLE_RATE:
+            *value = c.sample_rate;
+            return c.has.sample_rate;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Compare two values.
+ *
+ * \param a       Left hand side.
+ * \param compare Comparison operator.
+ * \param b       Right hand side.
+ *
+ * \return Comparison result.
+ */
+template <typename T>
+static bool Apply(T a, Compare compare, T b) {
+    switch (compare) {
+        case Compare::EQ:
+            return a == b;
+        case Compare::NE:
+            return a != b;
+        case Compare::LT:
+            return a < b;
+        case Compare::LE:
+            return a <= b;
+        case Compare::GT:
+            return a > b;
+        case Compare::GE:
+        default:
+            return a >= b;
+    }
+}
+
+/**
+ * Check if character can be part of a field name or constant.
+ *
+ * \param c Character.
+ *
+ * \return True if so.
+ */
+static bool IsWordChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_' || c == '.' || c == '+' || c == '-';
+}
+
+/**
+ * Recursive descent parser, which emits instructions in postfix order.
+ */
+class Parser {
+   public:
+    explicit Parser(const std::string& expression) : expr_{expression} {}
+
+    /**
+     * Parse whole expression.
+     *
+     * \param program          Program to append instructions to (out).
+     * \param is_header_only   Set to false if any field needs more than the header (out).
+     *
+     * \throw std::runtime_error On syntax error.
+     */
+    void parse(std::vector<Instruction>* program, bool* is_header_only) {
+        program_        = program;
+        is_header_only_ = is_header_only;
+        parse_or();
+        skip_space();
+        if (pos_ != expr_.size()) {
+            fail("Unexpected '" + std::string(peek_word()) + "'");
+        }
+    }
+
+   private:
+    void parse_or() {
+        parse_and();
+        while (accept("||")) {
+            parse_and();
+            program_->push_back({Op::OR});
+        }
+    }
+
+    void parse_and() {
+        parse_unary();
+        while (accept("&&")) {
+            parse_unary();
+            program_->push_back({Op::AND});
+        }
+    }
+
+    void parse_unary() {
+        if (accept("!")) {
+            enter();
+            parse_unary();
+            program_->push_back({Op::NOT});
+            nesting_--;
+        } else if (accept("(")) {
+            enter();
+            parse_or();
+            if (!accept(")")) {
+                fail("Expected ')'");
+            }
+            nesting_--;
+        } else {
+            parse_comparison();
+        }
+    }
+
+    /**
+     * Enter nested expression. Limits recursion, so that long runs of '(' or '!' don't overflow the stack.
+     *
+     * \throw std::runtime_error If too deeply nested.
+     */
+    void enter() {
+        if (++nesting_ > Filter::MAX_DEPTH) {
+            throw std::runtime_error("Filter expression is too deeply nested");
+        }
+    }
+
+    void parse_comparison() {
+        skip_space();
+        size_t           field_pos{pos_};
+        std::string_view name{read_word()};
+        if (name.empty()) {
+            fail(pos_ == expr_.size() ? "Unexpected end of expression" : "Expected field name");
+        }
+        auto info{std::find_if(FIELDS.begin(), FIELDS.end(), [&](const FieldInfo& f) { return name == f.name; })};
+        if (info == FIELDS.end()) {
+            pos_ = field_pos;
+            fail("Unknown field '" + std::string(name) + "'");
+        }
+        if (!info->is_header) {
+            *is_header_only_ = false;
+        }
+
+        Instruction ins{Op::COMPARE, info->field};
+        if (accept("==")) {
+            ins.compare = Compare::EQ;
+        } else if (accept("!=")) {
+            ins.compare = Compare::NE;
+        } else if (accept("<=")) {
+            ins.compare = Compare::LE;
+        } else if (accept(">=")) {
+            ins.compare = Compare::GE;
+        } else if (accept("<")) {
+            ins.compare = Compare::LT;
+        } else if (accept(">")) {
+            ins.compare = Compare::GT;
+        } else {
+            // Field on its own
+            ins.op = Op::TEST;
+            program_->push_back(ins);
+            return;
+        }
+
+        skip_space();
+        size_t           value_pos{pos_};
+        std::string_view value{read_word()};
+        if (value.empty()) {
+            fail("Expected value");
+        }
+        if (!parse_value(*info, value, &ins)) {
+            pos_ = value_pos;
+            fail("Invalid value '" + std::string(value) + "' for field '" + info->name + "'");
+        }
+        program_->push_back(ins);
+    }
+
+    /**
+     * Parse constant for a field. Integers may be decimal, or hexadecimal with 0x prefix. Floating point values may
+     * have an SI suffix, e.g. 10M.
+     *
+     * \param info  Field.
+     * \param value Constant text.
+     * \param ins   Instruction to store constant in (out).
+     *
+     * \return False if invalid.
+     */
+    static bool parse_value(const FieldInfo& info, std::string_view value, Instruction* ins) {
+        for (const Symbol& symbol : info.symbols) {
+            if (value == symbol.name) {
+                ins->value_int = symbol.value;
+                return true;
+            }
+        }
+
+        std::string s(value);
+        errno = 0;
+        char* end{nullptr};
+        if (info.is_float) {
+            ins->value_float = std::strtod(s.c_str(), &end);
+            // Unit suffix only after a number
+            if (end != s.c_str() && *end != '\0' && *(end + 1) == '\0') {
+                switch (*end) {
+                    case 'k':
+                        ins->value_float *= 1e3;
+                        ++end;
+                        break;
+                    case 'M':
+                        ins->value_float *= 1e6;
+                        ++end;
+                        break;
+                    case 'G':
+                        ins->value_float *= 1e9;
+                        ++end;
+                        break;
+                    default:
+                        break;
+                }
+            }
+        } else {
+            if (!std::isdigit(static_cast<unsigned char>(s.front()))) {
+                return false;
+            }
+            bool is_hex{s.size() > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')};
+            ins->value_int = std::strtoull(s.c_str(), &end, is_hex ? 16 : 10);
+        }
+        return end != s.c_str() && *end == '\0' && errno == 0;
+    }
+
+    [[noreturn]] void fail(const std::string& msg) const {
+        std::stringstream ss;
+        ss << "Invalid filter expression at position " << pos_ << ": " << msg;
+        throw std::runtime_error(ss.str());
+    }
+
+    void skip_space() {
+        while (pos_ < expr_.size() && std::isspace(static_cast<unsigned char>(expr_[pos_])) != 0) {
+            ++pos_;
+        }
+    }
+
+    bool accept(std::string_view token) {
+        skip_space();
+        if (expr_.compare(pos_, token.size(), token) != 0) {
+            return false;
+        }
+        pos_ += token.size();
+        return true;
+    }
+
+    std::string_view peek_word() const {
+        size_t end{pos_};
+        while (end < expr_.size() && IsWordChar(expr_[end])) {
+            ++end;
+        }
+        return std::string_view(expr_).substr(pos_, std::max(end - pos_, static_cast<size_t>(1)));
+    }
+
+    std::string_view read_word() {
+        size_t begin{pos_};
+        while (pos_ < expr_.size() && IsWordChar(expr_[pos_])) {
+            ++pos_;
+        }
+        return std::string_view(expr_).substr(begin, pos_ - begin);
+    }
+
+    const std::string&        expr_;
+    size_t                    pos_{0};
+    std::vector<Instruction>* program_{nullptr};
+    bool*                     is_header_only_{nullptr};
+    size_t                    nesting_{0};
+};
+
+/**
+ * Constructor. Compile filter expression.
+ *
+ * \param expression Filter expression. Empty matches every packet.
+ *
+ * \throw std::runtime_error On syntax error.
+ */
+Filter::Filter(const std::string& expression) {
+    if (std::all_of(expression.begin(), expression.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; })) {
+        return;
+    }
+
+    Parser(expression).parse(&program_, &is_header_only_);
+
+    // Ensure evaluation stack is large enough
+    size_t depth{0};
+    for (const Instruction& ins : program_) {
+        if (ins.op == Op::TEST || ins.op == Op::COMPARE) {
+            if (++depth > MAX_DEPTH) {
+                throw std::runtime_error("Filter expression is too deeply nested");
+            }
+        } else if (ins.op != Op::NOT) {
+            depth--;
+        }
+    }
+}
+
+/**
+ * Check if packet matches filter. If the filter is header only, only the packet header needs to be valid.
+ *
+ * \param packet Packet.
+ *
+ * \return True if packet matches.
+ */
+bool Filter::matches(const vrt_packet& packet) const {
+    bool   stack[MAX_DEPTH];
+    size_t n{0};
+    for (const Instruction& ins : program_) {
+        switch (ins.op) {
+            case Op::TEST: {
+                uint64_t value_int{0};
+                double   value_float{0.0};
+                stack[n++] = GetInt(packet, ins.field, &value_int) ? value_int != 0
+                                                                     : GetFloat(packet, ins.field, &value_float) &&
+                                                                           value_float != 0.0;
+                break;
+            }
+            case Op::COMPARE: {
+                uint64_t value_int{0};
+                double   value_float{0.0};
+                if (GetInt(packet, ins.field, &value_int)) {
+                    stack[n++] = Apply(value_int, ins.compare, ins.value_int);
+                } else if (GetFloat(packet, ins.field, &value_float)) {
+                    stack[n++] = Apply(value_float, ins.compare, ins.value_float);
+                } else {
+                    stack[n++] = false;
+                }
+                break;
+            }
+            case Op::AND:
+                n--;
+                stack[n - 1] = stack[n - 1] && stack[n];
+                break;
+            case Op::OR:
+                n--;
+                stack[n - 1] = stack[n - 1] || stack[n];
+                break;
+            case Op::NOT:
+                stack[n - 1] = !stack[n - 1];
+                break;
+        }
+    }
+    return n == 0 || stack[0];
+}
+
+/**
+ * Read remainder of a packet whose header has just been read with InputStream::read_next_header(), if it matches the
+ * filter, or skip it otherwise. Non-matching packets are only parsed if the filter needs more than the header.
+ *
+ * \param filter       Filter.
+ * \param input_stream Input stream.
+ * \param is_match     Set to true if packet matches and has been read (out).
+ *
+ * \return False if End Of File in the middle of the packet.
+ *
+ * \throw std::runtime_error On read or parse error.
+ */
+bool read_remainder_if_match(const Filter& filter, InputStream* input_stream, bool* is_match) {
+    if (filter.is_header_only()) {
+        *is_match = filter.matches(*input_stream->get_packet());
+        return *is_match ? input_stream->read_remainder() : input_stream->skip_remainder();
+    }
+    if (!input_stream->read_remainder()) {
+        *is_match = false;
+        return false;
+    }
+    *is_match = filter.matches(*input_stream->get_packet());
+    return true;
+}
+
+/**
+ * Read next packet that matches filter, skipping packets that don't.
+ *
+ * \param filter       Filter.
+ * \param input_stream Input stream.
+ * \param n_packets    Incremented for every packet gone through, including the matching one (in/out).
+ *
+ * \return False if End Of File.
+ *
+ * \throw std::runtime_error On read or parse error.
+ */
+bool read_next_matching_packet(const Filter& filter, InputStream* input_stream, uint64_t* n_packets) {
+    if (filter.empty()) {
+        if (!input_stream->read_next_packet()) {
+            return false;
+        }
+        (*n_packets)++;
+        return true;
+    }
+    for (;;) {
+        bool is_match{false};
+        if (!input_stream->read_next_header() || !read_remainder_if_match(filter, input_stream, &is_match)) {
+            return false;
+        }
+        (*n_packets)++;
+        if (is_match) {
+            return true;
+        }
+    }
+}
+
+}  // namespace vrt::common
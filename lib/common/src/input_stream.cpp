@@ -28,11 +28,12 @@ namespace fs = ::std::filesystem;
  * \param file_path    Path to file.
  * \param do_byte_swap True if byte swap before parsing.
  * \param do_validate  True if packets shall be validated.
+ * \param do_warn      True if warnings about packets shall be printed.
  *
  * \throw std::runtime_error On read or parse error.
  */
-InputStream::InputStream(fs::path file_path, bool do_byte_swap, bool do_validate)
-    : file_path_{std::move(file_path)}, do_byte_swap_{do_byte_swap}, do_validate_{do_validate} {
+InputStream::InputStream(fs::path file_path, bool do_byte_swap, bool do_validate, bool do_warn)
+    : file_path_{std::move(file_path)}, do_byte_swap_{do_byte_swap}, do_validate_{do_validate}, do_warn_{do_warn} {
     file_.exceptions(std::ios::badbit | std::ios::failbit | std::ios::eofbit);
 
     // Open file for reading at end so file size is available
@@ -75,10 +76,29 @@ InputStream::InputStream(fs::path file_path, bool do_byte_swap, bool do_validate
  * \throw std::runtime_error On read or parse error.
  */
 bool InputStream::read_next_packet() {
-    if (!read_parse_header()) {
-        return false;
-    }
+    return read_parse_header() && read_remainder();
+}
 
+/**
+ * Read only the header of the next packet in stream. Must be followed by either read_remainder() or skip_remainder()
+ * before reading the next packet. Only the header of the packet from get_packet() is valid until then.
+ *
+ * \return False if End Of File.
+ *
+ * \throw std::runtime_error On read or parse error.
+ */
+bool InputStream::read_next_header() {
+    return read_parse_header();
+}
+
+/**
+ * Read and parse the remainder of a packet whose header was read with read_next_header().
+ *
+ * \return False if End Of File in the middle of the packet.
+ *
+ * \throw std::runtime_error On read or parse error.
+ */
+bool InputStream::read_remainder() {
     // Enlarge read buffer for the next section if needed
     if (buf_.size() < packet_->header.packet_size) {
         buf_.resize(packet_->header.packet_size);
@@ -92,7 +112,9 @@ bool InputStream::read_next_packet() {
     } catch (const std::ios::failure&) {
         if (file_.eof()) {
             // Just a warning. Mark as EOF.
-            std::cerr << "Warning: End of file in middle of packet #" << pkt_idx_ << '\n';
+            if (do_warn_) {
+                std::cerr << "Warning: End of file in middle of packet #" << pkt_idx_ << '\n';
+            }
             return false;
         }
         std::stringstream ss;
@@ -123,8 +145,10 @@ bool InputStream::read_next_packet() {
         // Never any error here, since buffer size is sufficient
         vrt_read_fields(&packet_->header, buf_byte_swap_.data() + VRT_WORDS_HEADER,
                         buf_byte_swap_.size() - VRT_WORDS_HEADER, &packet_->fields, false);
-        std::cerr << "Warning: Packet #" << pkt_idx_ << " in " << file_path_
-                  << ": Failed to validate fields section: " << vrt_string_error(words_fields);
+        if (do_warn_) {
+            std::cerr << "Warning: Packet #" << pkt_idx_ << " in " << file_path_
+                      << ": Failed to validate fields section: " << vrt_string_error(words_fields);
+        }
     }
 
     // Parse IF context, if any
@@ -144,8 +168,10 @@ bool InputStream::read_next_packet() {
             // Never any error here, since buffer size is sufficient
             vrt_read_if_context(buf_byte_swap_.data() + words_header_fields,
                                 buf_byte_swap_.size() - words_header_fields, &packet_->if_context, false);
-            std::cerr << "Warning: Packet #" << pkt_idx_ << " in " << file_path_
-                      << ": Failed to validate IF context: " << vrt_string_error(words_if_context);
+            if (do_warn_) {
+                std::cerr << "Warning: Packet #" << pkt_idx_ << " in " << file_path_
+                          << ": Failed to validate IF context: " << vrt_string_error(words_if_context);
+            }
         }
     }
 
@@ -165,8 +191,10 @@ bool InputStream::read_next_packet() {
             // Never any error here, since buffer size is sufficient
             vrt_read_trailer(buf_byte_swap_.data() + packet_->header.packet_size - 1,
                              buf_byte_swap_.size() - (packet_->header.packet_size - 1), &packet_->trailer);
-            std::cerr << "Warning: Packet #" << pkt_idx_ << " in " << file_path_
-                      << ": Failed to validate trailer: " << vrt_string_error(words_trailer);
+            if (do_warn_) {
+                std::cerr << "Warning: Packet #" << pkt_idx_ << " in " << file_path_
+                          << ": Failed to validate trailer: " << vrt_string_error(words_trailer);
+            }
         }
     }
 
@@ -181,7 +209,9 @@ bool InputStream::read_next_packet() {
 
         packet_->words_body = 0;
         packet_->body       = nullptr;
-        std::cerr << "Warning: Packet #" << pkt_idx_ << " in " << file_path_ << ": Body is a negative size";
+        if (do_warn_) {
+            std::cerr << "Warning: Packet #" << pkt_idx_ << " in " << file_path_ << ": Body is a negative size";
+        }
     } else {
         packet_->body = buf_.data() + VRT_WORDS_HEADER + words_fields;
     }
@@ -191,6 +221,84 @@ bool InputStream::read_next_packet() {
     return true;
 }
 
+/**
+ * Read and parse only the fields section of a packet whose header was read with read_next_header(), and skip the rest
+ * of it. Only the header and fields section of the packet from get_packet() are valid after this. Faster than
+ * read_remainder() when only e.g. Stream IDs or timestamps are needed.
+ *
+ * \return False if End Of File in the middle of the packet.
+ *
+ * \throw std::runtime_error On read or parse error.
+ */
+bool InputStream::read_fields() {
+    int32_t words_fields{vrt_words_fields(&packet_->header)};
+    if (VRT_WORDS_HEADER + words_fields > packet_->header.packet_size) {
+        if (do_validate_) {
+            std::stringstream ss;
+            ss << "Packet #" << pkt_idx_ << " in " << file_path_ << ": Fields section is larger than packet";
+            throw std::runtime_error(ss.str());
+        }
+        if (do_warn_) {
+            std::cerr << "Warning: Packet #" << pkt_idx_ << " in " << file_path_
+                      << ": Fields section is larger than packet";
+        }
+        packet_->fields = vrt_fields();
+        return skip_remainder();
+    }
+
+    // Enlarge read buffer for fields section if needed
+    if (buf_.size() < static_cast<size_t>(VRT_WORDS_HEADER + words_fields)) {
+        buf_.resize(VRT_WORDS_HEADER + words_fields);
+        buf_byte_swap_.resize(VRT_WORDS_HEADER + words_fields);
+    }
+
+    // Read fields section and skip the rest
+    try {
+        file_.read(reinterpret_cast<char*>(buf_.data() + VRT_WORDS_HEADER), sizeof(uint32_t) * words_fields);
+        file_.ignore(static_cast<std::streamsize>(sizeof(uint32_t) *
+                                                  (packet_->header.packet_size - VRT_WORDS_HEADER - words_fields)));
+    } catch (const std::ios::failure&) {
+        if (file_.eof()) {
+            if (do_warn_) {
+                std::cerr << "Warning: End of file in middle of packet #" << pkt_idx_ << '\n';
+            }
+            return false;
+        }
+        std::stringstream ss;
+        ss << "Packet #" << pkt_idx_ << " in " << file_path_ << ": Failed to read remainder of packet";
+        throw std::runtime_error(ss.str());
+    }
+
+    // Byte swap fields section
+    for (int32_t j{VRT_WORDS_HEADER}; j < VRT_WORDS_HEADER + words_fields; ++j) {
+        buf_byte_swap_[j] = do_byte_swap_ ? bswap_32(buf_[j]) : buf_[j];
+    }
+
+    // Parse and validate fields section
+    int32_t rv{vrt_read_fields(&packet_->header, buf_byte_swap_.data() + VRT_WORDS_HEADER, words_fields,
+                               &packet_->fields, true)};
+    if (rv < 0) {
+        if (do_validate_) {
+            std::stringstream ss;
+            ss << "Packet #" << pkt_idx_ << " in " << file_path_
+               << ": Failed to parse fields section: " << vrt_string_error(rv);
+            throw std::runtime_error(ss.str());
+        }
+
+        // Never any error here, since buffer size is sufficient
+        vrt_read_fields(&packet_->header, buf_byte_swap_.data() + VRT_WORDS_HEADER, words_fields, &packet_->fields,
+                        false);
+        if (do_warn_) {
+            std::cerr << "Warning: Packet #" << pkt_idx_ << " in " << file_path_
+                      << ": Failed to validate fields section: " << vrt_string_error(rv);
+        }
+    }
+
+    pkt_idx_++;
+
+    return true;
+}
+
 /**
  * Skip next packet in stream. More efficient than reading it.
  *
@@ -217,6 +325,35 @@ bool InputStream::skip_next_packet() {
     return true;
 }
 
+/**
+ * Skip the remainder of a packet whose header was read with read_next_header(), without parsing it. Unlike
+ * skip_next_packet(), this reads through the file buffer instead of seeking, which is faster for the small packets
+ * where the parsing cost matters.
+ *
+ * \return False if End Of File in the middle of the packet.
+ *
+ * \throw std::runtime_error On read error.
+ */
+bool InputStream::skip_remainder() {
+    try {
+        file_.ignore(static_cast<std::streamsize>(sizeof(uint32_t) * (packet_->header.packet_size - VRT_WORDS_HEADER)));
+    } catch (const std::ios::failure&) {
+        if (file_.eof()) {
+            if (do_warn_) {
+                std::cerr << "Warning: End of file in middle of packet #" << pkt_idx_ << '\n';
+            }
+            return false;
+        }
+        std::stringstream ss;
+        ss << "Packet #" << pkt_idx_ << " in " << file_path_ << ": Failed to read remainder of packet";
+        throw std::runtime_error(ss.str());
+    }
+
+    pkt_idx_++;
+
+    return true;
+}
+
 /**
  * Reset input stream from start.
  */
@@ -225,6 +362,43 @@ void InputStream::reset() {
     file_.seekg(0);
 }
 
+/**
+ * Get current position in file, i.e. where the next packet starts.
+ *
+ * \return Position [B].
+ *
+ * \throw std::runtime_error On error.
+ */
+std::streampos InputStream::tell() {
+    try {
+        return file_.tellg();
+    } catch (const std::ios::failure&) {
+        std::stringstream ss;
+        ss << "Failed to get position in file " << file_path_;
+        throw std::runtime_error(ss.str());
+    }
+}
+
+/**
+ * Continue reading from a packet in the middle of the stream.
+ *
+ * \param position  Position of packet start in file [B].
+ * \param pkt_idx   Index of packet in stream, used in messages.
+ *
+ * \throw std::runtime_error On seek error.
+ */
+void InputStream::seek(std::streampos position, uint64_t pkt_idx) {
+    file_.clear();
+    try {
+        file_.seekg(position);
+    } catch (const std::ios::failure&) {
+        std::stringstream ss;
+        ss << "Failed to seek in file " << file_path_;
+        throw std::runtime_error(ss.str());
+    }
+    pkt_idx_ = pkt_idx;
+}
+
 /**
  * Skip next packet in stream. More efficient than reading it.
  *
@@ -265,8 +439,10 @@ bool InputStream::read_parse_header() {
 
         // Never any error here, since buffer size is sufficient
         vrt_read_header(buf_byte_swap_.data(), buf_byte_swap_.size(), &packet_->header, false);
-        std::cerr << "Warning: Packet #" << pkt_idx_ << " in " << file_path_
-                  << ": Failed to validate header: " << vrt_string_error(words_header);
+        if (do_warn_) {
+            std::cerr << "Warning: Packet #" << pkt_idx_ << " in " << file_path_
+                      << ": Failed to validate header: " << vrt_string_error(words_header);
+        }
     }
 
     // No infinite loops thank you
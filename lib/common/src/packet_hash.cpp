@@ -0,0 +1,70 @@
+#include "common/packet_hash.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vrt::common {
+
+/**
+ * Rotate bits left.
+ *
+ * \param x Value.
+ * \param r Number of bits, in [1, 63].
+ *
+ * \return Rotated value.
+ */
+static uint64_t RotateLeft(uint64_t x, unsigned r) {
+    return (x << r) | (x >> (64U - r));
+}
+
+/**
+ * Mix bits so that every input bit affects every output bit, with the finalizer of MurmurHash3.
+ *
+ * \param h Value.
+ *
+ * \return Mixed value.
+ */
+uint64_t mix_bits(uint64_t h) {
+    h ^= h >> 33U;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33U;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33U;
+    return h;
+}
+
+/**
+ * Fast non-cryptographic 64-bit hash of words, e.g. a packet, with the mixing steps of MurmurHash3.
+ * Words are hashed two at a time.
+ *
+ * \param words Words [n].
+ * \param n     Number of words.
+ *
+ * \return Hash.
+ */
+uint64_t hash_words(const uint32_t* words, size_t n) {
+    const uint64_t c1{0x87C37B91114253D5ULL};
+    const uint64_t c2{0x4CF5AD432745937FULL};
+
+    uint64_t h{0x9E3779B97F4A7C15ULL ^ n};
+    size_t   i{0};
+    for (; i + 1 < n; i += 2) {
+        uint64_t k{static_cast<uint64_t>(words[i]) | (static_cast<uint64_t>(words[i + 1]) << 32U)};
+        k *= c1;
+        k = RotateLeft(k, 31);
+        k *= c2;
+        h ^= k;
+        h = RotateLeft(h, 27) * 5 + 0x52DCE729;
+    }
+    if (i < n) {
+        uint64_t k{words[i]};
+        k *= c1;
+        k = RotateLeft(k, 31);
+        k *= c2;
+        h ^= k;
+    }
+
+    return mix_bits(h ^ n);
+}
+
+}  // namespace vrt::common
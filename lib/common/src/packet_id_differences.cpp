@@ -4,7 +4,8 @@
 #include <vector>
 
 #include "vrt/vrt_types.h"
-#include "vrt/vrt_util.h"
+
+#include "common/stream_id.h"
 
 namespace vrt::common {
 
@@ -15,46 +16,62 @@ namespace vrt::common {
  * \return booleans describing packet differences.
  */
 PacketIdDiffs packet_id_differences(const std::vector<std::shared_ptr<vrt_packet>>& packets) {
-    // Pointers to previous packets
-    vrt_packet* prev_p{nullptr};    // Previous packet
-    vrt_packet* prev_cid{nullptr};  // Previous packet with Class ID
-    vrt_packet* prev_sid{nullptr};  // Previous packet with Stream ID
+    std::vector<StreamId> ids;
+    ids.reserve(packets.size());
+    for (const auto& p : packets) {
+        ids.emplace_back(*p);
+    }
+
+    return packet_id_differences(ids);
+}
+
+/**
+ * Find differences between streams.
+ *
+ * \param ids List of stream IDs.
+ * \return booleans describing stream differences.
+ */
+PacketIdDiffs packet_id_differences(const std::vector<StreamId>& ids) {
+    // Pointers to previous IDs
+    const StreamId* prev_p{nullptr};    // Previous ID
+    const StreamId* prev_cid{nullptr};  // Previous ID with Class ID
+    const StreamId* prev_sid{nullptr};  // Previous ID with Stream ID
 
     // Calculate
     PacketIdDiffs ret;
-    for (const auto& p : packets) {
+    for (const StreamId& p : ids) {
         if (prev_p != nullptr) {
-            if (p->header.has.class_id) {
+            if (p.has_class_id) {
                 ret.any_has_class_id = true;
             }
-            if (vrt_has_stream_id(&p->header)) {
+            if (p.has_stream_id) {
                 ret.any_has_stream_id = true;
             }
-            if (prev_cid != nullptr && p->header.has.class_id) {
-                if (p->fields.class_id.oui != prev_cid->fields.class_id.oui) {
+            if (prev_cid != nullptr && p.has_class_id) {
+                if (p.oui != prev_cid->oui) {
                     ret.diff_oui = true;
                 }
-                if (p->fields.class_id.information_class_code != prev_cid->fields.class_id.information_class_code) {
+                if (p.information_class_code != prev_cid->information_class_code) {
                     ret.diff_icc = true;
                 }
-                if (p->fields.class_id.packet_class_code != prev_cid->fields.class_id.packet_class_code) {
+                if (p.packet_class_code != prev_cid->packet_class_code) {
                     ret.diff_pcc = true;
                 }
             }
-            if (prev_sid != nullptr && vrt_has_stream_id(&p->header)) {
-                if (p->fields.stream_id != prev_sid->fields.stream_id) {
+            if (prev_sid != nullptr && p.has_stream_id) {
+                if (p.stream_id != prev_sid->stream_id) {
                     ret.diff_sid = true;
                 }
             }
         }
 
-        // Save pointers to previous packets
-        prev_p = p.get();
-        if (p->header.has.class_id) {
-            prev_cid = p.get();
+        // Save pointers to previous IDs
+        prev_p = &p;
+        if (p.has_class_id) {
+            prev_cid = &p;
         }
-        if (vrt_has_stream_id(&p->header)) {
-            prev_sid = p.get();
+        if (p.has_stream_id) {
+            prev_sid = &p;
         }
     }
 
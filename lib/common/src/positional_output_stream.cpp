@@ -0,0 +1,109 @@
+#include "common/positional_output_stream.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace vrt::common {
+
+namespace fs = ::std::filesystem;
+
+/**
+ * Constructor. Create file of the final size.
+ *
+ * \param file_path  Path to file.
+ * \param size_bytes File size [B].
+ *
+ * \throw std::runtime_error If file fails to be created.
+ */
+PositionalOutputStream::PositionalOutputStream(fs::path file_path, uint64_t size_bytes)
+    : file_path_{std::move(file_path)} {
+    fd_ = ::open(file_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        std::stringstream ss;
+        ss << "Failed to open output file " << file_path_ << ": " << std::strerror(errno);
+        throw std::runtime_error(ss.str());
+    }
+    if (::ftruncate(fd_, static_cast<off_t>(size_bytes)) != 0) {
+        std::stringstream ss;
+        ss << "Failed to set size of output file " << file_path_ << ": " << std::strerror(errno);
+        ::close(fd_);
+        fd_ = -1;
+        throw std::runtime_error(ss.str());
+    }
+}
+
+/**
+ * Destructor. Close file.
+ */
+PositionalOutputStream::~PositionalOutputStream() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+/**
+ * Write words at a position in file. Can be called from several threads at once, for regions that don't overlap.
+ *
+ * \param buf      Non-byte swapped words [words].
+ * \param words    Number of words.
+ * \param position Position in file [B].
+ *
+ * \throw std::runtime_error On write error.
+ */
+void PositionalOutputStream::write(const uint32_t* buf, size_t words, uint64_t position) {
+    const auto* data{reinterpret_cast<const char*>(buf)};
+    size_t      left{sizeof(uint32_t) * words};
+    while (left > 0) {
+        ssize_t n{::pwrite(fd_, data, left, static_cast<off_t>(position))};
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::stringstream ss;
+            ss << "Failed to write to output file " << file_path_ << ": " << std::strerror(errno);
+            throw std::runtime_error(ss.str());
+        }
+        data += n;
+        left -= static_cast<size_t>(n);
+        position += static_cast<uint64_t>(n);
+    }
+}
+
+/**
+ * Close file.
+ *
+ * \throw std::runtime_error On error.
+ */
+void PositionalOutputStream::close() {
+    int fd{fd_};
+    fd_ = -1;
+    if (fd >= 0 && ::close(fd) != 0) {
+        std::stringstream ss;
+        ss << "Failed to close output file " << file_path_ << ": " << std::strerror(errno);
+        throw std::runtime_error(ss.str());
+    }
+}
+
+/**
+ * Close and remove file.
+ */
+void PositionalOutputStream::remove_file() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    std::error_code ec;
+    fs::remove(file_path_, ec);
+}
+
+}  // namespace vrt::common
@@ -0,0 +1,82 @@
+#include "common/quantile_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace vrt::common {
+
+/**
+ * Bin boundaries grow by this factor.
+ */
+static constexpr double GAMMA{(1.0 + QuantileSketch::RELATIVE_ACCURACY) / (1.0 - QuantileSketch::RELATIVE_ACCURACY)};
+
+/**
+ * Constructor.
+ */
+QuantileSketch::QuantileSketch() : log_gamma_{std::log(GAMMA)} {}
+
+/**
+ * Add value. Negative values are counted as zero.
+ *
+ * \param value Value.
+ */
+void QuantileSketch::add(double value) {
+    if (value < MIN_VALUE) {
+        n_zero_++;
+    } else {
+        bins_[static_cast<int32_t>(std::ceil(std::log(value) / log_gamma_))]++;
+    }
+    count_++;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+/**
+ * Merge values of another sketch into this.
+ *
+ * \param other Other sketch.
+ */
+void QuantileSketch::merge(const QuantileSketch& other) {
+    for (const auto& bin : other.bins_) {
+        bins_[bin.first] += bin.second;
+    }
+    n_zero_ += other.n_zero_;
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+/**
+ * Estimate quantile.
+ *
+ * \param q Quantile, between 0 and 1.
+ *
+ * \return Estimated value, or NaN if sketch is empty.
+ */
+double QuantileSketch::quantile(double q) const {
+    if (count_ == 0) {
+        return std::nan("");
+    }
+
+    // Zero based rank of value to find
+    auto rank{static_cast<uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(count_ - 1))};
+    if (rank == count_ - 1) {
+        return max_;
+    }
+    uint64_t n{n_zero_};
+    if (rank < n) {
+        return std::max(min_, 0.0);
+    }
+    for (const auto& bin : bins_) {
+        n += bin.second;
+        if (rank < n) {
+            // Middle of bin, in a relative sense
+            double value{2.0 * std::exp(log_gamma_ * bin.first) / (GAMMA + 1.0)};
+            return std::clamp(value, min_, max_);
+        }
+    }
+    return max_;
+}
+
+}  // namespace vrt::common
@@ -0,0 +1,160 @@
+#include "common/sample_rate_timeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <tuple>
+
+#include "vrt/vrt_types.h"
+
+#include "common/timestamp.h"
+
+namespace vrt::common {
+
+/**
+ * Compare timestamps by their integer and fractional parts.
+ *
+ * \param a Timestamp a.
+ * \param b Timestamp b.
+ *
+ * \return True if a is before b.
+ */
+static bool IsBefore(const Timestamp& a, const Timestamp& b) {
+    return std::tie(a.integer, a.fractional) < std::tie(b.integer, b.fractional);
+}
+
+/**
+ * Check if timestamp is converted to time with a sample rate.
+ *
+ * \param time Timestamp.
+ *
+ * \return True if so.
+ */
+static bool IsCount(const Timestamp& time) {
+    return time.tsf == VRT_TSF_SAMPLE_COUNT || time.tsf == VRT_TSF_FREE_RUNNING_COUNT;
+}
+
+/**
+ * Start a new segment, if the sample rate changes. A segment that would start before the last one, since timestamps
+ * went backwards, starts with the last one instead.
+ *
+ * \param time        Timestamp of IF context packet with sample rate.
+ * \param sample_rate Sample rate [Hz].
+ */
+void SampleRateTimeline::append(const Timestamp& time, double sample_rate) {
+    if (!segments_.empty()) {
+        Segment& last{segments_.back()};
+        if (sample_rate == last.sample_rate) {
+            return;
+        }
+        if (!IsBefore(last.start, time)) {
+            last.sample_rate = sample_rate;
+            return;
+        }
+    }
+
+    Segment segment;
+    segment.start       = time;
+    segment.sample_rate = sample_rate;
+    TimeKey start{key(time, &segment.depends_on_start)};
+    if (start.is_exact()) {
+        segment.start_ps     = start.picoseconds();
+        segment.has_start_ps = true;
+    }
+    segments_.push_back(segment);
+}
+
+/**
+ * Append timeline of a later part of the same stream, as if its sample rates had been passed to append().
+ *
+ * \param later Timeline of the part following this.
+ */
+void SampleRateTimeline::append(const SampleRateTimeline& later) {
+    for (const Segment& segment : later.segments_) {
+        append(segment.start, segment.sample_rate);
+    }
+}
+
+/**
+ * Find segment of a timestamp.
+ *
+ * \param time Timestamp.
+ *
+ * \return Last segment starting at or before time, or nullptr if there is none.
+ */
+const SampleRateTimeline::Segment* SampleRateTimeline::find(const Timestamp& time) const {
+    auto it{std::upper_bound(segments_.begin(), segments_.end(), time,
+                             [](const Timestamp& t, const Segment& s) { return IsBefore(t, s.start); })};
+    return it != segments_.begin() ? &*(it - 1) : nullptr;
+}
+
+/**
+ * Convert timestamp to time, with the sample rate in effect at it.
+ *
+ * \param time             Timestamp.
+ * \param depends_on_start Set to true if the time would differ with another initial sample rate (out). May be nullptr.
+ *
+ * \return Time.
+ */
+TimeKey SampleRateTimeline::key(const Timestamp& time, bool* depends_on_start) const {
+    bool depends{false};
+    if (depends_on_start == nullptr) {
+        depends_on_start = &depends;
+    }
+    *depends_on_start = false;
+
+    if (!IsCount(time)) {
+        return TimeKey(time, 0.0);
+    }
+    const Segment* segment{find(time)};
+    if (segment == nullptr) {
+        *depends_on_start = true;
+        return TimeKey(time, sample_rate_initial_);
+    }
+
+    // Sample counts restart every integer second, so later seconds only need the sample rate
+    const Timestamp& start{segment->start};
+    if (start.tsi != time.tsi || start.tsf != time.tsf ||
+        (time.tsf == VRT_TSF_SAMPLE_COUNT && time.tsi != VRT_TSI_NONE && time.integer != start.integer)) {
+        return TimeKey(time, segment->sample_rate);
+    }
+
+    *depends_on_start = segment->depends_on_start || !segment->has_start_ps;
+    auto units{static_cast<uint64_t>(std::llround(segment->sample_rate * TimeKey::SAMPLE_FRACTION))};
+    if (!segment->has_start_ps || !(segment->sample_rate > 0.0) || units == 0) {
+        return TimeKey(time, segment->sample_rate);
+    }
+
+    Int128 ps{segment->start_ps};
+    if (time.tsi != VRT_TSI_NONE) {
+        ps += (static_cast<Int128>(time.integer) - start.integer) * PS_PER_S;
+    }
+    ps += divide_round((static_cast<Int128>(time.fractional) - start.fractional) * TimeKey::SAMPLE_FRACTION * PS_PER_S,
+                       units);
+
+    return TimeKey::from_picoseconds(ps, time);
+}
+
+/**
+ * \param time Timestamp.
+ *
+ * \return Sample rate in effect at timestamp [Hz].
+ */
+double SampleRateTimeline::get_sample_rate(const Timestamp& time) const {
+    const Segment* segment{find(time)};
+    return segment != nullptr ? segment->sample_rate : sample_rate_initial_;
+}
+
+/**
+ * \return Timeline with only the last segment, which gives the same times as this after its start. Used as the start
+ *         of the timeline of a later part of the stream.
+ */
+SampleRateTimeline SampleRateTimeline::tail() const {
+    SampleRateTimeline timeline(get_sample_rate());
+    if (!segments_.empty()) {
+        timeline.segments_.push_back(segments_.back());
+    }
+    return timeline;
+}
+
+}  // namespace vrt::common
@@ -1,26 +1,128 @@
 #include "common/stream_history.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
 #include "vrt/vrt_types.h"
 
+#include "common/stream_id.h"
+#include "common/timestamp.h"
+
 namespace vrt::common {
 
 /**
- * Update stream history with new packet.
+ * Find stream.
+ *
+ * \param id Stream ID.
+ *
+ * \return Slot of stream, or NONE if there is none.
+ */
+size_t StreamHistory::find(const StreamId& id) const {
+    if (slot_last_ != NONE && ids_[slot_last_] == id) {
+        return slot_last_;
+    }
+    auto it{slots_.find(id)};
+    return it != slots_.end() ? it->second : NONE;
+}
+
+/**
+ * Add stream without packets.
+ *
+ * \param id       Stream ID, that isn't already added.
+ * \param timeline Sample rates of stream so far, e.g. only an initial sample rate until an IF context packet has one.
+ *
+ * \return Slot of stream.
+ */
+size_t StreamHistory::add(const StreamId& id, const SampleRateTimeline& timeline) {
+    size_t slot{ids_.size()};
+    slots_.emplace(id, slot);
+    ids_.push_back(id);
+    current_.emplace_back();
+    time_first_.emplace_back();
+    timelines_.push_back(timeline);
+    slot_last_ = slot;
+
+    return slot;
+}
+
+/**
+ * Update history of a stream with new packet.
+ *
+ * \param slot   Slot of stream.
+ * \param packet New packet.
+ */
+void StreamHistory::update(size_t slot, const vrt_packet& packet) {
+    Current& current{current_[slot]};
+    current.time = Timestamp(packet);
+    if (packet.header.packet_type == VRT_PT_IF_CONTEXT && packet.if_context.has.sample_rate) {
+        // Earlier timestamps keep the sample rate they had
+        timelines_[slot].append(current.time, packet.if_context.sample_rate);
+    }
+
+    if (current.n_packets == 0) {
+        time_first_[slot] = current.time;
+    }
+    current.n_packets++;
+    slot_last_ = slot;
+}
+
+/**
+ * Update history of the stream of a packet with it, and add the stream if it is new.
  *
  * \param packet New packet.
+ *
+ * \return Slot of stream.
  */
-void StreamHistory::update(const std::shared_ptr<vrt_packet>& packet) {
-    if (packet->header.packet_type == VRT_PT_IF_CONTEXT && packet->if_context.has.sample_rate) {
-        // Overwrite previous sample rate, perhaps from command line
-        sample_rate_ = packet->if_context.sample_rate;
+size_t StreamHistory::update(const vrt_packet& packet) {
+    StreamId id(packet);
+    size_t   slot{find(id)};
+    if (slot == NONE) {
+        slot = add(id);
     }
+    update(slot, packet);
+
+    return slot;
+}
+
+/**
+ * Merge history of a later part of the same streams into this, as if its packets had been passed to update(). Streams
+ * that are new are added in the order of their slots in later.
+ *
+ * \param later History of the packets following the ones in this history.
+ */
+void StreamHistory::merge(const StreamHistory& later) {
+    for (size_t slot_later{0}; slot_later < later.size(); ++slot_later) {
+        const Current& current_later{later.current_[slot_later]};
+        size_t         slot{find(later.ids_[slot_later])};
+        if (slot == NONE) {
+            slot = add(later.ids_[slot_later], later.timelines_[slot_later]);
+        } else {
+            timelines_[slot].append(later.timelines_[slot_later]);
+        }
+        if (current_later.n_packets == 0) {
+            continue;
+        }
 
-    if (packet_first_ == nullptr) {
-        packet_first_ = packet;
+        Current& current{current_[slot]};
+        if (current.n_packets == 0) {
+            time_first_[slot] = later.time_first_[slot_later];
+        }
+        current.time = current_later.time;
+        current.n_packets += current_later.n_packets;
     }
-    packet_cur_ = packet;
+}
+
+/**
+ * \return Slots of streams, ordered by stream ID.
+ */
+std::vector<size_t> StreamHistory::get_slots_sorted() const {
+    std::vector<size_t> slots(ids_.size());
+    std::iota(slots.begin(), slots.end(), 0);
+    std::sort(slots.begin(), slots.end(), [this](size_t a, size_t b) { return ids_[a] < ids_[b]; });
 
-    n_packets_++;
+    return slots;
 }
 
 }  // namespace vrt::common
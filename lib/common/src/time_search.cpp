@@ -0,0 +1,324 @@
+#include "common/time_search.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "vrt/vrt_read.h"
+#include "vrt/vrt_types.h"
+#include "vrt/vrt_words.h"
+
+#include "common/byte_swap.h"
+
+namespace vrt::common {
+
+namespace fs = ::std::filesystem;
+
+/**
+ * Maximum size of header and fields section [words].
+ */
+static constexpr uint32_t MAX_WORDS_HEADER_FIELDS{7};
+
+/**
+ * Constructor. Open input file for reading.
+ *
+ * \param file_path    Path to file.
+ * \param do_byte_swap True if byte swap before parsing.
+ *
+ * \throw std::runtime_error If file fails to open.
+ */
+TimeSearch::TimeSearch(fs::path file_path, bool do_byte_swap)
+    : file_path_{std::move(file_path)}, do_byte_swap_{do_byte_swap} {
+    // Reads are small and scattered, so buffering would only read more than needed
+    file_.rdbuf()->pubsetbuf(nullptr, 0);
+    file_.open(file_path_, std::ios::in | std::ios::binary);
+    if (!file_) {
+        std::stringstream ss;
+        ss << "Failed to open input file " << file_path_;
+        throw std::runtime_error(ss.str());
+    }
+
+    try {
+        file_size_bytes_ = fs::file_size(file_path_);
+    } catch (const fs::filesystem_error&) {
+        std::stringstream ss;
+        ss << "Failed to get size of file " << file_path_;
+        throw std::runtime_error(ss.str());
+    }
+}
+
+/**
+ * Get time of first packet with a timestamp.
+ *
+ * \param time Packet time (out).
+ *
+ * \return False if no packet has a timestamp.
+ *
+ * \throw std::runtime_error On read error.
+ */
+bool TimeSearch::first_time(PacketTime* time) {
+    uint64_t position{0};
+    uint64_t size{0};
+    return next_timed_packet(&position, file_size_bytes_, time, &size);
+}
+
+/**
+ * Find first packet with a timestamp that is not before a time.
+ *
+ * \param time Time.
+ *
+ * \return Position of packet in file [B], or file size if there is none.
+ *
+ * \throw std::runtime_error On read error.
+ */
+uint64_t TimeSearch::find(const PacketTime& time) {
+    // Every packet starting before lo is before time. lo is always a packet start.
+    uint64_t lo{0};
+    uint64_t hi{file_size_bytes_};
+    while (lo < hi && hi - lo > LINEAR_BYTES) {
+        uint64_t mid{(lo + (hi - lo) / 2) & ~static_cast<uint64_t>(3)};
+        uint64_t position{resync(mid)};
+
+        // The first packet after resynchronizing may be a false positive inside a packet, which happens to end where
+        // a packet starts, so skip it
+        vrt_header header;
+        vrt_fields fields;
+        if (position < hi && parse(position, &header, &fields)) {
+            position += sizeof(uint32_t) * header.packet_size;
+        }
+
+        PacketTime t;
+        uint64_t   size{0};
+        if (!next_timed_packet(&position, hi, &t, &size)) {
+            hi = mid;
+        } else if (t < time) {
+            lo = position + size;
+        } else {
+            hi = mid;
+        }
+    }
+
+    // Linear scan from the last packet known to be before time
+    uint64_t   position{lo};
+    PacketTime t;
+    uint64_t   size{0};
+    while (next_timed_packet(&position, file_size_bytes_, &t, &size)) {
+        if (!(t < time)) {
+            return position;
+        }
+        position += size;
+    }
+    return file_size_bytes_;
+}
+
+/**
+ * Find the first packet start at or after a position. A position is accepted if it's followed by a chain of valid
+ * packet headers, so it may be inside a packet if the data there happens to look like a header. The following packets
+ * are then correct though.
+ *
+ * \param position Position in file [B].
+ *
+ * \return Position of packet start [B], or file size if there is none.
+ *
+ * \throw std::runtime_error On read error.
+ */
+uint64_t TimeSearch::resync(uint64_t position) {
+    // Packets are always word aligned
+    position = (position + 3) & ~static_cast<uint64_t>(3);
+
+    while (position < file_size_bytes_) {
+        // Read block to scan
+        auto n{static_cast<uint32_t>(
+            std::min<uint64_t>(BLOCK_WORDS, (file_size_bytes_ - position) / sizeof(uint32_t)))};
+        if (n == 0) {
+            break;
+        }
+        block_.clear();
+        std::vector<uint32_t> block(n);
+        if (!read_words(position, n, block.data())) {
+            break;
+        }
+        block_          = std::move(block);
+        block_position_ = position;
+
+        for (uint32_t i{0}; i < n; ++i) {
+            if (is_packet_start(position + sizeof(uint32_t) * i)) {
+                return position + sizeof(uint32_t) * i;
+            }
+        }
+        position += sizeof(uint32_t) * n;
+    }
+
+    return file_size_bytes_;
+}
+
+/**
+ * Find the end of the last complete packet. This is the file size, unless the file ends with a partial packet or with
+ * data that isn't packets. Only the end of the file is read, from a packet start found by resynchronizing, or from the
+ * start of the file if it's small.
+ *
+ * \return Position after last complete packet [B].
+ *
+ * \throw std::runtime_error On read error.
+ */
+uint64_t TimeSearch::find_end() {
+    // A partial packet at the end breaks the chain of packets when resynchronizing, so search further back until a
+    // packet start is found
+    uint64_t position{0};
+    for (uint64_t tail{LINEAR_BYTES}; tail < file_size_bytes_; tail *= 2) {
+        position = resync(file_size_bytes_ - tail);
+        if (position < file_size_bytes_) {
+            break;
+        }
+        position = 0;
+    }
+
+    while (position < file_size_bytes_) {
+        vrt_header header;
+        vrt_fields fields;
+        if (!parse(position, &header, &fields) ||
+            sizeof(uint32_t) * static_cast<uint64_t>(header.packet_size) > file_size_bytes_ - position) {
+            break;
+        }
+        position += sizeof(uint32_t) * header.packet_size;
+    }
+
+    return position;
+}
+
+/**
+ * Read words from file, or from the last scanned block if it contains them.
+ *
+ * \param position Position in file [B].
+ * \param n        Number of words.
+ * \param words    Buffer [n] (out).
+ *
+ * \return False if the words are not in the file.
+ *
+ * \throw std::runtime_error On read error.
+ */
+bool TimeSearch::read_words(uint64_t position, uint32_t n, uint32_t* words) {
+    uint64_t bytes{sizeof(uint32_t) * static_cast<uint64_t>(n)};
+    if (position >= block_position_ && position + bytes <= block_position_ + sizeof(uint32_t) * block_.size()) {
+        std::copy_n(block_.data() + (position - block_position_) / sizeof(uint32_t), n, words);
+        return true;
+    }
+    if (position + bytes > file_size_bytes_) {
+        return false;
+    }
+
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(position));
+    file_.read(reinterpret_cast<char*>(words), static_cast<std::streamsize>(bytes));
+    if (!file_) {
+        std::stringstream ss;
+        ss << "Failed to read from file " << file_path_ << " at position " << position;
+        throw std::runtime_error(ss.str());
+    }
+    bytes_read_ += bytes;
+
+    return true;
+}
+
+/**
+ * Parse and validate header and fields section of a packet.
+ *
+ * \param position Position of packet in file [B].
+ * \param header   Header (out).
+ * \param fields   Fields section (out).
+ *
+ * \return False if there is no valid packet at position.
+ *
+ * \throw std::runtime_error On read error.
+ */
+bool TimeSearch::parse(uint64_t position, vrt_header* header, vrt_fields* fields) {
+    std::array<uint32_t, MAX_WORDS_HEADER_FIELDS> buf{};
+
+    auto n{static_cast<uint32_t>(
+        std::min<uint64_t>(MAX_WORDS_HEADER_FIELDS, (file_size_bytes_ - position) / sizeof(uint32_t)))};
+    if (n < VRT_WORDS_HEADER || !read_words(position, n, buf.data())) {
+        return false;
+    }
+    if (do_byte_swap_) {
+        for (uint32_t i{0}; i < n; ++i) {
+            buf[i] = bswap_32(buf[i]);
+        }
+    }
+
+    if (vrt_read_header(buf.data(), n, header, true) < 0) {
+        return false;
+    }
+    int32_t words_fields{vrt_words_fields(header)};
+    if (words_fields < 0 || header->packet_size < VRT_WORDS_HEADER + static_cast<uint32_t>(words_fields) ||
+        n < VRT_WORDS_HEADER + static_cast<uint32_t>(words_fields)) {
+        return false;
+    }
+    return vrt_read_fields(header, buf.data() + VRT_WORDS_HEADER, n - VRT_WORDS_HEADER, fields, true) >= 0;
+}
+
+/**
+ * Check if a position is the start of a packet, by checking that it is followed by a chain of valid packets.
+ *
+ * \param position Position in file [B].
+ *
+ * \return True if so.
+ *
+ * \throw std::runtime_error On read error.
+ */
+bool TimeSearch::is_packet_start(uint64_t position) {
+    for (unsigned i{0}; i < CHAIN_PACKETS; ++i) {
+        if (position == file_size_bytes_) {
+            return i != 0;
+        }
+        vrt_header header;
+        vrt_fields fields;
+        if (!parse(position, &header, &fields)) {
+            return false;
+        }
+        position += sizeof(uint32_t) * header.packet_size;
+        if (position > file_size_bytes_) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Find the next packet with a timestamp, starting before end.
+ *
+ * \param position Position of packet start to search from. Set to position of found packet (in/out) [B].
+ * \param end      Position to stop searching at [B].
+ * \param time     Packet time (out).
+ * \param size     Packet size (out) [B].
+ *
+ * \return False if there is none.
+ *
+ * \throw std::runtime_error On read error.
+ */
+bool TimeSearch::next_timed_packet(uint64_t* position, uint64_t end, PacketTime* time, uint64_t* size) {
+    uint64_t p{*position};
+    while (p < end) {
+        vrt_header header;
+        vrt_fields fields;
+        if (!parse(p, &header, &fields)) {
+            p = resync(p + sizeof(uint32_t));
+            continue;
+        }
+        if (header.tsi != VRT_TSI_NONE) {
+            *position         = p;
+            time->seconds     = fields.integer_seconds_timestamp;
+            time->picoseconds = header.tsf == VRT_TSF_REAL_TIME ? fields.fractional_seconds_timestamp : 0;
+            *size             = sizeof(uint32_t) * header.packet_size;
+            return true;
+        }
+        p += sizeof(uint32_t) * header.packet_size;
+    }
+    return false;
+}
+
+}  // namespace vrt::common
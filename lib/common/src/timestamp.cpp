@@ -0,0 +1,191 @@
+#include "common/timestamp.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include "vrt/vrt_time.h"
+#include "vrt/vrt_types.h"
+
+namespace vrt::common {
+
+/**
+ * Constructor.
+ *
+ * \param packet Packet to get timestamp from.
+ */
+Timestamp::Timestamp(const vrt_packet& packet)
+    : fractional{packet.fields.fractional_seconds_timestamp},
+      integer{packet.fields.integer_seconds_timestamp},
+      tsi{static_cast<uint8_t>(packet.header.tsi)},
+      tsf{static_cast<uint8_t>(packet.header.tsf)} {}
+
+/**
+ * Constructor.
+ *
+ * \param timestamp   Timestamp.
+ * \param sample_rate Sample rate [Hz], for sample count and free running count timestamps. 0 if unknown.
+ */
+TimeKey::TimeKey(const Timestamp& timestamp, double sample_rate)
+    : integer_{timestamp.integer}, tsi_{timestamp.tsi}, tsf_{timestamp.tsf} {
+    Int128 integer{tsi_ != VRT_TSI_NONE ? timestamp.integer : 0};
+    switch (static_cast<vrt_tsf>(timestamp.tsf)) {
+        case VRT_TSF_NONE: {
+            numerator_   = integer;
+            denominator_ = 1;
+            break;
+        }
+        case VRT_TSF_REAL_TIME: {
+            numerator_   = integer * PS_PER_S + timestamp.fractional;
+            denominator_ = PS_PER_S;
+            break;
+        }
+        default: {
+            auto units{static_cast<uint64_t>(std::llround(sample_rate * SAMPLE_FRACTION))};
+            if (sample_rate > 0.0 && units != 0) {
+                numerator_   = integer * units + static_cast<Int128>(timestamp.fractional) * SAMPLE_FRACTION;
+                denominator_ = units;
+            } else {
+                numerator_   = (integer << 64U) + timestamp.fractional;
+                denominator_ = 0;
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * Create time from a number of picoseconds, e.g. when a count timestamp has been converted with more than one sample
+ * rate.
+ *
+ * \param ps        Time [ps].
+ * \param timestamp Timestamp that was converted, for its types and integer part.
+ *
+ * \return Time.
+ */
+TimeKey TimeKey::from_picoseconds(Int128 ps, const Timestamp& timestamp) {
+    TimeKey key;
+    key.numerator_   = ps;
+    key.denominator_ = PS_PER_S;
+    key.integer_     = timestamp.integer;
+    key.tsi_         = timestamp.tsi;
+    key.tsf_         = timestamp.tsf;
+
+    return key;
+}
+
+/**
+ * Compare times. Exact times are ordered by time, and times that aren't exact by their integer and fractional parts.
+ * Times that aren't exact can't be compared with exact ones, and are ordered before them. This is a strict weak
+ * ordering, so that times can be sorted or kept in a heap.
+ *
+ * \param other Other time.
+ *
+ * \return True if this is earlier than other.
+ */
+bool TimeKey::operator<(const TimeKey& other) const {
+    if (denominator_ == other.denominator_) {
+        return numerator_ < other.numerator_;
+    }
+    if (denominator_ == 0 || other.denominator_ == 0) {
+        return denominator_ == 0;
+    }
+    return numerator_ * other.denominator_ < other.numerator_ * denominator_;
+}
+
+/**
+ * Compare times.
+ *
+ * \param other Other time.
+ *
+ * \return True if times are equal.
+ */
+bool TimeKey::operator==(const TimeKey& other) const {
+    if (denominator_ == other.denominator_) {
+        return numerator_ == other.numerator_;
+    }
+    if (denominator_ == 0 || other.denominator_ == 0) {
+        return false;
+    }
+    return numerator_ * other.denominator_ == other.numerator_ * denominator_;
+}
+
+/**
+ * \return Time in picoseconds, rounded to nearest, or 0 if it isn't exact.
+ */
+Int128 TimeKey::picoseconds() const {
+    if (denominator_ == 0) {
+        return 0;
+    }
+    if (denominator_ == PS_PER_S) {
+        return numerator_;
+    }
+    return divide_round(numerator_ * PS_PER_S, denominator_);
+}
+
+/**
+ * Calculate time difference a - b.
+ *
+ * \param a    Time a.
+ * \param b    Time b.
+ * \param diff Difference, rounded to nearest [ps] (out).
+ *
+ * \return False if the difference can't be calculated, since a time is missing, timestamp types differ, or the sample
+ *         rate is unknown.
+ */
+bool time_difference(const TimeKey& a, const TimeKey& b, Int128* diff) {
+    if (!a.is_exact() || !b.is_exact() || a.tsi_ != b.tsi_ || a.tsf_ != b.tsf_) {
+        return false;
+    }
+    if (a.denominator_ == b.denominator_) {
+        // Round only once
+        *diff = a.denominator_ == PS_PER_S ? a.numerator_ - b.numerator_
+                                           : divide_round((a.numerator_ - b.numerator_) * PS_PER_S, a.denominator_);
+    } else {
+        *diff = a.picoseconds() - b.picoseconds();
+    }
+    return true;
+}
+
+/**
+ * Divide and round to nearest, with halves away from zero.
+ *
+ * \param n Numerator.
+ * \param d Denominator, positive.
+ *
+ * \return Rounded quotient.
+ */
+Int128 divide_round(Int128 n, Int128 d) {
+    return n >= 0 ? (n + d / 2) / d : -((-n + d / 2) / d);
+}
+
+/**
+ * Convert picoseconds to seconds and picoseconds.
+ *
+ * \param ps Time [ps].
+ * \param t  Time, with picoseconds between 0 and a second (out).
+ */
+void to_vrt_time(Int128 ps, vrt_time* t) {
+    Int128 s{ps / static_cast<Int128>(PS_PER_S)};
+    Int128 rem{ps % static_cast<Int128>(PS_PER_S)};
+    if (rem < 0) {
+        rem += PS_PER_S;
+        s--;
+    }
+    t->s  = static_cast<int64_t>(s);
+    t->ps = static_cast<int64_t>(rem);
+}
+
+/**
+ * Convert picoseconds to seconds.
+ *
+ * \param ps Time [ps].
+ *
+ * \return Time [s].
+ */
+double to_seconds(Int128 ps) {
+    vrt_time t;
+    to_vrt_time(ps, &t);
+    return static_cast<double>(t.s) + static_cast<double>(t.ps) / PS_PER_S;
+}
+
+}  // namespace vrt::common
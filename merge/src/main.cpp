@@ -1,7 +1,9 @@
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
+#include <map>
 #include <stdexcept>
+#include <string>
 
 #include "vrt/vrt_util.h"
 
@@ -42,6 +44,31 @@ static vrt::merge::ProgramArguments setup_arg_parse(CLI::App* app) {
     app->add_flag("-b,--byte-swap", args.do_byte_swap,
                   "Apply byte swap before parsing file. Note that this will NOT byte swap packet output.");
 
+    // Reorder window
+    app->add_option("-w,--reorder-window", args.reorder_window,
+                    "Fix packets that are out of order within a window in each input file, either a number of packets, "
+                    "e.g. 100, or a time, e.g. 10ms. Packets further out of order are counted and reported.");
+
+    // Jobs
+    CLI::Option* opt_jobs{app->add_option("-j,--jobs", args.n_jobs,
+                                          "Number of threads merging time partitions of the input files. 0 means one "
+                                          "per CPU core. Default is 1. Not used with --reorder-window or "
+                                          "--dedup.")};
+    opt_jobs->check(CLI::NonNegativeNumber);
+
+    // Duplicates
+    app->add_flag("-d,--dedup", args.do_dedup,
+                  "Remove packets identical to one already written, e.g. when merging captures of the same streams "
+                  "from redundant nodes.");
+    CLI::Option* opt_dedup_window{app->add_option(
+        "--dedup-window", args.dedup_window_s,
+        "Time window of --dedup [s], e.g. 100ms. Packets are compared with the ones at most this much earlier than "
+        "the latest one. Default is 1 s.")};
+    opt_dedup_window->check(CLI::NonNegativeNumber);
+    opt_dedup_window->transform(
+        CLI::AsNumberWithUnit(std::map<std::string, double>{{"s", 1.0}, {"ms", 1e-3}, {"us", 1e-6}, {"ns", 1e-9}},
+                              CLI::AsNumberWithUnit::CASE_SENSITIVE));
+
     return args;
 }
 
@@ -0,0 +1,361 @@
+#include "parallel_merge.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "vrt/vrt_types.h"
+
+#include "Progress-CPP/ProgressBar.hpp"
+#include "common/input_stream.h"
+#include "common/positional_output_stream.h"
+#include "common/timestamp.h"
+#include "program_arguments.h"
+
+namespace vrt::merge {
+
+namespace fs = ::std::filesystem;
+
+/**
+ * Number of packets between samples of the time in an input file.
+ */
+static constexpr uint64_t SAMPLE_INTERVAL{1024};
+
+/**
+ * Number of time partitions per thread, so that a thread that is done early can take on another one.
+ */
+static constexpr size_t PARTITIONS_PER_JOB{4};
+
+/**
+ * Size of output buffer of a partition [words].
+ */
+static constexpr size_t OUTPUT_BUFFER_WORDS{256 * 1024};
+
+/**
+ * Packet in input file, with its time.
+ */
+struct Sample {
+    uint64_t        position; /**< Position in file [B]. */
+    uint64_t        pkt_idx;  /**< Index in file. */
+    common::TimeKey key;      /**< Time. */
+};
+
+/**
+ * What is known about an input file after reading it once.
+ */
+struct InputIndex {
+    std::vector<Sample> samples;                /**< Every SAMPLE_INTERVAL:th packet. */
+    uint64_t            size_bytes{0};          /**< Size of the complete packets in file [B]. */
+    common::Timestamp   first;                  /**< Time of first packet, if any. */
+    bool                has_packets{false};     /**< If there is any packet. */
+    bool                can_partition{true};    /**< If packets are ordered by time, with the same timestamp types. */
+};
+
+/**
+ * Packet range of an input file, in a time partition.
+ */
+struct PartitionInput {
+    std::unique_ptr<common::InputStream> stream;        /**< Input stream, at the next packet. */
+    uint64_t                             position{0};   /**< Position of current packet [B]. */
+    uint64_t                             end{0};        /**< End of range [B]. */
+    common::TimeKey                      key;           /**< Time of current packet. */
+};
+
+/**
+ * Read input file once, and check if it can be split into time partitions.
+ *
+ * \param file_path    Input file path.
+ * \param do_byte_swap True if byte swap before parsing.
+ *
+ * \return Index of input file. Reading stops early if it can't be partitioned.
+ *
+ * \throw std::runtime_error On read or parse error.
+ */
+static InputIndex IndexInput(const fs::path& file_path, bool do_byte_swap) {
+    common::InputStream input_stream(file_path, do_byte_swap);
+    InputIndex          index;
+    common::TimeKey     key_prev;
+    for (uint64_t i{0}; input_stream.read_next_packet(); ++i) {
+        const vrt_packet& packet{*input_stream.get_packet()};
+        common::Timestamp time(packet);
+        common::TimeKey   key(time, 0.0);
+        if (i == 0) {
+            index.first       = time;
+            index.has_packets = true;
+        }
+        if (time.tsi == VRT_TSI_NONE || time.tsi != index.first.tsi || time.tsf != index.first.tsf ||
+            (i != 0 && key < key_prev)) {
+            index.can_partition = false;
+            break;
+        }
+        if (i % SAMPLE_INTERVAL == 0) {
+            index.samples.push_back(Sample{index.size_bytes, i, key});
+        }
+        key_prev = key;
+        index.size_bytes += sizeof(uint32_t) * packet.header.packet_size;
+    }
+
+    return index;
+}
+
+/**
+ * Find where time partitions start in an input file.
+ *
+ * \param file_path    Input file path.
+ * \param do_byte_swap True if byte swap before parsing.
+ * \param index        Index of input file.
+ * \param splits       Times where partitions start, except the first one. In order.
+ *
+ * \return Position of first packet in each partition, and then the end of file [B].
+ *
+ * \throw std::runtime_error On read or parse error.
+ */
+static std::vector<uint64_t> FindBoundaries(const fs::path&                     file_path,
+                                            bool                                do_byte_swap,
+                                            const InputIndex&                   index,
+                                            const std::vector<common::TimeKey>& splits) {
+    common::InputStream   input_stream(file_path, do_byte_swap, true, false);
+    std::vector<uint64_t> boundaries{0};
+    for (const common::TimeKey& split : splits) {
+        // Start at the last sample before the split, since packets up to the next sample can be before it too
+        auto it{std::lower_bound(index.samples.begin(), index.samples.end(), split,
+                                 [](const Sample& s, const common::TimeKey& k) { return s.key < k; })};
+        if (it == index.samples.begin()) {
+            boundaries.push_back(0);
+            continue;
+        }
+        --it;
+        uint64_t position{it->position};
+        input_stream.seek(static_cast<std::streampos>(position), it->pkt_idx);
+        while (position < index.size_bytes && input_stream.read_next_packet()) {
+            const vrt_packet& packet{*input_stream.get_packet()};
+            if (!(common::TimeKey(common::Timestamp(packet), 0.0) < split)) {
+                break;
+            }
+            position += sizeof(uint32_t) * packet.header.packet_size;
+        }
+        boundaries.push_back(std::min(position, index.size_bytes));
+    }
+    boundaries.push_back(index.size_bytes);
+
+    return boundaries;
+}
+
+/**
+ * Go to next packet in range of input file.
+ *
+ * \param input Input.
+ *
+ * \return False if there are no more packets in range.
+ *
+ * \throw std::runtime_error On read or parse error.
+ */
+static bool Next(PartitionInput* input) {
+    if (input->position >= input->end || !input->stream->read_next_packet()) {
+        return false;
+    }
+    input->key = common::TimeKey(common::Timestamp(*input->stream->get_packet()), 0.0);
+    return true;
+}
+
+/**
+ * Merge a time partition of all input files, and write it at its place in the output file.
+ *
+ * \param args       Program arguments.
+ * \param boundaries Partition boundaries of each input file.
+ * \param partition  Partition index.
+ * \param position   Position of partition in output file [B].
+ * \param output     Output file.
+ *
+ * \throw std::runtime_error On I/O error.
+ */
+static void MergePartition(const ProgramArguments&                   args,
+                           const std::vector<std::vector<uint64_t>>& boundaries,
+                           size_t                                    partition,
+                           uint64_t                                  position,
+                           common::PositionalOutputStream*           output) {
+    std::vector<PartitionInput> inputs(args.file_paths_in.size());
+
+    // Index of input with earliest packet is on top. Packets with the same time are taken from the first input, as
+    // when merging with one thread.
+    auto comparator{[&inputs](size_t a, size_t b) {
+        if (inputs[b].key < inputs[a].key) {
+            return true;
+        }
+        if (inputs[a].key < inputs[b].key) {
+            return false;
+        }
+        return a > b;
+    }};
+    std::priority_queue<size_t, std::vector<size_t>, decltype(comparator)> queue(comparator);
+    for (size_t i{0}; i < inputs.size(); ++i) {
+        PartitionInput& input{inputs[i]};
+        input.position = boundaries[i][partition];
+        input.end      = boundaries[i][partition + 1];
+        if (input.position < input.end) {
+            input.stream = std::make_unique<common::InputStream>(args.file_paths_in[i], args.do_byte_swap, true, false);
+            input.stream->seek(static_cast<std::streampos>(input.position), 0);
+            if (Next(&input)) {
+                queue.push(i);
+            }
+        }
+    }
+
+    std::vector<uint32_t> buf;
+    buf.reserve(OUTPUT_BUFFER_WORDS);
+    while (!queue.empty()) {
+        size_t i{queue.top()};
+        queue.pop();
+        PartitionInput& input{inputs[i]};
+
+        const std::vector<uint32_t>& packet_buf{input.stream->get_buffer()};
+        uint16_t                     words{input.stream->get_packet()->header.packet_size};
+        if (buf.size() + words > OUTPUT_BUFFER_WORDS && !buf.empty()) {
+            output->write(buf.data(), buf.size(), position);
+            position += sizeof(uint32_t) * buf.size();
+            buf.clear();
+        }
+        buf.insert(buf.end(), packet_buf.begin(), packet_buf.begin() + words);
+
+        input.position += sizeof(uint32_t) * words;
+        if (Next(&input)) {
+            queue.push(i);
+        }
+    }
+    output->write(buf.data(), buf.size(), position);
+}
+
+/**
+ * Merge input files in time partitions, each on its own thread. Input files are first read once, to check that they
+ * are ordered by time, and to sample times where to split them. Each partition is then merged into its own region of
+ * the output file. The output is the same as when merging with one thread.
+ *
+ * \param args   Program arguments.
+ * \param n_jobs Number of threads.
+ *
+ * \return False if input files can't be partitioned, since they aren't ordered by time, or have different timestamp
+ *         types. Nothing is written then.
+ *
+ * \throw std::runtime_error If there's an error.
+ */
+bool merge_parallel(const ProgramArguments& args, unsigned n_jobs) {
+    const size_t n_inputs{args.file_paths_in.size()};
+
+    // Index inputs in parallel
+    std::vector<InputIndex> indices(n_inputs);
+    {
+        std::deque<std::future<void>> indexing;
+        for (size_t i{0}; i < n_inputs; ++i) {
+            if (indexing.size() == n_jobs) {
+                indexing.front().get();
+                indexing.pop_front();
+            }
+            indexing.push_back(std::async(std::launch::async, [&args, &indices, i]() {
+                indices[i] = IndexInput(args.file_paths_in[i], args.do_byte_swap);
+            }));
+        }
+        for (std::future<void>& f : indexing) {
+            f.get();
+        }
+    }
+
+    // Check that inputs can be compared with each other by time only
+    const InputIndex* first{nullptr};
+    for (const InputIndex& index : indices) {
+        if (!index.can_partition) {
+            return false;
+        }
+        if (index.has_packets) {
+            if (first != nullptr && (index.first.tsi != first->first.tsi || index.first.tsf != first->first.tsf)) {
+                return false;
+            }
+            first = &index;
+        }
+    }
+
+    // Split at evenly spaced samples
+    std::vector<common::TimeKey> keys;
+    uint64_t                     size_bytes{0};
+    for (const InputIndex& index : indices) {
+        for (const Sample& sample : index.samples) {
+            keys.push_back(sample.key);
+        }
+        size_bytes += index.size_bytes;
+    }
+    std::sort(keys.begin(), keys.end());
+    size_t                       n_partitions{std::max<size_t>(std::min(PARTITIONS_PER_JOB * n_jobs, keys.size()), 1)};
+    std::vector<common::TimeKey> splits;
+    for (size_t p{1}; p < n_partitions; ++p) {
+        splits.push_back(keys[p * keys.size() / n_partitions]);
+    }
+
+    std::vector<std::vector<uint64_t>> boundaries(n_inputs);
+    {
+        std::deque<std::future<void>> finding;
+        for (size_t i{0}; i < n_inputs; ++i) {
+            if (finding.size() == n_jobs) {
+                finding.front().get();
+                finding.pop_front();
+            }
+            finding.push_back(std::async(std::launch::async, [&args, &indices, &splits, &boundaries, i]() {
+                boundaries[i] = FindBoundaries(args.file_paths_in[i], args.do_byte_swap, indices[i], splits);
+            }));
+        }
+        for (std::future<void>& f : finding) {
+            f.get();
+        }
+    }
+
+    common::PositionalOutputStream output(args.file_path_out, size_bytes);
+    progresscpp::ProgressBar       progress(size_bytes, 70);
+
+    std::deque<std::pair<std::future<void>, uint64_t>> merging;
+    try {
+        uint64_t position{0};
+        for (size_t p{0}; p < n_partitions; ++p) {
+            if (merging.size() == n_jobs) {
+                merging.front().first.get();
+                progress += merging.front().second;
+                progress.display();
+                merging.pop_front();
+            }
+
+            uint64_t partition_bytes{0};
+            for (size_t i{0}; i < n_inputs; ++i) {
+                partition_bytes += boundaries[i][p + 1] - boundaries[i][p];
+            }
+            merging.emplace_back(
+                std::async(std::launch::async, MergePartition, std::cref(args), std::cref(boundaries), p, position,
+                           &output),
+                partition_bytes);
+            position += partition_bytes;
+        }
+        while (!merging.empty()) {
+            merging.front().first.get();
+            progress += merging.front().second;
+            progress.display();
+            merging.pop_front();
+        }
+        output.close();
+
+        progress.done();
+    } catch (...) {
+        // Wait for threads still writing, then cleanup and rethrow
+        for (auto& m : merging) {
+            m.first.wait();
+        }
+        output.remove_file();
+        throw;
+    }
+
+    return true;
+}
+
+}  // namespace vrt::merge
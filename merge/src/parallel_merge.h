@@ -0,0 +1,12 @@
+#ifndef VRT_MERGE_SRC_PARALLEL_MERGE_H_
+#define VRT_MERGE_SRC_PARALLEL_MERGE_H_
+
+#include "program_arguments.h"
+
+namespace vrt::merge {
+
+bool merge_parallel(const ProgramArguments& args, unsigned n_jobs);
+
+}  // namespace vrt::merge
+
+#endif
@@ -1,27 +1,56 @@
 #include "process.h"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <iostream>
 #include <memory>
 #include <queue>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "vrt/vrt_string.h"
 #include "vrt/vrt_types.h"
 
 #include "Progress-CPP/ProgressBar.hpp"
+#include "common/duplicate_filter.h"
 #include "common/input_stream.h"
 #include "common/output_stream.h"
+#include "common/timestamp.h"
+#include "parallel_merge.h"
 #include "program_arguments.h"
+#include "reorder_buffer.h"
 
 namespace vrt::merge {
 
 // For convenience
-using InputStreamPtr = std::shared_ptr<common::InputStream>;
+using ReorderBufferPtr = std::shared_ptr<ReorderBuffer>;
+
+/**
+ * Input with the time of its current packet, which is converted once when the packet is read.
+ */
+struct QueueEntry {
+    ReorderBufferPtr  input;
+    size_t            index;
+    common::Timestamp time;
+    common::TimeKey   key;
+
+    /**
+     * Constructor.
+     *
+     * \param reorder_buffer Input with a current packet.
+     * \param input_index    Index of input, which orders packets with the same time.
+     */
+    QueueEntry(ReorderBufferPtr reorder_buffer, size_t input_index)
+        : input{std::move(reorder_buffer)}, index{input_index}, time{input->get().time}, key{input->get().key} {}
+};
 
 /**
  * Comparator for packets by time.
@@ -33,104 +62,172 @@ struct ComparatorTime {
      * \param a Packet 1.
      * \param b Packet 2.
      *
-     * \return True if a is later than b.
+     * \return True if a is later than b, or from a later input if they have the same time.
      */
-    bool operator()(const InputStreamPtr& a, const InputStreamPtr& b) const {
-        // Get headers and fields
-        const vrt_header& ah{a->get_packet()->header};
-        const vrt_header& bh{b->get_packet()->header};
-        const vrt_fields& af{a->get_packet()->fields};
-        const vrt_fields& bf{b->get_packet()->fields};
-
-        if (ah.tsi == VRT_TSI_NONE) {
+    bool operator()(const QueueEntry& a, const QueueEntry& b) const {
+        if (a.time.tsi == VRT_TSI_NONE) {
             std::stringstream ss;
-            ss << "Packet in " << a->get_file_path() << ": Integer second timestamp is NONE";
+            ss << "Packet in " << a.input->get_file_path() << ": Integer second timestamp is NONE";
             throw std::runtime_error(ss.str());
         }
 
-        if (ah.tsi != bh.tsi) {
+        if (a.time.tsi != b.time.tsi) {
             std::stringstream ss;
-            ss << "Cannot compare different Integer second timestamps (TSI) of " << vrt_string_tsi(ah.tsi) << " with "
-               << vrt_string_tsi(bh.tsi);
+            ss << "Cannot compare different Integer second timestamps (TSI) of "
+               << vrt_string_tsi(static_cast<vrt_tsi>(a.time.tsi)) << " with "
+               << vrt_string_tsi(static_cast<vrt_tsi>(b.time.tsi));
             throw std::runtime_error(ss.str());
         }
 
-        if (af.integer_seconds_timestamp < bf.integer_seconds_timestamp) {
-            return false;
-        }
-        if (af.integer_seconds_timestamp > bf.integer_seconds_timestamp) {
-            return true;
-        }
-
-        if (ah.tsf != bh.tsf) {
+        if (a.time.tsf != b.time.tsf) {
+            if (a.time.integer != b.time.integer) {
+                return a.time.integer > b.time.integer;
+            }
             std::stringstream ss;
-            ss << "Cannot compare different Fractional second timestamps (TSF) of " << vrt_string_tsf(ah.tsf)
-               << " with " << vrt_string_tsf(bh.tsf);
+            ss << "Cannot compare different Fractional second timestamps (TSF) of "
+               << vrt_string_tsf(static_cast<vrt_tsf>(a.time.tsf)) << " with "
+               << vrt_string_tsf(static_cast<vrt_tsf>(b.time.tsf));
             throw std::runtime_error(ss.str());
         }
 
-        if (ah.tsf == VRT_TSF_NONE) {
-            // Equality
+        if (b.key < a.key) {
+            return true;
+        }
+        if (a.key < b.key) {
             return false;
         }
+        return a.index > b.index;
+    }
+};
 
-        if (af.fractional_seconds_timestamp > bf.fractional_seconds_timestamp) {
-            return true;
-        }
+/**
+ * Parse reorder window.
+ *
+ * \param text           Number of packets, or time with a unit of s, ms, us or ns, e.g. 10ms. Empty if none.
+ * \param window_packets Number of packets (out).
+ * \param window_ps      Time [ps], or 0 if window is a number of packets (out).
+ *
+ * \throw std::runtime_error If text is invalid.
+ */
+static void ParseReorderWindow(const std::string& text, uint64_t* window_packets, uint64_t* window_ps) {
+    *window_packets = 0;
+    *window_ps      = 0;
+    if (text.empty()) {
+        return;
+    }
 
-        // a <= b
-        return false;
+    const std::array<std::pair<std::string, double>, 4> units{
+        {{"s", 1e12}, {"ms", 1e9}, {"us", 1e6}, {"ns", 1e3}}};
+    try {
+        size_t      n{0};
+        double      value{std::stod(text, &n)};
+        std::string unit{text.substr(n)};
+        if (unit.empty() && text.find_first_not_of("0123456789") == std::string::npos) {
+            *window_packets = std::stoull(text);
+            return;
+        }
+        for (const auto& u : units) {
+            if (unit == u.first && value >= 0.0) {
+                *window_ps = static_cast<uint64_t>(std::llround(value * u.second));
+                return;
+            }
+        }
+    } catch (const std::logic_error&) {
+        // Invalid below
     }
-};
+
+    std::stringstream ss;
+    ss << "Invalid reorder window '" << text << "'. Use a number of packets, or a time such as 10ms.";
+    throw std::runtime_error(ss.str());
+}
 
 /**
- * Process file contents.
+ * Process file contents. Each input is read through a reorder buffer, which fixes packets that are out of order within
+ * the reorder window, before inputs are merged. Packets identical to one already written within the dedup window, e.g.
+ * from redundant captures of the same stream, are optionally dropped. With more than one job, and neither reorder
+ * window nor dedup, inputs are merged in time partitions in parallel instead, if they are ordered by time. Packets
+ * with the same time are taken from inputs in order either way.
  *
  * \param args Program arguments.
  *
  * \throw std::runtime_error If there's an error.
  */
 void process(const ProgramArguments& args) {
+    uint64_t window_packets{0};
+    uint64_t window_ps{0};
+    ParseReorderWindow(args.reorder_window, &window_packets, &window_ps);
+
+    unsigned n_jobs{args.n_jobs != 0 ? args.n_jobs : std::max(std::thread::hardware_concurrency(), 1U)};
+    if (n_jobs > 1 && args.reorder_window.empty() && !args.do_dedup) {
+        if (merge_parallel(args, n_jobs)) {
+            return;
+        }
+        std::cerr << "Warning: Input files are not ordered by time, or have different timestamp types. Merging with "
+                     "one thread."
+                  << std::endl;
+    }
+
     common::OutputStream output_stream(args.file_path_out);
 
     // Earliest element is on top
-    std::priority_queue<InputStreamPtr, std::vector<InputStreamPtr>, ComparatorTime> input_stream_queue;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, ComparatorTime> input_stream_queue;
 
     // Start by filling queue
-    std::streampos total_file_size_bytes{0};
+    std::streampos                total_file_size_bytes{0};
+    std::vector<ReorderBufferPtr> inputs;
     for (const auto& file_path_in : args.file_paths_in) {
-        InputStreamPtr stream{std::make_shared<common::InputStream>(file_path_in, args.do_byte_swap)};
-        if (stream->read_next_packet()) {
-            input_stream_queue.push(stream);
-        }
+        auto stream{std::make_shared<common::InputStream>(file_path_in, args.do_byte_swap)};
         total_file_size_bytes += stream->get_file_size();
+        inputs.push_back(std::make_shared<ReorderBuffer>(stream, window_packets, window_ps));
+        if (inputs.back()->next()) {
+            input_stream_queue.emplace(inputs.back(), inputs.size() - 1);
+        }
     }
 
+    common::DuplicateFilter  filter(static_cast<uint64_t>(std::llround(args.dedup_window_s * common::PS_PER_S)));
     progresscpp::ProgressBar progress(static_cast<uint64_t>(total_file_size_bytes), 70);
 
     try {
         // Loop until there are no more packets left in any input file
         while (!input_stream_queue.empty()) {
             // Get earliest input packet from queue
-            InputStreamPtr input_stream{input_stream_queue.top()};
+            ReorderBufferPtr input{input_stream_queue.top().input};
+            size_t           index{input_stream_queue.top().index};
             input_stream_queue.pop();
 
-            // Write input packet to output
-            output_stream.write(input_stream->get_buffer(), input_stream->get_packet()->header.packet_size);
-
-            // Read next packet and insert at the right place into queue if any left
-            if (input_stream->read_next_packet()) {
-                input_stream_queue.push(input_stream);
+            // Write input packet to output, unless duplicate
+            const BufferedPacket& packet{input->get()};
+            if (!args.do_dedup ||
+                !filter.is_duplicate(packet.id, packet.time, packet.packet_count, input->get_buffer().data(),
+                                     packet.words)) {
+                output_stream.write(input->get_buffer(), static_cast<int32_t>(packet.words));
             }
 
             // Handle progress bar
-            progress += sizeof(uint32_t) * input_stream->get_packet()->header.packet_size;
+            progress += sizeof(uint32_t) * packet.words;
             if (progress.get_ticks() % 65536 == 0) {
                 progress.display();
             }
+
+            // Read next packet and insert at the right place into queue if any left
+            if (input->next()) {
+                input_stream_queue.emplace(input, index);
+            }
         }
 
         progress.done();
+
+        if (args.do_dedup) {
+            std::cout << filter.get_number_of_duplicates() << " duplicate packet(s) removed" << std::endl;
+        }
+        for (const ReorderBufferPtr& input : inputs) {
+            if (input->get_number_of_violations() != 0) {
+                std::cerr << "Warning: " << input->get_number_of_violations() << " packet(s) in "
+                          << input->get_file_path()
+                          << " were more out of order than the reorder window, and are out of order in the output"
+                          << std::endl;
+            }
+        }
     } catch (...) {
         // Cleanup and rethrow
         output_stream.remove_file();
@@ -14,6 +14,10 @@ struct ProgramArguments {
     std::vector<std::filesystem::path> file_paths_in{};
     std::filesystem::path              file_path_out{};
     bool                               do_byte_swap{false};
+    std::string                        reorder_window{};
+    unsigned                           n_jobs{1};
+    bool                               do_dedup{false};
+    double                             dedup_window_s{1.0};
 };
 
 }  // namespace vrt::merge
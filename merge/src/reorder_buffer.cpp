@@ -0,0 +1,160 @@
+#include "reorder_buffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "vrt/vrt_types.h"
+
+#include "common/input_stream.h"
+#include "common/stream_id.h"
+#include "common/timestamp.h"
+
+namespace vrt::merge {
+
+/**
+ * Compare packets, so that the earliest one is on top of the heap, and packets with the same time come out in the
+ * order they were read.
+ *
+ * \param a Packet a.
+ * \param b Packet b.
+ *
+ * \return True if a should come out after b.
+ */
+static bool IsLater(const BufferedPacket& a, const BufferedPacket& b) {
+    if (b.key < a.key) {
+        return true;
+    }
+    if (a.key < b.key) {
+        return false;
+    }
+    return a.sequence > b.sequence;
+}
+
+/**
+ * Constructor. Call next() to get the first packet.
+ *
+ * \param input_stream   Input stream.
+ * \param window_packets Number of packets read ahead, if window_ps is 0.
+ * \param window_ps      Time read ahead [ps], or 0 to use window_packets.
+ */
+ReorderBuffer::ReorderBuffer(std::shared_ptr<common::InputStream> input_stream,
+                             uint64_t                             window_packets,
+                             uint64_t                             window_ps)
+    : input_stream_{std::move(input_stream)}, window_packets_{window_packets}, window_ps_{window_ps} {}
+
+/**
+ * Check if enough packets are read ahead for the earliest one to come out.
+ *
+ * \return True if so.
+ *
+ * \throw std::runtime_error If the window is a time and packet times can't be subtracted.
+ */
+bool ReorderBuffer::is_full() const {
+    if (heap_.empty()) {
+        return false;
+    }
+    if (window_ps_ == 0) {
+        return heap_.size() > window_packets_;
+    }
+
+    common::Int128 diff;
+    if (!common::time_difference(key_latest_, heap_.front().key, &diff)) {
+        std::stringstream ss;
+        ss << "Packet in " << input_stream_->get_file_path()
+           << ": Reorder window in time needs timestamps of the same type, in real time or integer seconds";
+        throw std::runtime_error(ss.str());
+    }
+    return diff > window_ps_;
+}
+
+/**
+ * Set everything but the buffer of a packet from the packet read last.
+ *
+ * \param packet Packet (out).
+ */
+void ReorderBuffer::describe(BufferedPacket* packet) {
+    const vrt_packet& p{*input_stream_->get_packet()};
+    packet->words        = p.header.packet_size;
+    packet->id           = common::StreamId(p);
+    packet->time         = common::Timestamp(p);
+    packet->key          = common::TimeKey(packet->time, 0.0);
+    packet->packet_count = p.header.packet_count;
+    packet->sequence     = n_read_++;
+}
+
+/**
+ * Go to next packet, in time order within the window.
+ *
+ * \return False if there are no more packets.
+ *
+ * \throw std::runtime_error On read or parse error.
+ */
+bool ReorderBuffer::next() {
+    if (window_packets_ == 0 && window_ps_ == 0) {
+        // Nothing to reorder, so use packet in input stream buffer as is
+        if (!input_stream_->read_next_packet()) {
+            has_current_ = false;
+            return false;
+        }
+        describe(&current_);
+        if (has_current_ && current_.key < key_out_) {
+            n_violations_++;
+        }
+        buf_         = &input_stream_->get_buffer();
+        key_out_     = current_.key;
+        has_current_ = true;
+        return true;
+    }
+
+    if (has_current_) {
+        free_.push_back(std::move(current_));
+    }
+
+    while (!is_end_of_file_ && !is_full()) {
+        if (!input_stream_->read_next_packet()) {
+            is_end_of_file_ = true;
+            break;
+        }
+
+        // Reuse buffer of a packet that has come out, if any
+        BufferedPacket packet;
+        if (!free_.empty()) {
+            packet = std::move(free_.back());
+            free_.pop_back();
+        }
+        describe(&packet);
+        const std::vector<uint32_t>& buf{input_stream_->get_buffer()};
+        packet.buf.assign(buf.begin(), buf.begin() + packet.words);
+        if (packet.sequence == 0 || key_latest_ < packet.key) {
+            key_latest_ = packet.key;
+        }
+
+        heap_.push_back(std::move(packet));
+        std::push_heap(heap_.begin(), heap_.end(), IsLater);
+    }
+
+    if (heap_.empty()) {
+        has_current_ = false;
+        return false;
+    }
+
+    std::pop_heap(heap_.begin(), heap_.end(), IsLater);
+    if (has_current_ && heap_.back().key < key_out_) {
+        // The previous packet came out too early
+        n_violations_++;
+    }
+    current_ = std::move(heap_.back());
+    heap_.pop_back();
+    buf_         = &current_.buf;
+    key_out_     = current_.key;
+    has_current_ = true;
+
+    return true;
+}
+
+}  // namespace vrt::merge
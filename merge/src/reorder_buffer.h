@@ -0,0 +1,82 @@
+#ifndef VRT_MERGE_SRC_REORDER_BUFFER_H_
+#define VRT_MERGE_SRC_REORDER_BUFFER_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "common/input_stream.h"
+#include "common/stream_id.h"
+#include "common/timestamp.h"
+
+namespace vrt::merge {
+
+/**
+ * Packet read from an input file, with its time.
+ */
+struct BufferedPacket {
+    std::vector<uint32_t> buf;             /**< Non-byte swapped packet, unless read straight from the input. */
+    uint16_t              words{0};        /**< Packet size [words]. */
+    common::StreamId      id;              /**< Stream. */
+    common::Timestamp     time;            /**< Timestamp. */
+    common::TimeKey       key;             /**< Time. */
+    uint8_t               packet_count{0}; /**< Packet count. */
+    uint64_t              sequence{0};     /**< Index in input file. */
+};
+
+/**
+ * Input file that is nearly ordered by time, read through a small min-heap of packets so that packets that are at
+ * most a window out of order come out in order. The window is a number of packets, or a time if window_ps isn't 0.
+ * Packets that are further out of order are counted as violations, and come out as soon as they are read. Without a
+ * window, packets come out straight from the input stream buffer, without being copied.
+ */
+class ReorderBuffer {
+   public:
+    ReorderBuffer(std::shared_ptr<common::InputStream> input_stream, uint64_t window_packets, uint64_t window_ps);
+
+    bool next();
+
+    /**
+     * \return Current packet, after next() has returned true. Use get_buffer() for its contents.
+     */
+    const BufferedPacket& get() const { return current_; }
+
+    /**
+     * \return Non-byte swapped buffer of current packet, after next() has returned true. Only valid until next().
+     */
+    const std::vector<uint32_t>& get_buffer() const { return *buf_; }
+
+    /**
+     * \return Number of packets that came out after a later packet, since they were too far out of order.
+     */
+    uint64_t get_number_of_violations() const { return n_violations_; }
+
+    /**
+     * \return Input file path.
+     */
+    const std::filesystem::path& get_file_path() const { return input_stream_->get_file_path(); }
+
+   private:
+    bool is_full() const;
+    void describe(BufferedPacket* packet);
+
+    const std::shared_ptr<common::InputStream> input_stream_;
+    const uint64_t                             window_packets_;
+    const uint64_t                             window_ps_;
+
+    std::vector<BufferedPacket>  heap_;                  /**< Buffered packets, earliest on top. */
+    std::vector<BufferedPacket>  free_;                  /**< Packets whose buffers can be reused. */
+    BufferedPacket               current_;               /**< Packet that came out last. */
+    const std::vector<uint32_t>* buf_{nullptr};          /**< Buffer of packet that came out last. */
+    bool                         has_current_{false};    /**< If a packet has come out. */
+    common::TimeKey              key_out_;               /**< Time of packet that came out last. */
+    common::TimeKey              key_latest_;            /**< Latest time read. */
+    bool                         is_end_of_file_{false}; /**< If all packets have been read. */
+    uint64_t                     n_read_{0};             /**< Number of packets read. */
+    uint64_t                     n_violations_{0};       /**< Number of packets too far out of order. */
+};
+
+}  // namespace vrt::merge
+
+#endif
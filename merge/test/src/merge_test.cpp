@@ -3,7 +3,9 @@
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <random>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -15,8 +17,11 @@
 
 #include "../../src/process.h"
 #include "../../src/program_arguments.h"
+#include "../../src/reorder_buffer.h"
 #include "common/byte_swap.h"
 #include "common/generate_packet_sequence.h"
+#include "common/input_stream.h"
+#include "common/timestamp.h"
 
 using namespace vrt;
 
@@ -65,14 +70,91 @@ static std::vector<fs::path> generate_input_file_paths(uint64_t n) {
     return paths;
 }
 
-static void process(const std::vector<fs::path>& file_paths_in, bool do_byte_swap = false) {
+static void process(const std::vector<fs::path>& file_paths_in,
+                    bool                         do_byte_swap   = false,
+                    const std::string&           reorder_window = "",
+                    unsigned                     n_jobs         = 1,
+                    bool                         do_dedup       = false) {
     vrt::merge::ProgramArguments args;
-    args.file_paths_in = file_paths_in;
-    args.file_path_out = TMP_FILE_OUT_PATH;
-    args.do_byte_swap  = do_byte_swap;
+    args.file_paths_in  = file_paths_in;
+    args.file_path_out  = TMP_FILE_OUT_PATH;
+    args.do_byte_swap   = do_byte_swap;
+    args.reorder_window = reorder_window;
+    args.n_jobs         = n_jobs;
+    args.do_dedup       = do_dedup;
     vrt::merge::process(args);
 }
 
+/**
+ * Generate file where packet i has time times[i] [ms].
+ */
+static void generate_times(const fs::path& file_path, vrt_packet* p, const std::vector<uint64_t>& times) {
+    p->header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    p->header.tsi         = VRT_TSI_UTC;
+    p->header.tsf         = VRT_TSF_REAL_TIME;
+    common::generate_packet_sequence(file_path, p, times.size(), [&](uint64_t i) {
+        p->fields.stream_id                    = static_cast<uint32_t>(times[i]);
+        p->fields.integer_seconds_timestamp    = static_cast<uint32_t>(times[i] / 1000);
+        p->fields.fractional_seconds_timestamp = (times[i] % 1000) * 1000000000;
+    });
+}
+
+/**
+ * \return Contents of file.
+ */
+static std::string read_file(const fs::path& file_path) {
+    std::ifstream     file(file_path, std::ios::in | std::ios::binary);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+/**
+ * Merge with one thread and in parallel, and check that output is the same.
+ */
+static void check_parallel(const std::vector<fs::path>& file_paths_in) {
+    process(file_paths_in);
+    std::string serial{read_file(TMP_FILE_OUT_PATH)};
+    ASSERT_FALSE(serial.empty());
+    for (unsigned n_jobs : {2U, 3U, 8U}) {
+        fs::remove(TMP_FILE_OUT_PATH);
+        process(file_paths_in, false, "", n_jobs);
+        ASSERT_EQ(read_file(TMP_FILE_OUT_PATH), serial);
+    }
+}
+
+/**
+ * \return Times [ms] of packets in output file.
+ */
+static std::vector<uint64_t> read_output_times() {
+    std::vector<uint64_t> times;
+    common::InputStream   input_stream(TMP_FILE_OUT_PATH, false);
+    while (input_stream.read_next_packet()) {
+        const vrt_packet& p{*input_stream.get_packet()};
+        times.push_back(1000 * static_cast<uint64_t>(p.fields.integer_seconds_timestamp) +
+                        p.fields.fractional_seconds_timestamp / 1000000000);
+    }
+    return times;
+}
+
+/**
+ * \return Times [ms] of packets read through reorder buffer, and number of violations.
+ */
+static std::vector<uint64_t> read_reordered_times(const fs::path& file_path,
+                                                  uint64_t        window_packets,
+                                                  uint64_t        window_ps,
+                                                  uint64_t*       n_violations) {
+    std::vector<uint64_t>     times;
+    vrt::merge::ReorderBuffer buffer(std::make_shared<common::InputStream>(file_path, false), window_packets,
+                                     window_ps);
+    while (buffer.next()) {
+        const common::Timestamp& t{buffer.get().time};
+        times.push_back(1000 * static_cast<uint64_t>(t.integer) + t.fractional / 1000000000);
+    }
+    *n_violations = buffer.get_number_of_violations();
+    return times;
+}
+
 static void check(bool do_byte_swap = false) {
     std::vector<uint32_t> buf;
 
@@ -231,3 +313,103 @@ TEST_F(MergeTest, ByteSwap) {
     SCOPED_TRACE(::testing::UnitTest::GetInstance()->current_test_info()->name());
     check(true);
 }
+
+TEST_F(MergeTest, ReorderWindowPackets) {
+    std::vector<fs::path> file_paths_in{generate_input_file_paths(2)};
+    generate_times(file_paths_in[0], &p_, {0, 2, 1, 4, 3, 6, 5, 7});
+    generate_times(file_paths_in[1], &p_, {10, 8, 9, 11});
+
+    process(file_paths_in, false, "1");
+    ASSERT_EQ(read_output_times(), (std::vector<uint64_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+}
+
+TEST_F(MergeTest, ReorderWindowTime) {
+    std::vector<fs::path> file_paths_in{generate_input_file_paths(2)};
+    generate_times(file_paths_in[0], &p_, {3, 0, 1, 2, 7, 4, 5, 6});
+    generate_times(file_paths_in[1], &p_, {8, 9});
+
+    process(file_paths_in, false, "3ms");
+    ASSERT_EQ(read_output_times(), (std::vector<uint64_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST_F(MergeTest, ReorderWindowInvalid) {
+    std::vector<fs::path> file_paths_in{generate_input_file_paths(1)};
+    generate_times(file_paths_in[0], &p_, {0, 1});
+
+    ASSERT_THROW(process(file_paths_in, false, "3 packets"), std::runtime_error);
+    ASSERT_THROW(process(file_paths_in, false, "-1ms"), std::runtime_error);
+    ASSERT_THROW(process(file_paths_in, false, "ms"), std::runtime_error);
+}
+
+TEST_F(MergeTest, ReorderViolations) {
+    fs::path file_path{TMP_DIR / "reorder.vrt"};
+    generate_times(file_path, &p_, {0, 1, 3, 4, 5, 2, 6, 7});
+
+    // Fits in window
+    uint64_t n_violations{0};
+    ASSERT_EQ(read_reordered_times(file_path, 3, 0, &n_violations), (std::vector<uint64_t>{0, 1, 2, 3, 4, 5, 6, 7}));
+    ASSERT_EQ(n_violations, 0);
+    ASSERT_EQ(read_reordered_times(file_path, 0, 2000000000, &n_violations),
+              (std::vector<uint64_t>{0, 1, 2, 3, 4, 5, 6, 7}));
+    ASSERT_EQ(n_violations, 0);
+
+    // Packet 2 comes out after 4
+    ASSERT_EQ(read_reordered_times(file_path, 1, 0, &n_violations), (std::vector<uint64_t>{0, 1, 3, 4, 2, 5, 6, 7}));
+    ASSERT_EQ(n_violations, 1);
+
+    // Packet 2 comes out after 3
+    ASSERT_EQ(read_reordered_times(file_path, 0, 1000000000, &n_violations),
+              (std::vector<uint64_t>{0, 1, 3, 2, 4, 5, 6, 7}));
+    ASSERT_EQ(n_violations, 1);
+
+    // No window
+    ASSERT_EQ(read_reordered_times(file_path, 0, 0, &n_violations), (std::vector<uint64_t>{0, 1, 3, 4, 5, 2, 6, 7}));
+    ASSERT_EQ(n_violations, 1);
+}
+
+TEST_F(MergeTest, ParallelSameAsSerial) {
+    std::vector<fs::path> file_paths_in{generate_input_file_paths(4)};
+    std::mt19937          gen(1);
+    for (size_t k{0}; k < file_paths_in.size(); ++k) {
+        // Several packets with the same time, within and between inputs
+        std::vector<uint64_t>                   times(3000 + 500 * k);
+        std::uniform_int_distribution<uint64_t> distrib(0, 2);
+        for (size_t i{1}; i < times.size(); ++i) {
+            times[i] = times[i - 1] + distrib(gen);
+        }
+        generate_times(file_paths_in[k], &p_, times);
+    }
+
+    check_parallel(file_paths_in);
+}
+
+TEST_F(MergeTest, ParallelEmptyInput) {
+    std::vector<fs::path> file_paths_in{generate_input_file_paths(3)};
+    generate_times(file_paths_in[0], &p_, {0, 1, 2});
+    generate_times(file_paths_in[1], &p_, {});
+    generate_times(file_paths_in[2], &p_, {1, 1, 1});
+
+    check_parallel(file_paths_in);
+}
+
+TEST_F(MergeTest, ParallelUnordered) {
+    // Merged with one thread
+    std::vector<fs::path> file_paths_in{generate_input_file_paths(2)};
+    generate_times(file_paths_in[0], &p_, {0, 2, 1, 4, 3});
+    generate_times(file_paths_in[1], &p_, {0, 1, 2, 3, 4});
+
+    check_parallel(file_paths_in);
+}
+
+TEST_F(MergeTest, Dedup) {
+    // Two captures of the same packets, where one missed some
+    std::vector<fs::path> file_paths_in{generate_input_file_paths(3)};
+    generate_times(file_paths_in[0], &p_, {0, 1, 2, 3, 4, 5});
+    generate_times(file_paths_in[1], &p_, {0, 2, 3, 5, 6});
+    generate_times(file_paths_in[2], &p_, {0, 1, 2, 3, 4, 5, 6});
+
+    process(file_paths_in, false, "", 2, true);
+    ASSERT_EQ(read_output_times(), (std::vector<uint64_t>{0, 1, 2, 3, 4, 5, 6}));
+    process(file_paths_in);
+    ASSERT_EQ(read_output_times().size(), 18);
+}
@@ -0,0 +1,153 @@
+#include "impairments.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "vrt/vrt_types.h"
+
+#include "common/byte_swap.h"
+
+namespace vrt::packet_loss {
+
+/**
+ * Parts of the counter range of random numbers, where 0 and 1 are used by loss models.
+ */
+enum Draw : unsigned { DUPLICATE = 2, CORRUPT, CORRUPT_BIT, TRUNCATE, TRUNCATE_WORDS, REORDER, REORDER_DELAY };
+
+/**
+ * Constructor.
+ *
+ * \param args          Impairments.
+ * \param seed          Seed of random numbers.
+ * \param do_byte_swap  If packets are byte swapped, compared to the platform.
+ * \param output_stream Output stream.
+ */
+Impairments::Impairments(const ImpairmentArguments& args,
+                         uint64_t                   seed,
+                         bool                       do_byte_swap,
+                         common::OutputStream*      output_stream)
+    : args_{args}, random_{seed}, do_byte_swap_{do_byte_swap}, output_stream_{output_stream} {}
+
+/**
+ * \param k Part of counter range.
+ * \param i Index in part.
+ *
+ * \return Pseudo random number.
+ */
+uint64_t Impairments::draw(unsigned k, uint64_t i) const {
+    return random_.get((static_cast<uint64_t>(k) << 60U) + i);
+}
+
+/**
+ * \param k Part of counter range.
+ * \param i Index in part.
+ *
+ * \return Pseudo random number in [0, 1).
+ */
+double Impairments::uniform(unsigned k, uint64_t i) const {
+    return random_.uniform((static_cast<uint64_t>(k) << 60U) + i);
+}
+
+/**
+ * Impair packet that isn't lost, and write it, or delay it. Packets delayed until now are written first.
+ *
+ * \param i      Packet index, in increasing order.
+ * \param buf    Non-byte swapped packet buffer.
+ * \param packet Packet.
+ *
+ * \throw std::runtime_error On write error.
+ */
+void Impairments::write(uint64_t i, const std::vector<uint32_t>& buf, const vrt_packet& packet) {
+    advance(i);
+
+    int32_t                      words{packet.header.packet_size};
+    const std::vector<uint32_t>* out{&buf};
+
+    // Offset and size of the part after the fields section, where a packet is corrupted or cut off
+    auto    words_front{packet.body != nullptr
+                            ? static_cast<int32_t>(static_cast<const uint32_t*>(packet.body) - buf.data())
+                            : words};
+    int32_t words_back{words - words_front};
+
+    bool is_corrupted{args_.prob_corrupt > 0.0 && packet.words_body > 0 && uniform(CORRUPT, i) < args_.prob_corrupt};
+    bool is_truncated{args_.prob_truncate > 0.0 && words_back > 0 && uniform(TRUNCATE, i) < args_.prob_truncate};
+    if (is_corrupted || is_truncated) {
+        scratch_.assign(buf.begin(), buf.begin() + words);
+        out = &scratch_;
+
+        if (is_corrupted) {
+            uint64_t bit{draw(CORRUPT_BIT, i) % (32 * static_cast<uint64_t>(packet.words_body))};
+            scratch_[words_front + bit / 32] ^= 1U << (bit % 32);
+            n_corrupted_++;
+        }
+        if (is_truncated) {
+            // Keep header and fields section, and the packet size in the header right, so that later packets can be
+            // read
+            words = words_front + static_cast<int32_t>(draw(TRUNCATE_WORDS, i) % static_cast<uint64_t>(words_back));
+            uint32_t header{do_byte_swap_ ? bswap_32(scratch_[0]) : scratch_[0]};
+            header = (header & 0xFFFF0000U) | static_cast<uint32_t>(words);
+            scratch_[0] = do_byte_swap_ ? bswap_32(header) : header;
+            n_truncated_++;
+        }
+    }
+
+    send(i, 0, *out, words);
+    if (args_.prob_duplicate > 0.0 && uniform(DUPLICATE, i) < args_.prob_duplicate) {
+        send(i, 1, *out, words);
+        n_duplicated_++;
+    }
+}
+
+/**
+ * Write copy of packet now, or delay it.
+ *
+ * \param i     Packet index.
+ * \param copy  Copy of packet, 0 or 1.
+ * \param buf   Non-byte swapped packet buffer.
+ * \param words Packet size [words].
+ *
+ * \throw std::runtime_error On write error.
+ */
+void Impairments::send(uint64_t i, uint64_t copy, const std::vector<uint32_t>& buf, int32_t words) {
+    if (args_.prob_reorder > 0.0 && uniform(REORDER, 2 * i + copy) < args_.prob_reorder) {
+        Delayed delayed;
+        delayed.departure = i + 1 + draw(REORDER_DELAY, 2 * i + copy) % std::max<uint64_t>(args_.reorder_window, 1);
+        delayed.sequence  = sequence_++;
+        delayed.buf.assign(buf.begin(), buf.begin() + words);
+        heap_.push_back(std::move(delayed));
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+        n_reordered_++;
+    } else {
+        output_stream_->write(buf, words);
+    }
+}
+
+/**
+ * Write packets delayed until, and including, a time. Called for every packet, also lost ones.
+ *
+ * \param i Time, i.e. packet index.
+ *
+ * \throw std::runtime_error On write error.
+ */
+void Impairments::advance(uint64_t i) {
+    while (!heap_.empty() && heap_.front().departure <= i) {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+        output_stream_->write(heap_.back().buf, static_cast<int32_t>(heap_.back().buf.size()));
+        heap_.pop_back();
+    }
+}
+
+/**
+ * Write all delayed packets, at end of input.
+ *
+ * \throw std::runtime_error On write error.
+ */
+void Impairments::flush() {
+    advance(UINT64_MAX);
+}
+
+}  // namespace vrt::packet_loss
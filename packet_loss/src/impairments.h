@@ -0,0 +1,105 @@
+#ifndef VRT_PACKET_LOSS_SRC_IMPAIRMENTS_H_
+#define VRT_PACKET_LOSS_SRC_IMPAIRMENTS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "common/counter_random.h"
+#include "common/output_stream.h"
+
+struct vrt_packet;
+
+namespace vrt::packet_loss {
+
+/**
+ * Probabilities of impairments of a packet.
+ */
+struct ImpairmentArguments {
+    double   prob_duplicate{0.0}; /**< Probability that a packet is written twice. */
+    double   prob_reorder{0.0};   /**< Probability that a packet is delayed, so that later packets pass it. */
+    uint64_t reorder_window{8};   /**< Largest delay of a packet [packets]. */
+    double   prob_corrupt{0.0};   /**< Probability that a bit is flipped in the body of a packet. */
+    double   prob_truncate{0.0};  /**< Probability that the end of a packet is cut off. */
+};
+
+/**
+ * Impairments of packets that aren't lost, applied in a streaming pass with bounded memory. Packet i arrives at
+ * virtual time i, and departs then, or at a later time if delayed. Delayed packets wait in a small heap keyed by
+ * departure time, so at most the reorder window of packets are held at a time. Random numbers only depend on the seed
+ * and the packet index.
+ */
+class Impairments {
+   public:
+    Impairments(const ImpairmentArguments& args, uint64_t seed, bool do_byte_swap, common::OutputStream* output_stream);
+
+    void write(uint64_t i, const std::vector<uint32_t>& buf, const vrt_packet& packet);
+    void advance(uint64_t i);
+    void flush();
+
+    /**
+     * \return True if any impairment is enabled.
+     */
+    bool is_enabled() const {
+        return args_.prob_duplicate > 0.0 || args_.prob_reorder > 0.0 || args_.prob_corrupt > 0.0 ||
+               args_.prob_truncate > 0.0;
+    }
+
+    /**
+     * \return Number of packets written twice.
+     */
+    uint64_t get_number_of_duplicated() const { return n_duplicated_; }
+
+    /**
+     * \return Number of packets delayed.
+     */
+    uint64_t get_number_of_reordered() const { return n_reordered_; }
+
+    /**
+     * \return Number of packets with a flipped bit.
+     */
+    uint64_t get_number_of_corrupted() const { return n_corrupted_; }
+
+    /**
+     * \return Number of packets cut off.
+     */
+    uint64_t get_number_of_truncated() const { return n_truncated_; }
+
+   private:
+    /**
+     * Packet waiting for its departure.
+     */
+    struct Delayed {
+        uint64_t              departure{0}; /**< Departure time. */
+        uint64_t              sequence{0};  /**< Order of arrival, for packets departing at the same time. */
+        std::vector<uint32_t> buf;          /**< Packet. */
+
+        /**
+         * \return True if this departs after other, for a min-heap.
+         */
+        bool operator>(const Delayed& other) const {
+            return departure != other.departure ? departure > other.departure : sequence > other.sequence;
+        }
+    };
+
+    uint64_t draw(unsigned k, uint64_t i) const;
+    double   uniform(unsigned k, uint64_t i) const;
+    void     send(uint64_t i, uint64_t copy, const std::vector<uint32_t>& buf, int32_t words);
+
+    const ImpairmentArguments   args_;
+    const common::CounterRandom random_;
+    const bool                  do_byte_swap_;
+    common::OutputStream*       output_stream_;
+
+    std::vector<Delayed>  heap_;        /**< Delayed packets, earliest departure on top. */
+    std::vector<uint32_t> scratch_;     /**< Copy of packet being impaired. */
+    uint64_t              sequence_{0}; /**< Number of packets delayed. */
+
+    uint64_t n_duplicated_{0};
+    uint64_t n_reordered_{0};
+    uint64_t n_corrupted_{0};
+    uint64_t n_truncated_{0};
+};
+
+}  // namespace vrt::packet_loss
+
+#endif
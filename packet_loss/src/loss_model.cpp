@@ -0,0 +1,235 @@
+#include "loss_model.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "vrt/vrt_types.h"
+#include "vrt/vrt_util.h"
+
+namespace vrt::packet_loss {
+
+namespace fs = ::std::filesystem;
+
+/**
+ * Parse probability, as a ratio or a percentage.
+ *
+ * \param text Text, e.g. 0.01 or 1%.
+ * \param spec Model specification, used in messages.
+ *
+ * \return Probability.
+ *
+ * \throw std::runtime_error If text isn't a probability.
+ */
+static double parse_probability(std::string text, const std::string& spec) {
+    double scale{1.0};
+    if (!text.empty() && text.back() == '%') {
+        text.pop_back();
+        scale = 0.01;
+    }
+
+    size_t n{0};
+    double value{0.0};
+    try {
+        value = scale * std::stod(text, &n);
+    } catch (const std::logic_error&) {
+        n = 0;
+    }
+    if (n == 0 || n != text.size() || !(value >= 0.0 && value <= 1.0)) {
+        std::stringstream ss;
+        ss << "Invalid probability '" << text << "' in loss model '" << spec << "'";
+        throw std::runtime_error(ss.str());
+    }
+
+    return value;
+}
+
+/**
+ * Constructor.
+ *
+ * \param prob_packet_loss Probability that a packet is lost.
+ * \param prob_burst_loss  Probability that a packet is lost if the previous packet was lost, or 0 to use
+ *                         prob_packet_loss.
+ */
+MarkovLossModel::MarkovLossModel(double prob_packet_loss, double prob_burst_loss)
+    : prob_packet_loss_{prob_packet_loss}, prob_burst_loss_{prob_burst_loss} {}
+
+bool MarkovLossModel::lost(const vrt_packet& /* packet */, const double* r) {
+    double lim{prob_packet_loss_};
+    if (prob_burst_loss_ != 0.0 && prev_lost_) {
+        lim = prob_burst_loss_;
+    }
+
+    prev_lost_ = r[0] <= lim;
+    return prev_lost_;
+}
+
+/**
+ * Constructor. The model starts in the good state.
+ *
+ * \param prob_good_bad  Probability of going from the good to the bad state, before a packet.
+ * \param prob_bad_good  Probability of going from the bad to the good state, before a packet.
+ * \param prob_loss_good Probability that a packet is lost in the good state.
+ * \param prob_loss_bad  Probability that a packet is lost in the bad state.
+ */
+GilbertElliottLossModel::GilbertElliottLossModel(double prob_good_bad,
+                                                 double prob_bad_good,
+                                                 double prob_loss_good,
+                                                 double prob_loss_bad)
+    : prob_good_bad_{prob_good_bad},
+      prob_bad_good_{prob_bad_good},
+      prob_loss_good_{prob_loss_good},
+      prob_loss_bad_{prob_loss_bad} {}
+
+bool GilbertElliottLossModel::lost(const vrt_packet& /* packet */, const double* r) {
+    if (is_bad_) {
+        is_bad_ = !(r[1] < prob_bad_good_);
+    } else {
+        is_bad_ = r[1] < prob_good_bad_;
+    }
+
+    return r[0] < (is_bad_ ? prob_loss_bad_ : prob_loss_good_);
+}
+
+/**
+ * Constructor. Read bitmap, where bit i is the (i % 8):th least significant bit of byte i / 8.
+ *
+ * \param file_path Bitmap file path.
+ *
+ * \throw std::runtime_error If file fails to open, or is empty.
+ */
+TraceLossModel::TraceLossModel(const fs::path& file_path) {
+    std::ifstream file(file_path, std::ios::in | std::ios::binary);
+    if (!file) {
+        std::stringstream ss;
+        ss << "Failed to open loss trace " << file_path;
+        throw std::runtime_error(ss.str());
+    }
+    bits_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (bits_.empty()) {
+        std::stringstream ss;
+        ss << "Loss trace " << file_path << " is empty";
+        throw std::runtime_error(ss.str());
+    }
+}
+
+bool TraceLossModel::lost(const vrt_packet& /* packet */, const double* /* r */) {
+    uint64_t bit{n_ % (8 * bits_.size())};
+    n_++;
+    return ((bits_[bit / 8] >> (bit % 8)) & 1U) != 0;
+}
+
+/**
+ * Constructor. Each line of the profile file has a Stream ID in hexadecimal and a loss model, e.g.
+ * "ABABABAB gilbert-elliott:0.01,0.3,0,1". Empty lines, and anything after #, are ignored.
+ *
+ * \param profiles_path Profile file path.
+ * \param default_model Model of packets with other or no Stream IDs.
+ *
+ * \throw std::runtime_error If file fails to open, or on an invalid line.
+ */
+StreamLossModel::StreamLossModel(const fs::path& profiles_path, std::unique_ptr<LossModel> default_model)
+    : default_model_{std::move(default_model)} {
+    std::ifstream file(profiles_path);
+    if (!file) {
+        std::stringstream ss;
+        ss << "Failed to open loss profiles " << profiles_path;
+        throw std::runtime_error(ss.str());
+    }
+
+    std::string line;
+    for (uint64_t line_number{1}; std::getline(file, line); ++line_number) {
+        line = line.substr(0, line.find('#'));
+
+        std::stringstream ss_line(line);
+        std::string       id_text;
+        std::string       spec;
+        std::string       rest;
+        if (!(ss_line >> id_text)) {
+            continue;
+        }
+
+        size_t        n{0};
+        unsigned long id{0};
+        try {
+            id = std::stoul(id_text, &n, 16);
+        } catch (const std::logic_error&) {
+            n = 0;
+        }
+        if (n == 0 || n != id_text.size() || id > UINT32_MAX || !(ss_line >> spec) || ss_line >> rest) {
+            std::stringstream ss;
+            ss << "Loss profiles " << profiles_path << " line " << line_number
+               << ": Expected a hexadecimal Stream ID and a loss model, e.g. 'ABABABAB markov:0.01'";
+            throw std::runtime_error(ss.str());
+        }
+        if (!models_.emplace(static_cast<uint32_t>(id), make_loss_model(spec)).second) {
+            std::stringstream ss;
+            ss << "Loss profiles " << profiles_path << " line " << line_number << ": Stream ID " << id_text
+               << " already has a loss model";
+            throw std::runtime_error(ss.str());
+        }
+    }
+}
+
+bool StreamLossModel::lost(const vrt_packet& packet, const double* r) {
+    if (vrt_has_stream_id(&packet.header)) {
+        auto it{models_.find(packet.fields.stream_id)};
+        if (it != models_.end()) {
+            return it->second->lost(packet, r);
+        }
+    }
+
+    return default_model_->lost(packet, r);
+}
+
+/**
+ * Make loss model from a specification, which is one of:
+ * - markov:P[,B], with loss probability P, and B if the previous packet was lost,
+ * - gilbert-elliott:P,R,H,K, with probabilities P from good to bad state, R from bad to good state, and of loss H in
+ *   good and K in bad state, and
+ * - trace:FILE, with a loss bitmap file.
+ * Probabilities are ratios or percentages.
+ *
+ * \param spec Specification.
+ *
+ * \return Model.
+ *
+ * \throw std::runtime_error On invalid specification.
+ */
+std::unique_ptr<LossModel> make_loss_model(const std::string& spec) {
+    size_t      colon{spec.find(':')};
+    std::string name{spec.substr(0, colon)};
+    std::string params{colon != std::string::npos ? spec.substr(colon + 1) : std::string()};
+
+    if (name == "trace" && !params.empty()) {
+        return std::make_unique<TraceLossModel>(params);
+    }
+
+    std::vector<double> probs;
+    std::stringstream   ss_params(params);
+    std::string         param;
+    while (std::getline(ss_params, param, ',')) {
+        probs.push_back(parse_probability(param, spec));
+    }
+    if (name == "markov" && (probs.size() == 1 || probs.size() == 2)) {
+        return std::make_unique<MarkovLossModel>(probs[0], probs.size() == 2 ? probs[1] : 0.0);
+    }
+    if (name == "gilbert-elliott" && probs.size() == 4) {
+        return std::make_unique<GilbertElliottLossModel>(probs[0], probs[1], probs[2], probs[3]);
+    }
+
+    std::stringstream ss;
+    ss << "Invalid loss model '" << spec
+       << "'. Use markov:P[,B], gilbert-elliott:P,R,H,K or trace:FILE, e.g. gilbert-elliott:1%,30%,0,100%.";
+    throw std::runtime_error(ss.str());
+}
+
+}  // namespace vrt::packet_loss
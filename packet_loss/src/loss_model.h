@@ -0,0 +1,103 @@
+#ifndef VRT_PACKET_LOSS_SRC_LOSS_MODEL_H_
+#define VRT_PACKET_LOSS_SRC_LOSS_MODEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct vrt_packet;
+
+namespace vrt::packet_loss {
+
+/**
+ * Number of random numbers given to a loss model for each packet.
+ */
+static constexpr size_t DRAWS_PER_PACKET{2};
+
+/**
+ * Model of which packets are lost, called once per packet in order.
+ */
+class LossModel {
+   public:
+    virtual ~LossModel() = default;
+
+    /**
+     * Calculate if a packet shall be lost.
+     *
+     * \param packet Packet.
+     * \param r      Random numbers in [0, 1) of packet [DRAWS_PER_PACKET].
+     *
+     * \return True if the packet shall be considered lost.
+     */
+    virtual bool lost(const vrt_packet& packet, const double* r) = 0;
+};
+
+/**
+ * Loss with a probability, or another probability if the previous packet was lost.
+ */
+class MarkovLossModel : public LossModel {
+   public:
+    MarkovLossModel(double prob_packet_loss, double prob_burst_loss);
+
+    bool lost(const vrt_packet& packet, const double* r) override;
+
+   private:
+    const double prob_packet_loss_;
+    const double prob_burst_loss_;
+    bool         prev_lost_{false};
+};
+
+/**
+ * Gilbert-Elliott model, with a good and a bad state that each have a loss probability.
+ */
+class GilbertElliottLossModel : public LossModel {
+   public:
+    GilbertElliottLossModel(double prob_good_bad, double prob_bad_good, double prob_loss_good, double prob_loss_bad);
+
+    bool lost(const vrt_packet& packet, const double* r) override;
+
+   private:
+    const double prob_good_bad_;
+    const double prob_bad_good_;
+    const double prob_loss_good_;
+    const double prob_loss_bad_;
+    bool         is_bad_{false};
+};
+
+/**
+ * Loss replayed from a recorded bitmap, which is repeated if there are more packets than bits.
+ */
+class TraceLossModel : public LossModel {
+   public:
+    explicit TraceLossModel(const std::filesystem::path& file_path);
+
+    bool lost(const vrt_packet& packet, const double* r) override;
+
+   private:
+    std::vector<uint8_t> bits_; /**< Bitmap, where bit i is set if packet i is lost. */
+    uint64_t             n_{0}; /**< Index of next packet. */
+};
+
+/**
+ * Loss with a model per Stream ID, from a profile file, and a default model for other packets.
+ */
+class StreamLossModel : public LossModel {
+   public:
+    StreamLossModel(const std::filesystem::path& profiles_path, std::unique_ptr<LossModel> default_model);
+
+    bool lost(const vrt_packet& packet, const double* r) override;
+
+   private:
+    std::unordered_map<uint32_t, std::unique_ptr<LossModel>> models_;        /**< Stream ID -> Model. */
+    std::unique_ptr<LossModel>                               default_model_; /**< Model of other packets. */
+};
+
+std::unique_ptr<LossModel> make_loss_model(const std::string& spec);
+
+}  // namespace vrt::packet_loss
+
+#endif
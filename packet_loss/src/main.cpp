@@ -7,7 +7,7 @@
 
 #include "CLI/CLI.hpp"
 
-#include "percentage_validator.h"
+#include "common/percentage_validator.h"
 #include "process.h"
 #include "program_arguments.h"
 
@@ -42,15 +42,59 @@ static vrt::packet_loss::ProgramArguments setup_arg_parse(CLI::App* app) {
     // Packet loss
     CLI::Option* opt_file_packet_loss{
         app->add_option("-p,--packet-loss", args.prob_packet_loss, "Probability that a packet is lost")};
-    opt_file_packet_loss->required(true);
     opt_file_packet_loss->check(CLI::Range(0.0, 1.0));
-    opt_file_packet_loss->transform(PercentageValidator());
+    opt_file_packet_loss->transform(vrt::common::PercentageValidator());
 
     // Burst loss
     CLI::Option* opt_file_burst_loss{app->add_option(
         "-B,--burst-loss", args.prob_burst_loss, "Probability that a packet is lost if the previous packet was lost")};
     opt_file_burst_loss->check(CLI::Range(0.0, 1.0));
-    opt_file_burst_loss->transform(PercentageValidator());
+    opt_file_burst_loss->transform(vrt::common::PercentageValidator());
+
+    // Loss model
+    CLI::Option* opt_loss_model{app->add_option(
+        "-m,--model", args.loss_model,
+        "Loss model instead of --packet-loss and --burst-loss: markov:P[,B] with loss probability P, and B if the "
+        "previous packet was lost; gilbert-elliott:P,R,H,K with probabilities P from good to bad state, R from bad to "
+        "good state, and of loss H in good and K in bad state; or trace:FILE with a loss bitmap, where bit i of the "
+        "file, least significant bit first, is set if packet i is lost.")};
+    opt_loss_model->excludes(opt_file_packet_loss);
+    opt_loss_model->excludes(opt_file_burst_loss);
+
+    // Loss profiles
+    CLI::Option* opt_loss_profiles{app->add_option(
+        "--profiles", args.loss_profiles,
+        "File with a loss model per stream, with a hexadecimal Stream ID and a model on each line, e.g. 'ABABABAB "
+        "markov:1%'. Packets of other streams use the default model.")};
+    opt_loss_profiles->check(CLI::ExistingFile);
+
+    // Impairments
+    CLI::Option* opt_duplicate{app->add_option("--duplicate", args.impairments.prob_duplicate,
+                                               "Probability that a packet is written twice")};
+    opt_duplicate->check(CLI::Range(0.0, 1.0));
+    opt_duplicate->transform(vrt::common::PercentageValidator());
+    CLI::Option* opt_reorder{app->add_option("--reorder", args.impairments.prob_reorder,
+                                             "Probability that a packet is delayed, so that later packets pass it")};
+    opt_reorder->check(CLI::Range(0.0, 1.0));
+    opt_reorder->transform(vrt::common::PercentageValidator());
+    CLI::Option* opt_reorder_window{app->add_option(
+        "--reorder-window", args.impairments.reorder_window,
+        "Largest delay of a reordered packet [packets]. Default is 8. At most this many packets are held in memory.")};
+    opt_reorder_window->check(CLI::PositiveNumber);
+    CLI::Option* opt_corrupt{app->add_option("--corrupt", args.impairments.prob_corrupt,
+                                             "Probability that a random bit is flipped in the body of a packet")};
+    opt_corrupt->check(CLI::Range(0.0, 1.0));
+    opt_corrupt->transform(vrt::common::PercentageValidator());
+    CLI::Option* opt_truncate{app->add_option(
+        "--truncate", args.impairments.prob_truncate,
+        "Probability that the end of a packet after the fields section is cut off. The packet size in the header is "
+        "changed to match, so that the following packets can still be read.")};
+    opt_truncate->check(CLI::Range(0.0, 1.0));
+    opt_truncate->transform(vrt::common::PercentageValidator());
+
+    // Seed
+    app->add_option("-s,--seed", args.seed,
+                    "Seed of random numbers, for reproducible runs. Default is a random seed, which is printed.");
 
     // Byte swap
     app->add_flag("-b,--byte-swap", args.do_byte_swap,
@@ -72,6 +116,7 @@ int main(int argc, const char** argv) {
     CLI::App                           app(CMAKE_PROJECT_DESCRIPTION, CMAKE_PROJECT_NAME);
     vrt::packet_loss::ProgramArguments program_args{setup_arg_parse(&app)};
     CLI11_PARSE(app, argc, argv)
+    program_args.has_seed = app.count("--seed") != 0;
 
     // Parameter validation
     try {
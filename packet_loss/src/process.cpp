@@ -1,17 +1,27 @@
 #include "process.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
 
 #include "vrt/vrt_types.h"
+#include "vrt/vrt_util.h"
 
 #include "Progress-CPP/ProgressBar.hpp"
+#include "common/counter_random.h"
 #include "common/input_stream.h"
 #include "common/output_stream.h"
+#include "impairments.h"
+#include "loss_model.h"
 #include "program_arguments.h"
 
 namespace vrt::packet_loss {
@@ -19,27 +29,122 @@ namespace vrt::packet_loss {
 // For convenience
 using PacketPtr = std::shared_ptr<vrt_packet>;
 
+/**
+ * Number of packets that random numbers are drawn for at a time.
+ */
+static constexpr uint64_t BATCH_PACKETS{4096};
+
+/**
+ * Achieved loss of packets.
+ */
+struct LossStats {
+    uint64_t n_packets{0};     /**< Number of packets. */
+    uint64_t n_lost{0};        /**< Number of lost packets. */
+    uint64_t n_bursts{0};      /**< Number of runs of lost packets. */
+    uint64_t longest_burst{0}; /**< Longest run of lost packets. */
+    uint64_t burst{0};         /**< Length of current run of lost packets. */
+
+    /**
+     * Add packet.
+     *
+     * \param is_lost If packet is lost.
+     */
+    void add(bool is_lost) {
+        n_packets++;
+        if (is_lost) {
+            n_lost++;
+            if (burst == 0) {
+                n_bursts++;
+            }
+            burst++;
+            longest_burst = std::max(longest_burst, burst);
+        } else {
+            burst = 0;
+        }
+    }
+};
+
+/**
+ * Print achieved loss.
+ *
+ * \param name  Name of packets, e.g. "Stream ID ABABABAB: ".
+ * \param stats Loss statistics.
+ */
+static void print_stats(const std::string& name, const LossStats& stats) {
+    std::streamsize initial_prec{std::cout.precision()};
+    std::cout << std::fixed << std::setprecision(2) << name << stats.n_lost << " out of " << stats.n_packets
+              << " packets (" << 100.0 * static_cast<double>(stats.n_lost) / static_cast<double>(stats.n_packets)
+              << " %) were lost, in " << stats.n_bursts << " bursts";
+    if (stats.n_bursts != 0) {
+        std::cout << " of mean length "
+                  << static_cast<double>(stats.n_lost) / static_cast<double>(stats.n_bursts)
+                  << " and longest " << stats.longest_burst;
+    }
+    std::cout << std::endl;
+
+    // Reset streams to default
+    std::cout << std::setprecision(initial_prec) << std::defaultfloat;
+}
+
+/**
+ * Make loss model from program arguments.
+ *
+ * \param args Program arguments.
+ *
+ * \return Loss model.
+ *
+ * \throw std::runtime_error On invalid model.
+ */
+static std::unique_ptr<LossModel> make_model(const ProgramArguments& args) {
+    std::unique_ptr<LossModel> model;
+    if (!args.loss_model.empty()) {
+        model = make_loss_model(args.loss_model);
+    } else {
+        model = std::make_unique<MarkovLossModel>(args.prob_packet_loss, args.prob_burst_loss);
+    }
+    if (!args.loss_profiles.empty()) {
+        model = std::make_unique<StreamLossModel>(args.loss_profiles, std::move(model));
+    }
+
+    return model;
+}
+
 /**
  * Constructor.
  *
  * \param args Program arguments.
+ *
+ * \throw std::runtime_error On invalid loss model.
  */
-Processor::Processor(const ProgramArguments& args) : program_args_{args}, e2_{rd_()}, dist_{0.0, 1.0} {}
+Processor::Processor(const ProgramArguments& args)
+    : program_args_{args},
+      seed_{common::get_seed(args.has_seed, args.seed)},
+      random_{seed_},
+      draws_(DRAWS_PER_PACKET * BATCH_PACKETS),
+      model_{make_model(args)} {}
 
 /**
- * Calculate if a packet shall be lost.
+ * Calculate if a packet shall be lost. The random numbers of a packet only depend on the seed and the packet index,
+ * and are drawn in batches.
+ *
+ * \param i      Packet index, in increasing order from 0.
+ * \param packet Packet.
  *
  * \return True if the packet shall be considered lost.
  */
-bool Processor::lost() {
-    double r{dist_(e2_)};
-    double lim{program_args_.prob_packet_loss};
-    if (program_args_.prob_burst_loss != 0.0 && prev_lost_) {
-        lim = program_args_.prob_burst_loss;
+bool Processor::lost(uint64_t i, const vrt_packet& packet) {
+    // Each random number of a packet is from its own part of the counter range
+    if (i % BATCH_PACKETS == 0) {
+        for (size_t k{0}; k < DRAWS_PER_PACKET; ++k) {
+            random_.uniform((static_cast<uint64_t>(k) << 60U) + i, draws_.data() + k * BATCH_PACKETS, BATCH_PACKETS);
+        }
+    }
+    double r[DRAWS_PER_PACKET];
+    for (size_t k{0}; k < DRAWS_PER_PACKET; ++k) {
+        r[k] = draws_[k * BATCH_PACKETS + i % BATCH_PACKETS];
     }
 
-    prev_lost_ = r <= lim;
-    return prev_lost_;
+    return model_->lost(packet, r);
 }
 
 /**
@@ -50,12 +155,14 @@ bool Processor::lost() {
 void Processor::process() {
     common::InputStream  input_stream(program_args_.file_path_in, program_args_.do_byte_swap);
     common::OutputStream output_stream(program_args_.file_path_out);
+    Impairments          impairments(program_args_.impairments, seed_, program_args_.do_byte_swap, &output_stream);
 
     // Progress bar
     progresscpp::ProgressBar progress(static_cast<uint64_t>(input_stream.get_file_size()), 70);
 
-    // Number of lost packets
-    uint64_t n_lost{0};
+    // Achieved loss, in total and by Stream ID, or -1 if none
+    LossStats                    stats;
+    std::map<int64_t, LossStats> stream_stats;
 
     // Go over all packets in input file
     uint64_t i{0};
@@ -66,11 +173,17 @@ void Processor::process() {
         }
         PacketPtr packet{input_stream.get_packet()};
 
-        if (lost()) {
-            n_lost++;
+        bool is_lost{lost(i, *packet)};
+        if (!is_lost) {
+            // Write input packet to output, possibly impaired or later
+            impairments.write(i, input_stream.get_buffer(), *packet);
         } else {
-            // Write input packet to output
-            output_stream.write(input_stream.get_buffer(), packet->header.packet_size);
+            impairments.advance(i);
+        }
+        stats.add(is_lost);
+        if (!program_args_.loss_profiles.empty()) {
+            stream_stats[vrt_has_stream_id(&packet->header) ? static_cast<int64_t>(packet->fields.stream_id) : -1]
+                .add(is_lost);
         }
 
         // Handle progress bar
@@ -80,21 +193,37 @@ void Processor::process() {
         }
     }
 
+    impairments.flush();
+
     progress.done();
 
+    if (!program_args_.has_seed) {
+        std::cout << "Seed: " << seed_ << std::endl;
+    }
+
     if (i == 0) {
         std::cerr << "Warning: No packets in file" << std::endl;
     } else {
-        if (n_lost == 0) {
+        if (stats.n_lost == 0 && !impairments.is_enabled()) {
             std::cerr << "Warning: 0 out of " << i << " packets were lost. Try increasing probability of packet loss."
                       << std::endl;
         } else {
-            std::streamsize initial_prec{std::cout.precision()};
-            std::cout << std::fixed << std::setprecision(2) << n_lost << " out of " << i << " packets ("
-                      << 100.0 * static_cast<double>(n_lost) / static_cast<double>(i) << " %) were lost" << std::endl;
-
-            // Reset streams to default
-            std::cout << std::setprecision(initial_prec) << std::defaultfloat;
+            print_stats("", stats);
+        }
+        if (impairments.is_enabled()) {
+            std::cout << impairments.get_number_of_duplicated() << " duplicated, "
+                      << impairments.get_number_of_reordered() << " reordered, "
+                      << impairments.get_number_of_corrupted() << " corrupted and "
+                      << impairments.get_number_of_truncated() << " truncated packets" << std::endl;
+        }
+        for (const auto& [id, s] : stream_stats) {
+            std::stringstream ss;
+            if (id < 0) {
+                ss << "No Stream ID: ";
+            } else {
+                ss << "Stream ID " << std::hex << std::uppercase << id << ": ";
+            }
+            print_stats(ss.str(), s);
         }
     }
 }
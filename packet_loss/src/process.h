@@ -1,7 +1,14 @@
 #ifndef VRT_PACKET_LOSS_SRC_PROCESS_H_
 #define VRT_PACKET_LOSS_SRC_PROCESS_H_
 
-#include <random>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/counter_random.h"
+#include "loss_model.h"
+
+struct vrt_packet;
 
 namespace vrt::packet_loss {
 struct ProgramArguments;
@@ -18,13 +25,12 @@ class Processor {
    private:
     const ProgramArguments& program_args_;
 
-    bool lost();
-
-    std::random_device               rd_;
-    std::mt19937                     e2_;
-    std::uniform_real_distribution<> dist_;
+    bool lost(uint64_t i, const vrt_packet& packet);
 
-    bool prev_lost_{false};
+    const uint64_t             seed_;
+    common::CounterRandom      random_;
+    std::vector<double>        draws_; /**< Random numbers of a batch of packets. */
+    std::unique_ptr<LossModel> model_;
 };
 
 }  // namespace vrt::packet_loss
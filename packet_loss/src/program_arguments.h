@@ -1,7 +1,11 @@
 #ifndef VRT_PACKET_LOSS_SRC_PROGRAM_ARGUMENTS_H_
 #define VRT_PACKET_LOSS_SRC_PROGRAM_ARGUMENTS_H_
 
+#include <cstdint>
 #include <filesystem>
+#include <string>
+
+#include "impairments.h"
 
 namespace vrt::packet_loss {
 
@@ -13,7 +17,12 @@ struct ProgramArguments {
     std::filesystem::path file_path_out{};
     double                prob_packet_loss{0.0};
     double                prob_burst_loss{0.0};
+    std::string           loss_model{};
+    std::filesystem::path loss_profiles{};
+    ImpairmentArguments   impairments{};
     bool                  do_byte_swap{false};
+    uint64_t              seed{0};
+    bool                  has_seed{false};
 };
 
 }  // namespace vrt::packet_loss
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <vector>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "../../src/impairments.h"
+#include "common/byte_swap.h"
+#include "common/generate_packet_sequence.h"
+#include "common/input_stream.h"
+#include "common/output_stream.h"
+
+using namespace vrt;
+
+namespace fs = ::std::filesystem;
+
+static const fs::path TMP_DIR{"test_tmp"};
+static const fs::path TMP_FILE_IN_PATH{TMP_DIR / "impairments_in.vrt"};
+static const fs::path TMP_FILE_OUT_PATH{TMP_DIR / "impairments_out.vrt"};
+
+static const uint64_t N_PACKETS{2000};
+static const int32_t  WORDS_BODY{4};
+static const int32_t  WORDS_FRONT{3}; /**< Header, Stream ID and integer seconds timestamp [words]. */
+
+/**
+ * Packet read from output.
+ */
+struct OutPacket {
+    uint32_t              index;      /**< Index of packet in input. */
+    uint16_t              words;      /**< Packet size in header [words]. */
+    int32_t               words_body; /**< Body size [words]. */
+    std::vector<uint32_t> body;       /**< Body. */
+};
+
+/**
+ * \param i Packet index.
+ * \param k Word index in body.
+ *
+ * \return Body word of input packet.
+ */
+static uint32_t body_word(uint64_t i, int32_t k) {
+    return static_cast<uint32_t>(0x01010101U * (i % 256)) ^ static_cast<uint32_t>(k);
+}
+
+class ImpairmentsTest : public ::testing::Test {
+   protected:
+    ImpairmentsTest() : p_() {}
+
+    void SetUp() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+        fs::create_directory(TMP_DIR);
+        vrt_init_packet(&p_);
+        p_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+        p_.header.tsi         = VRT_TSI_UTC;
+        p_.words_body         = WORDS_BODY;
+    }
+    void TearDown() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+    }
+
+    /**
+     * Write input file, with packet index as integer seconds timestamp, and run impairments on all packets.
+     *
+     * \param do_byte_swap If packets are byte swapped.
+     *
+     * \return Packets in output file.
+     */
+    std::vector<OutPacket> run(bool do_byte_swap = false) {
+        std::vector<uint32_t> body(WORDS_BODY);
+        p_.body = body.data();
+        common::generate_packet_sequence(
+            TMP_FILE_IN_PATH, &p_, N_PACKETS,
+            [&](uint64_t i) {
+                p_.fields.integer_seconds_timestamp = static_cast<uint32_t>(i);
+                for (int32_t k{0}; k < WORDS_BODY; ++k) {
+                    body[k] = body_word(i, k);
+                }
+            },
+            do_byte_swap);
+        p_.body = nullptr;
+
+        {
+            common::InputStream  input_stream(TMP_FILE_IN_PATH, do_byte_swap);
+            common::OutputStream output_stream(TMP_FILE_OUT_PATH);
+            packet_loss::Impairments impairments(args_, 1, do_byte_swap, &output_stream);
+            for (uint64_t i{0}; input_stream.read_next_packet(); ++i) {
+                impairments.write(i, input_stream.get_buffer(), *input_stream.get_packet());
+            }
+            impairments.flush();
+
+            n_duplicated_ = impairments.get_number_of_duplicated();
+            n_reordered_  = impairments.get_number_of_reordered();
+            n_corrupted_  = impairments.get_number_of_corrupted();
+            n_truncated_  = impairments.get_number_of_truncated();
+        }
+
+        std::vector<OutPacket> packets;
+        common::InputStream    input_stream(TMP_FILE_OUT_PATH, do_byte_swap);
+        while (input_stream.read_next_packet()) {
+            const vrt_packet& p{*input_stream.get_packet()};
+            OutPacket         packet;
+            packet.index      = p.fields.integer_seconds_timestamp;
+            packet.words      = p.header.packet_size;
+            packet.words_body = p.words_body;
+            if (p.body != nullptr) {
+                const auto* b{static_cast<const uint32_t*>(p.body)};
+                packet.body.assign(b, b + p.words_body);
+                if (do_byte_swap) {
+                    for (uint32_t& w : packet.body) {
+                        w = bswap_32(w);
+                    }
+                }
+            }
+            packets.push_back(packet);
+        }
+        return packets;
+    }
+
+    vrt_packet                       p_;
+    packet_loss::ImpairmentArguments args_;
+    uint64_t                         n_duplicated_{0};
+    uint64_t                         n_reordered_{0};
+    uint64_t                         n_corrupted_{0};
+    uint64_t                         n_truncated_{0};
+};
+
+TEST_F(ImpairmentsTest, None) {
+    std::vector<OutPacket> packets{run()};
+    ASSERT_EQ(packets.size(), N_PACKETS);
+    for (uint64_t i{0}; i < packets.size(); ++i) {
+        ASSERT_EQ(packets[i].index, i);
+    }
+}
+
+TEST_F(ImpairmentsTest, Reorder) {
+    args_.prob_reorder   = 0.3;
+    args_.prob_duplicate = 0.1;
+    args_.reorder_window = 5;
+    std::vector<OutPacket> packets{run()};
+
+    // Every packet is written, so no delayed packet is left after flush
+    ASSERT_GT(n_reordered_, 0);
+    ASSERT_EQ(packets.size(), N_PACKETS + n_duplicated_);
+
+    // A packet departs at the latest before the packet reorder window after it
+    uint32_t max_index{0};
+    uint64_t n_passed{0};
+    for (const OutPacket& packet : packets) {
+        if (max_index > packet.index) {
+            ASSERT_LT(max_index, packet.index + args_.reorder_window);
+            n_passed++;
+        }
+        max_index = std::max(max_index, packet.index);
+    }
+    ASSERT_GT(n_passed, 0);
+}
+
+TEST_F(ImpairmentsTest, Duplicate) {
+    args_.prob_duplicate = 0.2;
+    std::vector<OutPacket> packets{run()};
+    ASSERT_GT(n_duplicated_, 0);
+    ASSERT_LT(n_duplicated_, N_PACKETS);
+    ASSERT_EQ(packets.size(), N_PACKETS + n_duplicated_);
+
+    // Copies are written right after each other
+    std::map<uint32_t, uint64_t> n_copies;
+    for (uint64_t j{0}; j < packets.size(); ++j) {
+        if (++n_copies[packets[j].index] == 2) {
+            ASSERT_EQ(packets[j - 1].index, packets[j].index);
+        }
+    }
+    ASSERT_EQ(n_copies.size(), N_PACKETS);
+    ASSERT_EQ(std::count_if(n_copies.begin(), n_copies.end(), [](const auto& c) { return c.second == 2; }),
+              n_duplicated_);
+}
+
+TEST_F(ImpairmentsTest, Corrupt) {
+    args_.prob_corrupt = 0.3;
+    std::vector<OutPacket> packets{run()};
+    ASSERT_EQ(packets.size(), N_PACKETS);
+
+    // Exactly one bit is flipped, in the body
+    uint64_t n_corrupted{0};
+    for (const OutPacket& packet : packets) {
+        ASSERT_EQ(packet.words_body, WORDS_BODY);
+        size_t n_bits{0};
+        for (int32_t k{0}; k < WORDS_BODY; ++k) {
+            n_bits += std::bitset<32>(packet.body[k] ^ body_word(packet.index, k)).count();
+        }
+        ASSERT_LE(n_bits, 1);
+        n_corrupted += n_bits;
+    }
+    ASSERT_GT(n_corrupted, 0);
+    ASSERT_EQ(n_corrupted, n_corrupted_);
+}
+
+TEST_F(ImpairmentsTest, Truncate) {
+    for (bool do_byte_swap : {false, true}) {
+        args_.prob_truncate = 0.3;
+        std::vector<OutPacket> packets{run(do_byte_swap)};
+
+        // Later packets still parse, since packet size is rewritten
+        ASSERT_EQ(packets.size(), N_PACKETS);
+        uint64_t n_truncated{0};
+        for (uint64_t i{0}; i < packets.size(); ++i) {
+            const OutPacket& packet{packets[i]};
+            ASSERT_EQ(packet.index, i);
+            ASSERT_LE(packet.words_body, WORDS_BODY);
+            ASSERT_EQ(packet.words, packet.words_body + WORDS_FRONT);
+            for (int32_t k{0}; k < packet.words_body; ++k) {
+                ASSERT_EQ(packet.body[k], body_word(i, k));
+            }
+            if (packet.words_body < WORDS_BODY) {
+                n_truncated++;
+            }
+        }
+        ASSERT_GT(n_truncated, 0);
+        ASSERT_EQ(n_truncated, n_truncated_);
+    }
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "../../src/loss_model.h"
+
+using namespace vrt;
+
+namespace fs = ::std::filesystem;
+
+static const fs::path TMP_DIR{"test_tmp"};
+static const fs::path TMP_FILE_PATH{TMP_DIR / "loss_model.txt"};
+
+class LossModelTest : public ::testing::Test {
+   protected:
+    LossModelTest() : p_() {}
+
+    void SetUp() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+        fs::create_directory(TMP_DIR);
+        vrt_init_packet(&p_);
+        p_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    }
+    void TearDown() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+    }
+
+    /**
+     * Write file.
+     */
+    static void write_file(const std::string& contents) {
+        std::ofstream file(TMP_FILE_PATH, std::ios::out | std::ios::binary);
+        file << contents;
+    }
+
+    /**
+     * Run model over packets with fixed random numbers.
+     *
+     * \param model Model.
+     * \param draws Random numbers of each packet.
+     *
+     * \return If each packet is lost.
+     */
+    std::vector<bool> run(packet_loss::LossModel* model, const std::vector<std::vector<double>>& draws) {
+        std::vector<bool> lost;
+        for (const std::vector<double>& r : draws) {
+            lost.push_back(model->lost(p_, r.data()));
+        }
+        return lost;
+    }
+
+    vrt_packet p_;
+};
+
+TEST_F(LossModelTest, Markov) {
+    packet_loss::MarkovLossModel model(0.2, 0.7);
+    ASSERT_EQ(run(&model, {{0.5, 0.0}, {0.1, 0.0}, {0.5, 0.0}, {0.6, 0.0}, {0.8, 0.0}, {0.5, 0.0}}),
+              (std::vector<bool>{false, true, true, true, false, false}));
+
+    // No burst probability is the same as the loss probability
+    packet_loss::MarkovLossModel model_no_burst(0.2, 0.0);
+    ASSERT_EQ(run(&model_no_burst, {{0.1, 0.0}, {0.5, 0.0}, {0.2, 0.0}}), (std::vector<bool>{true, false, true}));
+}
+
+TEST_F(LossModelTest, GilbertElliott) {
+    // Always lost in bad state, and never in good state, so loss shows the state
+    packet_loss::GilbertElliottLossModel model(0.1, 0.3, 0.0, 1.0);
+    ASSERT_EQ(run(&model,
+                  {
+                      {0.5, 0.5},   // Stays good
+                      {0.5, 0.05},  // Good to bad
+                      {0.5, 0.5},   // Stays bad
+                      {0.5, 0.2},   // Bad to good
+                      {0.5, 0.2},   // Stays good, since only the good to bad probability applies
+                      {0.5, 0.05},  // Good to bad
+                  }),
+              (std::vector<bool>{false, true, true, false, false, true}));
+
+    // Loss probabilities of states
+    packet_loss::GilbertElliottLossModel model_loss(1.0, 0.0, 0.0, 0.25);
+    ASSERT_EQ(run(&model_loss, {{0.2, 0.5}, {0.3, 0.5}}), (std::vector<bool>{true, false}));
+}
+
+TEST_F(LossModelTest, Trace) {
+    // Least significant bit first, and repeated
+    write_file(std::string{'\x05', '\x80'});
+    packet_loss::TraceLossModel model(TMP_FILE_PATH);
+    std::vector<bool> expected(16, false);
+    expected[0]  = true;
+    expected[2]  = true;
+    expected[15] = true;
+    for (int k{0}; k < 3; ++k) {
+        ASSERT_EQ(run(&model, std::vector<std::vector<double>>(16, {0.0, 0.0})), expected);
+    }
+
+    write_file("");
+    ASSERT_THROW(packet_loss::TraceLossModel{TMP_FILE_PATH}, std::runtime_error);
+    ASSERT_THROW(packet_loss::TraceLossModel{TMP_DIR / "no_such_file"}, std::runtime_error);
+}
+
+TEST_F(LossModelTest, Spec) {
+    // Probabilities as ratios or percentages
+    std::unique_ptr<packet_loss::LossModel> model{packet_loss::make_loss_model("markov:50%")};
+    ASSERT_EQ(run(model.get(), {{0.4, 0.0}, {0.6, 0.0}}), (std::vector<bool>{true, false}));
+    model = packet_loss::make_loss_model("gilbert-elliott:1,0,0,0.5");
+    ASSERT_EQ(run(model.get(), {{0.4, 0.0}, {0.6, 0.0}}), (std::vector<bool>{true, false}));
+    ASSERT_NO_THROW(packet_loss::make_loss_model("markov:0.01,30%"));
+    ASSERT_NO_THROW(packet_loss::make_loss_model("gilbert-elliott:1%,30%,0,100%"));
+
+    ASSERT_THROW(packet_loss::make_loss_model(""), std::runtime_error);
+    ASSERT_THROW(packet_loss::make_loss_model("markov"), std::runtime_error);
+    ASSERT_THROW(packet_loss::make_loss_model("markov:"), std::runtime_error);
+    ASSERT_THROW(packet_loss::make_loss_model("markov:0.1,0.2,0.3"), std::runtime_error);
+    ASSERT_THROW(packet_loss::make_loss_model("markov:1.5"), std::runtime_error);
+    ASSERT_THROW(packet_loss::make_loss_model("markov:-1%"), std::runtime_error);
+    ASSERT_THROW(packet_loss::make_loss_model("markov:0.1x"), std::runtime_error);
+    ASSERT_THROW(packet_loss::make_loss_model("markov:abc"), std::runtime_error);
+    ASSERT_THROW(packet_loss::make_loss_model("gilbert-elliott:0.1,0.2,0.3"), std::runtime_error);
+    ASSERT_THROW(packet_loss::make_loss_model("bernoulli:0.1"), std::runtime_error);
+    ASSERT_THROW(packet_loss::make_loss_model("trace:"), std::runtime_error);
+    ASSERT_THROW(packet_loss::make_loss_model("trace:" + (TMP_DIR / "no_such_file").string()), std::runtime_error);
+}
+
+TEST_F(LossModelTest, Profiles) {
+    write_file(
+        "# Stream ID and model\n"
+        "\n"
+        "ABABABAB markov:1   # Always lost\n"
+        "  1 markov:0\n");
+    packet_loss::StreamLossModel model(TMP_FILE_PATH, std::make_unique<packet_loss::MarkovLossModel>(0.5, 0.0));
+    const double r[]{0.4, 0.0};
+
+    p_.fields.stream_id = 0xABABABAB;
+    ASSERT_TRUE(model.lost(p_, r));
+    p_.fields.stream_id = 1;
+    ASSERT_FALSE(model.lost(p_, r));
+
+    // Default model
+    p_.fields.stream_id = 2;
+    ASSERT_TRUE(model.lost(p_, r));
+    p_.header.packet_type = VRT_PT_IF_DATA_WITHOUT_STREAM_ID;
+    p_.fields.stream_id   = 1;
+    ASSERT_TRUE(model.lost(p_, r));
+}
+
+TEST_F(LossModelTest, ProfilesInvalid) {
+    for (const char* contents : {
+             "1 markov:0\n1 markov:1\n",   // Duplicate Stream ID
+             "01 markov:0\n1 markov:1\n",  // Duplicate Stream ID, written differently
+             "XYZ markov:0\n",             // Not hexadecimal
+             "1X markov:0\n",              // Not hexadecimal
+             "100000000 markov:0\n",       // Too large
+             "1\n",                        // No model
+             "1 markov:0 markov:1\n",      // Extra text
+             "1 markov:2\n",               // Invalid model
+         }) {
+        write_file(contents);
+        ASSERT_THROW(packet_loss::StreamLossModel(TMP_FILE_PATH, std::make_unique<packet_loss::MarkovLossModel>(0, 0)),
+                     std::runtime_error)
+            << contents;
+    }
+    ASSERT_THROW(packet_loss::StreamLossModel(TMP_DIR / "no_such_file",
+                                              std::make_unique<packet_loss::MarkovLossModel>(0, 0)),
+                 std::runtime_error);
+}
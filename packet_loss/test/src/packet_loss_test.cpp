@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "../../src/process.h"
+#include "../../src/program_arguments.h"
+#include "common/counter_random.h"
+#include "common/generate_packet_sequence.h"
+
+using namespace vrt;
+
+namespace fs = ::std::filesystem;
+
+static const fs::path TMP_DIR{"test_tmp"};
+static const fs::path TMP_FILE_IN_PATH{TMP_DIR / "packet_loss_in.vrt"};
+static const fs::path TMP_FILE_OUT_PATH{TMP_DIR / "packet_loss_out.vrt"};
+
+/**
+ * \return Contents of file.
+ */
+static std::vector<char> read_bytes(const fs::path& file_path) {
+    std::ifstream file(file_path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+class PacketLossTest : public ::testing::Test {
+   protected:
+    PacketLossTest() : p_() {}
+
+    void SetUp() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+        fs::create_directory(TMP_DIR);
+        vrt_init_packet(&p_);
+        p_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+        p_.header.tsi         = VRT_TSI_UTC;
+        p_.header.tsf         = VRT_TSF_REAL_TIME;
+        p_.words_body         = 4;
+
+        args_.file_path_in  = TMP_FILE_IN_PATH;
+        args_.file_path_out = TMP_FILE_OUT_PATH;
+        args_.seed          = 1;
+        args_.has_seed      = true;
+    }
+    void TearDown() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+    }
+
+    /**
+     * Write input file with packets, with packet index in body.
+     */
+    void generate(uint64_t n) {
+        std::vector<uint32_t> body(4, 0);
+        p_.body = body.data();
+        common::generate_packet_sequence(TMP_FILE_IN_PATH, &p_, n, [&](uint64_t i) {
+            p_.header.packet_count              = static_cast<uint8_t>(i % 16);
+            p_.fields.stream_id                 = static_cast<uint32_t>(i % 3);
+            p_.fields.integer_seconds_timestamp = static_cast<uint32_t>(i);
+            body[0]                             = static_cast<uint32_t>(i);
+        });
+        p_.body = nullptr;
+    }
+
+    /**
+     * \return Output file contents.
+     */
+    std::vector<char> process() {
+        packet_loss::Processor(args_).process();
+        return read_bytes(TMP_FILE_OUT_PATH);
+    }
+
+    vrt_packet                    p_;
+    packet_loss::ProgramArguments args_;
+};
+
+TEST_F(PacketLossTest, Seed) {
+    generate(10000);
+    args_.prob_packet_loss = 0.3;
+    args_.prob_burst_loss  = 0.6;
+    std::vector<char> out{process()};
+    ASSERT_FALSE(out.empty());
+    ASSERT_LT(out.size(), fs::file_size(TMP_FILE_IN_PATH));
+    ASSERT_EQ(process(), out);
+
+    args_.seed = 2;
+    ASSERT_NE(process(), out);
+}
+
+TEST_F(PacketLossTest, SeedImpairments) {
+    generate(10000);
+    args_.prob_packet_loss           = 0.1;
+    args_.impairments.prob_duplicate = 0.1;
+    args_.impairments.prob_reorder   = 0.1;
+    args_.impairments.prob_corrupt   = 0.1;
+    args_.impairments.prob_truncate  = 0.1;
+    std::vector<char> out{process()};
+    ASSERT_FALSE(out.empty());
+    ASSERT_EQ(process(), out);
+
+    args_.seed = 2;
+    ASSERT_NE(process(), out);
+}
+
+TEST_F(PacketLossTest, CounterRandom) {
+    common::CounterRandom random(7);
+    std::vector<double>   values(1000);
+    random.uniform(12345, values.data(), values.size());
+    for (size_t i{0}; i < values.size(); ++i) {
+        ASSERT_EQ(values[i], random.uniform(12345 + i));
+        ASSERT_GE(values[i], 0.0);
+        ASSERT_LT(values[i], 1.0);
+    }
+
+    // Same seed gives same numbers, and other seeds other numbers
+    ASSERT_EQ(common::CounterRandom(7).get(3), random.get(3));
+    ASSERT_NE(common::CounterRandom(8).get(3), random.get(3));
+    ASSERT_NE(random.get(3), random.get(4));
+
+    // Largest number is still below 1
+    ASSERT_LT(static_cast<double>(UINT64_MAX >> 11U) * 0x1.0p-53, 1.0);
+}
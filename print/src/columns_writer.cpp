@@ -0,0 +1,48 @@
+#include "columns_writer.h"
+
+#include <algorithm>
+#include <string_view>
+
+namespace vrt::print {
+
+/**
+ * Line printed before each packet.
+ */
+static constexpr std::string_view SEPARATOR{
+    "--------------------------------------------------------------------------------\n"};
+
+void ColumnsWriter::begin_packet() {
+    out_->append(SEPARATOR);
+}
+
+void ColumnsWriter::on_begin_group(std::string_view /*key*/, std::string_view label) {
+    out_->append_fill(' ', 2 * indentation_level_);
+    out_->append(label);
+    out_->append('\n');
+    indentation_level_++;
+}
+
+void ColumnsWriter::on_end_group() {
+    indentation_level_--;
+}
+
+void ColumnsWriter::on_begin_list(std::string_view /*key*/, std::string_view label) {
+    out_->append(label);
+    out_->append('\n');
+}
+
+void ColumnsWriter::on_end_list() {}
+
+void ColumnsWriter::write_value(std::string_view /*key*/,
+                                std::string_view label,
+                                const ValueStr&  value,
+                                bool             is_derived) {
+    // Derived values are indented below the value they are derived from
+    WriteCols(out_, label, value, is_derived ? std::max(indentation_level_, 1U) : indentation_level_);
+}
+
+void ColumnsWriter::write_list_item(const ValueStr& value) {
+    WriteCols(out_, "", value, indentation_level_ + 1);
+}
+
+}  // namespace vrt::print
@@ -0,0 +1,41 @@
+#ifndef VRT_PRINT_SRC_COLUMNS_WRITER_H_
+#define VRT_PRINT_SRC_COLUMNS_WRITER_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "output_buffer.h"
+#include "stringify.h"
+#include "writer.h"
+
+namespace vrt::print {
+
+/**
+ * Writes packets in a human readable 80 column table format.
+ */
+class ColumnsWriter : public Writer {
+   public:
+    ColumnsWriter(OutputBuffer* out, const std::vector<std::string>& fields) : Writer(out, fields) {}
+
+    void begin_packet() override;
+    void end_packet() override {}
+
+   protected:
+    void on_begin_group(std::string_view key, std::string_view label) override;
+    void on_end_group() override;
+    void on_begin_list(std::string_view key, std::string_view label) override;
+    void on_end_list() override;
+    void write_value(std::string_view key, std::string_view label, const ValueStr& value, bool is_derived) override;
+    void write_list_item(const ValueStr& value) override;
+
+   private:
+    /**
+     * Indentation level of fields in current group.
+     */
+    unsigned indentation_level_{0};
+};
+
+}  // namespace vrt::print
+
+#endif
@@ -0,0 +1,166 @@
+#include "delimited_writer.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "type_printer.h"
+
+namespace vrt::print {
+
+/**
+ * Columns used if no fields are selected.
+ */
+static const std::vector<std::string> DEFAULT_COLUMNS{"index",
+                                                      "packet_type",
+                                                      "tsm",
+                                                      "tsi",
+                                                      "tsf",
+                                                      "packet_count",
+                                                      "packet_size",
+                                                      "stream_id",
+                                                      "class_id.oui",
+                                                      "class_id.information_class_code",
+                                                      "class_id.packet_class_code",
+                                                      "integer_seconds_timestamp",
+                                                      "fractional_seconds_timestamp",
+                                                      "body_size"};
+
+/**
+ * Constructor.
+ *
+ * \param out       Buffer to write to.
+ * \param fields    Field keys, one per column. Uses a default set of columns if empty.
+ * \param delimiter Column delimiter.
+ *
+ * \throw std::runtime_error If a field key doesn't name a single field or list.
+ */
+DelimitedWriter::DelimitedWriter(OutputBuffer* out, const std::vector<std::string>& fields, char delimiter)
+    : Writer(out, fields.empty() ? DEFAULT_COLUMNS : fields),
+      delimiter_{delimiter},
+      columns_{fields.empty() ? DEFAULT_COLUMNS : fields},
+      cells_(columns_.size()) {
+    // A group, or a misspelled key, would be a column that is always empty
+    for (const std::string& column : columns_) {
+        if (!is_field_key(column)) {
+            std::stringstream ss;
+            ss << "Field key '" << column << "' doesn't name a single field, which is needed for csv and tsv";
+            throw std::runtime_error(ss.str());
+        }
+    }
+}
+
+/**
+ * Write header row.
+ */
+void DelimitedWriter::begin_stream() {
+    for (size_t i{0}; i < columns_.size(); ++i) {
+        if (i != 0) {
+            out_->append(delimiter_);
+        }
+        write_cell(columns_[i]);
+    }
+    out_->append('\n');
+}
+
+void DelimitedWriter::begin_packet() {
+    for (std::string& cell : cells_) {
+        cell.clear();
+    }
+}
+
+void DelimitedWriter::end_packet() {
+    for (size_t i{0}; i < cells_.size(); ++i) {
+        if (i != 0) {
+            out_->append(delimiter_);
+        }
+        write_cell(cells_[i]);
+    }
+    out_->append('\n');
+}
+
+void DelimitedWriter::on_begin_list(std::string_view key, std::string_view /*label*/) {
+    list_cell_ = find_cell(key);
+}
+
+void DelimitedWriter::on_end_list() {
+    list_cell_ = nullptr;
+}
+
+void DelimitedWriter::write_value(std::string_view key,
+                                  std::string_view /*label*/,
+                                  const ValueStr&  value,
+                                  bool /*is_derived*/) {
+    std::string* cell{find_cell(key)};
+    if (cell != nullptr) {
+        cell->assign(value.view());
+    }
+}
+
+void DelimitedWriter::write_list_item(const ValueStr& value) {
+    if (list_cell_ == nullptr) {
+        return;
+    }
+    if (!list_cell_->empty()) {
+        *list_cell_ += ' ';
+    }
+    list_cell_->append(value.view());
+}
+
+/**
+ * Find cell of field in current group.
+ *
+ * \param key Field key.
+ *
+ * \return Cell, or nullptr if field isn't a column.
+ */
+std::string* DelimitedWriter::find_cell(std::string_view key) {
+    std::string_view k{full_key(key)};
+    for (size_t i{0}; i < columns_.size(); ++i) {
+        if (columns_[i] == k) {
+            return &cells_[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Write cell contents. Contents are quoted if needed for CSV, while tabs and line breaks are replaced with spaces for
+ * TSV.
+ *
+ * \param s Cell contents.
+ */
+void DelimitedWriter::write_cell(std::string_view s) {
+    if (delimiter_ == '\t') {
+        size_t begin{0};
+        for (size_t i{0}; i < s.size(); ++i) {
+            if (s[i] == '\t' || s[i] == '\n' || s[i] == '\r') {
+                out_->append(s.substr(begin, i - begin));
+                out_->append(' ');
+                begin = i + 1;
+            }
+        }
+        out_->append(s.substr(begin));
+        return;
+    }
+
+    if (s.find_first_of("\",\n\r") == std::string_view::npos) {
+        out_->append(s);
+        return;
+    }
+    out_->append('"');
+    size_t begin{0};
+    for (size_t i{0}; i < s.size(); ++i) {
+        if (s[i] == '"') {
+            out_->append(s.substr(begin, i + 1 - begin));
+            out_->append('"');
+            begin = i + 1;
+        }
+    }
+    out_->append(s.substr(begin));
+    out_->append('"');
+}
+
+}  // namespace vrt::print
@@ -0,0 +1,55 @@
+#ifndef VRT_PRINT_SRC_DELIMITED_WRITER_H_
+#define VRT_PRINT_SRC_DELIMITED_WRITER_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "output_buffer.h"
+#include "stringify.h"
+#include "writer.h"
+
+namespace vrt::print {
+
+/**
+ * Writes packets as delimiter separated values, e.g. CSV or TSV, with one column per selected field key and a header
+ * row. Each selected key must name a single field or list. Items in lists are separated by spaces. Fields that are not
+ * present in a packet are left empty.
+ */
+class DelimitedWriter : public Writer {
+   public:
+    DelimitedWriter(OutputBuffer* out, const std::vector<std::string>& fields, char delimiter);
+
+    void begin_stream() override;
+    void begin_packet() override;
+    void end_packet() override;
+
+   protected:
+    void on_begin_group(std::string_view /*key*/, std::string_view /*label*/) override {}
+    void on_end_group() override {}
+    void on_begin_list(std::string_view key, std::string_view label) override;
+    void on_end_list() override;
+    void write_value(std::string_view key, std::string_view label, const ValueStr& value, bool is_derived) override;
+    void write_list_item(const ValueStr& value) override;
+
+   private:
+    std::string* find_cell(std::string_view key);
+    void         write_cell(std::string_view s);
+
+    char                     delimiter_;
+    std::vector<std::string> columns_;
+
+    /**
+     * Cell contents of current row, reused between packets.
+     */
+    std::vector<std::string> cells_;
+
+    /**
+     * Cell of list currently being written. Null if none.
+     */
+    std::string* list_cell_{nullptr};
+};
+
+}  // namespace vrt::print
+
+#endif
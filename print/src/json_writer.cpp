@@ -0,0 +1,125 @@
+#include "json_writer.h"
+
+#include <string_view>
+
+namespace vrt::print {
+
+void JsonWriter::begin_packet() {
+    out_->append('{');
+    need_comma_ = false;
+}
+
+void JsonWriter::end_packet() {
+    out_->append("}\n");
+}
+
+void JsonWriter::on_begin_group(std::string_view key, std::string_view /*label*/) {
+    write_key(key);
+    out_->append('{');
+    need_comma_ = false;
+}
+
+void JsonWriter::on_end_group() {
+    out_->append('}');
+    need_comma_ = true;
+}
+
+void JsonWriter::on_begin_list(std::string_view key, std::string_view /*label*/) {
+    write_key(key);
+    out_->append('[');
+    need_comma_ = false;
+}
+
+void JsonWriter::on_end_list() {
+    out_->append(']');
+    need_comma_ = true;
+}
+
+void JsonWriter::write_value(std::string_view key,
+                             std::string_view /*label*/,
+                             const ValueStr&  value,
+                             bool /*is_derived*/) {
+    write_key(key);
+    write_scalar(value);
+    need_comma_ = true;
+}
+
+void JsonWriter::write_list_item(const ValueStr& value) {
+    if (need_comma_) {
+        out_->append(',');
+    }
+    write_scalar(value);
+    need_comma_ = true;
+}
+
+/**
+ * Write object member name, preceded by a comma if needed.
+ *
+ * \param key Member name.
+ */
+void JsonWriter::write_key(std::string_view key) {
+    if (need_comma_) {
+        out_->append(',');
+    }
+    out_->append('"');
+    out_->append(key);
+    out_->append("\":");
+}
+
+/**
+ * Write value. Text is written as a string, and numbers and bools as is.
+ *
+ * \param value Value.
+ */
+void JsonWriter::write_scalar(const ValueStr& value) {
+    if (value.is_text()) {
+        write_string(value.view());
+    } else {
+        out_->append(value.view());
+    }
+}
+
+/**
+ * Write string with quotes and escaped characters.
+ *
+ * \param s String.
+ */
+void JsonWriter::write_string(std::string_view s) {
+    static constexpr char HEX[]{"0123456789abcdef"};
+
+    out_->append('"');
+    size_t begin{0};
+    for (size_t i{0}; i < s.size(); ++i) {
+        auto c{static_cast<unsigned char>(s[i])};
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out_->append(s.substr(begin, i - begin));
+        begin = i + 1;
+        out_->append('\\');
+        switch (c) {
+            case '"':
+            case '\\':
+                out_->append(static_cast<char>(c));
+                break;
+            case '\n':
+                out_->append('n');
+                break;
+            case '\r':
+                out_->append('r');
+                break;
+            case '\t':
+                out_->append('t');
+                break;
+            default:
+                out_->append("u00");
+                out_->append(HEX[c >> 4]);
+                out_->append(HEX[c & 0xF]);
+                break;
+        }
+    }
+    out_->append(s.substr(begin));
+    out_->append('"');
+}
+
+}  // namespace vrt::print
@@ -0,0 +1,46 @@
+#ifndef VRT_PRINT_SRC_JSON_WRITER_H_
+#define VRT_PRINT_SRC_JSON_WRITER_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "output_buffer.h"
+#include "stringify.h"
+#include "writer.h"
+
+namespace vrt::print {
+
+/**
+ * Writes packets as JSON Lines, i.e. one JSON object per packet and line. Groups are nested objects and lists are
+ * arrays.
+ */
+class JsonWriter : public Writer {
+   public:
+    JsonWriter(OutputBuffer* out, const std::vector<std::string>& fields) : Writer(out, fields) {}
+
+    void begin_packet() override;
+    void end_packet() override;
+
+   protected:
+    void on_begin_group(std::string_view key, std::string_view label) override;
+    void on_end_group() override;
+    void on_begin_list(std::string_view key, std::string_view label) override;
+    void on_end_list() override;
+    void write_value(std::string_view key, std::string_view label, const ValueStr& value, bool is_derived) override;
+    void write_list_item(const ValueStr& value) override;
+
+   private:
+    void write_key(std::string_view key);
+    void write_scalar(const ValueStr& value);
+    void write_string(std::string_view s);
+
+    /**
+     * True if a comma is needed before the next member of the current object or array.
+     */
+    bool need_comma_{false};
+};
+
+}  // namespace vrt::print
+
+#endif
@@ -64,6 +64,36 @@ static vrt::print::ProgramArguments setup_arg_parse(CLI::App* app) {
     // Byte swap
     app->add_flag("-b,--byte-swap", args.do_byte_swap, "Apply byte swap before parsing file");
 
+    // Output format
+    const std::map<std::string, vrt::print::Format> formats{{"columns", vrt::print::Format::COLUMNS},
+                                                            {"json", vrt::print::Format::JSON},
+                                                            {"csv", vrt::print::Format::CSV},
+                                                            {"tsv", vrt::print::Format::TSV}};
+    CLI::Option* opt_format{app->add_option("-F,--format", args.format,
+                                            "Output format. 'columns' is human readable, while 'json' (JSON Lines, one "
+                                            "object per packet), 'csv', and 'tsv' are meant for other programs.")};
+    opt_format->transform(CLI::CheckedTransformer(formats, CLI::ignore_case));
+
+    // Field selection
+    CLI::Option* opt_fields{app->add_option(
+        "--fields", args.fields,
+        "Comma separated keys of fields to print, e.g. 'index,stream_id,class_id,bandwidth'. Keys are snake case "
+        "versions of printed names, and keys of fields in groups are prefixed by the group key, e.g. 'class_id.oui'. "
+        "Selecting a group selects all fields in it. For csv and tsv every key is a column and must name a single "
+        "field. Defaults to all fields.")};
+    opt_fields->delimiter(',');
+
+    // Jobs
+    CLI::Option* opt_jobs{app->add_option("-j,--jobs", args.n_jobs,
+                                          "Number of threads formatting packets. 0 means one per CPU core. Output is "
+                                          "the same as with one thread.")};
+    opt_jobs->check(CLI::NonNegativeNumber);
+
+    // Filter
+    app->add_option("--filter", args.filter,
+                    "Only print packets matching expression, e.g. 'stream_id==0xDEADBEEF && type==context'. Packets "
+                    "skipped and counted are the matching ones.");
+
     return args;
 }
 
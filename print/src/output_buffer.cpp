@@ -0,0 +1,34 @@
+#include "output_buffer.h"
+
+namespace vrt::print {
+
+/**
+ * Constructor.
+ *
+ * \param os       Stream to write buffered text to, or nullptr to only keep it in memory.
+ * \param capacity Buffer size [bytes] at which contents are flushed to the stream.
+ */
+OutputBuffer::OutputBuffer(std::ostream* os, size_t capacity) : os_{os}, capacity_{capacity} {
+    // Some margin so a line appended just below the threshold doesn't reallocate
+    buf_.reserve(capacity_ + 4096);
+}
+
+/**
+ * Destructor. Flushes any remaining text.
+ */
+OutputBuffer::~OutputBuffer() {
+    flush();
+}
+
+/**
+ * Write buffered text to the stream and empty the buffer. Does nothing if there is no stream.
+ */
+void OutputBuffer::flush() {
+    if (os_ == nullptr) {
+        return;
+    }
+    os_->write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+    buf_.clear();
+}
+
+}  // namespace vrt::print
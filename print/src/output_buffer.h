@@ -0,0 +1,86 @@
+#ifndef VRT_PRINT_SRC_OUTPUT_BUFFER_H_
+#define VRT_PRINT_SRC_OUTPUT_BUFFER_H_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace vrt::print {
+
+/**
+ * Large reusable character buffer that text is formatted into. Contents are written to the output stream in big
+ * chunks instead of one small write per field.
+ */
+class OutputBuffer {
+   public:
+    /**
+     * Default flush threshold [bytes].
+     */
+    static constexpr size_t DEFAULT_CAPACITY{1 << 20};
+
+    explicit OutputBuffer(std::ostream* os, size_t capacity = DEFAULT_CAPACITY);
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    /**
+     * Append string.
+     *
+     * \param s String to append.
+     */
+    void append(std::string_view s) {
+        buf_.append(s.data(), s.size());
+        flush_if_full();
+    }
+
+    /**
+     * Append character.
+     *
+     * \param c Character to append.
+     */
+    void append(char c) {
+        buf_.push_back(c);
+        flush_if_full();
+    }
+
+    /**
+     * Append the same character several times.
+     *
+     * \param c Character to append.
+     * \param n Number of times to append it.
+     */
+    void append_fill(char c, size_t n) {
+        buf_.append(n, c);
+        flush_if_full();
+    }
+
+    /**
+     * Get text that is not yet flushed.
+     *
+     * \return Buffered text.
+     */
+    std::string_view view() const { return buf_; }
+
+    void clear() { buf_.clear(); }
+    void flush();
+
+   private:
+    void flush_if_full() {
+        if (os_ != nullptr && buf_.size() >= capacity_) {
+            flush();
+        }
+    }
+
+    /**
+     * Stream to flush to. Buffer just grows if null.
+     */
+    std::ostream* os_;
+    size_t        capacity_;
+    std::string   buf_;
+};
+
+}  // namespace vrt::print
+
+#endif
@@ -1,97 +1,359 @@
 #include "process.h"
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <exception>
 #include <iostream>
-#include <map>
 #include <memory>
-#include <string>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include "vrt/vrt_types.h"
 
-#include "common/comparator_id.h"
+#include "common/filter.h"
 #include "common/input_stream.h"
 #include "common/stream_history.h"
+#include "common/stream_id.h"
+#include "output_buffer.h"
 #include "program_arguments.h"
-#include "stringify.h"
 #include "type_printer.h"
+#include "writer.h"
 
 namespace vrt::print {
 
-using PacketPtr        = std::shared_ptr<vrt_packet>;
-using StreamHistoryPtr = std::unique_ptr<common::StreamHistory>;
+using PacketPtr = std::shared_ptr<vrt_packet>;
 
 /**
- * Process file contents.
+ * Number of packets formatted by a worker at a time in parallel mode.
+ */
+static constexpr uint64_t CHUNK_PACKETS{4096};
+
+/**
+ * Range of packets to format in parallel mode.
+ */
+struct Chunk {
+    std::streampos      position;     /**< Position of first packet in file [B]. */
+    uint64_t            first_index;  /**< Index of first packet in stream. */
+    uint64_t            n_packets;    /**< Number of packets. */
+    std::vector<double> sample_rates; /**< Sample rate of the stream of each packet [Hz]. */
+    OutputBuffer        out{nullptr};
+    bool                is_done{false};
+};
+
+/**
+ * Packet counters, for warnings at the end.
+ */
+struct Counters {
+    uint64_t n_packets{0};
+    uint64_t n_matched_packets{0};
+    uint64_t n_printed_packets{0};
+};
+
+/**
+ * Update stream history with a packet and get sample rate of its stream.
  *
- * \param args Program arguments.
+ * \param packet  Packet.
+ * \param args    Program arguments.
+ * \param history Stream histories.
  *
- * \throw std::runtime_error If there's an error.
+ * \return Sample rate [Hz].
  */
-void process(const ProgramArguments& args) {
-    common::InputStream input_stream(args.file_path, args.do_byte_swap, false);
+static double update_sample_rate(const PacketPtr& packet, const ProgramArguments& args,
+                                 common::StreamHistory* history) {
+    common::StreamId id(*packet);
+    size_t           slot{history->find(id)};
+    if (slot == common::StreamHistory::NONE) {
+        history->add(id);
+        return args.sample_rate;
+    }
+    history->update(slot, *packet);
+    return history->get_sample_rate(slot);
+}
 
-    // Number of printed packets
-    uint64_t n_printed_packets{0};
+/**
+ * Print a packet.
+ *
+ * \param writer      Writer.
+ * \param packet      Packet.
+ * \param i           Packet index.
+ * \param args        Program arguments.
+ * \param sample_rate Sample rate of packet stream [Hz].
+ */
+static void print_packet(Writer* writer, const PacketPtr& packet, uint64_t i, const ProgramArguments& args,
+                         double sample_rate) {
+    writer->begin_packet();
+    writer->write("index", "#", i);
+    print_header(writer, *packet);
+    print_fields(writer, *packet, args.sample_rate);
+    print_body(writer, *packet);
 
-    std::map<PacketPtr, StreamHistoryPtr, common::ComparatorId> id_streams;
+    if (packet->header.packet_type == VRT_PT_IF_CONTEXT) {
+        print_if_context(writer, *packet, sample_rate);
+    }
+    if (packet->header.has.trailer) {
+        print_trailer(writer, *packet);
+    }
+    writer->end_packet();
+}
+
+/**
+ * Go through packets in the same way as when printing them, but only call a function for each packet to print.
+ * Packets skipped and counted are the ones matching the filter.
+ *
+ * \param args          Program arguments.
+ * \param filter        Packet filter.
+ * \param input_stream  Input stream.
+ * \param f             Function called with packet index for each packet to print. The packet is available from the
+ *                      input stream.
+ *
+ * \return Packet counters.
+ */
+template <typename F>
+static Counters for_each_packet(const ProgramArguments& args, const common::Filter& filter,
+                                common::InputStream* input_stream, F f) {
+    Counters c;
 
     // Note that we must go through all packets, since we don't know the size of a packet in the middle of the stream
     // is.
-    uint64_t i{0};
-    for (; n_printed_packets < args.packet_count; ++i) {
-        // Check this after checking EOF
-        bool do_print_packet{i >= args.packet_skip};
-        if (do_print_packet) {
-            n_printed_packets++;
-            std::cout << std::string(80, '-') << '\n';
-
-            if (!input_stream.read_next_packet()) {
-                break;
-            }
-        } else {
-            if (!input_stream.skip_next_packet()) {
+    while (c.n_printed_packets < args.packet_count) {
+        if (filter.empty() && c.n_matched_packets < args.packet_skip) {
+            if (!input_stream->skip_next_packet()) {
                 break;
             }
+            c.n_packets++;
+            c.n_matched_packets++;
+            continue;
+        }
+
+        if (!common::read_next_matching_packet(filter, input_stream, &c.n_packets)) {
+            break;
+        }
+        if (c.n_matched_packets++ < args.packet_skip) {
             continue;
         }
 
+        c.n_printed_packets++;
+        f(c.n_packets - 1);
+    }
+
+    return c;
+}
+
+/**
+ * Print packets in order.
+ *
+ * \param args Program arguments.
+ * \param out  Buffer to write to.
+ *
+ * \return Packet counters.
+ */
+static Counters process_serial(const ProgramArguments& args, const common::Filter& filter, OutputBuffer* out) {
+    common::InputStream input_stream(args.file_path, args.do_byte_swap, false);
+
+    common::StreamHistory   history(args.sample_rate);
+    std::unique_ptr<Writer> writer{make_writer(args.format, out, args.fields)};
+    writer->begin_stream();
+
+    return for_each_packet(args, filter, &input_stream, [&](uint64_t i) {
         PacketPtr packet{input_stream.get_packet()};
+        print_packet(writer.get(), packet, i, args, update_sample_rate(packet, args, &history));
+    });
+}
+
+/**
+ * Print packets with several worker threads. A scanner thread goes through the file first and divides it into chunks
+ * of packets, together with the sample rate of the stream of each packet, since sample rates from IF context packets
+ * must be tracked in order. Workers format chunks independently into their own buffers, which are then written in
+ * order.
+ *
+ * \param args   Program arguments.
+ * \param filter Packet filter.
+ * \param n_jobs Number of worker threads.
+ * \param out    Buffer to write to.
+ *
+ * \return Packet counters.
+ *
+ * \throw std::runtime_error If there's an error.
+ */
+static Counters process_parallel(const ProgramArguments& args, const common::Filter& filter, unsigned n_jobs,
+                                 OutputBuffer* out) {
+    // Limit number of chunks in memory
+    const size_t MAX_CHUNKS{4 * static_cast<size_t>(n_jobs)};
+
+    std::mutex              mutex;
+    std::condition_variable cv;
+    // Scanned chunks not yet written. Front is the next one to write.
+    std::deque<std::unique_ptr<Chunk>> chunks;
+    // Number of chunks handed to workers, among the ones in chunks
+    size_t             n_taken{0};
+    bool               is_scan_done{false};
+    std::exception_ptr error;
+    Counters           counters;
 
-        WriteCols("#", std::to_string(i));
-        print_header(*packet);
-        print_fields(*packet, args.sample_rate);
-        print_body(*packet);
-
-        // Get sample rate
-        double sample_rate{args.sample_rate};
-        auto   it{id_streams.find(packet)};
-        if (it == id_streams.end()) {
-            id_streams[packet] = std::make_unique<common::StreamHistory>(args.sample_rate);
-        } else {
-            it->second->update(packet);
-            sample_rate = it->second->get_sample_rate();
+    // Store first error and wake everyone up, so that threads exit
+    auto fail{[&](std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) {
+            error = std::move(e);
         }
+        cv.notify_all();
+    }};
+
+    std::thread scanner([&]() {
+        try {
+            common::InputStream    input_stream(args.file_path, args.do_byte_swap, false);
+            common::StreamHistory  history(args.sample_rate);
+            std::unique_ptr<Chunk> chunk;
 
-        if (packet->header.packet_type == VRT_PT_IF_CONTEXT) {
-            print_if_context(*packet, sample_rate);
+            auto push{[&]() {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return chunks.size() < MAX_CHUNKS || error; });
+                if (error) {
+                    // Just stop scanning. Only the first error is reported.
+                    throw std::runtime_error("Scan aborted");
+                }
+                chunks.push_back(std::move(chunk));
+                cv.notify_all();
+            }};
+
+            Counters c{for_each_packet(args, filter, &input_stream, [&](uint64_t i) {
+                PacketPtr packet{input_stream.get_packet()};
+                if (!chunk) {
+                    auto packet_bytes{static_cast<std::streamoff>(sizeof(uint32_t) * packet->header.packet_size)};
+                    chunk              = std::make_unique<Chunk>();
+                    chunk->position    = input_stream.tell() - packet_bytes;
+                    chunk->first_index = i;
+                    chunk->n_packets   = 0;
+                    chunk->sample_rates.reserve(CHUNK_PACKETS);
+                }
+                chunk->n_packets++;
+                chunk->sample_rates.push_back(update_sample_rate(packet, args, &history));
+
+                if (chunk->n_packets == CHUNK_PACKETS) {
+                    push();
+                }
+            })};
+            if (chunk) {
+                push();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            counters     = c;
+            is_scan_done = true;
+            cv.notify_all();
+        } catch (...) {
+            fail(std::current_exception());
         }
-        if (packet->header.has.trailer) {
-            print_trailer(*packet);
+    });
+
+    std::vector<std::thread> workers;
+    for (unsigned j{0}; j < n_jobs; ++j) {
+        workers.emplace_back([&]() {
+            try {
+                common::InputStream input_stream(args.file_path, args.do_byte_swap, false, false);
+                for (;;) {
+                    Chunk* chunk{nullptr};
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        cv.wait(lock, [&]() { return n_taken < chunks.size() || is_scan_done || error; });
+                        if (error || n_taken == chunks.size()) {
+                            return;
+                        }
+                        chunk = chunks[n_taken++].get();
+                    }
+
+                    std::unique_ptr<Writer> writer{make_writer(args.format, &chunk->out, args.fields)};
+                    input_stream.seek(chunk->position, chunk->first_index);
+                    // Packets not matching the filter may be interleaved with the ones in the chunk
+                    uint64_t i{chunk->first_index};
+                    for (uint64_t k{0}; k < chunk->n_packets; ++k) {
+                        if (!common::read_next_matching_packet(filter, &input_stream, &i)) {
+                            std::stringstream ss;
+                            ss << "Unexpected end of file " << args.file_path << " at packet #" << i;
+                            throw std::runtime_error(ss.str());
+                        }
+                        print_packet(writer.get(), input_stream.get_packet(), i - 1, args, chunk->sample_rates[k]);
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    chunk->is_done = true;
+                    cv.notify_all();
+                }
+            } catch (...) {
+                fail(std::current_exception());
+            }
+        });
+    }
+
+    // Header row, if any
+    make_writer(args.format, out, args.fields)->begin_stream();
+
+    // Write chunks in order
+    for (;;) {
+        std::unique_ptr<Chunk> chunk;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&]() {
+                return (!chunks.empty() && chunks.front()->is_done) || (is_scan_done && chunks.empty()) || error;
+            });
+            if (error || chunks.empty()) {
+                break;
+            }
+            chunk = std::move(chunks.front());
+            chunks.pop_front();
+            n_taken--;
+            cv.notify_all();
         }
+        out->append(chunk->out.view());
+    }
+
+    scanner.join();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
     }
 
+    return counters;
+}
+
+/**
+ * Process file contents.
+ *
+ * \param args Program arguments.
+ *
+ * \throw std::runtime_error If there's an error.
+ */
+void process(const ProgramArguments& args) {
+    // Text is formatted into a large buffer which is written to stdout in big chunks
+    OutputBuffer out(&std::cout);
+
+    common::Filter filter(args.filter);
+
+    unsigned n_jobs{args.n_jobs != 0 ? args.n_jobs : std::max(std::thread::hardware_concurrency(), 1U)};
+    Counters c{n_jobs <= 1 ? process_serial(args, filter, &out) : process_parallel(args, filter, n_jobs, &out)};
+
+    // Ensure text is output before any warnings
+    out.flush();
+    std::cout << std::flush;
+
     // Print some warnings if not all packets were printed
-    if (i != 0) {
-        if (n_printed_packets == 0) {
-            std::cerr << "Warning: Skipped over all " << i << " packet(s)\n";
-        } else if (n_printed_packets < args.packet_count && args.packet_count != static_cast<uint64_t>(-1)) {
-            std::cerr << "Warning: Printed only " << n_printed_packets << " out of " << args.packet_count
+    if (c.n_packets != 0) {
+        if (c.n_matched_packets == 0) {
+            std::cerr << "Warning: No packet out of " << c.n_packets << " matched the filter\n";
+        } else if (c.n_printed_packets == 0) {
+            std::cerr << "Warning: Skipped over all " << c.n_matched_packets << " packet(s)\n";
+        } else if (c.n_printed_packets < args.packet_count && args.packet_count != static_cast<uint64_t>(-1)) {
+            std::cerr << "Warning: Printed only " << c.n_printed_packets << " out of " << args.packet_count
                       << " packet(s) due to end of file\n";
         }
     }
-
-    // Ensure text is output
-    std::cout << std::flush;
 }
 
 }  // namespace vrt::print
@@ -3,6 +3,9 @@
 
 #include <filesystem>
 #include <string>
+#include <vector>
+
+#include "writer.h"
 
 namespace vrt::print {
 
@@ -10,11 +13,15 @@ namespace vrt::print {
  * Input arguments to program.
  */
 struct ProgramArguments {
-    std::filesystem::path file_path{};
-    double                sample_rate{0.0};
-    uint64_t              packet_skip{0};
-    uint64_t              packet_count{static_cast<uint64_t>(-1)};
-    bool                  do_byte_swap{false};
+    std::filesystem::path    file_path{};
+    double                   sample_rate{0.0};
+    uint64_t                 packet_skip{0};
+    uint64_t                 packet_count{static_cast<uint64_t>(-1)};
+    bool                     do_byte_swap{false};
+    Format                   format{Format::COLUMNS};
+    std::vector<std::string> fields{};
+    unsigned                 n_jobs{1};
+    std::string              filter{};
 };
 
 }  // namespace vrt::print
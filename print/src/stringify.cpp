@@ -1,43 +1,76 @@
 #include "stringify.h"
 
-#include <iomanip>
-#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 
 namespace vrt::print {
 
 /**
- * Convert uint32_t to a hexadecimal representation string.
+ * Format value in hexadecimal, i.e. 0x0000ABCD.
  *
- * \param v       Value to convert.
- * \param symbols Number of hexadecimal symbols to use for the representation. Defaults to 8 (all).
+ * \param h Value and number of hexadecimal symbols to use for the representation.
+ */
+ValueStr::ValueStr(Hex h) : is_text_{true} {
+    static constexpr char DIGITS[]{"0123456789ABCDEF"};
+
+    // Number of significant symbols
+    int n{1};
+    for (uint32_t v{h.value >> 4}; v != 0; v >>= 4) {
+        n++;
+    }
+    n = std::max(n, h.symbols);
+
+    buf_[0] = '0';
+    buf_[1] = 'x';
+    uint32_t v{h.value};
+    for (int i{n + 1}; i >= 2; --i) {
+        buf_[i] = DIGITS[v & 0xF];
+        v >>= 4;
+    }
+    view_ = std::string_view(buf_, n + 2);
+}
+
+/**
+ * Format floating point value with 6 decimals, i.e. the same as std::to_string(). Infinity and NaN are text.
  *
- * \return String representation.
+ * \param v Value.
  */
-std::string Uint32ToHexStr(uint32_t v, int symbols) {
-    std::stringstream ss;
-    ss << "0x" << std::hex << std::setw(symbols) << std::setfill('0') << std::uppercase << v;
-    return ss.str();
+ValueStr::ValueStr(double v) : is_text_{!std::isfinite(v)} {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto res{std::to_chars(buf_, buf_ + sizeof(buf_), v, std::chars_format::fixed, 6)};
+    view_ = std::string_view(buf_, res.ptr - buf_);
+#else
+    int n{std::snprintf(buf_, sizeof(buf_), "%f", v)};
+    view_ = std::string_view(buf_, n < 0 ? 0 : std::min(static_cast<size_t>(n), sizeof(buf_) - 1));
+#endif
 }
 
 /**
  * Write name - value pair in a nice table format.
  *
+ * \param out               Buffer to write to.
  * \param name              Name to write in the left column.
  * \param value             Value to write in the right column.
  * \param indentation_level Indentation level to use for the left column. Defaults to 0 (none).
  */
-void WriteCols(const std::string& name, const std::string& value, unsigned indentation_level) {
+void WriteCols(OutputBuffer* out, std::string_view name, const ValueStr& value, unsigned indentation_level) {
     // Number of spaces per indentation level
-    const int INDENTATION_SPACES{2};
+    const size_t INDENTATION_SPACES{2};
 
     // Total width in command line characters
-    const int TOTAL_WIDTH{80};
+    const size_t TOTAL_WIDTH{80};
+
+    size_t indentation{INDENTATION_SPACES * indentation_level};
+    size_t width{indentation + name.size() + value.view().size()};
 
-    std::string indented_name{std::string(INDENTATION_SPACES * indentation_level, ' ') + name};
-    int         width_left{static_cast<int>(indented_name.size())};
-    int         width_right{static_cast<int>(TOTAL_WIDTH - width_left)};
-    std::cout << std::left << std::setw(width_left) << indented_name << std::right << std::setw(width_right) << value
-              << "\n";
+    out->append_fill(' ', indentation);
+    out->append(name);
+    if (width < TOTAL_WIDTH) {
+        out->append_fill(' ', TOTAL_WIDTH - width);
+    }
+    out->append(value.view());
+    out->append('\n');
 }
 
 }  // namespace vrt::print
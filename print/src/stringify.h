@@ -1,24 +1,57 @@
 #ifndef VRT_PRINT_SRC_STRINGIFY_H_
 #define VRT_PRINT_SRC_STRINGIFY_H_
 
+#include <charconv>
 #include <cstdint>
-#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "output_buffer.h"
 
 namespace vrt::print {
 
 /**
- * Convert bool to string representation.
- *
- * \param b Bool to convert.
- * \return String representation.
+ * Unsigned value to be written in hexadecimal, i.e. 0x0000ABCD.
+ */
+struct Hex {
+    uint32_t value;
+    int      symbols{8};
+};
+
+/**
+ * Text representation of a value, formatted into a fixed size internal buffer without any heap allocation.
+ * Representations are the same as std::to_string() for numbers and "true"/"false" for bools. Values that are not
+ * numbers or bools are marked as text, so that serializers know what to quote.
  */
-inline std::string BoolToStr(bool b) {
-    return b ? "true" : "false";
-}
+class ValueStr {
+   public:
+    ValueStr(const char* s) : view_{s}, is_text_{true} {}
+    ValueStr(std::string_view s) : view_{s}, is_text_{true} {}
+    ValueStr(bool b) : view_{b ? "true" : "false"} {}
+    ValueStr(Hex h);
+    ValueStr(double v);
+
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+    ValueStr(T v) {
+        // Promote so that 8-bit types are written as numbers
+        auto res{std::to_chars(buf_, buf_ + sizeof(buf_), +v)};
+        view_ = std::string_view(buf_, res.ptr - buf_);
+    }
+
+    ValueStr(const ValueStr&) = delete;
+    ValueStr& operator=(const ValueStr&) = delete;
+
+    std::string_view view() const { return view_; }
+    bool             is_text() const { return is_text_; }
 
-std::string Uint32ToHexStr(uint32_t v, int symbols = 8);
+   private:
+    // Fits any double in fixed notation
+    char             buf_[328];
+    std::string_view view_;
+    bool             is_text_{false};
+};
 
-void WriteCols(const std::string& name, const std::string& value, unsigned indentation_level = 0);
+void WriteCols(OutputBuffer* out, std::string_view name, const ValueStr& value, unsigned indentation_level = 0);
 
 }  // namespace vrt::print
 
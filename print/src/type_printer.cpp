@@ -1,9 +1,12 @@
 #include "type_printer.h"
 
-#include <iomanip>
-#include <iostream>
-#include <sstream>
+#include <algorithm>
+#include <charconv>
 #include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "vrt/vrt_string.h"
 #include "vrt/vrt_time.h"
@@ -17,40 +20,65 @@ namespace vrt::print {
 /**
  * Print calendar time.
  *
- * \param tsf       Timestamp fractional.
- * \param cal_time  Calendar time.
- * \param ind_lvl   Indentation level.
+ * \param w        Writer.
+ * \param key      Field key.
+ * \param tsf      Timestamp fractional.
+ * \param cal_time Calendar time.
  */
-static void print_calendar_time(vrt_tsf tsf, const vrt_calendar_time& cal_time, unsigned int ind_lvl) {
-    std::stringstream ss;
-    ss << std::setfill('0');
-    ss << 1900 + cal_time.year << '-' << std::setw(2) << 1 + cal_time.mon << '-' << std::setw(2) << cal_time.mday << ' '
-       << cal_time.hour << ':' << cal_time.min << ':' << cal_time.sec;
-    ss << std::setw(0);
+static void print_calendar_time(Writer* w, std::string_view key, vrt_tsf tsf, const vrt_calendar_time& cal_time) {
+    char  buf[96];
+    char* p{buf};
+
+    // Write value zero padded to a width
+    auto append{[&](auto v, int width) {
+        char  tmp[24];
+        char* tmp_end{std::to_chars(tmp, tmp + sizeof(tmp), v).ptr};
+        for (int n{static_cast<int>(tmp_end - tmp)}; n < width; ++n) {
+            *p++ = '0';
+        }
+        p = std::copy(tmp, tmp_end, p);
+    }};
+
+    append(1900 + cal_time.year, 0);
+    *p++ = '-';
+    append(1 + cal_time.mon, 2);
+    *p++ = '-';
+    append(cal_time.mday, 2);
+    *p++ = ' ';
+    append(cal_time.hour, 0);
+    *p++ = ':';
+    append(cal_time.min, 0);
+    *p++ = ':';
+    append(cal_time.sec, 0);
     if (tsf != VRT_TSF_NONE) {
-        ss << '.' << std::setw(12) << cal_time.ps;
+        *p++ = '.';
+        append(cal_time.ps, 12);
     }
-    WriteCols("(Time)", ss.str(), ind_lvl);
+    w->write(key, "(Time)", std::string_view(buf, p - buf), true);
 }
 
 /**
  * Print formatted GPS/INS geolocation.
  *
+ * \param w             Writer.
  * \param c             IF context.
  * \param sample_rate   Sample rate [Hz].
  * \param gps           True if GPS geolocation, False otherwise.
  */
-static void print_formatted_geolocation(const vrt_if_context& c, double sample_rate, bool gps) {
+static void print_formatted_geolocation(Writer* w, const vrt_if_context& c, double sample_rate, bool gps) {
+    if (!w->begin_group(gps ? "formatted_gps_geolocation" : "formatted_ins_geolocation",
+                        gps ? "Formatted GPS geolocation" : "Formatted INS geolocation")) {
+        return;
+    }
     const vrt_formatted_geolocation& g{gps ? c.formatted_gps_geolocation : c.formatted_ins_geolocation};
-    std::cout << "Formatted " << (gps ? "GPS" : "INS") << " geolocation\n";
-    WriteCols("TSI", vrt_string_tsi(g.tsi), 1);
-    WriteCols("TSF", vrt_string_tsf(g.tsf), 1);
-    WriteCols("OUI", Uint32ToHexStr(g.oui, 6), 1);
+    w->write("tsi", "TSI", vrt_string_tsi(g.tsi));
+    w->write("tsf", "TSF", vrt_string_tsf(g.tsf));
+    w->write("oui", "OUI", Hex{g.oui, 6});
     if (g.tsi != VRT_TSI_UNDEFINED) {
-        WriteCols("Integer second timestamp", std::to_string(g.integer_second_timestamp), 1);
+        w->write("integer_second_timestamp", "Integer second timestamp", g.integer_second_timestamp);
     }
     if (g.tsf != VRT_TSF_UNDEFINED) {
-        WriteCols("Fractional second timestamp", std::to_string(g.fractional_second_timestamp), 1);
+        w->write("fractional_second_timestamp", "Fractional second timestamp", g.fractional_second_timestamp);
     }
     vrt_calendar_time cal_time;
     int               rv;
@@ -60,49 +88,54 @@ static void print_formatted_geolocation(const vrt_if_context& c, double sample_r
         rv = vrt_time_calendar_ins_geolocation(&c, sample_rate, &cal_time);
     }
     if (rv == 0) {
-        print_calendar_time(gps ? c.formatted_gps_geolocation.tsf : c.formatted_ins_geolocation.tsf, cal_time, 1);
+        print_calendar_time(w, "time", g.tsf, cal_time);
     }
     if (g.has.latitude) {
-        WriteCols("Latitude [degrees]", std::to_string(g.latitude), 1);
+        w->write("latitude", "Latitude [degrees]", g.latitude);
     }
     if (g.has.longitude) {
-        WriteCols("Longitude [degrees]", std::to_string(g.longitude), 1);
+        w->write("longitude", "Longitude [degrees]", g.longitude);
     }
     if (g.has.altitude) {
-        WriteCols("Altitude [m]", std::to_string(g.altitude), 1);
+        w->write("altitude", "Altitude [m]", g.altitude);
     }
     if (g.has.speed_over_ground) {
-        WriteCols("Speed over ground [m/s]", std::to_string(g.speed_over_ground), 1);
+        w->write("speed_over_ground", "Speed over ground [m/s]", g.speed_over_ground);
     }
     if (g.has.heading_angle) {
-        WriteCols("Heading angle [degrees]", std::to_string(g.heading_angle), 1);
+        w->write("heading_angle", "Heading angle [degrees]", g.heading_angle);
     }
     if (g.has.track_angle) {
-        WriteCols("Track angle [degrees]", std::to_string(g.track_angle), 1);
+        w->write("track_angle", "Track angle [degrees]", g.track_angle);
     }
     if (g.has.magnetic_variation) {
-        WriteCols("Magnetic variation [degrees]", std::to_string(g.magnetic_variation), 1);
+        w->write("magnetic_variation", "Magnetic variation [degrees]", g.magnetic_variation);
     }
+    w->end_group();
 }
 
 /**
  * Print ECEF/Relative ephemeris.
  *
+ * \param w           Writer.
  * \param c           IF context.
  * \param sample_rate Sample rate [Hz].
  * \param ecef        True if ECEF ephmemeris, false otherwise.
  */
-static void print_ephemeris(const vrt_if_context& c, double sample_rate, bool ecef) {
+static void print_ephemeris(Writer* w, const vrt_if_context& c, double sample_rate, bool ecef) {
+    if (!w->begin_group(ecef ? "ecef_ephemeris" : "relative_ephemeris",
+                        ecef ? "ECEF ephemeris" : "Relative ephemeris")) {
+        return;
+    }
     const vrt_ephemeris& e{ecef ? c.ecef_ephemeris : c.relative_ephemeris};
-    std::cout << (ecef ? "ECEF" : "Relative") << " ephemeris\n";
-    WriteCols("TSI", vrt_string_tsi(e.tsi), 1);
-    WriteCols("TSF", vrt_string_tsf(e.tsf), 1);
-    WriteCols("OUI", Uint32ToHexStr(e.oui, 6), 1);
+    w->write("tsi", "TSI", vrt_string_tsi(e.tsi));
+    w->write("tsf", "TSF", vrt_string_tsf(e.tsf));
+    w->write("oui", "OUI", Hex{e.oui, 6});
     if (e.tsi != VRT_TSI_UNDEFINED) {
-        WriteCols("Integer second timestamp", std::to_string(e.integer_second_timestamp), 1);
+        w->write("integer_second_timestamp", "Integer second timestamp", e.integer_second_timestamp);
     }
     if (e.tsf != VRT_TSF_UNDEFINED) {
-        WriteCols("Fractional second timestamp", std::to_string(e.fractional_second_timestamp), 1);
+        w->write("fractional_second_timestamp", "Fractional second timestamp", e.fractional_second_timestamp);
     }
     vrt_calendar_time cal_time;
     int               rv;
@@ -112,94 +145,119 @@ static void print_ephemeris(const vrt_if_context& c, double sample_rate, bool ec
         rv = vrt_time_calendar_relative_ephemeris(&c, sample_rate, &cal_time);
     }
     if (rv == 0) {
-        print_calendar_time(ecef ? c.ecef_ephemeris.tsf : c.relative_ephemeris.tsf, cal_time, 1);
+        print_calendar_time(w, "time", e.tsf, cal_time);
     }
     if (e.has.position_x) {
-        WriteCols("Position X [m]", std::to_string(e.position_x), 1);
+        w->write("position_x", "Position X [m]", e.position_x);
     }
     if (e.has.position_y) {
-        WriteCols("Position Y [m]", std::to_string(e.position_y), 1);
+        w->write("position_y", "Position Y [m]", e.position_y);
     }
     if (e.has.position_z) {
-        WriteCols("Position Z [m]", std::to_string(e.position_z), 1);
+        w->write("position_z", "Position Z [m]", e.position_z);
     }
     if (e.has.attitude_alpha) {
-        WriteCols("Altitude alpha [degrees]", std::to_string(e.attitude_alpha), 1);
+        w->write("attitude_alpha", "Altitude alpha [degrees]", e.attitude_alpha);
     }
     if (e.has.attitude_beta) {
-        WriteCols("Altitude beta [degrees]", std::to_string(e.attitude_beta), 1);
+        w->write("attitude_beta", "Altitude beta [degrees]", e.attitude_beta);
     }
     if (e.has.attitude_phi) {
-        WriteCols("Altitude phi [degrees]", std::to_string(e.attitude_phi), 1);
+        w->write("attitude_phi", "Altitude phi [degrees]", e.attitude_phi);
     }
     if (e.has.velocity_dx) {
-        WriteCols("Velocity dX [m/s]", std::to_string(e.velocity_dx), 1);
+        w->write("velocity_dx", "Velocity dX [m/s]", e.velocity_dx);
     }
     if (e.has.velocity_dy) {
-        WriteCols("Velocity dY [m/s]", std::to_string(e.velocity_dy), 1);
+        w->write("velocity_dy", "Velocity dY [m/s]", e.velocity_dy);
     }
     if (e.has.velocity_dz) {
-        WriteCols("Velocity dZ [m/s]", std::to_string(e.velocity_dz), 1);
+        w->write("velocity_dz", "Velocity dZ [m/s]", e.velocity_dz);
     }
+    w->end_group();
+}
+
+/**
+ * Print context association list.
+ *
+ * \param w     Writer.
+ * \param key   List key.
+ * \param label List label.
+ * \param list  List [size].
+ * \param size  Number of list items.
+ */
+static void print_list(Writer* w, std::string_view key, std::string_view label, const uint32_t* list, uint16_t size) {
+    if (!w->begin_list(key, label)) {
+        return;
+    }
+    for (uint16_t j{0}; j < size; ++j) {
+        w->write_item(Hex{list[j]});
+    }
+    w->end_list();
 }
 
 /**
  * Print header.
  *
+ * \param w      Writer.
  * \param packet Packet.
  */
-void print_header(const vrt_packet& packet) {
+void print_header(Writer* w, const vrt_packet& packet) {
     const vrt_header& header{packet.header};
-    WriteCols("Packet type", vrt_string_packet_type(header.packet_type));
+    w->write("packet_type", "Packet type", vrt_string_packet_type(header.packet_type));
     // No idea to print has.class_id and has.trailer
-    WriteCols("tsm", vrt_string_tsm(header.tsm));
-    WriteCols("TSI", vrt_string_tsi(header.tsi));
-    WriteCols("TSF", vrt_string_tsf(header.tsf));
-    WriteCols("Packet count", std::to_string(header.packet_count));
-    WriteCols("Packet size [words]", std::to_string(header.packet_size));
+    w->write("tsm", "tsm", vrt_string_tsm(header.tsm));
+    w->write("tsi", "TSI", vrt_string_tsi(header.tsi));
+    w->write("tsf", "TSF", vrt_string_tsf(header.tsf));
+    w->write("packet_count", "Packet count", header.packet_count);
+    w->write("packet_size", "Packet size [words]", header.packet_size);
 }
 
 /**
  * Print fields.
  *
+ * \param w           Writer.
  * \param packet      Packet.
  * \param sample_rate Sample rate [Hz].
  */
-void print_fields(const vrt_packet& packet, double sample_rate) {
+void print_fields(Writer* w, const vrt_packet& packet, double sample_rate) {
     if (vrt_has_stream_id(&packet.header)) {
-        WriteCols("Stream ID", Uint32ToHexStr(packet.fields.stream_id));
+        w->write("stream_id", "Stream ID", Hex{packet.fields.stream_id});
     }
-    if (packet.header.has.class_id) {
-        std::cout << "Class ID\n";
-        WriteCols("OUI", Uint32ToHexStr(packet.fields.class_id.oui, 6), 1);
-        WriteCols("Information class code", Uint32ToHexStr(packet.fields.class_id.information_class_code, 4), 1);
-        WriteCols("Packet class code", Uint32ToHexStr(packet.fields.class_id.packet_class_code, 4), 1);
+    if (packet.header.has.class_id && w->begin_group("class_id", "Class ID")) {
+        w->write("oui", "OUI", Hex{packet.fields.class_id.oui, 6});
+        w->write("information_class_code", "Information class code",
+                 Hex{packet.fields.class_id.information_class_code, 4});
+        w->write("packet_class_code", "Packet class code", Hex{packet.fields.class_id.packet_class_code, 4});
+        w->end_group();
     }
     if (packet.header.tsi != VRT_TSI_NONE) {
-        WriteCols("Integer seconds timestamp", std::to_string(packet.fields.integer_seconds_timestamp));
+        w->write("integer_seconds_timestamp", "Integer seconds timestamp", packet.fields.integer_seconds_timestamp);
     }
     if (packet.header.tsf != VRT_TSF_NONE) {
-        WriteCols("Fractional seconds timestamp", std::to_string(packet.fields.fractional_seconds_timestamp));
+        w->write("fractional_seconds_timestamp", "Fractional seconds timestamp",
+                 packet.fields.fractional_seconds_timestamp);
     }
     vrt_calendar_time cal_time;
     if (vrt_time_calendar_fields(&packet.header, &packet.fields, sample_rate, &cal_time) == 0) {
-        print_calendar_time(packet.header.tsf, cal_time, 1);
+        print_calendar_time(w, "time", packet.header.tsf, cal_time);
     }
 }
 
 /**
  * Print body.
  *
+ * \param w      Writer.
  * \param packet Packet.
  */
-void print_body(const vrt_packet& packet) {
+void print_body(Writer* w, const vrt_packet& packet) {
     int32_t words_body{packet.words_body};
     switch (packet.header.packet_type) {
         case VRT_PT_IF_DATA_WITHOUT_STREAM_ID:
         case VRT_PT_IF_DATA_WITH_STREAM_ID:
         case VRT_PT_EXT_DATA_WITHOUT_STREAM_ID:
         case VRT_PT_EXT_DATA_WITH_STREAM_ID: {
-            WriteCols("Body size [words]", std::to_string(words_body));
+            w->write("body_size", "Body size [words]", words_body);
             break;
         }
         case VRT_PT_IF_CONTEXT: {
@@ -207,7 +265,7 @@ void print_body(const vrt_packet& packet) {
             break;
         }
         case VRT_PT_EXT_CONTEXT: {
-            WriteCols("Extended context section size [words]", std::to_string(words_body));
+            w->write("extended_context_size", "Extended context section size [words]", words_body);
             break;
         }
     }
@@ -216,226 +274,295 @@ void print_body(const vrt_packet& packet) {
 /**
  * Print IF context.
  *
+ * \param w           Writer.
  * \param packet      Packet.
  * \param sample_rate Sample rate [Hz].
  */
-void print_if_context(const vrt_packet& packet, double sample_rate) {
+void print_if_context(Writer* w, const vrt_packet& packet, double sample_rate) {
     const vrt_if_context& if_context{packet.if_context};
     if (if_context.context_field_change_indicator) {
-        WriteCols("Changed", BoolToStr(if_context.context_field_change_indicator));
+        w->write("context_field_change_indicator", "Changed", if_context.context_field_change_indicator);
     }
     if (if_context.has.reference_point_identifier) {
-        WriteCols("Reference point identifier", Uint32ToHexStr(if_context.reference_point_identifier));
+        w->write("reference_point_identifier", "Reference point identifier",
+                 Hex{if_context.reference_point_identifier});
     }
     if (if_context.has.bandwidth) {
-        WriteCols("Bandwidth [Hz]", std::to_string(if_context.bandwidth));
+        w->write("bandwidth", "Bandwidth [Hz]", if_context.bandwidth);
     }
     if (if_context.has.if_reference_frequency) {
-        WriteCols("IF reference frequency [Hz]", std::to_string(if_context.if_reference_frequency));
+        w->write("if_reference_frequency", "IF reference frequency [Hz]", if_context.if_reference_frequency);
     }
     if (if_context.has.rf_reference_frequency) {
-        WriteCols("RF reference frequency [Hz]", std::to_string(if_context.rf_reference_frequency));
+        w->write("rf_reference_frequency", "RF reference frequency [Hz]", if_context.rf_reference_frequency);
     }
     if (if_context.has.rf_reference_frequency_offset) {
-        WriteCols("RF reference frequency offset [Hz]", std::to_string(if_context.rf_reference_frequency_offset));
+        w->write("rf_reference_frequency_offset", "RF reference frequency offset [Hz]",
+                 if_context.rf_reference_frequency_offset);
     }
     if (if_context.has.if_band_offset) {
-        WriteCols("IF band offset [Hz]", std::to_string(if_context.if_band_offset));
+        w->write("if_band_offset", "IF band offset [Hz]", if_context.if_band_offset);
     }
     if (if_context.has.reference_level) {
-        WriteCols("Reference level [dBm]", std::to_string(if_context.reference_level));
+        w->write("reference_level", "Reference level [dBm]", if_context.reference_level);
     }
-    if (if_context.has.gain) {
-        std::cout << "Gain\n";
-        WriteCols("Stage 1 [dB]", std::to_string(if_context.gain.stage1), 1);
-        WriteCols("Stage 2 [dB]", std::to_string(if_context.gain.stage2), 1);
+    if (if_context.has.gain && w->begin_group("gain", "Gain")) {
+        w->write("stage1", "Stage 1 [dB]", if_context.gain.stage1);
+        w->write("stage2", "Stage 2 [dB]", if_context.gain.stage2);
+        w->end_group();
     }
     if (if_context.has.over_range_count) {
-        WriteCols("Over-range count", std::to_string(if_context.over_range_count));
+        w->write("over_range_count", "Over-range count", if_context.over_range_count);
     }
     if (if_context.has.sample_rate) {
-        WriteCols("Sample rate [Hz]", std::to_string(if_context.sample_rate));
+        w->write("sample_rate", "Sample rate [Hz]", if_context.sample_rate);
     }
     if (if_context.has.timestamp_adjustment) {
-        WriteCols("Timestamp adjustment [ps]", std::to_string(if_context.timestamp_adjustment));
+        w->write("timestamp_adjustment", "Timestamp adjustment [ps]", if_context.timestamp_adjustment);
     }
     if (if_context.has.timestamp_calibration_time) {
-        WriteCols("Timestamp calibration time", std::to_string(if_context.timestamp_calibration_time));
+        w->write("timestamp_calibration_time", "Timestamp calibration time", if_context.timestamp_calibration_time);
         vrt_calendar_time cal_time;
         if (vrt_time_calendar_calibration(&packet.header, &if_context, &cal_time) == 0) {
-            print_calendar_time(VRT_TSF_NONE, cal_time, 1);
+            print_calendar_time(w, "calibration_time", VRT_TSF_NONE, cal_time);
         }
     }
     if (if_context.has.temperature) {
-        WriteCols("Temperature [degrees C]", std::to_string(if_context.temperature));
-    }
-    if (if_context.has.device_identifier) {
-        std::cout << "Device identifier\n";
-        WriteCols("OUI", Uint32ToHexStr(if_context.device_identifier.oui, 6), 1);
-        WriteCols("Device code", Uint32ToHexStr(if_context.device_identifier.device_code, 4), 1);
-    }
-    if (if_context.has.state_and_event_indicators) {
-        std::cout << "State and event indicators\n";
-        if (if_context.state_and_event_indicators.has.calibrated_time) {
-            WriteCols("Calibrated time", BoolToStr(if_context.state_and_event_indicators.calibrated_time), 1);
+        w->write("temperature", "Temperature [degrees C]", if_context.temperature);
+    }
+    if (if_context.has.device_identifier && w->begin_group("device_identifier", "Device identifier")) {
+        w->write("oui", "OUI", Hex{if_context.device_identifier.oui, 6});
+        w->write("device_code", "Device code", Hex{if_context.device_identifier.device_code, 4});
+        w->end_group();
+    }
+    if (if_context.has.state_and_event_indicators &&
+        w->begin_group("state_and_event_indicators", "State and event indicators")) {
+        const auto& s{if_context.state_and_event_indicators};
+        if (s.has.calibrated_time) {
+            w->write("calibrated_time", "Calibrated time", s.calibrated_time);
         }
-        if (if_context.state_and_event_indicators.has.valid_data) {
-            WriteCols("Valid data", BoolToStr(if_context.state_and_event_indicators.valid_data), 1);
+        if (s.has.valid_data) {
+            w->write("valid_data", "Valid data", s.valid_data);
         }
-        if (if_context.state_and_event_indicators.has.reference_lock) {
-            WriteCols("Reference lock", BoolToStr(if_context.state_and_event_indicators.reference_lock), 1);
+        if (s.has.reference_lock) {
+            w->write("reference_lock", "Reference lock", s.reference_lock);
         }
-        if (if_context.state_and_event_indicators.has.agc_or_mgc) {
-            WriteCols("AGC/MGC", vrt_string_agc_or_mgc(if_context.state_and_event_indicators.agc_or_mgc), 1);
+        if (s.has.agc_or_mgc) {
+            w->write("agc_or_mgc", "AGC/MGC", vrt_string_agc_or_mgc(s.agc_or_mgc));
         }
-        if (if_context.state_and_event_indicators.has.detected_signal) {
-            WriteCols("Detected signal", BoolToStr(if_context.state_and_event_indicators.detected_signal), 1);
+        if (s.has.detected_signal) {
+            w->write("detected_signal", "Detected signal", s.detected_signal);
         }
-        if (if_context.state_and_event_indicators.has.spectral_inversion) {
-            WriteCols("Spectral inversion", BoolToStr(if_context.state_and_event_indicators.spectral_inversion), 1);
+        if (s.has.spectral_inversion) {
+            w->write("spectral_inversion", "Spectral inversion", s.spectral_inversion);
         }
-        if (if_context.state_and_event_indicators.has.over_range) {
-            WriteCols("Over-range", BoolToStr(if_context.state_and_event_indicators.over_range), 1);
+        if (s.has.over_range) {
+            w->write("over_range", "Over-range", s.over_range);
         }
-        if (if_context.state_and_event_indicators.has.sample_loss) {
-            WriteCols("Sample loss", BoolToStr(if_context.state_and_event_indicators.sample_loss), 1);
+        if (s.has.sample_loss) {
+            w->write("sample_loss", "Sample loss", s.sample_loss);
         }
-        WriteCols("User defined", Uint32ToHexStr(if_context.state_and_event_indicators.user_defined, 2), 1);
-    }
-    if (if_context.has.data_packet_payload_format) {
-        std::cout << "Data packet payload format\n";
-        WriteCols("Packing method", vrt_string_packing_method(if_context.data_packet_payload_format.packing_method), 1);
-        WriteCols("Real/Complex", vrt_string_real_or_complex(if_context.data_packet_payload_format.real_or_complex), 1);
-        WriteCols("Data item format",
-                  vrt_string_data_item_format(if_context.data_packet_payload_format.data_item_format), 1);
-        WriteCols("Sample component repeat", BoolToStr(if_context.data_packet_payload_format.sample_component_repeat),
-                  1);
-        WriteCols("Event tag size", std::to_string(if_context.data_packet_payload_format.event_tag_size), 1);
-        WriteCols("Channel tag size", std::to_string(if_context.data_packet_payload_format.channel_tag_size), 1);
-        WriteCols("Item packing field size",
-                  std::to_string(if_context.data_packet_payload_format.item_packing_field_size), 1);
-        WriteCols("Data item size", std::to_string(if_context.data_packet_payload_format.data_item_size), 1);
-        WriteCols("Repeat count", std::to_string(if_context.data_packet_payload_format.repeat_count), 1);
-        WriteCols("Vector size", std::to_string(if_context.data_packet_payload_format.vector_size), 1);
+        w->write("user_defined", "User defined", Hex{s.user_defined, 2});
+        w->end_group();
+    }
+    if (if_context.has.data_packet_payload_format &&
+        w->begin_group("data_packet_payload_format", "Data packet payload format")) {
+        const auto& f{if_context.data_packet_payload_format};
+        w->write("packing_method", "Packing method", vrt_string_packing_method(f.packing_method));
+        w->write("real_or_complex", "Real/Complex", vrt_string_real_or_complex(f.real_or_complex));
+        w->write("data_item_format", "Data item format", vrt_string_data_item_format(f.data_item_format));
+        w->write("sample_component_repeat", "Sample component repeat", f.sample_component_repeat);
+        w->write("event_tag_size", "Event tag size", f.event_tag_size);
+        w->write("channel_tag_size", "Channel tag size", f.channel_tag_size);
+        w->write("item_packing_field_size", "Item packing field size", f.item_packing_field_size);
+        w->write("data_item_size", "Data item size", f.data_item_size);
+        w->write("repeat_count", "Repeat count", f.repeat_count);
+        w->write("vector_size", "Vector size", f.vector_size);
+        w->end_group();
     }
     if (if_context.has.formatted_gps_geolocation) {
-        print_formatted_geolocation(if_context, sample_rate, true);
+        print_formatted_geolocation(w, if_context, sample_rate, true);
     }
     if (if_context.has.formatted_ins_geolocation) {
-        print_formatted_geolocation(if_context, sample_rate, false);
+        print_formatted_geolocation(w, if_context, sample_rate, false);
     }
     if (if_context.has.ecef_ephemeris) {
-        print_ephemeris(if_context, sample_rate, true);
+        print_ephemeris(w, if_context, sample_rate, true);
     }
     if (if_context.has.relative_ephemeris) {
-        print_ephemeris(if_context, sample_rate, false);
+        print_ephemeris(w, if_context, sample_rate, false);
     }
     if (if_context.has.ephemeris_reference_identifier) {
-        WriteCols("Ephemeris reference identifier", Uint32ToHexStr(if_context.ephemeris_reference_identifier));
+        w->write("ephemeris_reference_identifier", "Ephemeris reference identifier",
+                 Hex{if_context.ephemeris_reference_identifier});
     }
-    if (if_context.has.gps_ascii) {
-        std::cout << "GPS ASCII\n";
-        WriteCols("OUI", Uint32ToHexStr(if_context.gps_ascii.oui, 6), 1);
-        WriteCols("Number of words", std::to_string(if_context.gps_ascii.number_of_words), 1);
+    if (if_context.has.gps_ascii && w->begin_group("gps_ascii", "GPS ASCII")) {
+        w->write("oui", "OUI", Hex{if_context.gps_ascii.oui, 6});
+        w->write("number_of_words", "Number of words", if_context.gps_ascii.number_of_words);
         // Get full string and print, even if it may look a bit weird. Useful for debugging.
-        std::string ascii_str(if_context.gps_ascii.ascii, if_context.gps_ascii.ascii +
-                                                              sizeof(uint32_t) * if_context.gps_ascii.number_of_words -
-                                                              if_context.gps_ascii.ascii);
-        WriteCols("ASCII", ascii_str, 1);
-    }
-    if (if_context.has.context_association_lists) {
-        std::cout << "Context association lists\n";
-        WriteCols("Source list size", std::to_string(if_context.context_association_lists.source_list_size), 1);
-        WriteCols("System list size", std::to_string(if_context.context_association_lists.system_list_size), 1);
-        WriteCols("Vector component list size",
-                  std::to_string(if_context.context_association_lists.vector_component_list_size), 1);
-        WriteCols("Asynchronous channel list size",
-                  std::to_string(if_context.context_association_lists.asynchronous_channel_list_size), 1);
-        if (if_context.context_association_lists.has.asynchronous_channel_tag_list) {
-            WriteCols("Asynchronous channel tag list size",
-                      std::to_string(if_context.context_association_lists.asynchronous_channel_list_size), 1);
-        }
-
-        std::cout << "Source list\n";
-        for (uint16_t j{0}; j < if_context.context_association_lists.source_list_size; ++j) {
-            WriteCols("", Uint32ToHexStr(if_context.context_association_lists.source_context_association_list[j]), 2);
-        }
-
-        std::cout << "System list\n";
-        for (uint16_t j{0}; j < if_context.context_association_lists.system_list_size; ++j) {
-            WriteCols("", Uint32ToHexStr(if_context.context_association_lists.system_context_association_list[j]), 2);
-        }
-
-        std::cout << "Vector component list\n";
-        for (uint16_t j{0}; j < if_context.context_association_lists.vector_component_list_size; ++j) {
-            WriteCols("",
-                      Uint32ToHexStr(if_context.context_association_lists.vector_component_context_association_list[j]),
-                      2);
+        w->write("ascii", "ASCII",
+                 std::string_view(if_context.gps_ascii.ascii, sizeof(uint32_t) * if_context.gps_ascii.number_of_words));
+        w->end_group();
+    }
+    if (if_context.has.context_association_lists &&
+        w->begin_group("context_association_lists", "Context association lists")) {
+        const auto& l{if_context.context_association_lists};
+        w->write("source_list_size", "Source list size", l.source_list_size);
+        w->write("system_list_size", "System list size", l.system_list_size);
+        w->write("vector_component_list_size", "Vector component list size", l.vector_component_list_size);
+        w->write("asynchronous_channel_list_size", "Asynchronous channel list size", l.asynchronous_channel_list_size);
+        if (l.has.asynchronous_channel_tag_list) {
+            w->write("asynchronous_channel_tag_list_size", "Asynchronous channel tag list size",
+                     l.asynchronous_channel_list_size);
         }
 
-        std::cout << "Asynchronous channel list\n";
-        for (uint16_t j{0}; j < if_context.context_association_lists.asynchronous_channel_list_size; ++j) {
-            WriteCols(
-                "",
-                Uint32ToHexStr(if_context.context_association_lists.asynchronous_channel_context_association_list[j]),
-                2);
-        }
-
-        if (if_context.context_association_lists.has.asynchronous_channel_tag_list) {
-            std::cout << "Asynchronous channel tag list\n";
-            for (uint16_t j{0}; j < if_context.context_association_lists.asynchronous_channel_list_size; ++j) {
-                WriteCols("", Uint32ToHexStr(if_context.context_association_lists.asynchronous_channel_tag_list[j]), 2);
-            }
+        print_list(w, "source_list", "Source list", l.source_context_association_list, l.source_list_size);
+        print_list(w, "system_list", "System list", l.system_context_association_list, l.system_list_size);
+        print_list(w, "vector_component_list", "Vector component list",
+                   l.vector_component_context_association_list, l.vector_component_list_size);
+        print_list(w, "asynchronous_channel_list", "Asynchronous channel list",
+                   l.asynchronous_channel_context_association_list, l.asynchronous_channel_list_size);
+        if (l.has.asynchronous_channel_tag_list) {
+            print_list(w, "asynchronous_channel_tag_list", "Asynchronous channel tag list",
+                       l.asynchronous_channel_tag_list, l.asynchronous_channel_list_size);
         }
+        w->end_group();
     }
 }
 
 /**
  * Print trailer.
  *
+ * \param w      Writer.
  * \param packet Packet.
  */
-void print_trailer(const vrt_packet& packet) {
+void print_trailer(Writer* w, const vrt_packet& packet) {
     const vrt_trailer& trailer{packet.trailer};
     if (trailer.has.calibrated_time) {
-        WriteCols("Calibrated time", BoolToStr(trailer.calibrated_time));
+        w->write("calibrated_time", "Calibrated time", trailer.calibrated_time);
     }
     if (trailer.has.valid_data) {
-        WriteCols("Valid data", BoolToStr(trailer.valid_data));
+        w->write("valid_data", "Valid data", trailer.valid_data);
     }
     if (trailer.has.reference_lock) {
-        WriteCols("Reference lock", BoolToStr(trailer.reference_lock));
+        w->write("reference_lock", "Reference lock", trailer.reference_lock);
     }
     if (trailer.has.agc_or_mgc) {
-        WriteCols("AGC/MGC", vrt_string_agc_or_mgc(trailer.agc_or_mgc));
+        w->write("agc_or_mgc", "AGC/MGC", vrt_string_agc_or_mgc(trailer.agc_or_mgc));
     }
     if (trailer.has.detected_signal) {
-        WriteCols("Detected signal", BoolToStr(trailer.detected_signal));
+        w->write("detected_signal", "Detected signal", trailer.detected_signal);
     }
     if (trailer.has.spectral_inversion) {
-        WriteCols("Spectral inversion", BoolToStr(trailer.spectral_inversion));
+        w->write("spectral_inversion", "Spectral inversion", trailer.spectral_inversion);
     }
     if (trailer.has.over_range) {
-        WriteCols("Over range", BoolToStr(trailer.over_range));
+        w->write("over_range", "Over range", trailer.over_range);
     }
     if (trailer.has.sample_loss) {
-        WriteCols("Sample loss", BoolToStr(trailer.sample_loss));
+        w->write("sample_loss", "Sample loss", trailer.sample_loss);
     }
     if (trailer.has.user_defined11) {
-        WriteCols("User defined 11", BoolToStr(trailer.user_defined11));
+        w->write("user_defined11", "User defined 11", trailer.user_defined11);
     }
     if (trailer.has.user_defined10) {
-        WriteCols("User defined 10", BoolToStr(trailer.user_defined10));
+        w->write("user_defined10", "User defined 10", trailer.user_defined10);
     }
     if (trailer.has.user_defined9) {
-        WriteCols("User defined 9", BoolToStr(trailer.user_defined9));
+        w->write("user_defined9", "User defined 9", trailer.user_defined9);
     }
     if (trailer.has.user_defined8) {
-        WriteCols("User defined 8", BoolToStr(trailer.user_defined8));
+        w->write("user_defined8", "User defined 8", trailer.user_defined8);
     }
     if (trailer.has.associated_context_packet_count) {
-        WriteCols("Associated context packet count", std::to_string(trailer.associated_context_packet_count));
+        w->write("associated_context_packet_count", "Associated context packet count",
+                 trailer.associated_context_packet_count);
     }
 }
 
+/**
+ * Check if key names a single field or list, rather than a group or nothing, in any packet printed by the functions
+ * above. Keep in sync with them.
+ *
+ * \param key Full field key, e.g. "class_id.oui".
+ *
+ * \return True if key names a single field or list.
+ */
+bool is_field_key(std::string_view key) {
+    static const std::vector<std::string> GEOLOCATION{"tsi",
+                                                      "tsf",
+                                                      "oui",
+                                                      "integer_second_timestamp",
+                                                      "fractional_second_timestamp",
+                                                      "time",
+                                                      "latitude",
+                                                      "longitude",
+                                                      "altitude",
+                                                      "speed_over_ground",
+                                                      "heading_angle",
+                                                      "track_angle",
+                                                      "magnetic_variation"};
+    static const std::vector<std::string> EPHEMERIS{"tsi",
+                                                    "tsf",
+                                                    "oui",
+                                                    "integer_second_timestamp",
+                                                    "fractional_second_timestamp",
+                                                    "time",
+                                                    "position_x",
+                                                    "position_y",
+                                                    "position_z",
+                                                    "attitude_alpha",
+                                                    "attitude_beta",
+                                                    "attitude_phi",
+                                                    "velocity_dx",
+                                                    "velocity_dy",
+                                                    "velocity_dz"};
+
+    // Groups, with the keys of their fields. Top level fields have an empty group key.
+    static const std::vector<std::pair<std::string, std::vector<std::string>>> GROUPS{
+        {"",
+         {// Index is printed by the caller
+          "index", "packet_type", "tsm", "tsi", "tsf", "packet_count", "packet_size", "stream_id",
+          "integer_seconds_timestamp", "fractional_seconds_timestamp", "time", "body_size", "extended_context_size",
+          // IF context
+          "context_field_change_indicator", "reference_point_identifier", "bandwidth", "if_reference_frequency",
+          "rf_reference_frequency", "rf_reference_frequency_offset", "if_band_offset", "reference_level",
+          "over_range_count", "sample_rate", "timestamp_adjustment", "timestamp_calibration_time", "calibration_time",
+          "temperature", "ephemeris_reference_identifier",
+          // Trailer
+          "calibrated_time", "valid_data", "reference_lock", "agc_or_mgc", "detected_signal", "spectral_inversion",
+          "over_range", "sample_loss", "user_defined11", "user_defined10", "user_defined9", "user_defined8",
+          "associated_context_packet_count"}},
+        {"class_id", {"oui", "information_class_code", "packet_class_code"}},
+        {"gain", {"stage1", "stage2"}},
+        {"device_identifier", {"oui", "device_code"}},
+        {"state_and_event_indicators",
+         {"calibrated_time", "valid_data", "reference_lock", "agc_or_mgc", "detected_signal", "spectral_inversion",
+          "over_range", "sample_loss", "user_defined"}},
+        {"data_packet_payload_format",
+         {"packing_method", "real_or_complex", "data_item_format", "sample_component_repeat", "event_tag_size",
+          "channel_tag_size", "item_packing_field_size", "data_item_size", "repeat_count", "vector_size"}},
+        {"formatted_gps_geolocation", GEOLOCATION},
+        {"formatted_ins_geolocation", GEOLOCATION},
+        {"ecef_ephemeris", EPHEMERIS},
+        {"relative_ephemeris", EPHEMERIS},
+        {"gps_ascii", {"oui", "number_of_words", "ascii"}},
+        {"context_association_lists",
+         {"source_list_size", "system_list_size", "vector_component_list_size", "asynchronous_channel_list_size",
+          "asynchronous_channel_tag_list_size", "source_list", "system_list", "vector_component_list",
+          "asynchronous_channel_list", "asynchronous_channel_tag_list"}}};
+
+    static const std::unordered_set<std::string> KEYS{[] {
+        std::unordered_set<std::string> keys;
+        for (const auto& group : GROUPS) {
+            for (const std::string& k : group.second) {
+                keys.insert(group.first.empty() ? k : group.first + '.' + k);
+            }
+        }
+        return keys;
+    }()};
+
+    return KEYS.count(std::string(key)) != 0;
+}
+
 }  // namespace vrt::print
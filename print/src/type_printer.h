@@ -2,16 +2,21 @@
 #define VRT_PRINT_SRC_TYPE_PRINTER_H_
 
 #include <cstdint>
+#include <string_view>
+
+#include "writer.h"
 
 struct vrt_packet;
 
 namespace vrt::print {
 
-void print_header(const vrt_packet& packet);
-void print_fields(const vrt_packet& packet, double sample_rate);
-void print_body(const vrt_packet& packet);
-void print_if_context(const vrt_packet& packet, double sample_rate);
-void print_trailer(const vrt_packet& packet);
+void print_header(Writer* w, const vrt_packet& packet);
+void print_fields(Writer* w, const vrt_packet& packet, double sample_rate);
+void print_body(Writer* w, const vrt_packet& packet);
+void print_if_context(Writer* w, const vrt_packet& packet, double sample_rate);
+void print_trailer(Writer* w, const vrt_packet& packet);
+
+bool is_field_key(std::string_view key);
 
 }  // namespace vrt::print
 
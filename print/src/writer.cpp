@@ -0,0 +1,181 @@
+#include "writer.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "columns_writer.h"
+#include "delimited_writer.h"
+#include "json_writer.h"
+
+namespace vrt::print {
+
+/**
+ * Check if key is the same as, or inside, a group key.
+ *
+ * \param group Group key, e.g. "class_id".
+ * \param key   Key, e.g. "class_id.oui".
+ *
+ * \return True if key is the same or inside.
+ */
+static bool IsInside(std::string_view group, std::string_view key) {
+    return key.size() >= group.size() && key.compare(0, group.size(), group) == 0 &&
+           (key.size() == group.size() || key[group.size()] == '.');
+}
+
+/**
+ * Constructor.
+ *
+ * \param out    Buffer to write to.
+ * \param fields Keys of fields or groups to write. Everything is written if empty.
+ */
+Writer::Writer(OutputBuffer* out, const std::vector<std::string>& fields) : out_{out}, fields_{fields} {
+    stack_.emplace_back(0, fields_.empty());
+}
+
+/**
+ * Get full key of a field in the current group.
+ *
+ * \param key Field key.
+ *
+ * \return Full key. Only valid until the next call.
+ */
+std::string_view Writer::full_key(std::string_view key) {
+    if (path_.empty()) {
+        return key;
+    }
+    key_.assign(path_);
+    key_ += '.';
+    key_.append(key);
+    return key_;
+}
+
+/**
+ * Check if field in current group is selected.
+ *
+ * \param key Field key.
+ *
+ * \return True if selected.
+ */
+bool Writer::is_selected(std::string_view key) {
+    if (stack_.back().second) {
+        return true;
+    }
+    std::string_view k{full_key(key)};
+    for (const std::string& f : fields_) {
+        if (IsInside(f, k)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Begin group of fields. Nothing must be written for the group if false is returned.
+ *
+ * \param key   Group key.
+ * \param label Group label.
+ *
+ * \return True if group contains selected fields, false otherwise.
+ */
+bool Writer::begin_group(std::string_view key, std::string_view label) {
+    bool is_all_selected{stack_.back().second};
+    if (!is_all_selected) {
+        std::string_view k{full_key(key)};
+        bool             is_any_selected{false};
+        for (const std::string& f : fields_) {
+            if (IsInside(f, k)) {
+                is_all_selected = true;
+                break;
+            }
+            if (IsInside(k, f)) {
+                is_any_selected = true;
+            }
+        }
+        if (!is_all_selected && !is_any_selected) {
+            return false;
+        }
+    }
+    on_begin_group(key, label);
+    push(key, is_all_selected);
+    return true;
+}
+
+/**
+ * End group of fields that was begun with begin_group().
+ */
+void Writer::end_group() {
+    pop();
+    on_end_group();
+}
+
+/**
+ * Begin list of items. Nothing must be written for the list if false is returned.
+ *
+ * \param key   List key.
+ * \param label List label.
+ *
+ * \return True if list is selected, false otherwise.
+ */
+bool Writer::begin_list(std::string_view key, std::string_view label) {
+    if (!is_selected(key)) {
+        return false;
+    }
+    on_begin_list(key, label);
+    return true;
+}
+
+/**
+ * End list of items that was begun with begin_list().
+ */
+void Writer::end_list() {
+    on_end_list();
+}
+
+/**
+ * Enter group.
+ *
+ * \param key             Group key.
+ * \param is_all_selected True if every field in group is selected.
+ */
+void Writer::push(std::string_view key, bool is_all_selected) {
+    stack_.emplace_back(path_.size(), is_all_selected);
+    if (!path_.empty()) {
+        path_ += '.';
+    }
+    path_.append(key);
+}
+
+/**
+ * Leave group.
+ */
+void Writer::pop() {
+    path_.resize(stack_.back().first);
+    stack_.pop_back();
+}
+
+/**
+ * Create writer for an output format.
+ *
+ * \param format Output format.
+ * \param out    Buffer to write to.
+ * \param fields Keys of fields or groups to write. Everything is written if empty.
+ *
+ * \return Writer.
+ */
+std::unique_ptr<Writer> make_writer(Format format, OutputBuffer* out, const std::vector<std::string>& fields) {
+    switch (format) {
+        case Format::JSON:
+            return std::make_unique<JsonWriter>(out, fields);
+        case Format::CSV:
+            return std::make_unique<DelimitedWriter>(out, fields, ',');
+        case Format::TSV:
+            return std::make_unique<DelimitedWriter>(out, fields, '\t');
+        case Format::COLUMNS:
+        default:
+            return std::make_unique<ColumnsWriter>(out, fields);
+    }
+}
+
+}  // namespace vrt::print
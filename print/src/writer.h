@@ -0,0 +1,119 @@
+#ifndef VRT_PRINT_SRC_WRITER_H_
+#define VRT_PRINT_SRC_WRITER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "output_buffer.h"
+#include "stringify.h"
+
+namespace vrt::print {
+
+/**
+ * Output format.
+ */
+enum class Format { COLUMNS, JSON, CSV, TSV };
+
+/**
+ * Serializer for the packet field walk in type_printer. Every field has a key, i.e. a snake_case identifier used for
+ * field selection and machine-readable formats, and a label, i.e. the human readable name. Keys of fields inside
+ * groups are prefixed by the group keys, e.g. "class_id.oui".
+ *
+ * Fields are only formatted if selected, and groups that contain no selected fields are skipped entirely by the
+ * field walk.
+ */
+class Writer {
+   public:
+    Writer(OutputBuffer* out, const std::vector<std::string>& fields);
+    virtual ~Writer() = default;
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    virtual void begin_stream() {}
+    virtual void begin_packet()                                                                                    = 0;
+    virtual void end_packet()                                                                                      = 0;
+
+    bool begin_group(std::string_view key, std::string_view label);
+    void end_group();
+    bool begin_list(std::string_view key, std::string_view label);
+    void end_list();
+
+    /**
+     * Write field, if selected.
+     *
+     * \param key        Field key.
+     * \param label      Field label.
+     * \param value      Field value. Anything ValueStr can be constructed from.
+     * \param is_derived True if value is derived from the field before, such as its calendar time.
+     */
+    template <typename T>
+    void write(std::string_view key, std::string_view label, const T& value, bool is_derived = false) {
+        if (is_selected(key)) {
+            write_value(key, label, ValueStr(value), is_derived);
+        }
+    }
+
+    /**
+     * Write list item. Must be called between begin_list() and end_list().
+     *
+     * \param value Item value. Anything ValueStr can be constructed from.
+     */
+    template <typename T>
+    void write_item(const T& value) {
+        write_list_item(ValueStr(value));
+    }
+
+   protected:
+    virtual void on_begin_group(std::string_view key, std::string_view label)                                      = 0;
+    virtual void on_end_group()                                                                                    = 0;
+    virtual void on_begin_list(std::string_view key, std::string_view label)                                       = 0;
+    virtual void on_end_list()                                                                                     = 0;
+    virtual void write_value(std::string_view key, std::string_view label, const ValueStr& value, bool is_derived) = 0;
+    virtual void write_list_item(const ValueStr& value)                                                            = 0;
+
+    /**
+     * Get full key of current group, e.g. "if_context.gain". Empty at top level.
+     *
+     * \return Group key.
+     */
+    std::string_view path() const { return path_; }
+
+    std::string_view full_key(std::string_view key);
+
+    OutputBuffer* out_;
+
+   private:
+    bool is_selected(std::string_view key);
+    void push(std::string_view key, bool is_all_selected);
+    void pop();
+
+    /**
+     * Selected field keys. Empty if all are selected.
+     */
+    std::vector<std::string> fields_;
+
+    /**
+     * Current group key.
+     */
+    std::string path_;
+
+    /**
+     * Reusable storage for full keys.
+     */
+    std::string key_;
+
+    /**
+     * Length of path_ and if everything is selected, for each enclosing group.
+     */
+    std::vector<std::pair<size_t, bool>> stack_;
+};
+
+std::unique_ptr<Writer> make_writer(Format format, OutputBuffer* out, const std::vector<std::string>& fields);
+
+}  // namespace vrt::print
+
+#endif
@@ -1,8 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <iostream>
+
 #include "vrt/vrt_init.h"
 #include "vrt/vrt_types.h"
 
+#include "../../src/columns_writer.h"
+#include "../../src/output_buffer.h"
 #include "../../src/type_printer.h"
 
 class PrintFieldsTest : public ::testing::Test {
@@ -10,13 +14,15 @@ class PrintFieldsTest : public ::testing::Test {
     void SetUp() override { vrt_init_packet(&p_); }
 
     void TearDown() override {
-        vrt::print::print_header(p_);
-        vrt::print::print_fields(p_, SAMPLE_RATE);
+        vrt::print::print_header(&writer_, p_);
+        vrt::print::print_fields(&writer_, p_, SAMPLE_RATE);
     }
 
     static constexpr double SAMPLE_RATE{16e6};
 
-    vrt_packet p_;
+    vrt::print::OutputBuffer  out_{&std::cout};
+    vrt::print::ColumnsWriter writer_{&out_, {}};
+    vrt_packet                p_;
 };
 
 TEST_F(PrintFieldsTest, None) {}
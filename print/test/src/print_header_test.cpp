@@ -1,17 +1,23 @@
 #include <gtest/gtest.h>
 
+#include <iostream>
+
 #include "vrt/vrt_init.h"
 #include "vrt/vrt_types.h"
 
+#include "../../src/columns_writer.h"
+#include "../../src/output_buffer.h"
 #include "../../src/type_printer.h"
 
 class PrintHeaderTest : public ::testing::Test {
    protected:
     void SetUp() override { vrt_init_packet(&p_); }
 
-    void TearDown() override { vrt::print::print_header(p_); }
+    void TearDown() override { vrt::print::print_header(&writer_, p_); }
 
-    vrt_packet p_;
+    vrt::print::OutputBuffer  out_{&std::cout};
+    vrt::print::ColumnsWriter writer_{&out_, {}};
+    vrt_packet                p_;
 };
 
 TEST_F(PrintHeaderTest, None) {}
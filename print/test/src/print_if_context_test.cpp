@@ -2,10 +2,13 @@
 
 #include <array>
 #include <cstdint>
+#include <iostream>
 
 #include "vrt/vrt_init.h"
 #include "vrt/vrt_types.h"
 
+#include "../../src/columns_writer.h"
+#include "../../src/output_buffer.h"
 #include "../../src/type_printer.h"
 
 static constexpr double SAMPLE_RATE{16e6};
@@ -14,9 +17,11 @@ class PrintIfContextTest : public ::testing::Test {
    protected:
     void SetUp() override { vrt_init_packet(&p_); }
 
-    void TearDown() override { vrt::print::print_if_context(p_, SAMPLE_RATE); }
+    void TearDown() override { vrt::print::print_if_context(&writer_, p_, SAMPLE_RATE); }
 
-    vrt_packet p_;
+    vrt::print::OutputBuffer  out_{&std::cout};
+    vrt::print::ColumnsWriter writer_{&out_, {}};
+    vrt_packet                p_;
 };
 
 TEST_F(PrintIfContextTest, None) {}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "../../src/output_buffer.h"
+#include "../../src/stringify.h"
+
+using vrt::print::Hex;
+using vrt::print::OutputBuffer;
+using vrt::print::ValueStr;
+
+TEST(StringifyTest, Bool) {
+    ASSERT_EQ(ValueStr(true).view(), "true");
+    ASSERT_EQ(ValueStr(false).view(), "false");
+}
+
+TEST(StringifyTest, Integer) {
+    ASSERT_EQ(ValueStr(0).view(), "0");
+    ASSERT_EQ(ValueStr(static_cast<uint8_t>(0xFF)).view(), "255");
+    ASSERT_EQ(ValueStr(static_cast<int8_t>(-128)).view(), "-128");
+    ASSERT_EQ(ValueStr(std::numeric_limits<int32_t>::min()).view(),
+              std::to_string(std::numeric_limits<int32_t>::min()));
+    ASSERT_EQ(ValueStr(std::numeric_limits<uint64_t>::max()).view(),
+              std::to_string(std::numeric_limits<uint64_t>::max()));
+}
+
+TEST(StringifyTest, Double) {
+    for (double v : {0.0, -0.0, 1.0, -1.5, 0.1234565, 16e6, 1.0 / 3.0, -123456789.987654321, 1e300}) {
+        ASSERT_EQ(ValueStr(v).view(), std::to_string(v));
+    }
+    ASSERT_EQ(ValueStr(std::numeric_limits<double>::max()).view(), std::to_string(std::numeric_limits<double>::max()));
+    ASSERT_EQ(ValueStr(static_cast<float>(2.5F)).view(), std::to_string(2.5F));
+}
+
+TEST(StringifyTest, Hex) {
+    ASSERT_EQ(ValueStr(Hex{0}).view(), "0x00000000");
+    ASSERT_EQ(ValueStr(Hex{0xDEADBEEF}).view(), "0xDEADBEEF");
+    ASSERT_EQ(ValueStr(Hex{0xABC, 6}).view(), "0x000ABC");
+    ASSERT_EQ(ValueStr(Hex{0x12345, 4}).view(), "0x12345");
+    ASSERT_EQ(ValueStr(Hex{0xF, 2}).view(), "0x0F");
+}
+
+TEST(StringifyTest, WriteCols) {
+    OutputBuffer out(nullptr);
+    vrt::print::WriteCols(&out, "Name", "value");
+    vrt::print::WriteCols(&out, "Indented", 12, 2);
+    vrt::print::WriteCols(&out, std::string(100, 'n'), "v");
+    ASSERT_EQ(out.view(), "Name" + std::string(80 - 4 - 5, ' ') + "value\n" + "    Indented" +
+                              std::string(80 - 12 - 2, ' ') + "12\n" + std::string(100, 'n') + "v\n");
+}
+
+TEST(StringifyTest, Flush) {
+    std::ostringstream ss;
+    {
+        OutputBuffer out(&ss, 8);
+        out.append("1234");
+        ASSERT_TRUE(ss.str().empty());
+        out.append_fill('5', 4);
+        ASSERT_EQ(ss.str(), "12345555");
+        ASSERT_TRUE(out.view().empty());
+        out.append('6');
+    }
+    ASSERT_EQ(ss.str(), "123455556");
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "../../src/output_buffer.h"
+#include "../../src/type_printer.h"
+#include "../../src/writer.h"
+
+class WriterTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        vrt_init_packet(&p_);
+        p_.header.packet_type                = VRT_PT_IF_DATA_WITH_STREAM_ID;
+        p_.header.has.class_id               = true;
+        p_.header.packet_size                = 7;
+        p_.fields.stream_id                  = 0xDEADBEEF;
+        p_.fields.class_id.oui               = 0xABCDEF;
+        p_.fields.class_id.packet_class_code = 0x12;
+        p_.words_body                        = 3;
+    }
+
+    std::string print(vrt::print::Format format, const std::vector<std::string>& fields) {
+        vrt::print::OutputBuffer            out(nullptr);
+        std::unique_ptr<vrt::print::Writer> w{vrt::print::make_writer(format, &out, fields)};
+        w->begin_stream();
+        for (uint64_t i{0}; i < 2; ++i) {
+            w->begin_packet();
+            w->write("index", "#", i);
+            vrt::print::print_header(w.get(), p_);
+            vrt::print::print_fields(w.get(), p_, 0.0);
+            vrt::print::print_body(w.get(), p_);
+            if (p_.header.packet_type == VRT_PT_IF_CONTEXT) {
+                vrt::print::print_if_context(w.get(), p_, 0.0);
+            }
+            w->end_packet();
+        }
+        return std::string(out.view());
+    }
+
+    vrt_packet p_;
+};
+
+TEST_F(WriterTest, ColumnsFields) {
+    std::string s{print(vrt::print::Format::COLUMNS, {"stream_id", "class_id.oui"})};
+    std::string packet{std::string(80, '-') + "\nStream ID" + std::string(80 - 9 - 10, ' ') +
+                       "0xDEADBEEF\nClass ID\n  OUI" + std::string(80 - 5 - 8, ' ') + "0xABCDEF\n"};
+    ASSERT_EQ(s, packet + packet);
+}
+
+TEST_F(WriterTest, ColumnsContextLists) {
+    // List labels start in the first column, as the items are indented below the group
+    std::array<uint32_t, 2> l1{0x1, 0x2};
+    p_.header.packet_type                                                   = VRT_PT_IF_CONTEXT;
+    p_.header.has.class_id                                                  = false;
+    p_.if_context.has.context_association_lists                             = true;
+    p_.if_context.context_association_lists.source_list_size                = 2;
+    p_.if_context.context_association_lists.source_context_association_list = l1.data();
+    std::string s{print(vrt::print::Format::COLUMNS, {"context_association_lists.source_list"})};
+    std::string packet{std::string(80, '-') + "\nContext association lists\nSource list\n" + std::string(80 - 10, ' ') +
+                       "0x00000001\n" + std::string(80 - 10, ' ') + "0x00000002\n"};
+    ASSERT_EQ(s, packet + packet);
+}
+
+TEST_F(WriterTest, ColumnsDerived) {
+    // Derived values are indented, even at top level
+    vrt::print::OutputBuffer            out(nullptr);
+    std::unique_ptr<vrt::print::Writer> w{vrt::print::make_writer(vrt::print::Format::COLUMNS, &out, {})};
+    w->write("time", "(Time)", "x", true);
+    w->write("(x)", "(x)", "y");
+    ASSERT_EQ(out.view(), "  (Time)" + std::string(80 - 9, ' ') + "x\n(x)" + std::string(80 - 4, ' ') + "y\n");
+}
+
+TEST_F(WriterTest, Json) {
+    std::string s{print(vrt::print::Format::JSON, {})};
+    std::string packet{
+        "\"packet_type\":\"IF Data packet with Stream Identifier\",\"tsm\":\"Fine\",\"tsi\":\"None/Undefined\","
+        "\"tsf\":\"None/Undefined\",\"packet_count\":0,\"packet_size\":7,\"stream_id\":\"0xDEADBEEF\","
+        "\"class_id\":{\"oui\":\"0xABCDEF\",\"information_class_code\":\"0x0000\",\"packet_class_code\":\"0x0012\"},"
+        "\"body_size\":3}\n"};
+    ASSERT_EQ(s, "{\"index\":0," + packet + "{\"index\":1," + packet);
+}
+
+TEST_F(WriterTest, JsonFields) {
+    std::string s{print(vrt::print::Format::JSON, {"index", "class_id.packet_class_code"})};
+    ASSERT_EQ(s,
+              "{\"index\":0,\"class_id\":{\"packet_class_code\":\"0x0012\"}}\n"
+              "{\"index\":1,\"class_id\":{\"packet_class_code\":\"0x0012\"}}\n");
+}
+
+TEST_F(WriterTest, JsonContextLists) {
+    std::array<uint32_t, 2> l1{0x1, 0x2};
+    p_.header.packet_type                                                   = VRT_PT_IF_CONTEXT;
+    p_.header.has.class_id                                                  = false;
+    p_.if_context.has.context_association_lists                             = true;
+    p_.if_context.context_association_lists.source_list_size                = 2;
+    p_.if_context.context_association_lists.source_context_association_list = l1.data();
+    p_.if_context.has.bandwidth                                             = true;
+    p_.if_context.bandwidth                                                 = 1.5;
+    std::string s{print(vrt::print::Format::JSON, {"bandwidth", "context_association_lists.source_list"})};
+    ASSERT_EQ(s.substr(0, s.find('\n')),
+              "{\"bandwidth\":1.500000,\"context_association_lists\":{\"source_list\":[\"0x00000001\","
+              "\"0x00000002\"]}}");
+}
+
+TEST_F(WriterTest, Csv) {
+    p_.header.packet_type = VRT_PT_IF_DATA_WITHOUT_STREAM_ID;
+    std::string s{print(vrt::print::Format::CSV, {"index", "packet_type", "stream_id", "class_id.oui", "body_size"})};
+    ASSERT_EQ(s,
+              "index,packet_type,stream_id,class_id.oui,body_size\n"
+              "0,IF Data packet without Stream Identifier,,0xABCDEF,3\n"
+              "1,IF Data packet without Stream Identifier,,0xABCDEF,3\n");
+}
+
+TEST_F(WriterTest, CsvDefault) {
+    std::string s{print(vrt::print::Format::CSV, {})};
+    ASSERT_EQ(s.substr(0, s.find('\n')),
+              "index,packet_type,tsm,tsi,tsf,packet_count,packet_size,stream_id,class_id.oui,"
+              "class_id.information_class_code,class_id.packet_class_code,integer_seconds_timestamp,"
+              "fractional_seconds_timestamp,body_size");
+}
+
+TEST_F(WriterTest, CsvInvalidKey) {
+    vrt::print::OutputBuffer out(nullptr);
+    ASSERT_THROW(vrt::print::make_writer(vrt::print::Format::CSV, &out, {"index", "class_id"}), std::runtime_error);
+    ASSERT_THROW(vrt::print::make_writer(vrt::print::Format::TSV, &out, {"stream_ib"}), std::runtime_error);
+    ASSERT_NO_THROW(vrt::print::make_writer(vrt::print::Format::CSV, &out,
+                                            {"formatted_gps_geolocation.time", "context_association_lists.source_list",
+                                             "state_and_event_indicators.user_defined", "user_defined8"}));
+    ASSERT_NO_THROW(vrt::print::make_writer(vrt::print::Format::JSON, &out, {"class_id"}));
+}
+
+TEST_F(WriterTest, Tsv) {
+    std::string s{print(vrt::print::Format::TSV, {"index", "stream_id"})};
+    ASSERT_EQ(s, "index\tstream_id\n0\t0xDEADBEEF\n1\t0xDEADBEEF\n");
+}
@@ -1,11 +1,14 @@
 #include <cstdlib>
 #include <iostream>
+#include <map>
 #include <stdexcept>
+#include <string>
 
 #include "vrt/vrt_util.h"
 
 #include "CLI/CLI.hpp"
 
+#include "common/percentage_validator.h"
 #include "process.h"
 #include "program_arguments.h"
 
@@ -64,6 +67,57 @@ static vrt::socket::ProgramArguments setup_arg_parse(CLI::App* app) {
     // Loop
     app->add_flag("-l,--loop", args.do_loop, "Loop when reaching end of stream");
 
+    // Impairments
+    const std::map<std::string, double> time_units{{"ms", 1e-3}, {"us", 1e-6}, {"ns", 1e-9}};
+    CLI::Option* opt_loss{app->add_option("--loss", args.impairments.prob_loss, "Probability that a packet is lost")};
+    opt_loss->check(CLI::Range(0.0, 1.0));
+    opt_loss->transform(vrt::common::PercentageValidator());
+    CLI::Option* opt_burst_loss{
+        app->add_option("--burst-loss", args.impairments.prob_burst_loss,
+                        "Probability that a packet is lost if the previous packet was lost")};
+    opt_burst_loss->check(CLI::Range(0.0, 1.0));
+    opt_burst_loss->transform(vrt::common::PercentageValidator());
+    CLI::Option* opt_delay{app->add_option("--delay", args.impairments.delay_s, "Added latency of all packets [s]")};
+    opt_delay->check(CLI::NonNegativeNumber);
+    opt_delay->transform(CLI::AsNumberWithUnit(time_units, CLI::AsNumberWithUnit::CASE_SENSITIVE));
+    CLI::Option* opt_jitter{app->add_option(
+        "--jitter", args.impairments.jitter_s,
+        "Largest added random latency [s], uniformly distributed. Packets may be reordered if larger than the time "
+        "between packets.")};
+    opt_jitter->check(CLI::NonNegativeNumber);
+    opt_jitter->transform(CLI::AsNumberWithUnit(time_units, CLI::AsNumberWithUnit::CASE_SENSITIVE));
+    CLI::Option* opt_reorder{app->add_option("--reorder", args.impairments.prob_reorder,
+                                             "Probability that a packet is delayed further, so that later packets "
+                                             "pass it")};
+    opt_reorder->check(CLI::Range(0.0, 1.0));
+    opt_reorder->transform(vrt::common::PercentageValidator());
+    CLI::Option* opt_reorder_delay{app->add_option("--reorder-delay", args.impairments.reorder_delay_s,
+                                                   "Further latency of reordered packets [s]. Default is 1 ms.")};
+    opt_reorder_delay->check(CLI::NonNegativeNumber);
+    opt_reorder_delay->transform(CLI::AsNumberWithUnit(time_units, CLI::AsNumberWithUnit::CASE_SENSITIVE));
+    CLI::Option* opt_duplicate{app->add_option("--duplicate", args.impairments.prob_duplicate,
+                                               "Probability that a packet is sent twice")};
+    opt_duplicate->check(CLI::Range(0.0, 1.0));
+    opt_duplicate->transform(vrt::common::PercentageValidator());
+    CLI::Option* opt_bottleneck_rate{app->add_option(
+        "--bottleneck-rate", args.impairments.bottleneck_rate,
+        "Rate of a bottleneck link that packets are queued for [B/s]. Default is no bottleneck.")};
+    opt_bottleneck_rate->transform(CLI::AsNumberWithUnit(
+        std::map<std::string, uint64_t>{{"G", 1000000000}, {"M", 1000000}, {"k", 1000}},
+        CLI::AsNumberWithUnit::CASE_SENSITIVE));
+    CLI::Option* opt_queue_size{app->add_option(
+        "--queue-size", args.impairments.queue_bytes,
+        "Size of the queue before the bottleneck link [B]. Packets are dropped when it is full. Default is 64k.")};
+    opt_queue_size->transform(CLI::AsNumberWithUnit(
+        std::map<std::string, uint64_t>{{"G", 1024 * 1024 * 1024}, {"M", 1024 * 1024}, {"k", 1024}},
+        CLI::AsNumberWithUnit::CASE_SENSITIVE));
+    opt_queue_size->needs(opt_bottleneck_rate);
+
+    // Seed
+    app->add_option("--seed", args.seed,
+                    "Seed of random numbers of impairments, for reproducible runs. Default is a random seed, which is "
+                    "printed.");
+
     return args;
 }
 
@@ -80,6 +134,7 @@ int main(int argc, const char** argv) {
     CLI::App                      app(CMAKE_PROJECT_DESCRIPTION, CMAKE_PROJECT_NAME);
     vrt::socket::ProgramArguments program_args{setup_arg_parse(&app)};
     CLI11_PARSE(app, argc, argv)
+    program_args.has_seed = app.count("--seed") != 0;
 
     // Check that endianness of platform compared to byte swap parameter makes sense
     if (vrt_is_platform_little_endian() && !program_args.do_byte_swap) {
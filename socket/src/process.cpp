@@ -6,31 +6,30 @@
 #include <cstdio>
 #include <filesystem>
 #include <iostream>
-#include <map>
 #include <memory>
 #include <stdexcept>
-#include <thread>
 #include <utility>
 #include <vector>
 
 #include <iostream>
 
-#include "vrt/vrt_time.h"
 #include "vrt/vrt_types.h"
 
 #include "Progress-CPP/ProgressBar.hpp"
-#include "common/comparator_id.h"
+#include "common/counter_random.h"
 #include "common/input_stream.h"
+#include "common/sample_rate_timeline.h"
 #include "common/stream_history.h"
+#include "common/timestamp.h"
 #include "program_arguments.h"
+#include "send_scheduler.h"
 #include "socket_abstraction.h"
 
 namespace vrt::socket {
 
 // For convenience
-using PacketPtr        = ::std::shared_ptr<vrt_packet>;
-namespace tm           = ::std::chrono;
-using StreamHistoryPtr = ::std::unique_ptr<common::StreamHistory>;
+using PacketPtr = ::std::shared_ptr<vrt_packet>;
+namespace tm    = ::std::chrono;
 
 /**
  * Process file contents.
@@ -45,12 +44,16 @@ void process(const ProgramArguments& args) {
     // Progress bar
     progresscpp::ProgressBar progress(static_cast<uint64_t>(input_stream.get_file_size()), 70);
 
-    std::map<PacketPtr, StreamHistoryPtr, common::ComparatorId> id_streams;
+    common::StreamHistory history(args.sample_rate);
 
-    PacketPtr                            pkt_0;
+    common::TimeKey                      key_0;
     std::vector<std::unique_ptr<Socket>> sockets;
     sockets.reserve(args.hosts.size());
 
+    // Impairments are applied by the scheduler, in this thread
+    uint64_t      seed{common::get_seed(args.has_seed, args.seed)};
+    SendScheduler scheduler(args.impairments, seed, &sockets);
+
     try {
         for (const std::string& host : args.hosts) {
             if (args.protocol == protocol_type::UDP) {
@@ -79,6 +82,9 @@ void process(const ProgramArguments& args) {
                     }
                     i = 0;
                     progress.reset();
+
+                    // Sample rates are found again, in time order
+                    history = common::StreamHistory(args.sample_rate);
                 } else {
                     break;
                 }
@@ -86,43 +92,29 @@ void process(const ProgramArguments& args) {
 
             // Get current time
             tm::time_point<tm::system_clock, tm::nanoseconds> t_now{tm::system_clock::now()};
+
+            // Convert timestamp with the sample rate of its stream at that time, so that pacing doesn't drift when a
+            // sample rate changes
+            PacketPtr       pkt{input_stream.get_packet()};
+            size_t          slot{history.update(*pkt)};
+            common::TimeKey key{history.get_timeline(slot).key(common::Timestamp(*pkt))};
             if (i == 0) {
-                pkt_0 = input_stream.get_packet();
+                key_0 = key;
                 t_0   = t_now;
             }
 
-            // Find Class ID, Stream ID combination in map, or construct new output ID if needed
-            PacketPtr pkt{input_stream.get_packet()};
-
-            // Get sample rate
-            double sample_rate{args.sample_rate};
-            auto   it{id_streams.find(pkt)};
-            if (it == id_streams.end()) {
-                id_streams[pkt] = std::make_unique<common::StreamHistory>(args.sample_rate);
-            } else {
-                it->second->update(pkt);
-                sample_rate = it->second->get_sample_rate();
-            }
-
             // Calculate time until next packet
-            vrt_time time_diff;
-            if (vrt_time_difference_fields(&pkt->header, &pkt->fields, &pkt_0->header, &pkt_0->fields, sample_rate,
-                                           &time_diff) < 0 ||
-                time_diff.s < 0) {
+            common::Int128 time_diff;
+            if (!common::time_difference(key, key_0, &time_diff) || time_diff < 0) {
                 // Don't sleep if error or negative time
-                time_diff.s  = 0;
-                time_diff.ps = 0;
+                time_diff = 0;
             }
 
-            tm::duration<int64_t, std::nano> td{tm::seconds(time_diff.s) + tm::nanoseconds(time_diff.ps / 1000)};
-            tm::time_point<tm::system_clock, tm::nanoseconds> t_pkt_now{
-                tm::time_point<tm::system_clock, tm::nanoseconds>(td)};
+            // Round to nearest nanosecond, without accumulating errors since time is relative to the first packet
+            tm::duration<int64_t, std::nano> td{static_cast<int64_t>((time_diff + 500) / 1000)};
 
-            std::this_thread::sleep_for(td - (t_now - t_0));
-
-            for (auto& socket : sockets) {
-                socket->send(input_stream.get_buffer().data(), sizeof(uint32_t) * pkt->header.packet_size);
-            }
+            // Send at deadline, or later if impaired
+            scheduler.schedule(t_0 + td, input_stream.get_buffer().data(), sizeof(uint32_t) * pkt->header.packet_size);
 
             // Handle progress bar
             progress += sizeof(uint32_t) * pkt->header.packet_size;
@@ -131,6 +123,9 @@ void process(const ProgramArguments& args) {
                 t_progress_bar_update = t_now;
             }
         }
+
+        // Send packets still delayed
+        scheduler.flush();
     } catch (const libsocket::socket_exception& exc) {
         std::stringstream ss;
         ss << "Socket send error: ";
@@ -140,6 +135,15 @@ void process(const ProgramArguments& args) {
 
     progress.done();
 
+    if (scheduler.is_enabled()) {
+        if (!args.has_seed) {
+            std::cout << "Seed: " << seed << std::endl;
+        }
+        std::cout << "Lost " << scheduler.get_number_of_lost() << ", duplicated "
+                  << scheduler.get_number_of_duplicated() << ", reordered " << scheduler.get_number_of_reordered()
+                  << " and dropped by queue " << scheduler.get_number_of_queue_dropped() << " packets" << std::endl;
+    }
+
     std::cout.flush();
 }
 
@@ -3,6 +3,9 @@
 
 #include <filesystem>
 #include <string>
+#include <vector>
+
+#include "send_scheduler.h"
 
 namespace vrt::socket {
 
@@ -19,6 +22,9 @@ struct ProgramArguments {
     double                   sample_rate{0.0};             /**< Sample rate [Hz] */
     protocol_type            protocol{protocol_type::UDP}; /**< Network protocol */
     bool                     do_loop{false};               /**< True if loop at end */
+    ImpairmentArguments      impairments{};                /**< Network impairments */
+    uint64_t                 seed{0};                      /**< Seed of random numbers */
+    bool                     has_seed{false};              /**< True if seed is given */
 };
 
 }  // namespace vrt::socket
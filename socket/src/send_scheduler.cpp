@@ -0,0 +1,174 @@
+#include "send_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "socket_abstraction.h"
+
+namespace vrt::socket {
+
+namespace tm = ::std::chrono;
+
+/**
+ * Parts of the counter range of random numbers.
+ */
+enum Draw : unsigned { LOSS, DUPLICATE, JITTER, REORDER };
+
+/**
+ * Convert duration in seconds.
+ *
+ * \param s Duration [s].
+ *
+ * \return Duration [ns].
+ */
+static tm::nanoseconds to_duration(double s) {
+    return tm::nanoseconds(static_cast<int64_t>(s * 1e9 + 0.5));
+}
+
+/**
+ * Constructor.
+ *
+ * \param args    Impairments.
+ * \param seed    Seed of random numbers.
+ * \param sockets Sockets to send to.
+ */
+SendScheduler::SendScheduler(const ImpairmentArguments&            args,
+                             uint64_t                              seed,
+                             std::vector<std::unique_ptr<Socket>>* sockets)
+    : args_{args},
+      random_{seed},
+      sockets_{sockets},
+      is_enabled_{args.prob_loss > 0.0 || args.delay_s > 0.0 || args.jitter_s > 0.0 || args.prob_reorder > 0.0 ||
+                  args.prob_duplicate > 0.0 || args.bottleneck_rate != 0} {}
+
+/**
+ * Schedule packet, and send packets departing until its deadline. Without impairments, the packet is sent at its
+ * deadline.
+ *
+ * \param deadline Time to send packet, without impairments.
+ * \param buf      Non-byte swapped packet buffer.
+ * \param bytes    Packet size [B].
+ *
+ * \throw libsocket::socket_exception On send error.
+ */
+void SendScheduler::schedule(TimePoint deadline, const uint32_t* buf, size_t bytes) {
+    if (!is_enabled_) {
+        send(deadline, buf, bytes);
+        return;
+    }
+
+    // Packets scheduled earlier may depart before this one
+    send_until(deadline);
+
+    uint64_t n{n_++};
+    double   lim{args_.prob_loss};
+    if (args_.prob_burst_loss != 0.0 && prev_lost_) {
+        lim = args_.prob_burst_loss;
+    }
+    prev_lost_ = random_.uniform((static_cast<uint64_t>(LOSS) << 60U) + n) < lim;
+    if (prev_lost_) {
+        n_lost_++;
+        return;
+    }
+
+    bool is_duplicated{args_.prob_duplicate > 0.0 &&
+                       random_.uniform((static_cast<uint64_t>(DUPLICATE) << 60U) + n) < args_.prob_duplicate};
+    for (uint64_t copy{0}; copy < (is_duplicated ? 2U : 1U); ++copy) {
+        double latency_s{args_.delay_s +
+                         args_.jitter_s * random_.uniform((static_cast<uint64_t>(JITTER) << 60U) + 2 * n + copy)};
+        if (args_.prob_reorder > 0.0 &&
+            random_.uniform((static_cast<uint64_t>(REORDER) << 60U) + 2 * n + copy) < args_.prob_reorder) {
+            latency_s += args_.reorder_delay_s;
+            n_reordered_++;
+        }
+        push(deadline + to_duration(latency_s), buf, bytes);
+    }
+    if (is_duplicated) {
+        n_duplicated_++;
+    }
+}
+
+/**
+ * Send all pending packets, at end of input.
+ *
+ * \throw libsocket::socket_exception On send error.
+ */
+void SendScheduler::flush() {
+    send_until(TimePoint::max());
+}
+
+/**
+ * Add packet to pending packets.
+ *
+ * \param departure Departure time.
+ * \param buf       Non-byte swapped packet buffer.
+ * \param bytes     Packet size [B].
+ */
+void SendScheduler::push(TimePoint departure, const uint32_t* buf, size_t bytes) {
+    Pending pending;
+    pending.departure = departure;
+    pending.sequence  = sequence_++;
+    pending.buf.assign(buf, buf + (bytes + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+    pending.bytes = bytes;
+    heap_.push_back(std::move(pending));
+    std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+}
+
+/**
+ * Send pending packets departing until a time, in order of departure.
+ *
+ * \param t Time.
+ *
+ * \throw libsocket::socket_exception On send error.
+ */
+void SendScheduler::send_until(TimePoint t) {
+    while (!heap_.empty() && heap_.front().departure <= t) {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+        const Pending& pending{heap_.back()};
+        send(pending.departure, pending.buf.data(), pending.bytes);
+        heap_.pop_back();
+    }
+}
+
+/**
+ * Send packet to all sockets at departure time, or later if the bottleneck link is busy. The packet is dropped if the
+ * bottleneck queue is full.
+ *
+ * \param departure Departure time.
+ * \param buf       Non-byte swapped packet buffer.
+ * \param bytes     Packet size [B].
+ *
+ * \throw libsocket::socket_exception On send error.
+ */
+void SendScheduler::send(TimePoint departure, const uint32_t* buf, size_t bytes) {
+    TimePoint t_send{departure};
+    if (args_.bottleneck_rate != 0) {
+        // Bytes waiting in queue when packet arrives
+        double queued{0.0};
+        if (link_free_ > departure) {
+            queued = static_cast<double>((link_free_ - departure).count()) * 1e-9 *
+                     static_cast<double>(args_.bottleneck_rate);
+        }
+        if (queued + static_cast<double>(bytes) > static_cast<double>(args_.queue_bytes)) {
+            n_queue_dropped_++;
+            return;
+        }
+
+        t_send     = std::max(departure, link_free_);
+        link_free_ = t_send + to_duration(static_cast<double>(bytes) / static_cast<double>(args_.bottleneck_rate));
+    }
+
+    std::this_thread::sleep_until(t_send);
+    for (auto& socket : *sockets_) {
+        socket->send(buf, bytes);
+    }
+}
+
+}  // namespace vrt::socket
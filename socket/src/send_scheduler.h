@@ -0,0 +1,115 @@
+#ifndef VRT_SOCKET_SRC_SEND_SCHEDULER_H_
+#define VRT_SOCKET_SRC_SEND_SCHEDULER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/counter_random.h"
+
+namespace vrt::socket {
+
+class Socket;
+
+/**
+ * Time of sending.
+ */
+using TimePoint = std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>;
+
+/**
+ * Network impairments applied when sending.
+ */
+struct ImpairmentArguments {
+    double   prob_loss{0.0};         /**< Probability that a packet is lost. */
+    double   prob_burst_loss{0.0};   /**< Probability that a packet is lost if the previous one was, or 0 if same. */
+    double   delay_s{0.0};           /**< Added latency [s]. */
+    double   jitter_s{0.0};          /**< Largest added random latency [s]. */
+    double   prob_reorder{0.0};      /**< Probability that a packet is delayed further, so that later packets pass. */
+    double   reorder_delay_s{1e-3};  /**< Further latency of reordered packets [s]. */
+    double   prob_duplicate{0.0};    /**< Probability that a packet is sent twice. */
+    uint64_t bottleneck_rate{0};     /**< Rate of bottleneck link [B/s], or 0 if none. */
+    uint64_t queue_bytes{64 * 1024}; /**< Size of queue before bottleneck link [B]. */
+};
+
+/**
+ * Scheduler of packets to send at their deadlines, with impairments. Impaired packets are held in a min-heap keyed by
+ * departure time, and sent from the same thread as they are read, when the deadline of a later packet is reached. Added
+ * latency is never negative, so a packet never departs before its deadline, and packets are sent in order of
+ * departure. A bottleneck link sends packets no faster than its rate, and drops them when its queue is full. Random
+ * numbers only depend on the seed and the number of packets scheduled.
+ */
+class SendScheduler {
+   public:
+    SendScheduler(const ImpairmentArguments& args, uint64_t seed, std::vector<std::unique_ptr<Socket>>* sockets);
+
+    void schedule(TimePoint deadline, const uint32_t* buf, size_t bytes);
+    void flush();
+
+    /**
+     * \return True if any impairment is enabled.
+     */
+    bool is_enabled() const { return is_enabled_; }
+
+    /**
+     * \return Number of packets lost.
+     */
+    uint64_t get_number_of_lost() const { return n_lost_; }
+
+    /**
+     * \return Number of packets sent twice.
+     */
+    uint64_t get_number_of_duplicated() const { return n_duplicated_; }
+
+    /**
+     * \return Number of packets delayed further, to be reordered.
+     */
+    uint64_t get_number_of_reordered() const { return n_reordered_; }
+
+    /**
+     * \return Number of packets dropped by a full bottleneck queue.
+     */
+    uint64_t get_number_of_queue_dropped() const { return n_queue_dropped_; }
+
+   private:
+    /**
+     * Packet waiting for its departure.
+     */
+    struct Pending {
+        TimePoint             departure;   /**< Departure time. */
+        uint64_t              sequence{0}; /**< Order of scheduling, for packets departing at the same time. */
+        std::vector<uint32_t> buf;         /**< Packet. */
+        size_t                bytes{0};    /**< Packet size [B]. */
+
+        /**
+         * \return True if this departs after other, for a min-heap.
+         */
+        bool operator>(const Pending& other) const {
+            return departure != other.departure ? departure > other.departure : sequence > other.sequence;
+        }
+    };
+
+    void send_until(TimePoint t);
+    void send(TimePoint departure, const uint32_t* buf, size_t bytes);
+    void push(TimePoint departure, const uint32_t* buf, size_t bytes);
+
+    const ImpairmentArguments                   args_;
+    const common::CounterRandom                 random_;
+    std::vector<std::unique_ptr<Socket>>* const sockets_;
+    const bool                                  is_enabled_;
+
+    std::vector<Pending> heap_;               /**< Pending packets, earliest departure on top. */
+    uint64_t             n_{0};               /**< Number of packets scheduled. */
+    uint64_t             sequence_{0};        /**< Number of packets pushed on heap. */
+    bool                 prev_lost_{false};   /**< If previous packet was lost. */
+    TimePoint            link_free_;          /**< When bottleneck link has sent all queued packets. */
+    uint64_t             n_lost_{0};          /**< Number of packets lost. */
+    uint64_t             n_duplicated_{0};    /**< Number of packets sent twice. */
+    uint64_t             n_reordered_{0};     /**< Number of packets delayed further. */
+    uint64_t             n_queue_dropped_{0}; /**< Number of packets dropped by bottleneck queue. */
+};
+
+}  // namespace vrt::socket
+
+#endif
@@ -13,6 +13,8 @@ namespace vrt::socket {
  */
 class Socket {
    public:
+    virtual ~Socket() = default;
+
     virtual void send(const void* buf, size_t size) = 0;
 };
 
@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "../../src/send_scheduler.h"
+#include "../../src/socket_abstraction.h"
+#include "common/counter_random.h"
+
+using namespace vrt;
+
+namespace chrono = ::std::chrono;
+
+static const uint64_t SEED{1234};
+static const size_t   N_PACKETS{1000};
+static const size_t   WORDS{25};
+static const size_t   BYTES{WORDS * sizeof(uint32_t)};
+
+/**
+ * Parts of the counter range of random numbers, as in SendScheduler.
+ */
+enum Draw : unsigned { LOSS, DUPLICATE, JITTER, REORDER };
+
+/**
+ * Socket recording the index of each packet sent, which is the first word.
+ */
+class FakeSocket : public socket::Socket {
+   public:
+    explicit FakeSocket(std::vector<uint32_t>* sent) : sent_{sent} {}
+
+    void send(const void* buf, size_t size) override {
+        ASSERT_EQ(size, BYTES);
+        sent_->push_back(*static_cast<const uint32_t*>(buf));
+    }
+
+   private:
+    std::vector<uint32_t>* sent_;
+};
+
+class SendSchedulerTest : public ::testing::Test {
+   protected:
+    SendSchedulerTest() : random_{SEED}, buf_(WORDS) {}
+
+    void SetUp() override {
+        sockets_.clear();
+        sent_[0].clear();
+        sent_[1].clear();
+        sockets_.push_back(std::make_unique<FakeSocket>(&sent_[0]));
+        sockets_.push_back(std::make_unique<FakeSocket>(&sent_[1]));
+        // In the past, so that nothing sleeps
+        t0_ = chrono::time_point_cast<chrono::nanoseconds>(chrono::system_clock::now()) - chrono::seconds(10);
+    }
+
+    /**
+     * Schedule packets with increasing index and deadline, and flush.
+     *
+     * \param scheduler Scheduler.
+     * \param spacing   Time between deadlines.
+     */
+    void schedule(socket::SendScheduler* scheduler, chrono::nanoseconds spacing) {
+        for (size_t i{0}; i < N_PACKETS; ++i) {
+            buf_[0] = static_cast<uint32_t>(i);
+            scheduler->schedule(t0_ + static_cast<int64_t>(i) * spacing, buf_.data(), BYTES);
+        }
+        scheduler->flush();
+    }
+
+    /**
+     * Draw random number as SendScheduler does.
+     *
+     * \param draw Part of counter range.
+     * \param i    Counter in part.
+     *
+     * \return Number in [0, 1).
+     */
+    double uniform(Draw draw, uint64_t i) const { return random_.uniform((static_cast<uint64_t>(draw) << 60U) + i); }
+
+    const common::CounterRandom                  random_;
+    std::vector<uint32_t>                        buf_;
+    std::vector<std::unique_ptr<socket::Socket>> sockets_;
+    std::vector<uint32_t>                        sent_[2];
+    socket::TimePoint                            t0_;
+};
+
+TEST_F(SendSchedulerTest, None) {
+    socket::ImpairmentArguments args;
+    socket::SendScheduler       scheduler(args, SEED, &sockets_);
+    ASSERT_FALSE(scheduler.is_enabled());
+    schedule(&scheduler, chrono::microseconds(100));
+
+    std::vector<uint32_t> expected(N_PACKETS);
+    std::iota(expected.begin(), expected.end(), 0);
+    ASSERT_EQ(sent_[0], expected);
+    ASSERT_EQ(sent_[1], expected);
+}
+
+TEST_F(SendSchedulerTest, Delay) {
+    socket::ImpairmentArguments args;
+    args.delay_s = 1e-3;
+    socket::SendScheduler scheduler(args, SEED, &sockets_);
+    ASSERT_TRUE(scheduler.is_enabled());
+    schedule(&scheduler, chrono::microseconds(100));
+
+    // Constant latency never reorders
+    std::vector<uint32_t> expected(N_PACKETS);
+    std::iota(expected.begin(), expected.end(), 0);
+    ASSERT_EQ(sent_[0], expected);
+    ASSERT_EQ(sent_[1], expected);
+}
+
+TEST_F(SendSchedulerTest, JitterReorder) {
+    socket::ImpairmentArguments args;
+    args.jitter_s        = 250e-6;
+    args.prob_reorder    = 0.2;
+    args.reorder_delay_s = 350e-6;
+    socket::SendScheduler scheduler(args, SEED, &sockets_);
+    schedule(&scheduler, chrono::microseconds(100));
+
+    // Packets are sent in order of departure, from the same draws
+    std::vector<int64_t>  departure(N_PACKETS);
+    uint64_t              n_reordered{0};
+    std::vector<uint32_t> expected(N_PACKETS);
+    for (size_t i{0}; i < N_PACKETS; ++i) {
+        double latency_s{args.jitter_s * uniform(JITTER, 2 * i)};
+        if (uniform(REORDER, 2 * i) < args.prob_reorder) {
+            latency_s += args.reorder_delay_s;
+            n_reordered++;
+        }
+        departure[i] = static_cast<int64_t>(i) * 100000 + static_cast<int64_t>(latency_s * 1e9 + 0.5);
+    }
+    std::iota(expected.begin(), expected.end(), 0);
+    std::stable_sort(expected.begin(), expected.end(),
+                     [&departure](uint32_t a, uint32_t b) { return departure[a] < departure[b]; });
+    ASSERT_EQ(sent_[0], expected);
+    ASSERT_EQ(sent_[1], expected);
+    ASSERT_EQ(scheduler.get_number_of_reordered(), n_reordered);
+    ASSERT_GT(n_reordered, 0);
+    ASSERT_EQ(scheduler.get_number_of_lost(), 0);
+    ASSERT_EQ(scheduler.get_number_of_duplicated(), 0);
+
+    // Some packets pass others
+    ASSERT_FALSE(std::is_sorted(sent_[0].begin(), sent_[0].end()));
+}
+
+TEST_F(SendSchedulerTest, LossDuplicate) {
+    socket::ImpairmentArguments args;
+    args.prob_loss       = 0.1;
+    args.prob_burst_loss = 0.5;
+    args.prob_duplicate  = 0.05;
+    socket::SendScheduler scheduler(args, SEED, &sockets_);
+    schedule(&scheduler, chrono::microseconds(100));
+
+    // Count from the same draws
+    std::vector<uint32_t> expected;
+    uint64_t              n_lost{0};
+    uint64_t              n_duplicated{0};
+    bool                  prev_lost{false};
+    for (size_t i{0}; i < N_PACKETS; ++i) {
+        prev_lost = uniform(LOSS, i) < (prev_lost ? args.prob_burst_loss : args.prob_loss);
+        if (prev_lost) {
+            n_lost++;
+            continue;
+        }
+        expected.push_back(static_cast<uint32_t>(i));
+        if (uniform(DUPLICATE, i) < args.prob_duplicate) {
+            // Both copies depart at the deadline
+            expected.push_back(static_cast<uint32_t>(i));
+            n_duplicated++;
+        }
+    }
+    ASSERT_EQ(scheduler.get_number_of_lost(), n_lost);
+    ASSERT_EQ(scheduler.get_number_of_duplicated(), n_duplicated);
+    ASSERT_GT(n_lost, 0);
+    ASSERT_GT(n_duplicated, 0);
+    ASSERT_EQ(sent_[0], expected);
+    ASSERT_EQ(sent_[1], expected);
+    ASSERT_EQ(sent_[0].size(), N_PACKETS - n_lost + n_duplicated);
+}
+
+TEST_F(SendSchedulerTest, Seed) {
+    socket::ImpairmentArguments args;
+    args.prob_loss      = 0.1;
+    args.jitter_s       = 1e-3;
+    args.prob_duplicate = 0.1;
+    socket::SendScheduler scheduler1(args, SEED, &sockets_);
+    schedule(&scheduler1, chrono::microseconds(100));
+    std::vector<uint32_t> sent1{sent_[0]};
+
+    sent_[0].clear();
+    socket::SendScheduler scheduler2(args, SEED, &sockets_);
+    schedule(&scheduler2, chrono::microseconds(100));
+    ASSERT_EQ(sent_[0], sent1);
+
+    sent_[0].clear();
+    socket::SendScheduler scheduler3(args, SEED + 1, &sockets_);
+    schedule(&scheduler3, chrono::microseconds(100));
+    ASSERT_NE(sent_[0], sent1);
+}
+
+TEST_F(SendSchedulerTest, Bottleneck) {
+    socket::ImpairmentArguments args;
+    args.bottleneck_rate = 1000000;  // A packet per 100 us
+    args.queue_bytes     = 950;
+    socket::SendScheduler scheduler(args, SEED, &sockets_);
+    ASSERT_TRUE(scheduler.is_enabled());
+
+    // Burst at the same deadline fills the queue
+    for (size_t i{0}; i < 20; ++i) {
+        buf_[0] = static_cast<uint32_t>(i);
+        scheduler.schedule(t0_, buf_.data(), BYTES);
+    }
+    // Queue has drained
+    buf_[0] = 20;
+    scheduler.schedule(t0_ + chrono::milliseconds(10), buf_.data(), BYTES);
+    scheduler.flush();
+
+    // Packet queued behind 9 others would exceed the queue, and so would all later packets in the burst
+    std::vector<uint32_t> expected{0, 1, 2, 3, 4, 5, 6, 7, 8, 20};
+    ASSERT_EQ(sent_[0], expected);
+    ASSERT_EQ(sent_[1], expected);
+    ASSERT_EQ(scheduler.get_number_of_queue_dropped(), 11);
+}
@@ -0,0 +1,126 @@
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include "vrt/vrt_util.h"
+
+#include "CLI/CLI.hpp"
+
+#include "process.h"
+#include "program_arguments.h"
+
+#ifndef CMAKE_PROJECT_NAME
+#error "No project name definition from CMake"
+#endif
+#ifndef CMAKE_PROJECT_DESCRIPTION
+#error "No project definition from CMake"
+#endif
+
+namespace fs = ::std::filesystem;
+
+/**
+ * Setup program command line argument parsing.
+ *
+ * \param app CLI11 app.
+ *
+ * \return Program input arguments.
+ */
+static vrt::sort::ProgramArguments setup_arg_parse(CLI::App* app) {
+    vrt::sort::ProgramArguments args;
+
+    // Input file
+    CLI::Option* opt_file_in{app->add_option("-i,--input-file", args.file_path_in, "Input file path")};
+    opt_file_in->required(true);
+    opt_file_in->check(CLI::ExistingFile);
+
+    // Output file
+    CLI::Option* opt_file_out{app->add_option("-o,--output-file", args.file_path_out, "Output file path")};
+    opt_file_out->required(true);
+
+    // Byte swap
+    app->add_flag("-b,--byte-swap", args.do_byte_swap,
+                  "Apply byte swap before parsing file. Note that this will NOT byte swap packet output.");
+
+    // Sample rate
+    CLI::Option* opt_sample_rate{app->add_option(
+        "-s,--sample-rate", args.sample_rate,
+        "Sample rate [Hz]. If IF context sample rate appears in the stream it will take precedence over this option.")};
+    opt_sample_rate->check(CLI::NonNegativeNumber);
+    opt_sample_rate->transform(CLI::AsNumberWithUnit(
+        std::map<std::string, uint64_t>{{"T", 1000000000000}, {"G", 1000000000}, {"M", 1000000}, {"k", 1000}},
+        CLI::AsNumberWithUnit::CASE_SENSITIVE));
+
+    // Memory
+    CLI::Option* opt_memory{app->add_option("-m,--memory", args.memory_bytes,
+                                            "Memory for sorting [B], e.g. 4G. Default is 256M. Larger files are "
+                                            "sorted in parts, which are kept in temporary files.")};
+    opt_memory->check(CLI::PositiveNumber);
+    opt_memory->transform(CLI::AsNumberWithUnit(
+        std::map<std::string, uint64_t>{{"G", 1024 * 1024 * 1024}, {"M", 1024 * 1024}, {"k", 1024}},
+        CLI::AsNumberWithUnit::CASE_SENSITIVE));
+
+    // Temporary directory
+    CLI::Option* opt_temp_dir{app->add_option("-t,--temp-dir", args.temp_dir,
+                                              "Directory of temporary files. Default is that of the output file.")};
+    opt_temp_dir->check(CLI::ExistingDirectory);
+
+    // Jobs
+    CLI::Option* opt_jobs{app->add_option(
+        "-j,--jobs", args.n_jobs, "Number of threads sorting parts of the file. 0 means one per CPU core.")};
+    opt_jobs->check(CLI::NonNegativeNumber);
+
+    return args;
+}
+
+/**
+ * Starting point.
+ *
+ * \param argc Number of input arguments.
+ * \param argv Input arguments [argc].
+ *
+ * \return EXIT_SUCCESS if success, and EXIT_FAILURE otherwise.
+ */
+int main(int argc, const char** argv) {
+    // Parse arguments
+    CLI::App                    app(CMAKE_PROJECT_DESCRIPTION, CMAKE_PROJECT_NAME);
+    vrt::sort::ProgramArguments program_args{setup_arg_parse(&app)};
+    CLI11_PARSE(app, argc, argv)
+
+    // Parameter validation
+    try {
+        if (fs::equivalent(program_args.file_path_in, program_args.file_path_out)) {
+            std::cerr << "Cannot use the same input as output file path: " << program_args.file_path_in << std::endl;
+            return EXIT_FAILURE;
+        }
+    } catch (const fs::filesystem_error&) {
+        // Do nothing. Output path does not exist. If input path doesn't exist it will be shown when file opens anyway.
+    }
+
+    // Check that endianness of platform compared to byte swap parameter makes sense
+    if (vrt_is_platform_little_endian() && !program_args.do_byte_swap) {
+        std::cerr << "Warning: Detected little endian platform, but byte swap is NOT enabled. This will only work on "
+                     "non-conforming VRT packets."
+                  << std::endl;
+    } else if (program_args.do_byte_swap) {
+        std::cerr << "Warning: Detected big endian platform, but byte swap IS enabled. This will only work on "
+                     "non-conforming VRT packets."
+                  << std::endl;
+    }
+
+    // Process
+    try {
+        vrt::sort::process(program_args);
+    } catch (const std::exception& exc) {
+        std::cerr << exc.what() << std::endl;
+        return EXIT_FAILURE;
+    } catch (...) {
+        std::cerr << "Unknown error" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,337 @@
+#include "process.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "vrt/vrt_string.h"
+#include "vrt/vrt_types.h"
+
+#include "Progress-CPP/ProgressBar.hpp"
+#include "common/input_stream.h"
+#include "common/output_stream.h"
+#include "common/stream_history.h"
+#include "common/timestamp.h"
+#include "program_arguments.h"
+#include "run.h"
+
+namespace vrt::sort {
+
+namespace fs = ::std::filesystem;
+
+/**
+ * Smallest number of records in a run, however little memory is given.
+ */
+static constexpr size_t MIN_RUN_RECORDS{64};
+
+/**
+ * Largest number of runs merged at a time. More runs are first merged into fewer, longer, ones.
+ */
+static constexpr size_t MAX_MERGE_RUNS{64};
+
+/**
+ * Temporary files, which are removed when going out of scope.
+ */
+class TempFiles {
+   public:
+    /**
+     * Constructor.
+     *
+     * \param dir  Directory of files.
+     * \param name Start of file names.
+     */
+    TempFiles(fs::path dir, std::string name) : dir_{std::move(dir)}, name_{std::move(name)} {}
+
+    ~TempFiles() {
+        for (const fs::path& path : paths_) {
+            std::error_code ec;
+            fs::remove(path, ec);
+        }
+    }
+
+    TempFiles(const TempFiles&) = delete;
+    TempFiles& operator=(const TempFiles&) = delete;
+
+    /**
+     * \return Path of a new temporary file.
+     */
+    fs::path create() {
+        fs::path path{dir_ / (name_ + ".run" + std::to_string(paths_.size()) + ".tmp")};
+        paths_.push_back(path);
+        return path;
+    }
+
+    /**
+     * Remove file that is no longer needed.
+     *
+     * \param path File path, from create().
+     */
+    static void remove(const fs::path& path) {
+        std::error_code ec;
+        fs::remove(path, ec);
+    }
+
+   private:
+    const fs::path        dir_;
+    const std::string     name_;
+    std::vector<fs::path> paths_;
+};
+
+/**
+ * Reader of packets from the input file, by position. Reading packets in order of position, as when the input is
+ * nearly sorted, doesn't seek.
+ */
+class PacketReader {
+   public:
+    /**
+     * Constructor. Open file for reading.
+     *
+     * \param file_path File path.
+     *
+     * \throw std::runtime_error If file fails to open.
+     */
+    explicit PacketReader(fs::path file_path) : file_path_{std::move(file_path)} {
+        file_.exceptions(std::ios::badbit | std::ios::failbit | std::ios::eofbit);
+        try {
+            file_.open(file_path_, std::ios::in | std::ios::binary);
+        } catch (const std::ios::failure&) {
+            std::stringstream ss;
+            ss << "Failed to open input file " << file_path_;
+            throw std::runtime_error(ss.str());
+        }
+    }
+
+    /**
+     * Read packet.
+     *
+     * \param record Record of packet.
+     *
+     * \return Non-byte swapped packet buffer, with at least record.words words.
+     *
+     * \throw std::runtime_error On read error.
+     */
+    const std::vector<uint32_t>& read(const Record& record) {
+        if (buf_.size() < record.words) {
+            buf_.resize(record.words);
+        }
+        try {
+            if (record.position != position_) {
+                file_.seekg(static_cast<std::streamoff>(record.position));
+            }
+            file_.read(reinterpret_cast<char*>(buf_.data()),
+                       static_cast<std::streamsize>(sizeof(uint32_t) * record.words));
+        } catch (const std::ios::failure&) {
+            std::stringstream ss;
+            ss << "Failed to read from input file " << file_path_ << " at position " << record.position;
+            throw std::runtime_error(ss.str());
+        }
+        position_ = record.position + sizeof(uint32_t) * record.words;
+
+        return buf_;
+    }
+
+   private:
+    const fs::path        file_path_;
+    std::ifstream         file_;
+    uint64_t              position_{0};
+    std::vector<uint32_t> buf_;
+};
+
+/**
+ * Sort records and write them as a run.
+ *
+ * \param records   Records.
+ * \param file_path Path of run file.
+ *
+ * \throw std::runtime_error On I/O error.
+ */
+static void SortRun(std::vector<Record> records, const fs::path& file_path) {
+    std::sort(records.begin(), records.end());
+    RunWriter writer(file_path);
+    writer.write(records.data(), records.size());
+    writer.close();
+}
+
+/**
+ * Make record of packet.
+ *
+ * \param packet   Packet.
+ * \param history  Stream histories, with packet.
+ * \param slot     Slot of stream of packet.
+ * \param position Position of packet in input file [B].
+ * \param tsi      Integer seconds timestamp type of first packet.
+ * \param i        Packet index, used in messages.
+ *
+ * \return Record.
+ *
+ * \throw std::runtime_error If packet can't be ordered by time.
+ */
+static Record MakeRecord(const vrt_packet&            packet,
+                         const common::StreamHistory& history,
+                         size_t                       slot,
+                         uint64_t                     position,
+                         vrt_tsi                      tsi,
+                         uint64_t                     i) {
+    common::Timestamp time(packet);
+    if (time.tsi == VRT_TSI_NONE) {
+        std::stringstream ss;
+        ss << "Packet " << i << ": Integer second timestamp is NONE";
+        throw std::runtime_error(ss.str());
+    }
+    if (time.tsi != tsi) {
+        std::stringstream ss;
+        ss << "Packet " << i << ": Cannot compare different Integer second timestamps (TSI) of "
+           << vrt_string_tsi(static_cast<vrt_tsi>(time.tsi)) << " with " << vrt_string_tsi(tsi);
+        throw std::runtime_error(ss.str());
+    }
+
+    common::TimeKey key{history.get_timeline(slot).key(time)};
+    if (!key.is_exact()) {
+        std::stringstream ss;
+        ss << "Packet " << i << ": Sample rate is needed to convert "
+           << vrt_string_tsf(static_cast<vrt_tsf>(time.tsf)) << " timestamp to time. Use --sample-rate.";
+        throw std::runtime_error(ss.str());
+    }
+
+    Record record;
+    record.time     = key.picoseconds();
+    record.id       = history.get_id(slot);
+    record.position = position;
+    record.words    = packet.header.packet_size;
+
+    return record;
+}
+
+/**
+ * Process file contents. Records of packets are gathered into runs that fit in memory, which are sorted in parallel
+ * and written to temporary files. Runs are then merged, and each packet is copied from the input file to the output
+ * file in order. If all records fit in one run, no temporary files are used.
+ *
+ * \param args Program arguments.
+ *
+ * \throw std::runtime_error If there's an error.
+ */
+void process(const ProgramArguments& args) {
+    common::InputStream input_stream(args.file_path_in, args.do_byte_swap);
+    auto                file_size{static_cast<uint64_t>(input_stream.get_file_size())};
+
+    // One run is gathered while the others are sorted
+    unsigned n_jobs{args.n_jobs != 0 ? args.n_jobs : std::max(std::thread::hardware_concurrency(), 1U)};
+    size_t   n_run_records{std::max<size_t>(
+        static_cast<size_t>(args.memory_bytes / (sizeof(Record) * (static_cast<uint64_t>(n_jobs) + 1))),
+        MIN_RUN_RECORDS)};
+
+    fs::path  temp_dir{!args.temp_dir.empty() ? args.temp_dir : args.file_path_out.parent_path()};
+    TempFiles temp_files(temp_dir.empty() ? fs::path(".") : temp_dir, args.file_path_out.filename().string());
+
+    common::OutputStream output_stream(args.file_path_out);
+
+    // Input is read twice, first for records and then for packets
+    progresscpp::ProgressBar progress(2 * file_size, 70);
+
+    try {
+        std::vector<fs::path>         runs;
+        std::deque<std::future<void>> sorting;
+        std::vector<Record>           records;
+        records.reserve(n_run_records);
+
+        common::StreamHistory history(args.sample_rate);
+        uint64_t              position{0};
+        vrt_tsi               tsi{VRT_TSI_NONE};
+        for (uint64_t i{0}; input_stream.read_next_packet(); ++i) {
+            const vrt_packet& packet{*input_stream.get_packet()};
+            size_t            slot{history.update(packet)};
+            if (i == 0) {
+                tsi = packet.header.tsi;
+            }
+            records.push_back(MakeRecord(packet, history, slot, position, tsi, i));
+
+            uint64_t size{sizeof(uint32_t) * packet.header.packet_size};
+            position += size;
+            progress += size;
+            if (progress.get_ticks() % 65536 == 0) {
+                progress.display();
+            }
+
+            if (records.size() == n_run_records) {
+                if (sorting.size() == n_jobs) {
+                    sorting.front().get();
+                    sorting.pop_front();
+                }
+                runs.push_back(temp_files.create());
+                sorting.push_back(std::async(std::launch::async, SortRun, std::move(records), runs.back()));
+                records = std::vector<Record>();
+                records.reserve(n_run_records);
+            }
+        }
+
+        PacketReader packet_reader(args.file_path_in);
+        auto         write{[&](const Record& record) {
+            output_stream.write(packet_reader.read(record), static_cast<int32_t>(record.words));
+            progress += sizeof(uint32_t) * record.words;
+            if (progress.get_ticks() % 65536 == 0) {
+                progress.display();
+            }
+        }};
+
+        if (runs.empty()) {
+            // Everything fits in memory
+            std::sort(records.begin(), records.end());
+            for (const Record& record : records) {
+                write(record);
+            }
+        } else {
+            runs.push_back(temp_files.create());
+            SortRun(std::move(records), runs.back());
+            records = std::vector<Record>();
+            for (std::future<void>& f : sorting) {
+                f.get();
+            }
+
+            // Merge the oldest runs into a new one, until few enough are left to merge at once
+            while (runs.size() > MAX_MERGE_RUNS) {
+                std::vector<RunReader> readers;
+                readers.reserve(MAX_MERGE_RUNS);
+                for (size_t k{0}; k < MAX_MERGE_RUNS; ++k) {
+                    readers.emplace_back(runs[k], n_run_records / MAX_MERGE_RUNS);
+                }
+                fs::path  path{temp_files.create()};
+                RunWriter writer(path);
+                merge_runs(&readers, [&](const Record& record) { writer.write(record); });
+                writer.close();
+
+                for (size_t k{0}; k < MAX_MERGE_RUNS; ++k) {
+                    TempFiles::remove(runs[k]);
+                }
+                runs.erase(runs.begin(), runs.begin() + MAX_MERGE_RUNS);
+                runs.push_back(path);
+            }
+
+            std::vector<RunReader> readers;
+            readers.reserve(runs.size());
+            for (const fs::path& path : runs) {
+                readers.emplace_back(path, n_run_records / runs.size());
+            }
+            merge_runs(&readers, write);
+        }
+
+        progress.done();
+    } catch (...) {
+        // Cleanup and rethrow
+        output_stream.remove_file();
+        throw;
+    }
+}
+
+}  // namespace vrt::sort
@@ -0,0 +1,14 @@
+#ifndef VRT_SORT_SRC_PROCESS_H_
+#define VRT_SORT_SRC_PROCESS_H_
+
+namespace vrt::sort {
+struct ProgramArguments;
+}
+
+namespace vrt::sort {
+
+void process(const ProgramArguments& args);
+
+}  // namespace vrt::sort
+
+#endif
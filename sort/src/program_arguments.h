@@ -0,0 +1,24 @@
+#ifndef VRT_SORT_SRC_PROGRAM_ARGUMENTS_H_
+#define VRT_SORT_SRC_PROGRAM_ARGUMENTS_H_
+
+#include <cstdint>
+#include <filesystem>
+
+namespace vrt::sort {
+
+/**
+ * Input arguments to program.
+ */
+struct ProgramArguments {
+    std::filesystem::path file_path_in{};                  /**< Input file path */
+    std::filesystem::path file_path_out{};                 /**< Output file path */
+    std::filesystem::path temp_dir{};                      /**< Temporary file directory, or empty for the output's */
+    bool                  do_byte_swap{false};             /**< True if byte swap is enabled */
+    double                sample_rate{0.0};                /**< Sample rate [Hz] */
+    uint64_t              memory_bytes{256 * 1024 * 1024}; /**< Memory for sorting [B] */
+    unsigned              n_jobs{0};                       /**< Number of sorting threads, or 0 for one per CPU core */
+};
+
+}  // namespace vrt::sort
+
+#endif
@@ -0,0 +1,179 @@
+#include "run.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vrt::sort {
+
+namespace fs = ::std::filesystem;
+
+// Records are written to and read from file as they are in memory
+static_assert(std::is_trivially_copyable<Record>::value, "Record must be trivially copyable");
+
+/**
+ * Constructor. Create file for writing.
+ *
+ * \param file_path File path.
+ *
+ * \throw std::runtime_error If file fails to open.
+ */
+RunWriter::RunWriter(fs::path file_path) : file_path_{std::move(file_path)} {
+    file_.exceptions(std::ios::badbit | std::ios::failbit | std::ios::eofbit);
+    try {
+        file_.open(file_path_, std::ios::out | std::ios::binary | std::ios::trunc);
+    } catch (const std::ios::failure&) {
+        std::stringstream ss;
+        ss << "Failed to open temporary file " << file_path_;
+        throw std::runtime_error(ss.str());
+    }
+    block_.reserve(BLOCK_RECORDS);
+}
+
+/**
+ * Write sorted records.
+ *
+ * \param records Records [n], not before the previous one.
+ * \param n       Number of records.
+ *
+ * \throw std::runtime_error On I/O error.
+ */
+void RunWriter::write(const Record* records, size_t n) {
+    flush();
+    write_file(records, n);
+}
+
+/**
+ * Write records to file, without the block.
+ *
+ * \param records Records [n].
+ * \param n       Number of records.
+ *
+ * \throw std::runtime_error On I/O error.
+ */
+void RunWriter::write_file(const Record* records, size_t n) {
+    try {
+        file_.write(reinterpret_cast<const char*>(records), static_cast<std::streamsize>(sizeof(Record) * n));
+    } catch (const std::ios::failure&) {
+        std::stringstream ss;
+        ss << "Failed to write to temporary file " << file_path_;
+        throw std::runtime_error(ss.str());
+    }
+}
+
+/**
+ * Write remaining records and close file.
+ *
+ * \throw std::runtime_error On I/O error.
+ */
+void RunWriter::close() {
+    flush();
+    try {
+        file_.close();
+    } catch (const std::ios::failure&) {
+        std::stringstream ss;
+        ss << "Failed to close temporary file " << file_path_;
+        throw std::runtime_error(ss.str());
+    }
+}
+
+/**
+ * Write block of records to file.
+ *
+ * \throw std::runtime_error On I/O error.
+ */
+void RunWriter::flush() {
+    write_file(block_.data(), block_.size());
+    block_.clear();
+}
+
+/**
+ * Constructor. Open file for reading. Call next() to get the first record.
+ *
+ * \param file_path     File path.
+ * \param block_records Number of records read from file at a time.
+ *
+ * \throw std::runtime_error If file fails to open.
+ */
+RunReader::RunReader(fs::path file_path, size_t block_records)
+    : file_path_{std::move(file_path)}, block_records_{std::max<size_t>(block_records, 1)} {
+    file_.exceptions(std::ios::badbit | std::ios::failbit | std::ios::eofbit);
+    try {
+        file_.open(file_path_, std::ios::in | std::ios::binary);
+        n_left_ = fs::file_size(file_path_) / sizeof(Record);
+    } catch (const std::exception&) {
+        std::stringstream ss;
+        ss << "Failed to open temporary file " << file_path_;
+        throw std::runtime_error(ss.str());
+    }
+}
+
+/**
+ * Go to next record.
+ *
+ * \return False if there are no more records.
+ *
+ * \throw std::runtime_error On I/O error.
+ */
+bool RunReader::next() {
+    if (index_ + 1 < block_.size()) {
+        index_++;
+        return true;
+    }
+    if (n_left_ == 0) {
+        return false;
+    }
+
+    block_.resize(static_cast<size_t>(std::min<uint64_t>(n_left_, block_records_)));
+    try {
+        file_.read(reinterpret_cast<char*>(block_.data()),
+                   static_cast<std::streamsize>(sizeof(Record) * block_.size()));
+    } catch (const std::ios::failure&) {
+        std::stringstream ss;
+        ss << "Failed to read from temporary file " << file_path_;
+        throw std::runtime_error(ss.str());
+    }
+    n_left_ -= block_.size();
+    index_ = 0;
+
+    return true;
+}
+
+/**
+ * Merge sorted runs into one sorted sequence of records.
+ *
+ * \param runs  Runs, where next() hasn't been called yet.
+ * \param write Function called with each record, in order.
+ *
+ * \throw std::runtime_error On I/O error, or any error from write.
+ */
+void merge_runs(std::vector<RunReader>* runs, const std::function<void(const Record&)>& write) {
+    // Index of run with earliest record is on top
+    auto comparator{[runs](size_t a, size_t b) { return (*runs)[b].get() < (*runs)[a].get(); }};
+    std::priority_queue<size_t, std::vector<size_t>, decltype(comparator)> queue(comparator);
+    for (size_t i{0}; i < runs->size(); ++i) {
+        if ((*runs)[i].next()) {
+            queue.push(i);
+        }
+    }
+
+    while (!queue.empty()) {
+        size_t i{queue.top()};
+        queue.pop();
+        write((*runs)[i].get());
+        if ((*runs)[i].next()) {
+            queue.push(i);
+        }
+    }
+}
+
+}  // namespace vrt::sort
@@ -0,0 +1,102 @@
+#ifndef VRT_SORT_SRC_RUN_H_
+#define VRT_SORT_SRC_RUN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+#include "common/stream_id.h"
+#include "common/timestamp.h"
+
+namespace vrt::sort {
+
+/**
+ * Where a packet is in the input file, and what it is sorted by. Packets stay in the input file until they are copied
+ * to the output file, so only records are sorted and written to temporary files.
+ */
+struct Record {
+    common::Int128   time{0};     /**< Time [ps]. */
+    common::StreamId id;          /**< Stream. */
+    uint64_t         position{0}; /**< Position in input file [B]. */
+    uint32_t         words{0};    /**< Packet size [words]. */
+};
+
+/**
+ * Order records by time, then stream, then position in input file, so that the order is always the same.
+ */
+inline bool operator<(const Record& a, const Record& b) {
+    return std::tie(a.time, a.id, a.position) < std::tie(b.time, b.id, b.position);
+}
+
+/**
+ * Writer of a sorted run of records to a temporary file.
+ */
+class RunWriter {
+   public:
+    explicit RunWriter(std::filesystem::path file_path);
+
+    void write(const Record* records, size_t n);
+    void close();
+
+    /**
+     * Write record.
+     *
+     * \param record Record, not before the previous one.
+     *
+     * \throw std::runtime_error On I/O error.
+     */
+    void write(const Record& record) {
+        block_.push_back(record);
+        if (block_.size() == BLOCK_RECORDS) {
+            flush();
+        }
+    }
+
+    /**
+     * Number of records written to file at a time.
+     */
+    static constexpr size_t BLOCK_RECORDS{4096};
+
+   private:
+    void flush();
+    void write_file(const Record* records, size_t n);
+
+    const std::filesystem::path file_path_;
+
+    std::ofstream       file_;
+    std::vector<Record> block_;
+};
+
+/**
+ * Reader of a sorted run of records from a temporary file, a block at a time.
+ */
+class RunReader {
+   public:
+    RunReader(std::filesystem::path file_path, size_t block_records);
+
+    bool next();
+
+    /**
+     * \return Current record, after next() has returned true.
+     */
+    const Record& get() const { return block_[index_]; }
+
+   private:
+    const std::filesystem::path file_path_;
+    const size_t                block_records_;
+
+    std::ifstream       file_;
+    uint64_t            n_left_{0}; /**< Number of records in file that aren't read yet. */
+    std::vector<Record> block_;
+    size_t              index_{0};
+};
+
+void merge_runs(std::vector<RunReader>* runs, const std::function<void(const Record&)>& write);
+
+}  // namespace vrt::sort
+
+#endif
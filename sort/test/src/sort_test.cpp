@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "../../src/process.h"
+#include "../../src/program_arguments.h"
+#include "common/generate_packet_sequence.h"
+#include "common/input_stream.h"
+
+using namespace vrt;
+
+namespace fs = ::std::filesystem;
+
+static const fs::path TMP_DIR{"test_tmp"};
+static const fs::path TMP_FILE_IN_PATH{TMP_DIR / "sort_in.vrt"};
+static const fs::path TMP_FILE_OUT_PATH{TMP_DIR / "sort_out.vrt"};
+
+/**
+ * Sort input file to output file.
+ */
+static void process(uint64_t memory_bytes = 256 * 1024 * 1024, unsigned n_jobs = 2, double sample_rate = 0.0) {
+    vrt::sort::ProgramArguments args;
+    args.file_path_in  = TMP_FILE_IN_PATH;
+    args.file_path_out = TMP_FILE_OUT_PATH;
+    args.memory_bytes  = memory_bytes;
+    args.n_jobs        = n_jobs;
+    args.sample_rate   = sample_rate;
+    vrt::sort::process(args);
+}
+
+/**
+ * Read times [ms] and stream IDs of packets in output file.
+ */
+static void read_output(std::vector<uint64_t>* times, std::vector<uint32_t>* ids) {
+    common::InputStream input_stream(TMP_FILE_OUT_PATH, false);
+    while (input_stream.read_next_packet()) {
+        const vrt_packet& p{*input_stream.get_packet()};
+        times->push_back(1000 * static_cast<uint64_t>(p.fields.integer_seconds_timestamp) +
+                         p.fields.fractional_seconds_timestamp / 1000000000);
+        ids->push_back(p.fields.stream_id);
+    }
+}
+
+class SortTest : public ::testing::Test {
+   protected:
+    SortTest() : p_() {}
+
+    void SetUp() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+        fs::create_directory(TMP_DIR);
+        vrt_init_packet(&p_);
+        p_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+        p_.header.tsi         = VRT_TSI_UTC;
+        p_.header.tsf         = VRT_TSF_REAL_TIME;
+    }
+    void TearDown() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+    }
+
+    /**
+     * Write input file where packet i has time times[i] and stream ID ids[i].
+     */
+    void generate(const std::vector<uint64_t>& times, const std::vector<uint32_t>& ids) {
+        common::generate_packet_sequence(TMP_FILE_IN_PATH, &p_, times.size(), [&](uint64_t i) {
+            p_.fields.integer_seconds_timestamp    = static_cast<uint32_t>(times[i] / 1000);
+            p_.fields.fractional_seconds_timestamp = (times[i] % 1000) * 1000000000;
+            p_.fields.stream_id                    = ids[i];
+        });
+    }
+
+    /**
+     * Sort shuffled packets, and check that output is sorted and has every packet.
+     */
+    void check_shuffled(uint64_t memory_bytes, unsigned n_jobs) {
+        const uint64_t        n{5000};
+        std::vector<uint64_t> times(n);
+        std::iota(times.begin(), times.end(), 0);
+        std::mt19937 gen(1);
+        std::shuffle(times.begin(), times.end(), gen);
+        std::vector<uint32_t> ids(times.begin(), times.end());
+        generate(times, ids);
+
+        process(memory_bytes, n_jobs);
+
+        std::vector<uint64_t> times_out;
+        std::vector<uint32_t> ids_out;
+        read_output(&times_out, &ids_out);
+        ASSERT_EQ(times_out.size(), n);
+        for (uint64_t i{0}; i < n; ++i) {
+            ASSERT_EQ(times_out[i], i);
+            ASSERT_EQ(ids_out[i], i);
+        }
+    }
+
+    vrt_packet p_;
+};
+
+TEST_F(SortTest, InMemory) {
+    check_shuffled(256 * 1024 * 1024, 2);
+    ASSERT_EQ(std::distance(fs::directory_iterator(TMP_DIR), fs::directory_iterator()), 2);
+}
+
+TEST_F(SortTest, Runs) {
+    // A few runs, merged at once
+    check_shuffled(64 * 1024, 3);
+    ASSERT_EQ(std::distance(fs::directory_iterator(TMP_DIR), fs::directory_iterator()), 2);
+}
+
+TEST_F(SortTest, ManyRuns) {
+    // Runs of the smallest size, which are too many to merge at once
+    check_shuffled(1, 1);
+    ASSERT_EQ(std::distance(fs::directory_iterator(TMP_DIR), fs::directory_iterator()), 2);
+}
+
+TEST_F(SortTest, SameTime) {
+    // Ordered by stream, then by position in input
+    generate({2, 1, 1, 1, 1}, {0, 7, 3, 7, 3});
+    process();
+
+    std::vector<uint64_t> times_out;
+    std::vector<uint32_t> ids_out;
+    read_output(&times_out, &ids_out);
+    ASSERT_EQ(times_out, (std::vector<uint64_t>{1, 1, 1, 1, 2}));
+    ASSERT_EQ(ids_out, (std::vector<uint32_t>{3, 3, 7, 7, 0}));
+}
+
+TEST_F(SortTest, SampleCount) {
+    p_.header.tsf = VRT_TSF_SAMPLE_COUNT;
+    common::generate_packet_sequence(TMP_FILE_IN_PATH, &p_, 3, [&](uint64_t i) {
+        p_.fields.integer_seconds_timestamp    = 1;
+        p_.fields.fractional_seconds_timestamp = 3 - i;
+    });
+    ASSERT_THROW(process(), std::runtime_error);
+    ASSERT_FALSE(fs::exists(TMP_FILE_OUT_PATH));
+
+    process(256 * 1024 * 1024, 2, 10.0);
+    common::InputStream input_stream(TMP_FILE_OUT_PATH, false);
+    for (uint64_t i{1}; i <= 3; ++i) {
+        ASSERT_TRUE(input_stream.read_next_packet());
+        ASSERT_EQ(input_stream.get_packet()->fields.fractional_seconds_timestamp, i);
+    }
+    ASSERT_FALSE(input_stream.read_next_packet());
+}
+
+TEST_F(SortTest, NoTimestamp) {
+    p_.header.tsi = VRT_TSI_NONE;
+    p_.header.tsf = VRT_TSF_NONE;
+    common::generate_packet_sequence(TMP_FILE_IN_PATH, &p_, 2);
+    ASSERT_THROW(process(), std::runtime_error);
+}
@@ -1,6 +1,8 @@
 #include <cstdlib>
 #include <iostream>
+#include <map>
 #include <stdexcept>
+#include <string>
 
 #include "vrt/vrt_util.h"
 
@@ -37,6 +39,57 @@ static vrt::split::ProgramArguments setup_arg_parse(CLI::App* app) {
     app->add_flag("-b,--byte-swap", args.do_byte_swap,
                   "Apply byte swap before parsing file. Note that this will NOT byte swap packet output.");
 
+    // Filter
+    app->add_option("--filter", args.filter,
+                    "Only split packets matching expression, e.g. 'type==data && valid_data'. Other packets are "
+                    "dropped.");
+
+    // Rotation
+    CLI::Option* opt_max_bytes{app->add_option(
+        "--max-bytes", args.max_bytes,
+        "Start a new numbered segment of a stream's output file before it gets larger than this [B], e.g. 1G.")};
+    opt_max_bytes->check(CLI::NonNegativeNumber);
+    opt_max_bytes->transform(CLI::AsNumberWithUnit(
+        std::map<std::string, uint64_t>{{"G", 1024 * 1024 * 1024}, {"M", 1024 * 1024}, {"k", 1024}},
+        CLI::AsNumberWithUnit::CASE_SENSITIVE));
+    CLI::Option* opt_max_duration{app->add_option(
+        "--max-duration", args.max_duration_s,
+        "Start a new numbered segment of a stream's output file every this many seconds of timestamps, e.g. 60. "
+        "Segments start at whole multiples of it.")};
+    opt_max_duration->check(CLI::NonNegativeNumber);
+
+    // Output resources
+    CLI::Option* opt_max_open_files{app->add_option(
+        "--max-open-files", args.max_open_files,
+        "Largest number of output files open at a time. The least recently used one is closed when another one is "
+        "written to. Default is 256.")};
+    opt_max_open_files->check(CLI::PositiveNumber);
+    CLI::Option* opt_memory{app->add_option(
+        "-m,--memory", args.memory_bytes,
+        "Memory for output file buffers [B], e.g. 256M. Default is 64M. The least recently written buffers are written "
+        "to file when more is used.")};
+    opt_memory->check(CLI::PositiveNumber);
+    opt_memory->transform(CLI::AsNumberWithUnit(
+        std::map<std::string, uint64_t>{{"G", 1024 * 1024 * 1024}, {"M", 1024 * 1024}, {"k", 1024}},
+        CLI::AsNumberWithUnit::CASE_SENSITIVE));
+
+    // Routing
+    app->add_option("--route-by", args.route_by,
+                    "Parts of the key that packets are split by, separated by comma: type (data, ext_data, context or "
+                    "ext_context), kind (data or context), class_id (oui, icc and pcc), oui, icc, pcc, stream_id or "
+                    "group. Default is class_id,stream_id, or group with --route-map. Output files are named by the "
+                    "parts that differ.");
+    CLI::Option* opt_route_map{app->add_option(
+        "--route-map", args.route_map,
+        "File mapping Stream IDs to groups, with a hexadecimal Stream ID and a group name on each line, e.g. "
+        "'ABABABAB left'. Packets with other or no Stream IDs are in group X.")};
+    opt_route_map->check(CLI::ExistingFile);
+
+    // Stream IDs
+    app->add_option("--ids", args.ids,
+                    "Stream IDs in hexadecimal, e.g. ABABABAB 12345678. Output files are named by Stream ID only, and "
+                    "the input file isn't first scanned for IDs. Other Stream IDs are an error.");
+
     return args;
 }
 
@@ -0,0 +1,216 @@
+#include "output_manager.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace vrt::split {
+
+namespace fs = ::std::filesystem;
+
+/**
+ * Largest buffer of a file [words]. A full buffer is written to file.
+ */
+static constexpr size_t BUFFER_WORDS{16 * 1024};
+
+/**
+ * Constructor.
+ *
+ * \param max_open_files Largest number of open file descriptors, at least 1.
+ * \param memory_bytes   Memory budget of buffers [B].
+ */
+OutputManager::OutputManager(size_t max_open_files, uint64_t memory_bytes)
+    : max_open_files_{std::max<size_t>(max_open_files, 1)}, memory_bytes_{memory_bytes} {}
+
+/**
+ * Destructor. Close files, and remove them unless finish() has been called.
+ */
+OutputManager::~OutputManager() {
+    for (File& file : files_) {
+        if (file.fd >= 0) {
+            ::close(file.fd);
+        }
+        if (file.is_created && !is_finished_) {
+            std::error_code ec;
+            fs::remove(file.path, ec);
+        }
+    }
+}
+
+/**
+ * Add output file. The file is created when it's first written to.
+ *
+ * \param file_path File path.
+ *
+ * \return File index.
+ */
+size_t OutputManager::create(fs::path file_path) {
+    files_.emplace_back();
+    files_.back().path = std::move(file_path);
+    return files_.size() - 1;
+}
+
+/**
+ * Append words to file.
+ *
+ * \param file  File index.
+ * \param buf   Words [words].
+ * \param words Number of words.
+ *
+ * \throw std::runtime_error On I/O error.
+ */
+void OutputManager::write(size_t file, const uint32_t* buf, size_t words) {
+    File& f{files_[file]};
+    if (!f.buf.empty() && f.buf.size() + words > BUFFER_WORDS) {
+        flush(file, false);
+    }
+
+    // Most recently written first
+    if (!f.buf.empty()) {
+        buffered_.erase(f.it_buffered);
+    }
+    buffered_.push_front(file);
+    f.it_buffered = buffered_.begin();
+
+    size_t capacity{f.buf.capacity()};
+    f.buf.insert(f.buf.end(), buf, buf + words);
+    buffer_bytes_ += sizeof(uint32_t) * (f.buf.capacity() - capacity);
+
+    // Write and release the least recently written buffers, until within budget
+    while (buffer_bytes_ > memory_bytes_ && !buffered_.empty()) {
+        flush(buffered_.back(), true);
+    }
+}
+
+/**
+ * Write buffer of file, and close it. Do not write to it after this.
+ *
+ * \param file File index.
+ *
+ * \throw std::runtime_error On I/O error.
+ */
+void OutputManager::close(size_t file) {
+    flush(file, true);
+    close_fd(file);
+}
+
+/**
+ * Write buffers of all files, and close them. Files are kept at destruction. Do not write after this.
+ *
+ * \throw std::runtime_error On I/O error.
+ */
+void OutputManager::finish() {
+    for (size_t i{0}; i < files_.size(); ++i) {
+        close(i);
+        if (!files_[i].is_created) {
+            // Nothing was written
+            open(i);
+            close_fd(i);
+        }
+    }
+    is_finished_ = true;
+}
+
+/**
+ * Write buffer of file to file.
+ *
+ * \param file       File index.
+ * \param do_release True if buffer memory shall be released.
+ *
+ * \throw std::runtime_error On I/O error.
+ */
+void OutputManager::flush(size_t file, bool do_release) {
+    File& f{files_[file]};
+    if (!f.buf.empty()) {
+        int         fd{open(file)};
+        const auto* data{reinterpret_cast<const char*>(f.buf.data())};
+        size_t      left{sizeof(uint32_t) * f.buf.size()};
+        while (left > 0) {
+            ssize_t n{::pwrite(fd, data, left, static_cast<off_t>(f.offset))};
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::stringstream ss;
+                ss << "Failed to write to output file " << f.path << ": " << std::strerror(errno);
+                throw std::runtime_error(ss.str());
+            }
+            data += n;
+            left -= static_cast<size_t>(n);
+            f.offset += static_cast<uint64_t>(n);
+        }
+        f.buf.clear();
+        buffered_.erase(f.it_buffered);
+    }
+    if (do_release) {
+        buffer_bytes_ -= sizeof(uint32_t) * f.buf.capacity();
+        std::vector<uint32_t>().swap(f.buf);
+    }
+}
+
+/**
+ * Get open file descriptor of file, and open it if needed. The least recently used descriptor is closed if too many
+ * are open.
+ *
+ * \param file File index.
+ *
+ * \return File descriptor.
+ *
+ * \throw std::runtime_error If file fails to open.
+ */
+int OutputManager::open(size_t file) {
+    File& f{files_[file]};
+    if (f.fd >= 0) {
+        // Most recently used first
+        open_.splice(open_.begin(), open_, f.it_open);
+        return f.fd;
+    }
+
+    if (open_.size() >= max_open_files_) {
+        close_fd(open_.back());
+    }
+
+    // Truncate when created, and append to it after that
+    int flags{O_WRONLY | O_CREAT};
+    if (!f.is_created) {
+        flags |= O_TRUNC;
+    }
+    f.fd = ::open(f.path.c_str(), flags, 0644);
+    if (f.fd < 0) {
+        std::stringstream ss;
+        ss << "Failed to open output file " << f.path << ": " << std::strerror(errno);
+        throw std::runtime_error(ss.str());
+    }
+    f.is_created = true;
+    open_.push_front(file);
+    f.it_open = open_.begin();
+
+    return f.fd;
+}
+
+/**
+ * Close file descriptor of file, if open.
+ *
+ * \param file File index.
+ */
+void OutputManager::close_fd(size_t file) {
+    File& f{files_[file]};
+    if (f.fd >= 0) {
+        ::close(f.fd);
+        f.fd = -1;
+        open_.erase(f.it_open);
+    }
+}
+
+}  // namespace vrt::split
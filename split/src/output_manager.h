@@ -0,0 +1,66 @@
+#ifndef VRT_SPLIT_SRC_OUTPUT_MANAGER_H_
+#define VRT_SPLIT_SRC_OUTPUT_MANAGER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <vector>
+
+namespace vrt::split {
+
+/**
+ * Output files, any number of them, written through an in-memory buffer per file and a pool of at most a number of
+ * open file descriptors. The least recently used descriptor is closed when another one is needed, and the least
+ * recently written buffers are written to file when the buffers together use more than the memory budget. Files are
+ * appended to with pwrite at the offset written so far. Files are removed at destruction, unless finished.
+ */
+class OutputManager {
+   public:
+    OutputManager(size_t max_open_files, uint64_t memory_bytes);
+    ~OutputManager();
+
+    OutputManager(const OutputManager&) = delete;
+    OutputManager& operator=(const OutputManager&) = delete;
+
+    size_t create(std::filesystem::path file_path);
+    void   write(size_t file, const uint32_t* buf, size_t words);
+    void   close(size_t file);
+    void   finish();
+
+    /**
+     * \return Number of files created.
+     */
+    size_t size() const { return files_.size(); }
+
+   private:
+    /**
+     * Output file.
+     */
+    struct File {
+        std::filesystem::path       path;              /**< Path. */
+        std::vector<uint32_t>       buf;               /**< Words not yet written to file. */
+        uint64_t                    offset{0};         /**< Bytes written to file. */
+        int                         fd{-1};            /**< File descriptor, or -1 if not open. */
+        bool                        is_created{false}; /**< If file exists. */
+        std::list<size_t>::iterator it_open;           /**< Position in open_, if open. */
+        std::list<size_t>::iterator it_buffered;       /**< Position in buffered_, if any words in buffer. */
+    };
+
+    void flush(size_t file, bool do_release);
+    int  open(size_t file);
+    void close_fd(size_t file);
+
+    const size_t   max_open_files_;
+    const uint64_t memory_bytes_;
+
+    std::vector<File> files_;              /**< Files, by index. */
+    std::list<size_t> open_;               /**< Files with open descriptors, most recently used first. */
+    std::list<size_t> buffered_;           /**< Files with words in buffer, most recently written first. */
+    uint64_t          buffer_bytes_{0};    /**< Memory used by buffers [B]. */
+    bool              is_finished_{false}; /**< If files are kept at destruction. */
+};
+
+}  // namespace vrt::split
+
+#endif
@@ -1,11 +1,17 @@
 #include "process.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
-#include <cstdio>
 #include <filesystem>
+#include <iomanip>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -14,86 +20,49 @@
 #include "vrt/vrt_util.h"
 
 #include "Progress-CPP/ProgressBar.hpp"
-#include "common/comparator_id.h"
+#include "common/filter.h"
 #include "common/input_stream.h"
-#include "common/packet_id_differences.h"
-#include "output_stream_rename.h"
+#include "common/timestamp.h"
+#include "output_manager.h"
 #include "program_arguments.h"
+#include "router.h"
 
 namespace vrt::split {
 
 namespace fs = ::std::filesystem;
 
-// For convenience
-using PacketPtr             = std::shared_ptr<vrt_packet>;
-using OutputStreamRenamePtr = std::unique_ptr<OutputStreamRename>;
-using PacketOutputStreamMap = std::map<PacketPtr, OutputStreamRenamePtr, common::ComparatorId>;
+/**
+ * Smallest number of digits of segment index in file names, so that they sort in order.
+ */
+static constexpr int SEGMENT_DIGITS{4};
 
 /**
- * Generate a temporary and for this application unique file path.
- *
- * \param file_path_in Input file path.
- * \param packet       Packet.
- *
- * \return Temporary file path.
+ * Output files of a stream, one per segment.
  */
-static fs::path generate_temporary_file_path(const fs::path& file_path_in, const vrt_packet& packet) {
-    // Separate path into parts
-    fs::path dir{file_path_in.parent_path()};
-    fs::path stem{file_path_in.stem()};
-    fs::path ext{file_path_in.extension()};
-
-    // Create filename as dir/stem_{Has Class ID}_{OUI}_{ICC}_{PCC}_{Has Stream ID}_{Stream ID}.{Extension}
-    fs::path file_path_tmp{dir};
-    file_path_tmp /= stem;
-    std::stringstream ss;
-    ss << '_' << (packet.header.has.class_id ? '1' : '0');
-    ss << '_' << std::hex << std::uppercase << packet.fields.class_id.oui << "_"
-       << packet.fields.class_id.information_class_code << "_" << packet.fields.class_id.packet_class_code;
-    file_path_tmp += ss.str();
-    ss.str("");
-    ss << '_' << (vrt_has_stream_id(&packet.header) ? '1' : '0');
-    ss << '_' << std::hex << std::uppercase << packet.fields.stream_id;
-    file_path_tmp += ss.str();
-    file_path_tmp += ext;
-
-    return file_path_tmp;
-}
+struct StreamOutput {
+    std::vector<size_t> segments;        /**< Files of segments, where only the last one is written to. */
+    uint64_t            bytes{0};        /**< Size of last segment [B]. */
+    common::Int128      slot{0};         /**< Time slot of last segment. */
+    bool                has_slot{false}; /**< If last segment has a time slot. */
+};
+
+// For convenience
+using PacketPtr      = std::shared_ptr<vrt_packet>;
+using RouteOutputMap = std::map<RouteKey, StreamOutput>;
 
 /**
  * Generate final output file path.
  *
- * \param file_path_in  Input file path.
- * \param packet        Input packet.
- * \param diffs         Packet differences.
+ * \param file_path_in Input file path.
+ * \param name         Name of output, from Router::name().
+ * \param segment      Segment index, or a negative value if files aren't rotated.
  * \return Final output file path.
  */
-static fs::path final_file_path(const fs::path& file_path_in, vrt_packet* packet, const common::PacketIdDiffs& diffs) {
+static fs::path final_file_path(const fs::path& file_path_in, const std::string& name, int64_t segment = -1) {
     std::stringstream body{};
-    if (diffs.any_has_class_id) {
-        if (packet->header.has.class_id) {
-            if (diffs.diff_oui) {
-                body << '_' << std::hex << std::uppercase << packet->fields.class_id.oui;
-            }
-            if (diffs.diff_icc) {
-                body << '_' << std::hex << std::uppercase << packet->fields.class_id.information_class_code;
-            }
-            if (diffs.diff_pcc) {
-                body << '_' << std::hex << std::uppercase << packet->fields.class_id.packet_class_code;
-            }
-        } else {
-            body << "_X_X_X";
-        }
-    }
-    if (diffs.any_has_stream_id) {
-        body << '_';
-        if (vrt_has_stream_id(&packet->header)) {
-            if (diffs.diff_sid) {
-                body << std::hex << std::uppercase << packet->fields.stream_id;
-            }
-        } else {
-            body << "X";
-        }
+    body << name;
+    if (segment >= 0) {
+        body << '_' << std::setw(SEGMENT_DIGITS) << std::setfill('0') << segment;
     }
 
     // Separate path into parts
@@ -112,83 +81,228 @@ static fs::path final_file_path(const fs::path& file_path_in, vrt_packet* packet
 }
 
 /**
- * Called when finishing writing, for renaming temporary files to final.
+ * Parse Stream IDs.
  *
- * \param file_path_in   Input file path.
- * \param output_streams Output streams.
+ * \param texts Stream IDs in hexadecimal.
  *
- * \throw std::filesystem::filesystem_error On renaming error.
+ * \return Stream IDs.
+ *
+ * \throw std::runtime_error If a Stream ID is invalid.
  */
-static void finish(const fs::path& file_path_in, const PacketOutputStreamMap& output_streams) {
-    // Check if all Class and Stream IDs are the same
-    if (output_streams.size() <= 1) {
-        for (const auto& el : output_streams) {
-            el.second->remove_file();
+static std::set<uint32_t> parse_ids(const std::vector<std::string>& texts) {
+    std::set<uint32_t> ids;
+    for (const std::string& text : texts) {
+        size_t        n{0};
+        unsigned long id{0};
+        try {
+            id = std::stoul(text, &n, 16);
+        } catch (const std::logic_error&) {
+            n = 0;
+        }
+        if (n == 0 || n != text.size() || id > UINT32_MAX) {
+            std::stringstream ss;
+            ss << "Invalid Stream ID '" << text << "'. Use hexadecimal, e.g. ABABABAB.";
+            throw std::runtime_error(ss.str());
         }
-        std::cerr << "Warning: All packets have the same Class and Stream ID (if any). Use the existing "
-                  << file_path_in << '.' << std::endl;
-        return;
+        ids.insert(static_cast<uint32_t>(id));
     }
+    return ids;
+}
 
-    try {
-        // Make vector from map
-        std::vector<PacketPtr> v;
-        v.reserve(output_streams.size());
-        for (const auto& el : output_streams) {
-            v.push_back(el.first);
+/**
+ * Find the route keys of packets matching filter, by reading no more of each packet than the filter and keys need.
+ *
+ * \param args     Program arguments.
+ * \param filter   Filter.
+ * \param router   Router.
+ * \param progress Progress bar.
+ *
+ * \return Route keys.
+ *
+ * \throw std::runtime_error On read or parse error.
+ */
+static std::vector<RouteKey> scan_keys(const ProgramArguments&   args,
+                                       const common::Filter&     filter,
+                                       const Router&             router,
+                                       progresscpp::ProgressBar* progress) {
+    common::InputStream input_stream(args.file_path_in, args.do_byte_swap, true, false);
+    std::set<RouteKey>  keys;
+    RouteKey            key;
+    while (input_stream.read_next_header()) {
+        bool is_match{false};
+        bool is_read{false};
+        if (filter.is_header_only()) {
+            is_match = filter.matches(*input_stream.get_packet());
+            if (is_match && !router.is_header_only()) {
+                is_read = input_stream.read_fields();
+            } else {
+                is_read = input_stream.skip_remainder();
+            }
+        } else {
+            is_read  = input_stream.read_remainder();
+            is_match = is_read && filter.matches(*input_stream.get_packet());
+        }
+        if (!is_read) {
+            break;
         }
 
-        common::PacketIdDiffs packet_diffs{common::packet_id_differences(v)};
+        const vrt_packet& packet{*input_stream.get_packet()};
+        if (is_match) {
+            router.key(packet, &key);
+            keys.insert(key);
+        }
+
+        // Handle progress bar
+        *progress += sizeof(uint32_t) * packet.header.packet_size;
+        if (progress->get_ticks() % 65536 == 0) {
+            progress->display();
+        }
+    }
+
+    return std::vector<RouteKey>(keys.begin(), keys.end());
+}
+
+/**
+ * Check if a packet starts a new segment of its stream, since the current one would be larger than the maximum size,
+ * or since the packet is in another time slot. Time slots are aligned to whole multiples of the maximum duration, and
+ * packets without a time in seconds stay in the current slot.
+ *
+ * \param args   Program arguments.
+ * \param packet Packet.
+ * \param output Output of stream of packet, where the time slot is updated.
+ *
+ * \return True if packet starts a new segment.
+ */
+static bool is_new_segment(const ProgramArguments& args, const vrt_packet& packet, StreamOutput* output) {
+    bool     is_new{output->segments.empty()};
+    uint64_t size{sizeof(uint32_t) * packet.header.packet_size};
+    if (args.max_bytes != 0 && output->bytes != 0 && output->bytes + size > args.max_bytes) {
+        is_new = true;
+    }
 
-        for (const auto& el : output_streams) {
-            fs::path file_out{final_file_path(file_path_in, el.first.get(), packet_diffs)};
-            el.second->rename_file(file_out);
+    if (args.max_duration_s > 0.0) {
+        common::Timestamp time(packet);
+        common::TimeKey   key(time, 0.0);
+        common::Int128    duration_ps{std::llround(args.max_duration_s * static_cast<double>(common::PS_PER_S))};
+        common::Int128    ps{0};
+        bool              has_time{true};
+        if (key.is_exact()) {
+            ps = key.picoseconds();
+        } else if (time.tsi != VRT_TSI_NONE) {
+            ps = static_cast<common::Int128>(time.integer) * common::PS_PER_S;
+        } else {
+            has_time = false;
         }
-    } catch (...) {
-        // Remove any newly created files before rethrow
-        for (const auto& el : output_streams) {
-            el.second->remove_file();
+        if (has_time && duration_ps > 0) {
+            common::Int128 slot{ps / duration_ps};
+            if (output->has_slot && slot != output->slot) {
+                is_new = true;
+            }
+            output->slot     = slot;
+            output->has_slot = true;
         }
-        throw;
     }
+
+    return is_new;
 }
 
 /**
- * Process file contents.
+ * Process file contents. Packets are routed to one file per route key, by default the Class and Stream ID combination,
+ * which is rotated into numbered segments if a maximum size or duration is given. Output file names only include the
+ * parts of the keys that differ between outputs, so the file is first scanned for keys, unless Stream IDs are given.
+ * Files are then written under their final names right away. Any number of outputs can be written, since output files
+ * are buffered within a memory budget, and only a few of them are open at a time.
  *
  * \param args Program arguments.
  *
  * \throw std::runtime_error If there's an error.
  */
 void process(const ProgramArguments& args) {
+    common::InputStream input_stream(args.file_path_in, args.do_byte_swap);
+    common::Filter      filter(args.filter);
+    Router              router(args.route_by, args.route_map);
+    bool                is_rotating{args.max_bytes != 0 || args.max_duration_s > 0.0};
+
+    // Progress bar, where the file is gone through twice if scanned for keys
+    auto                     file_size{static_cast<uint64_t>(input_stream.get_file_size())};
+    progresscpp::ProgressBar progress((args.ids.empty() ? 2 : 1) * file_size, 70);
+
+    // Find which parts of the keys to name files by
+    std::vector<bool>  is_named(router.get_parts().size(), false);
+    std::set<uint32_t> given_ids{parse_ids(args.ids)};
+    if (!given_ids.empty()) {
+        is_named = router.named_by(Router::Part::STREAM_ID);
+        if (std::find(is_named.begin(), is_named.end(), true) == is_named.end()) {
+            throw std::runtime_error("Stream IDs can only be given when splitting by stream_id");
+        }
+    } else {
+        std::vector<RouteKey> keys{scan_keys(args, filter, router, &progress)};
+        if (keys.size() <= 1 && !is_rotating) {
+            progress.done();
+            std::cerr << "Warning: All packets have the same route key. Use the existing " << args.file_path_in << '.'
+                      << std::endl;
+            return;
+        }
+
+        // A single output is only named by segment
+        is_named = router.differences(keys);
+    }
+
     /**
-     * Packet -> File map.
+     * Route key -> File map.
      */
-    PacketOutputStreamMap output_streams;
+    RouteOutputMap output_streams;
+    RouteKey       key;
 
-    common::InputStream input_stream(args.file_path_in, args.do_byte_swap);
+    // Writes to any number of files, with bounded memory and open files
+    OutputManager outputs(args.max_open_files, args.memory_bytes);
 
-    // Progress bar
-    progresscpp::ProgressBar progress(static_cast<uint64_t>(input_stream.get_file_size()), 70);
+    // Output file paths in use, which can only be the same for different keys if Stream IDs are given
+    std::set<fs::path> file_paths_out;
 
     // Go over all packets in input file
     for (uint64_t i{0};; ++i) {
-        if (!input_stream.read_next_packet()) {
+        bool is_match{false};
+        if (!input_stream.read_next_header() || !common::read_remainder_if_match(filter, &input_stream, &is_match)) {
             break;
         }
 
-        // Find Class ID, Stream ID combination in map, or construct new output file if needed
         PacketPtr packet{input_stream.get_packet()};
-        auto      it{output_streams.find(packet)};
-        if (it == output_streams.end()) {
-            fs::path p{generate_temporary_file_path(args.file_path_in, *packet.get())};
-            auto     pair{output_streams.emplace(packet, std::make_unique<OutputStreamRename>(p))};
+        if (is_match) {
+            // Find key in map, or construct new output if needed
+            router.key(*packet, &key);
+            auto it{output_streams.find(key)};
+            if (it == output_streams.end()) {
+                if (!given_ids.empty() &&
+                    (!vrt_has_stream_id(&packet->header) || given_ids.count(packet->fields.stream_id) == 0)) {
+                    std::stringstream ss;
+                    ss << "Packet #" << i << ": Stream ID is not one of the given IDs";
+                    throw std::runtime_error(ss.str());
+                }
+                it = output_streams.emplace(key, StreamOutput()).first;
+            }
 
-            it = pair.first;
-        }
+            // Start new segment if needed
+            StreamOutput& output{it->second};
+            if (is_new_segment(args, *packet, &output)) {
+                if (!output.segments.empty()) {
+                    outputs.close(output.segments.back());
+                }
+                fs::path p{final_file_path(args.file_path_in, router.name(key, is_named),
+                                           is_rotating ? static_cast<int64_t>(output.segments.size()) : -1)};
+                if (!file_paths_out.insert(p).second) {
+                    std::stringstream ss;
+                    ss << "Packet #" << i << ": Output file " << p << " is already used by another route key";
+                    throw std::runtime_error(ss.str());
+                }
+                output.segments.push_back(outputs.create(p));
+                output.bytes = 0;
+            }
 
-        // Write input packet to output
-        it->second->write(input_stream.get_buffer(), packet->header.packet_size);
+            // Write input packet to output
+            outputs.write(output.segments.back(), input_stream.get_buffer().data(), packet->header.packet_size);
+            output.bytes += sizeof(uint32_t) * packet->header.packet_size;
+        }
 
         // Handle progress bar
         progress += sizeof(uint32_t) * packet->header.packet_size;
@@ -197,9 +311,9 @@ void process(const ProgramArguments& args) {
         }
     }
 
-    progress.done();
+    outputs.finish();
 
-    finish(args.file_path_in, output_streams);
+    progress.done();
 }
 
 }  // namespace vrt::split
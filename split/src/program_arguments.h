@@ -1,7 +1,11 @@
 #ifndef VRT_SPLIT_SRC_PROGRAM_ARGUMENTS_H_
 #define VRT_SPLIT_SRC_PROGRAM_ARGUMENTS_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <string>
+#include <vector>
 
 namespace vrt::split {
 
@@ -9,8 +13,16 @@ namespace vrt::split {
  * Input arguments to program.
  */
 struct ProgramArguments {
-    std::filesystem::path file_path_in{};
-    bool                  do_byte_swap{false};
+    std::filesystem::path    file_path_in{};
+    bool                     do_byte_swap{false};
+    std::string              filter{};
+    uint64_t                 max_bytes{0};
+    double                   max_duration_s{0.0};
+    size_t                   max_open_files{256};
+    uint64_t                 memory_bytes{64 * 1024 * 1024};
+    std::vector<std::string> ids{};
+    std::string              route_by{};
+    std::filesystem::path    route_map{};
 };
 
 }  // namespace vrt::split
@@ -0,0 +1,298 @@
+#include "router.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vrt/vrt_types.h"
+#include "vrt/vrt_util.h"
+
+namespace vrt::split {
+
+namespace fs = ::std::filesystem;
+
+using Part = Router::Part;
+
+/**
+ * Names of key parts. class_id is short for oui,icc,pcc.
+ */
+static const std::map<std::string, std::vector<Part>> PART_NAMES{{"type", {Part::TYPE}},
+                                                                 {"kind", {Part::KIND}},
+                                                                 {"class_id", {Part::OUI, Part::ICC, Part::PCC}},
+                                                                 {"oui", {Part::OUI}},
+                                                                 {"icc", {Part::ICC}},
+                                                                 {"pcc", {Part::PCC}},
+                                                                 {"stream_id", {Part::STREAM_ID}},
+                                                                 {"group", {Part::GROUP}}};
+
+/**
+ * Names of values of type part, as in filter expressions.
+ */
+static const std::vector<std::string> TYPE_NAMES{"data", "ext_data", "context", "ext_context"};
+
+/**
+ * Names of values of kind part.
+ */
+static const std::vector<std::string> KIND_NAMES{"data", "context"};
+
+/**
+ * Get type of packet.
+ *
+ * \param packet_type Packet type.
+ *
+ * \return Index in TYPE_NAMES.
+ */
+static int64_t get_type(vrt_packet_type packet_type) {
+    switch (packet_type) {
+        case VRT_PT_IF_DATA_WITHOUT_STREAM_ID:
+        case VRT_PT_IF_DATA_WITH_STREAM_ID:
+            return 0;
+        case VRT_PT_EXT_DATA_WITHOUT_STREAM_ID:
+        case VRT_PT_EXT_DATA_WITH_STREAM_ID:
+            return 1;
+        case VRT_PT_IF_CONTEXT:
+            return 2;
+        case VRT_PT_EXT_CONTEXT:
+        default:
+            return 3;
+    }
+}
+
+/**
+ * Constructor.
+ *
+ * \param route_by       Names of key parts, separated by comma, e.g. "kind,stream_id". Default is class_id,stream_id,
+ *                       or group if there is a route map.
+ * \param route_map_path Path of file mapping Stream IDs to groups, or empty if none.
+ *
+ * \throw std::runtime_error If a part is unknown, or on an invalid route map.
+ */
+Router::Router(const std::string& route_by, const fs::path& route_map_path) {
+    std::string names{route_by};
+    if (names.empty()) {
+        names = route_map_path.empty() ? "class_id,stream_id" : "group";
+    }
+
+    std::stringstream ss_names(names);
+    std::string       name;
+    while (std::getline(ss_names, name, ',')) {
+        auto it{PART_NAMES.find(name)};
+        if (it == PART_NAMES.end()) {
+            std::stringstream ss;
+            ss << "Unknown route key part '" << name
+               << "'. Use type, kind, class_id, oui, icc, pcc, stream_id or group, separated by comma.";
+            throw std::runtime_error(ss.str());
+        }
+        for (Part part : it->second) {
+            parts_.push_back(part);
+            if (part != Part::TYPE && part != Part::KIND) {
+                is_header_only_ = false;
+            }
+        }
+    }
+    if (parts_.empty() || names.back() == ',') {
+        std::stringstream ss;
+        ss << "Invalid route key '" << names << "'";
+        throw std::runtime_error(ss.str());
+    }
+
+    bool has_group{false};
+    for (Part part : parts_) {
+        has_group = has_group || part == Part::GROUP;
+    }
+    if (has_group && route_map_path.empty()) {
+        throw std::runtime_error("Route key part group needs a route map");
+    }
+    if (!has_group && !route_map_path.empty()) {
+        throw std::runtime_error("Route map is only used with route key part group");
+    }
+    if (has_group) {
+        read_route_map(route_map_path);
+    }
+}
+
+/**
+ * Read file mapping Stream IDs to groups. Each line has a Stream ID in hexadecimal and a group name, e.g.
+ * "ABABABAB left". Empty lines, and anything after #, are ignored.
+ *
+ * \param route_map_path File path.
+ *
+ * \throw std::runtime_error If file fails to open, or on an invalid line.
+ */
+void Router::read_route_map(const fs::path& route_map_path) {
+    std::ifstream file(route_map_path);
+    if (!file) {
+        std::stringstream ss;
+        ss << "Failed to open route map " << route_map_path;
+        throw std::runtime_error(ss.str());
+    }
+
+    std::map<std::string, int64_t> group_indices;
+    std::string                    line;
+    for (uint64_t line_number{1}; std::getline(file, line); ++line_number) {
+        line = line.substr(0, line.find('#'));
+
+        std::stringstream ss_line(line);
+        std::string       id_text;
+        std::string       group;
+        std::string       rest;
+        if (!(ss_line >> id_text)) {
+            continue;
+        }
+
+        size_t        n{0};
+        unsigned long id{0};
+        try {
+            id = std::stoul(id_text, &n, 16);
+        } catch (const std::logic_error&) {
+            n = 0;
+        }
+        if (n == 0 || n != id_text.size() || id > UINT32_MAX || !(ss_line >> group) || ss_line >> rest ||
+            group.find('/') != std::string::npos) {
+            std::stringstream ss;
+            ss << "Route map " << route_map_path << " line " << line_number
+               << ": Expected a hexadecimal Stream ID and a group name, e.g. 'ABABABAB left'";
+            throw std::runtime_error(ss.str());
+        }
+
+        auto it{group_indices.find(group)};
+        if (it == group_indices.end()) {
+            it = group_indices.emplace(group, static_cast<int64_t>(group_names_.size())).first;
+            group_names_.push_back(group);
+        }
+        if (!groups_.emplace(static_cast<uint32_t>(id), it->second).second) {
+            std::stringstream ss;
+            ss << "Route map " << route_map_path << " line " << line_number << ": Stream ID " << id_text
+               << " is already mapped";
+            throw std::runtime_error(ss.str());
+        }
+    }
+}
+
+/**
+ * Get key of packet. Only the header is used if is_header_only().
+ *
+ * \param packet Packet.
+ * \param key    Key (out), which is reused between calls to avoid allocations.
+ */
+void Router::key(const vrt_packet& packet, RouteKey* key) const {
+    key->resize(parts_.size());
+    bool has_class_id{packet.header.has.class_id};
+    bool has_stream_id{vrt_has_stream_id(&packet.header)};
+    for (size_t i{0}; i < parts_.size(); ++i) {
+        int64_t& value{(*key)[i]};
+        switch (parts_[i]) {
+            case Part::TYPE:
+                value = get_type(packet.header.packet_type);
+                break;
+            case Part::KIND:
+                value = get_type(packet.header.packet_type) >= 2 ? 1 : 0;
+                break;
+            case Part::OUI:
+                value = has_class_id ? static_cast<int64_t>(packet.fields.class_id.oui) : -1;
+                break;
+            case Part::ICC:
+                value = has_class_id ? static_cast<int64_t>(packet.fields.class_id.information_class_code) : -1;
+                break;
+            case Part::PCC:
+                value = has_class_id ? static_cast<int64_t>(packet.fields.class_id.packet_class_code) : -1;
+                break;
+            case Part::STREAM_ID:
+                value = has_stream_id ? static_cast<int64_t>(packet.fields.stream_id) : -1;
+                break;
+            case Part::GROUP: {
+                value = -1;
+                if (has_stream_id) {
+                    auto it{groups_.find(packet.fields.stream_id)};
+                    if (it != groups_.end()) {
+                        value = it->second;
+                    }
+                }
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Find the parts of keys that differ between keys, which outputs are then named by.
+ *
+ * \param keys Keys.
+ *
+ * \return If part differs, for each part.
+ */
+std::vector<bool> Router::differences(const std::vector<RouteKey>& keys) const {
+    std::vector<bool> diffs(parts_.size(), false);
+    for (size_t k{1}; k < keys.size(); ++k) {
+        for (size_t i{0}; i < parts_.size(); ++i) {
+            if (keys[k][i] != keys[0][i]) {
+                diffs[i] = true;
+            }
+        }
+    }
+
+    return diffs;
+}
+
+/**
+ * Get parts to name outputs by, when naming by only one part.
+ *
+ * \param part Part.
+ *
+ * \return If outputs are named by part, for each part.
+ */
+std::vector<bool> Router::named_by(Part part) const {
+    std::vector<bool> is_named(parts_.size(), false);
+    for (size_t i{0}; i < parts_.size(); ++i) {
+        is_named[i] = parts_[i] == part;
+    }
+
+    return is_named;
+}
+
+/**
+ * Generate name of output from key, where each named part is preceded by '_'. Class and Stream IDs are in
+ * hexadecimal, and parts without a value are 'X'.
+ *
+ * \param key      Key.
+ * \param is_named If outputs are named by part, for each part.
+ *
+ * \return Name.
+ */
+std::string Router::name(const RouteKey& key, const std::vector<bool>& is_named) const {
+    std::stringstream ss;
+    for (size_t i{0}; i < parts_.size(); ++i) {
+        if (!is_named[i]) {
+            continue;
+        }
+        ss << '_';
+        if (key[i] < 0) {
+            ss << 'X';
+            continue;
+        }
+        switch (parts_[i]) {
+            case Part::TYPE:
+                ss << TYPE_NAMES[static_cast<size_t>(key[i])];
+                break;
+            case Part::KIND:
+                ss << KIND_NAMES[static_cast<size_t>(key[i])];
+                break;
+            case Part::GROUP:
+                ss << group_names_[static_cast<size_t>(key[i])];
+                break;
+            default:
+                ss << std::hex << std::uppercase << key[i] << std::dec;
+                break;
+        }
+    }
+
+    return ss.str();
+}
+
+}  // namespace vrt::split
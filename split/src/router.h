@@ -0,0 +1,67 @@
+#ifndef VRT_SPLIT_SRC_ROUTER_H_
+#define VRT_SPLIT_SRC_ROUTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct vrt_packet;
+
+namespace vrt::split {
+
+/**
+ * Key of the output that a packet is routed to, with one value per part of the key, or -1 if the packet has no value.
+ */
+using RouteKey = std::vector<int64_t>;
+
+/**
+ * Routing of packets to outputs, by a key made of parts such as packet type, Class ID fields, Stream ID, or a group
+ * that Stream IDs are mapped to in a file. Output files are named by the values of the parts that differ between keys.
+ */
+class Router {
+   public:
+    /**
+     * Part of a key.
+     */
+    enum class Part {
+        TYPE,      /**< Packet type, as data, ext_data, context or ext_context. */
+        KIND,      /**< Data or context. */
+        OUI,       /**< Class ID OUI. */
+        ICC,       /**< Class ID Information class code. */
+        PCC,       /**< Class ID Packet class code. */
+        STREAM_ID, /**< Stream ID. */
+        GROUP      /**< Group that Stream ID is mapped to. */
+    };
+
+    Router(const std::string& route_by, const std::filesystem::path& route_map_path);
+
+    void              key(const vrt_packet& packet, RouteKey* key) const;
+    std::vector<bool> differences(const std::vector<RouteKey>& keys) const;
+    std::vector<bool> named_by(Part part) const;
+    std::string       name(const RouteKey& key, const std::vector<bool>& is_named) const;
+
+    /**
+     * \return True if keys only need the packet header, and not the fields section.
+     */
+    bool is_header_only() const { return is_header_only_; }
+
+    /**
+     * \return Parts of key.
+     */
+    const std::vector<Part>& get_parts() const { return parts_; }
+
+   private:
+    void read_route_map(const std::filesystem::path& route_map_path);
+
+    std::vector<Part>                     parts_;                /**< Parts of key, in order. */
+    bool                                  is_header_only_{true}; /**< If keys only need the header. */
+    std::unordered_map<uint32_t, int64_t> groups_;               /**< Stream ID -> Group index. */
+    std::vector<std::string>              group_names_;          /**< Group names, by index. */
+};
+
+}  // namespace vrt::split
+
+#endif
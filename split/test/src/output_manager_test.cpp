@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../../src/output_manager.h"
+
+namespace fs = ::std::filesystem;
+
+static const fs::path TMP_DIR{"test_tmp_output_manager"};
+
+/**
+ * \return Words in file.
+ */
+static std::vector<uint32_t> read_words(const fs::path& file_path) {
+    std::vector<uint32_t> words(fs::file_size(file_path) / sizeof(uint32_t));
+    std::ifstream         file(file_path, std::ios::in | std::ios::binary);
+    file.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(sizeof(uint32_t) * words.size()));
+    return words;
+}
+
+class OutputManagerTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+        fs::create_directory(TMP_DIR);
+    }
+    void TearDown() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+    }
+};
+
+TEST_F(OutputManagerTest, Interleaved) {
+    const size_t n_files{10};
+    const size_t n_writes{200};
+
+    // Two open files, and memory for a few words
+    std::vector<std::vector<uint32_t>> expected(n_files);
+    {
+        vrt::split::OutputManager outputs(2, 64);
+        for (size_t i{0}; i < n_files; ++i) {
+            outputs.create(TMP_DIR / std::to_string(i));
+        }
+        for (uint32_t k{0}; k < n_writes; ++k) {
+            size_t                file{(k * 7) % n_files};
+            std::vector<uint32_t> buf(1 + k % 5, k);
+            outputs.write(file, buf.data(), buf.size());
+            expected[file].insert(expected[file].end(), buf.begin(), buf.end());
+        }
+        outputs.close(3);
+        outputs.create(TMP_DIR / "empty");
+        outputs.finish();
+    }
+
+    // Files are kept, also the one that was never written to
+    ASSERT_TRUE(fs::is_empty(TMP_DIR / "empty"));
+    for (size_t i{0}; i < n_files; ++i) {
+        ASSERT_EQ(read_words(TMP_DIR / std::to_string(i)), expected[i]);
+    }
+}
+
+TEST_F(OutputManagerTest, NotFinished) {
+    {
+        vrt::split::OutputManager outputs(1, 1024);
+        std::vector<uint32_t>     buf{1, 2, 3};
+        outputs.create(TMP_DIR / "a");
+        outputs.create(TMP_DIR / "b");
+        outputs.write(0, buf.data(), buf.size());
+        outputs.write(1, buf.data(), buf.size());
+        outputs.close(0);
+
+        // Written files can be read while others are written
+        ASSERT_EQ(read_words(TMP_DIR / "a"), buf);
+    }
+
+    // Files are removed, as after an error
+    ASSERT_TRUE(fs::is_empty(TMP_DIR));
+}
@@ -5,6 +5,7 @@
 #include <filesystem>
 #include <fstream>
 #include <istream>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -20,6 +21,7 @@
 #include "../../src/program_arguments.h"
 #include "common/byte_swap.h"
 #include "common/generate_packet_sequence.h"
+#include "common/input_stream.h"
 
 using namespace vrt;
 
@@ -54,13 +56,43 @@ class SplitTest : public ::testing::Test {
     vrt_packet p_;
 };
 
-static void process(bool do_byte_swap = false) {
+static void process(bool                            do_byte_swap   = false,
+                    uint64_t                        max_bytes      = 0,
+                    double                          max_duration_s = 0.0,
+                    size_t                          max_open_files = 256,
+                    uint64_t                        memory_bytes   = 64 * 1024 * 1024,
+                    const std::vector<std::string>& ids            = {}) {
+    vrt::split::ProgramArguments args;
+    args.file_path_in   = TMP_FILE_PATH;
+    args.do_byte_swap   = do_byte_swap;
+    args.max_bytes      = max_bytes;
+    args.max_duration_s = max_duration_s;
+    args.max_open_files = max_open_files;
+    args.memory_bytes   = memory_bytes;
+    args.ids            = ids;
+    vrt::split::process(args);
+}
+
+static void process_routed(const std::string& route_by, const fs::path& route_map = {}) {
     vrt::split::ProgramArguments args;
     args.file_path_in = TMP_FILE_PATH;
-    args.do_byte_swap = do_byte_swap;
+    args.route_by     = route_by;
+    args.route_map    = route_map;
     vrt::split::process(args);
 }
 
+/**
+ * Read headers and fields sections of packets in output file.
+ */
+static std::vector<vrt_packet> read_packets(const std::string& file_name) {
+    std::vector<vrt_packet> packets;
+    common::InputStream     input_stream(TMP_DIR / file_name, false);
+    while (input_stream.read_next_packet()) {
+        packets.push_back(*input_stream.get_packet());
+    }
+    return packets;
+}
+
 static void compare(const std::vector<std::string>& file_names, bool do_byte_swap = false) {
     std::vector<uint32_t> buf;
 
@@ -368,3 +400,177 @@ TEST_F(SplitTest, ByteSwap) {
     SCOPED_TRACE(::testing::UnitTest::GetInstance()->current_test_info()->name());
     compare({"split_BAAAAD_4B1D_DEAD_DEADBEEF.vrt", "split_ABABAB_BEBE_DEDE_FEFEFEFE.vrt"}, true);
 }
+
+TEST_F(SplitTest, MaxBytes) {
+    p_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    common::generate_packet_sequence(TMP_FILE_PATH, &p_, N_PACKETS, [&](uint64_t i) { p_.fields.stream_id = i % 2; });
+    uint64_t packet_bytes{fs::file_size(TMP_FILE_PATH) / N_PACKETS};
+
+    // 50 packets of each stream, at most 20 in each segment
+    process(false, 20 * packet_bytes + 1);
+    SCOPED_TRACE(::testing::UnitTest::GetInstance()->current_test_info()->name());
+    compare({"split_0_0000.vrt", "split_0_0001.vrt", "split_0_0002.vrt", "split_1_0000.vrt", "split_1_0001.vrt",
+             "split_1_0002.vrt"});
+    ASSERT_EQ(fs::file_size(TMP_DIR / "split_0_0000.vrt"), 20 * packet_bytes);
+    ASSERT_EQ(fs::file_size(TMP_DIR / "split_1_0002.vrt"), 10 * packet_bytes);
+}
+
+TEST_F(SplitTest, MaxDuration) {
+    p_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    p_.header.tsi         = VRT_TSI_UTC;
+    p_.header.tsf         = VRT_TSF_REAL_TIME;
+    common::generate_packet_sequence(TMP_FILE_PATH, &p_, N_PACKETS, [&](uint64_t i) {
+        // Times 0.5 to 10.4 s
+        uint64_t t_ms{500 + 100 * i};
+        p_.fields.stream_id                    = i % 2;
+        p_.fields.integer_seconds_timestamp    = static_cast<uint32_t>(t_ms / 1000);
+        p_.fields.fractional_seconds_timestamp = (t_ms % 1000) * 1000000000;
+    });
+
+    // Segments aligned to multiples of 4 s
+    process(false, 0, 4.0);
+    SCOPED_TRACE(::testing::UnitTest::GetInstance()->current_test_info()->name());
+    compare({"split_0_0000.vrt", "split_0_0001.vrt", "split_0_0002.vrt", "split_1_0000.vrt", "split_1_0001.vrt",
+             "split_1_0002.vrt"});
+    uint64_t packet_bytes{fs::file_size(TMP_FILE_PATH) / N_PACKETS};
+    ASSERT_EQ(fs::file_size(TMP_DIR / "split_0_0000.vrt"), 18 * packet_bytes);
+    ASSERT_EQ(fs::file_size(TMP_DIR / "split_0_0001.vrt"), 20 * packet_bytes);
+    ASSERT_EQ(fs::file_size(TMP_DIR / "split_0_0002.vrt"), 12 * packet_bytes);
+}
+
+TEST_F(SplitTest, RotateSameAll) {
+    // Only named by segment
+    common::generate_packet_sequence(TMP_FILE_PATH, &p_, N_PACKETS);
+    uint64_t packet_bytes{fs::file_size(TMP_FILE_PATH) / N_PACKETS};
+
+    process(false, 50 * packet_bytes);
+    SCOPED_TRACE(::testing::UnitTest::GetInstance()->current_test_info()->name());
+    compare({"split_0000.vrt", "split_0001.vrt"});
+}
+
+TEST_F(SplitTest, ManyStreams) {
+    // More streams than open files, and buffers of only a few packets
+    p_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    common::generate_packet_sequence(TMP_FILE_PATH, &p_, N_PACKETS, [&](uint64_t i) { p_.fields.stream_id = i % 20; });
+
+    process(false, 0, 0.0, 3, 256);
+    SCOPED_TRACE(::testing::UnitTest::GetInstance()->current_test_info()->name());
+    std::vector<std::string> file_names;
+    for (uint32_t id{0}; id < 20; ++id) {
+        std::stringstream ss;
+        ss << "split_" << std::hex << std::uppercase << id << ".vrt";
+        file_names.push_back(ss.str());
+    }
+    compare(file_names);
+}
+
+TEST_F(SplitTest, Ids) {
+    // Named by Stream ID only, though Class IDs differ too
+    p_.header.packet_type  = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    p_.header.has.class_id = true;
+    common::generate_packet_sequence(TMP_FILE_PATH, &p_, N_PACKETS, [&](uint64_t i) {
+        p_.fields.stream_id    = 10 + i % 2;
+        p_.fields.class_id.oui = p_.fields.stream_id;
+    });
+
+    process(false, 0, 0.0, 256, 64 * 1024 * 1024, {"a", "B"});
+    SCOPED_TRACE(::testing::UnitTest::GetInstance()->current_test_info()->name());
+    compare({"split_A.vrt", "split_B.vrt"});
+}
+
+TEST_F(SplitTest, IdsInvalid) {
+    p_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    common::generate_packet_sequence(TMP_FILE_PATH, &p_, N_PACKETS, [&](uint64_t i) { p_.fields.stream_id = i % 2; });
+
+    ASSERT_THROW(process(false, 0, 0.0, 256, 64 * 1024 * 1024, {"x"}), std::runtime_error);
+    ASSERT_THROW(process(false, 0, 0.0, 256, 64 * 1024 * 1024, {"100000000"}), std::runtime_error);
+
+    // Stream ID that isn't given, and no output is left behind
+    ASSERT_THROW(process(false, 0, 0.0, 256, 64 * 1024 * 1024, {"0"}), std::runtime_error);
+    ASSERT_EQ(std::distance(fs::directory_iterator(TMP_DIR), fs::directory_iterator()), 1);
+}
+
+TEST_F(SplitTest, RouteByKind) {
+    // Data and context of all streams in one file each
+    common::generate_packet_sequence(TMP_FILE_PATH, &p_, N_PACKETS, [&](uint64_t i) {
+        p_.header.packet_type = i % 3 == 0 ? VRT_PT_IF_CONTEXT : VRT_PT_IF_DATA_WITH_STREAM_ID;
+        p_.fields.stream_id   = i % 4;
+    });
+
+    process_routed("kind");
+    std::vector<vrt_packet> data{read_packets("split_data.vrt")};
+    std::vector<vrt_packet> context{read_packets("split_context.vrt")};
+    ASSERT_EQ(data.size(), 66);
+    ASSERT_EQ(context.size(), 34);
+    for (const vrt_packet& p : data) {
+        ASSERT_EQ(p.header.packet_type, VRT_PT_IF_DATA_WITH_STREAM_ID);
+    }
+    for (const vrt_packet& p : context) {
+        ASSERT_EQ(p.header.packet_type, VRT_PT_IF_CONTEXT);
+    }
+    ASSERT_EQ(std::distance(fs::directory_iterator(TMP_DIR), fs::directory_iterator()), 3);
+}
+
+TEST_F(SplitTest, RouteByOuiAndType) {
+    // Only the parts that differ name files, here not type
+    p_.header.packet_type  = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    p_.header.has.class_id = true;
+    common::generate_packet_sequence(TMP_FILE_PATH, &p_, N_PACKETS, [&](uint64_t i) {
+        p_.fields.class_id.oui                    = i % 2;
+        p_.fields.class_id.information_class_code = static_cast<uint16_t>(i % 3);
+        p_.fields.stream_id                       = i % 5;
+    });
+
+    process_routed("type,oui");
+    for (uint32_t oui{0}; oui < 2; ++oui) {
+        std::vector<vrt_packet> packets{read_packets("split_" + std::to_string(oui) + ".vrt")};
+        ASSERT_EQ(packets.size(), N_PACKETS / 2);
+        for (const vrt_packet& p : packets) {
+            ASSERT_EQ(p.fields.class_id.oui, oui);
+        }
+    }
+    ASSERT_EQ(std::distance(fs::directory_iterator(TMP_DIR), fs::directory_iterator()), 3);
+}
+
+TEST_F(SplitTest, RouteMap) {
+    p_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    common::generate_packet_sequence(TMP_FILE_PATH, &p_, N_PACKETS, [&](uint64_t i) { p_.fields.stream_id = i % 4; });
+    fs::path map_path{TMP_DIR / "map.txt"};
+    {
+        std::ofstream map_file(map_path);
+        map_file << "# Stream ID  Group\n0 left\n1 left  # Comment\n\n2 right\n";
+    }
+
+    // Stream ID 3 isn't mapped
+    process_routed("", map_path);
+    ASSERT_EQ(read_packets("split_left.vrt").size(), 50);
+    ASSERT_EQ(read_packets("split_right.vrt").size(), 25);
+    for (const vrt_packet& p : read_packets("split_X.vrt")) {
+        ASSERT_EQ(p.fields.stream_id, 3);
+    }
+    fs::remove(TMP_DIR / "split_left.vrt");
+    fs::remove(TMP_DIR / "split_right.vrt");
+    fs::remove(TMP_DIR / "split_X.vrt");
+
+    // Groups and data or context
+    process_routed("group,kind", map_path);
+    ASSERT_EQ(read_packets("split_left.vrt").size(), 50);
+    ASSERT_EQ(std::distance(fs::directory_iterator(TMP_DIR), fs::directory_iterator()), 5);
+}
+
+TEST_F(SplitTest, RouteInvalid) {
+    p_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+    common::generate_packet_sequence(TMP_FILE_PATH, &p_, N_PACKETS, [&](uint64_t i) { p_.fields.stream_id = i % 4; });
+    fs::path map_path{TMP_DIR / "map.txt"};
+    {
+        std::ofstream map_file(map_path);
+        map_file << "0 left\nnot_hex right\n";
+    }
+
+    ASSERT_THROW(process_routed("stream"), std::runtime_error);
+    ASSERT_THROW(process_routed("kind,"), std::runtime_error);
+    ASSERT_THROW(process_routed("group"), std::runtime_error);
+    ASSERT_THROW(process_routed("kind", map_path), std::runtime_error);
+    ASSERT_THROW(process_routed("group", map_path), std::runtime_error);
+    ASSERT_EQ(std::distance(fs::directory_iterator(TMP_DIR), fs::directory_iterator()), 2);
+}
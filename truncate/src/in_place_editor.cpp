@@ -0,0 +1,184 @@
+#include "in_place_editor.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace vrt::truncate {
+
+namespace fs = ::std::filesystem;
+
+/**
+ * Constructor. Open file for editing.
+ *
+ * \param file_path Path to file.
+ *
+ * \throw std::runtime_error If file fails to open.
+ */
+InPlaceEditor::InPlaceEditor(fs::path file_path) : file_path_{std::move(file_path)} {
+    fd_ = ::open(file_path_.c_str(), O_RDWR);
+    if (fd_ < 0) {
+        std::stringstream ss;
+        ss << "Failed to open file " << file_path_ << " for editing: " << std::strerror(errno);
+        throw std::runtime_error(ss.str());
+    }
+
+    struct stat st {};
+    if (::fstat(fd_, &st) == 0 && st.st_blksize > 0) {
+        block_size_ = static_cast<uint64_t>(st.st_blksize);
+    }
+}
+
+/**
+ * Destructor. Close file.
+ */
+InPlaceEditor::~InPlaceEditor() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+/**
+ * Remove everything from file but some extents, which are kept in order.
+ *
+ * \param extents Byte positions in file, sorted, not overlapping, and within file.
+ *
+ * \throw std::runtime_error On file error. The file may then be partly edited.
+ */
+void InPlaceEditor::keep(std::vector<Interval> extents) {
+    // Trailing range
+    resize(extents.empty() ? 0 : extents.back().end);
+
+    // Leading and middle ranges, from the back, so that the positions of earlier ranges stay the same
+    for (size_t k{extents.size()}; k-- > 0;) {
+        uint64_t gap_begin{k == 0 ? 0 : extents[k - 1].end};
+        uint64_t gap_bytes{extents[k].begin - gap_begin};
+        if (gap_bytes != 0 && collapse(gap_begin, gap_bytes)) {
+            for (size_t m{k}; m < extents.size(); ++m) {
+                extents[m].begin -= gap_bytes;
+                extents[m].end -= gap_bytes;
+            }
+        }
+    }
+
+    // Close ranges that are left by moving data forward
+    uint64_t to{0};
+    for (const Interval& extent : extents) {
+        if (extent.begin != to) {
+            move(extent.begin, to, extent.end - extent.begin);
+        }
+        to += extent.end - extent.begin;
+    }
+    resize(to);
+}
+
+/**
+ * Try to remove a range of the file, so that the data after it moves forward, without copying it.
+ *
+ * \param position Position of range [B].
+ * \param bytes    Size of range [B].
+ *
+ * \return True if removed, and false if not aligned to file system blocks or not supported.
+ *
+ * \throw std::runtime_error On other error.
+ */
+bool InPlaceEditor::collapse(uint64_t position, uint64_t bytes) {
+#ifdef FALLOC_FL_COLLAPSE_RANGE
+    if (!is_collapse_supported_ || block_size_ == 0 || position % block_size_ != 0 || bytes % block_size_ != 0) {
+        return false;
+    }
+    if (::fallocate(fd_, FALLOC_FL_COLLAPSE_RANGE, static_cast<off_t>(position), static_cast<off_t>(bytes)) == 0) {
+        bytes_collapsed_ += bytes;
+        return true;
+    }
+    if (errno == EOPNOTSUPP || errno == ENOSYS || errno == EINVAL) {
+        // Block size of file system may differ from the one reported for the file, so only give up if not supported
+        if (errno != EINVAL) {
+            is_collapse_supported_ = false;
+        }
+        return false;
+    }
+
+    std::stringstream ss;
+    ss << "Failed to collapse range of file " << file_path_ << ": " << std::strerror(errno);
+    throw std::runtime_error(ss.str());
+#else
+    (void)position;
+    (void)bytes;
+    return false;
+#endif
+}
+
+/**
+ * Move data forward in file, in large blocks.
+ *
+ * \param from  Position of data [B].
+ * \param to    Position to move to, before from [B].
+ * \param bytes Size of data [B].
+ *
+ * \throw std::runtime_error On read or write error.
+ */
+void InPlaceEditor::move(uint64_t from, uint64_t to, uint64_t bytes) {
+    buf_.resize(std::max<uint64_t>(buf_.size(), std::min(MOVE_BYTES, bytes)));
+
+    // Each block is read before it is written, and written no later than where it was read, so unread data is never
+    // overwritten
+    for (uint64_t done{0}; done < bytes;) {
+        size_t  n{static_cast<size_t>(std::min<uint64_t>(buf_.size(), bytes - done))};
+        ssize_t r{::pread(fd_, buf_.data(), n, static_cast<off_t>(from + done))};
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+        if (r <= 0) {
+            std::stringstream ss;
+            ss << "Failed to read from file " << file_path_ << ": " << (r < 0 ? std::strerror(errno) : "End of file");
+            throw std::runtime_error(ss.str());
+        }
+
+        const char* data{buf_.data()};
+        auto        left{static_cast<size_t>(r)};
+        uint64_t    position{to + done};
+        while (left > 0) {
+            ssize_t w{::pwrite(fd_, data, left, static_cast<off_t>(position))};
+            if (w < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::stringstream ss;
+                ss << "Failed to write to file " << file_path_ << ": " << std::strerror(errno);
+                throw std::runtime_error(ss.str());
+            }
+            data += w;
+            left -= static_cast<size_t>(w);
+            position += static_cast<uint64_t>(w);
+        }
+        done += static_cast<uint64_t>(r);
+    }
+    bytes_moved_ += bytes;
+}
+
+/**
+ * Cut off end of file.
+ *
+ * \param size File size [B].
+ *
+ * \throw std::runtime_error On error.
+ */
+void InPlaceEditor::resize(uint64_t size) {
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        std::stringstream ss;
+        ss << "Failed to set size of file " << file_path_ << ": " << std::strerror(errno);
+        throw std::runtime_error(ss.str());
+    }
+}
+
+}  // namespace vrt::truncate
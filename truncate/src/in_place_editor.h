@@ -0,0 +1,60 @@
+#ifndef VRT_TRUNCATE_SRC_IN_PLACE_EDITOR_H_
+#define VRT_TRUNCATE_SRC_IN_PLACE_EDITOR_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "range.h"
+
+namespace vrt::truncate {
+
+/**
+ * Editor that removes everything but some extents from a file, without writing a new file. A trailing range is cut off
+ * with ftruncate(). Leading and middle ranges are collapsed with fallocate(FALLOC_FL_COLLAPSE_RANGE) if they are
+ * aligned to file system blocks and the file system supports it, and otherwise closed by moving the data after them
+ * forward in large blocks.
+ */
+class InPlaceEditor {
+   public:
+    explicit InPlaceEditor(std::filesystem::path file_path);
+    ~InPlaceEditor();
+
+    InPlaceEditor(const InPlaceEditor&) = delete;
+    InPlaceEditor& operator=(const InPlaceEditor&) = delete;
+
+    void keep(std::vector<Interval> extents);
+
+    /**
+     * \return Number of bytes removed by collapsing ranges.
+     */
+    uint64_t get_bytes_collapsed() const { return bytes_collapsed_; }
+
+    /**
+     * \return Number of bytes moved to close ranges that couldn't be collapsed.
+     */
+    uint64_t get_bytes_moved() const { return bytes_moved_; }
+
+    /**
+     * Size of block moved at a time [B].
+     */
+    static constexpr uint64_t MOVE_BYTES{1 << 23};
+
+   private:
+    bool collapse(uint64_t position, uint64_t bytes);
+    void move(uint64_t from, uint64_t to, uint64_t bytes);
+    void resize(uint64_t size);
+
+    const std::filesystem::path file_path_;
+
+    int               fd_{-1};                      /**< File descriptor. */
+    uint64_t          block_size_{0};               /**< File system block size [B]. */
+    bool              is_collapse_supported_{true}; /**< False when file system has refused to collapse. */
+    std::vector<char> buf_;                         /**< Buffer for moving data. */
+    uint64_t          bytes_collapsed_{0};          /**< Number of bytes removed by collapsing. */
+    uint64_t          bytes_moved_{0};              /**< Number of bytes moved. */
+};
+
+}  // namespace vrt::truncate
+
+#endif
@@ -36,7 +36,14 @@ static vrt::truncate::ProgramArguments setup_arg_parse(CLI::App* app) {
 
     // Output file
     CLI::Option* opt_file_out{app->add_option("-o,--output-file", args.file_path_out, "Output file path")};
-    opt_file_out->required(true);
+
+    // In place
+    CLI::Option* opt_in_place{app->add_flag(
+        "--in-place", args.is_in_place,
+        "Remove packets outside the ranges from the input file instead of writing an output file. Removed ranges are "
+        "collapsed if the file system supports it, and otherwise closed by moving the data after them. The input file "
+        "is damaged if interrupted.")};
+    opt_in_place->excludes(opt_file_out);
 
     // Byte swap
     app->add_flag("-b,--byte-swap", args.do_byte_swap,
@@ -51,6 +58,31 @@ static vrt::truncate::ProgramArguments setup_arg_parse(CLI::App* app) {
     // Count
     app->add_option("-c,--count", args.count, "Number of packets to keep");
 
+    // Time range
+    app->add_option("--start-time", args.start_time,
+                    "Time of first packet to keep (inclusive), as seconds, e.g. 1600000000.5, UTC date and time, e.g. "
+                    "2020-09-13T12:26:40.5Z, or seconds after the first packet, e.g. +10.5. Packets must be ordered by "
+                    "time. The file is searched, so it isn't read from the start.");
+    app->add_option("--end-time", args.end_time, "Time of last packet to keep (exclusive), in the same format");
+
+    // Ranges
+    app->add_option("-r,--range", args.ranges,
+                    "Range of packets to keep, either packet indices, e.g. 100,200, or times prefixed by @, e.g. "
+                    "@+10,+20.5, in the same format as --start-time. The end is exclusive, and either side may be "
+                    "empty. Supports multiple ranges, which are sorted, merged, and extracted in one pass.");
+    CLI::Option* opt_range_file{app->add_option("--range-file", args.range_file,
+                                                "File with a range on each line, in the same format as --range")};
+    opt_range_file->check(CLI::ExistingFile);
+    CLI::Option* opt_split_ranges{app->add_flag("--split-ranges", args.do_split_ranges,
+                                                "Write each range to its own output file, named after the output file "
+                                                "with the range number appended, e.g. out_0.vrt")};
+    opt_split_ranges->excludes(opt_in_place);
+
+    // Filter
+    app->add_option("--filter", args.filter,
+                    "Only keep packets matching expression, e.g. 'stream_id==0xDEADBEEF && type==context'. Applies to "
+                    "packets in the ranges.");
+
     return args;
 }
 
@@ -69,6 +101,10 @@ int main(int argc, const char** argv) {
     CLI11_PARSE(app, argc, argv)
 
     // Parameter validation
+    if (!program_args.is_in_place && program_args.file_path_out.empty()) {
+        std::cerr << "Supply output file, or edit input file with --in-place" << std::endl;
+        return EXIT_FAILURE;
+    }
     try {
         if (fs::equivalent(program_args.file_path_in, program_args.file_path_out)) {
             std::cerr << "Cannot use the same input as output file path: " << program_args.file_path_in << std::endl;
@@ -98,8 +134,14 @@ int main(int argc, const char** argv) {
         std::cerr << "Cannot set first packet, last packet and number of packets at the same time" << std::endl;
         return EXIT_FAILURE;
     }
-    if (!set_begin && !set_end && !set_count) {
-        std::cerr << "Supply begin, end or, count. Supplying neither is pointless." << std::endl;
+    bool set_time{!program_args.start_time.empty() || !program_args.end_time.empty()};
+    if (set_time && (set_begin || set_end || set_count)) {
+        std::cerr << "Cannot combine start and end time with begin, end, or count" << std::endl;
+        return EXIT_FAILURE;
+    }
+    bool set_range{!program_args.ranges.empty() || !program_args.range_file.empty()};
+    if (!set_begin && !set_end && !set_count && !set_time && !set_range && program_args.filter.empty()) {
+        std::cerr << "Supply begin, end, count, time, range or, filter. Supplying neither is pointless." << std::endl;
         return EXIT_FAILURE;
     }
 
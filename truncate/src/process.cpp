@@ -1,23 +1,167 @@
 #include "process.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cstdint>
 #include <cstdio>
 #include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
 
 #include "vrt/vrt_types.h"
 
 #include "Progress-CPP/ProgressBar.hpp"
+#include "common/filter.h"
 #include "common/input_stream.h"
 #include "common/output_stream.h"
+#include "common/time_search.h"
+#include "common/timestamp.h"
+#include "in_place_editor.h"
 #include "program_arguments.h"
+#include "range.h"
 
 namespace vrt::truncate {
 
 // For convenience
-using PacketPtr = std::shared_ptr<vrt_packet>;
+namespace fs = ::std::filesystem;
+
+/**
+ * Number of words copied at a time.
+ */
+static constexpr size_t COPY_WORDS{1 << 20};
+
+/**
+ * Check if string only contains digits.
+ *
+ * \param s String.
+ *
+ * \return True if so.
+ */
+static bool IsDigits(const std::string& s) {
+    return std::all_of(s.begin(), s.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+}
+
+/**
+ * Days since 1970-01-01 of a date in the proleptic Gregorian calendar.
+ *
+ * \param y Year.
+ * \param m Month [1, 12].
+ * \param d Day [1, 31].
+ *
+ * \return Days.
+ */
+static int64_t DaysFromCivil(int64_t y, int64_t m, int64_t d) {
+    y -= m <= 2 ? 1 : 0;
+    int64_t era{(y >= 0 ? y : y - 399) / 400};
+    int64_t yoe{y - era * 400};
+    int64_t doy{(153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1};
+    int64_t doe{yoe * 365 + yoe / 4 - yoe / 100 + doy};
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ * Parse time, either as seconds, e.g. "1600000000.5", or as UTC date and time, e.g. "2020-09-13T12:26:40.5Z". A '+'
+ * prefix means relative to the first packet, e.g. "+10.5".
+ *
+ * \param str   Time string.
+ * \param first Time of first packet. Only used if time is relative.
+ *
+ * \return Time.
+ *
+ * \throw std::runtime_error If string is invalid.
+ */
+static common::PacketTime ParseTime(const std::string& str, const common::PacketTime& first) {
+    auto fail{[&]() {
+        std::stringstream ss;
+        ss << "Invalid time '" << str << "'. Use seconds, e.g. 1600000000.5, date and time, e.g. "
+           << "2020-09-13T12:26:40.5Z, or seconds relative to first packet, e.g. +10.5";
+        throw std::runtime_error(ss.str());
+    }};
+
+    bool        is_relative{!str.empty() && str.front() == '+'};
+    std::string s{is_relative ? str.substr(1) : str};
+    if (!s.empty() && s.back() == 'Z') {
+        s.pop_back();
+    }
+
+    // Split off fraction
+    std::string fraction;
+    size_t      dot{s.find('.')};
+    if (dot != std::string::npos) {
+        fraction = s.substr(dot + 1);
+        s.resize(dot);
+    }
+    if (s.empty() || fraction.size() > 12 || !IsDigits(fraction)) {
+        fail();
+    }
+    fraction.resize(12, '0');
+
+    common::PacketTime t;
+    t.picoseconds = std::stoull(fraction);
+    if (IsDigits(s)) {
+        if (s.size() > 19) {
+            fail();
+        }
+        t.seconds = std::stoull(s);
+    } else {
+        long     y{0};
+        unsigned mo{0};
+        unsigned d{0};
+        unsigned h{0};
+        unsigned mi{0};
+        unsigned sec{0};
+        char     c{'\0'};
+        if (is_relative || std::sscanf(s.c_str(), "%4ld-%2u-%2uT%2u:%2u:%2u%c", &y, &mo, &d, &h, &mi, &sec, &c) != 6 ||
+            y < 1970 || mo < 1 || mo > 12 || d < 1 || d > 31 || h > 23 || mi > 59 || sec > 60) {
+            fail();
+        }
+        t.seconds = static_cast<uint64_t>(DaysFromCivil(y, mo, d) * 86400 + h * 3600 + mi * 60 + sec);
+    }
+
+    if (is_relative) {
+        t.seconds += first.seconds;
+        t.picoseconds += first.picoseconds;
+        if (t.picoseconds >= common::PS_PER_S) {
+            t.seconds++;
+            t.picoseconds -= common::PS_PER_S;
+        }
+    }
+
+    return t;
+}
+
+/**
+ * Generate output file path of a range, with the range number appended to the stem, e.g. "out_07.vrt".
+ *
+ * \param file_path_out Output file path.
+ * \param k             Range number.
+ * \param n             Number of ranges.
+ *
+ * \return File path.
+ */
+static fs::path RangeFilePath(const fs::path& file_path_out, size_t k, size_t n) {
+    int digits{1};
+    for (size_t m{n - 1}; m >= 10; m /= 10) {
+        digits++;
+    }
+
+    std::stringstream body;
+    body << '_' << std::setw(digits) << std::setfill('0') << k;
+
+    fs::path file_out{file_path_out.parent_path()};
+    file_out /= file_path_out.stem();
+    file_out += body.str();
+    file_out += file_path_out.extension();
+    return file_out;
+}
 
 /**
  * Constructor.
@@ -61,57 +205,342 @@ std::tuple<uint64_t, uint64_t> Processor::calculate_begin_end() const {
 }
 
 /**
- * Process file contents.
+ * Collect ranges to keep, from begin, end, and count, from start and end time, and from range options, in that order.
+ * Without any range, all packets matching the filter are kept.
+ *
+ * \return Ranges.
+ *
+ * \throw std::runtime_error If a range is invalid.
+ */
+std::vector<RangeSpec> Processor::collect_ranges() const {
+    std::vector<RangeSpec> ranges;
+
+    if (program_args_.begin != 0 || program_args_.end != std::numeric_limits<uint64_t>::max() ||
+        program_args_.count != std::numeric_limits<uint64_t>::max()) {
+        RangeSpec range;
+        std::tie(range.indices.begin, range.indices.end) = calculate_begin_end();
+        ranges.push_back(range);
+    }
+    if (!program_args_.start_time.empty() || !program_args_.end_time.empty()) {
+        RangeSpec range;
+        range.is_time    = true;
+        range.start_time = program_args_.start_time;
+        range.end_time   = program_args_.end_time;
+        ranges.push_back(range);
+    }
+    for (const std::string& str : program_args_.ranges) {
+        ranges.push_back(ParseRange(str));
+    }
+    if (!program_args_.range_file.empty()) {
+        std::vector<RangeSpec> file_ranges{ReadRangeFile(program_args_.range_file)};
+        ranges.insert(ranges.end(), file_ranges.begin(), file_ranges.end());
+    }
+
+    if (ranges.empty()) {
+        ranges.emplace_back();
+    }
+
+    return ranges;
+}
+
+/**
+ * Resolve ranges to packet indices and byte positions of each output, and create output files. Time boundaries are
+ * found by searching the file, so only a small part of it is read.
+ *
+ * \param ranges Ranges.
+ *
+ * \return Outputs, either one with all ranges sorted and coalesced, or one per range if split.
+ *
+ * \throw std::runtime_error If a time is invalid, or on file error.
+ */
+std::vector<Processor::Output> Processor::resolve_ranges(const std::vector<RangeSpec>& ranges) const {
+    std::vector<Output> outputs(program_args_.do_split_ranges ? ranges.size() : 1);
+
+    std::unique_ptr<common::TimeSearch> search;
+    uint64_t                            end_bytes{0};
+    common::PacketTime                  first;
+    bool                                has_first{false};
+    for (size_t k{0}; k < ranges.size(); ++k) {
+        const RangeSpec& range{ranges[k]};
+        Output&          output{outputs[program_args_.do_split_ranges ? k : 0]};
+        if (!range.is_time) {
+            output.indices.push_back(range.indices);
+            continue;
+        }
+
+        if (!search) {
+            search    = std::make_unique<common::TimeSearch>(program_args_.file_path_in, program_args_.do_byte_swap);
+            end_bytes = search->find_end();
+        }
+
+        // Only need first packet time for relative times
+        if (!has_first && ((!range.start_time.empty() && range.start_time.front() == '+') ||
+                           (!range.end_time.empty() && range.end_time.front() == '+'))) {
+            if (!search->first_time(&first)) {
+                std::stringstream ss;
+                ss << "No packet in " << program_args_.file_path_in << " has a timestamp";
+                throw std::runtime_error(ss.str());
+            }
+            has_first = true;
+        }
+
+        // Ranges end at the last complete packet, which is copied as whole words
+        Interval bytes{0, end_bytes};
+        if (!range.start_time.empty()) {
+            bytes.begin = std::min(end_bytes, search->find(ParseTime(range.start_time, first)));
+        }
+        if (!range.end_time.empty()) {
+            bytes.end = std::clamp(search->find(ParseTime(range.end_time, first)), bytes.begin, end_bytes);
+        }
+        output.bytes.push_back(bytes);
+    }
+
+    for (size_t k{0}; k < outputs.size(); ++k) {
+        Coalesce(&outputs[k].indices);
+        Coalesce(&outputs[k].bytes);
+        if (!program_args_.is_in_place) {
+            outputs[k].stream = std::make_unique<common::OutputStream>(
+                program_args_.do_split_ranges ? RangeFilePath(program_args_.file_path_out, k, outputs.size())
+                                              : program_args_.file_path_out);
+        }
+    }
+
+    return outputs;
+}
+
+/**
+ * Process file contents. Ranges that are only known as byte positions, i.e. time ranges without a filter, are copied
+ * as is. Otherwise packet headers are read in one pass until the end of the last range, and contiguous runs of kept
+ * packets are copied as large extents, or packet by packet if filtered. When editing in place, the kept extents are
+ * found the same way, and everything else is then removed from the input file.
  *
  * \throw std::runtime_error If there's an error.
  */
 void Processor::process() {
-    common::InputStream  input_stream(program_args_.file_path_in, program_args_.do_byte_swap);
-    common::OutputStream output_stream(program_args_.file_path_out);
+    std::vector<Output> outputs{resolve_ranges(collect_ranges())};
+
+    file_.exceptions(std::ios::badbit | std::ios::failbit | std::ios::eofbit);
+    try {
+        file_.open(program_args_.file_path_in, std::ios::in | std::ios::binary);
+    } catch (const std::ios::failure&) {
+        std::stringstream ss;
+        ss << "Failed to open input file " << program_args_.file_path_in;
+        throw std::runtime_error(ss.str());
+    }
+
+    bool is_by_packet{!program_args_.filter.empty() ||
+                      std::any_of(outputs.begin(), outputs.end(),
+                                  [](const Output& output) { return !output.indices.empty(); })};
+    if (is_by_packet) {
+        process_packets(&outputs);
+    } else {
+        uint64_t total{0};
+        for (const Output& output : outputs) {
+            for (const Interval& bytes : output.bytes) {
+                total += bytes.end - bytes.begin;
+            }
+        }
+
+        progresscpp::ProgressBar progress(total, 70);
+        for (Output& output : outputs) {
+            for (const Interval& bytes : output.bytes) {
+                copy_extent(bytes, &output, &progress);
+            }
+        }
+        progress.done();
+    }
+
+    if (program_args_.is_in_place) {
+        file_.close();
+
+        // Keeping nothing would empty the input file, which is more likely a mistake
+        if (outputs.front().kept.empty()) {
+            std::stringstream ss;
+            ss << (program_args_.filter.empty() ? "No packets in range" : "No packet matched the filter")
+               << ", so input file " << program_args_.file_path_in << " is left as is";
+            throw std::runtime_error(ss.str());
+        }
 
-    // Calculate begin and end
-    uint64_t begin;
-    uint64_t end;
-    std::tie(begin, end) = calculate_begin_end();
+        InPlaceEditor editor(program_args_.file_path_in);
+        editor.keep(outputs.front().kept);
+        std::cout << "Collapsed " << editor.get_bytes_collapsed() << " B and moved " << editor.get_bytes_moved()
+                  << " B in place" << std::endl;
+    }
 
     uint64_t written{0};
+    for (const Output& output : outputs) {
+        written += output.written;
+    }
+    if (!program_args_.filter.empty() && written == 0) {
+        std::cerr << "Warning: No packet matched the filter" << std::endl;
+    } else if (written == 0) {
+        std::cerr << "Warning: No packets in range" << std::endl;
+    }
+}
+
+/**
+ * Read packets in one pass until the end of the last range, and write those in a range of an output.
+ *
+ * \param outputs Outputs.
+ *
+ * \throw std::runtime_error If there's an error.
+ */
+void Processor::process_packets(std::vector<Output>* outputs) {
+    common::InputStream input_stream(program_args_.file_path_in, program_args_.do_byte_swap);
+    common::Filter      filter(program_args_.filter);
+
+    // Reading stops after the last range
+    uint64_t end_index{0};
+    uint64_t end_byte{0};
+    for (const Output& output : *outputs) {
+        if (!output.indices.empty()) {
+            end_index = std::max(end_index, output.indices.back().end);
+        }
+        if (!output.bytes.empty()) {
+            end_byte = std::max(end_byte, output.bytes.back().end);
+        }
+    }
 
     // Progress bar
-    progresscpp::ProgressBar progress(end, 70);
+    progresscpp::ProgressBar progress(static_cast<uint64_t>(input_stream.get_file_size()), 70);
 
     // Go over all packets in input file
     uint64_t i{0};
+    uint64_t position{0};
     for (;; ++i) {
-        // Always read packet, so we get header size for progress bar
-        if (!input_stream.read_next_packet()) {
+        // Stop condition
+        if (i >= end_index && position >= end_byte) {
             break;
         }
 
-        // Stop condition
-        if (i >= end) {
+        if (!input_stream.read_next_header()) {
+            break;
+        }
+        uint64_t bytes{sizeof(uint32_t) * input_stream.get_packet()->header.packet_size};
+
+        // Find outputs with a range containing the packet. Ranges are sorted, so each is passed only once.
+        bool is_kept{false};
+        for (Output& output : *outputs) {
+            while (output.index_it < output.indices.size() && output.indices[output.index_it].end <= i) {
+                output.index_it++;
+            }
+            while (output.byte_it < output.bytes.size() && output.bytes[output.byte_it].end <= position) {
+                output.byte_it++;
+            }
+            output.is_kept =
+                (output.index_it < output.indices.size() && output.indices[output.index_it].begin <= i) ||
+                (output.byte_it < output.bytes.size() && output.bytes[output.byte_it].begin <= position);
+            is_kept = is_kept || output.is_kept;
+        }
+
+        // Only read and parse remainder of packets that may be kept, and that are filtered
+        bool is_match{false};
+        if (is_kept && !filter.empty()) {
+            if (!common::read_remainder_if_match(filter, &input_stream, &is_match)) {
+                break;
+            }
+        } else if (!input_stream.skip_remainder()) {
             break;
+        } else {
+            is_match = is_kept;
         }
 
-        if (i >= begin) {
-            // Write input packet to output
-            PacketPtr packet{input_stream.get_packet()};
-            output_stream.write(input_stream.get_buffer(), packet->header.packet_size);
-            written++;
+        if (is_match) {
+            for (Output& output : *outputs) {
+                if (!output.is_kept) {
+                    continue;
+                }
+                if (filter.empty() || program_args_.is_in_place) {
+                    // Extend run of contiguous packets, or copy it and start another
+                    if (output.extent.end != position) {
+                        copy_extent(output.extent, &output, nullptr);
+                        output.extent.begin = position;
+                    }
+                    output.extent.end = position + bytes;
+                } else {
+                    // Write input packet to output
+                    output.stream->write(input_stream.get_buffer(), input_stream.get_packet()->header.packet_size);
+                    output.written += bytes;
+                }
+            }
         }
+        position += bytes;
 
         // Handle progress bar
-        progress += 1;
-        if (progress.get_ticks() % 64 == 0) {
+        progress += bytes;
+        if (i % 64 == 0) {
             progress.display();
         }
     }
 
+    for (Output& output : *outputs) {
+        copy_extent(output.extent, &output, nullptr);
+        output.extent = {0, 0};
+    }
+
     progress.done();
 
-    // Warn if not all packets were printed
-    if (end != std::numeric_limits<uint64_t>::max() && written != end - begin) {
+    // Warn if not all packets were kept
+    if (end_index != std::numeric_limits<uint64_t>::max() && i < end_index) {
         std::cerr << "Warning: Did not truncate all packets" << std::endl;
     }
 }
 
+/**
+ * Copy part of input file to output as is, in large blocks, or note it to be kept if editing in place.
+ *
+ * \param extent   Byte positions in input file.
+ * \param output   Output.
+ * \param progress Progress bar, or nullptr if none.
+ *
+ * \throw std::runtime_error On read or write error, or if extent isn't whole words.
+ */
+void Processor::copy_extent(const Interval& extent, Output* output, progresscpp::ProgressBar* progress) {
+    if (extent.begin >= extent.end) {
+        return;
+    }
+
+    // Extents are only noted when editing in place, since the file is edited after it is read
+    if (program_args_.is_in_place) {
+        if (!output->kept.empty() && output->kept.back().end == extent.begin) {
+            output->kept.back().end = extent.end;
+        } else {
+            output->kept.push_back(extent);
+        }
+        output->written += extent.end - extent.begin;
+        return;
+    }
+
+    // Packets are whole words, so anything else would never be copied
+    if ((extent.end - extent.begin) % sizeof(uint32_t) != 0) {
+        std::stringstream ss;
+        ss << "Bytes " << extent.begin << " to " << extent.end << " of input file " << program_args_.file_path_in
+           << " aren't whole words";
+        throw std::runtime_error(ss.str());
+    }
+
+    uint64_t words_extent{(extent.end - extent.begin) / sizeof(uint32_t)};
+    buf_.resize(std::max<uint64_t>(buf_.size(), std::min<uint64_t>(COPY_WORDS, words_extent)));
+    try {
+        file_.seekg(static_cast<std::streamoff>(extent.begin));
+        for (uint64_t position{extent.begin}; position < extent.end;) {
+            auto words{
+                static_cast<int32_t>(std::min<uint64_t>(buf_.size(), (extent.end - position) / sizeof(uint32_t)))};
+            file_.read(reinterpret_cast<char*>(buf_.data()), static_cast<std::streamsize>(sizeof(uint32_t) * words));
+            output->stream->write(buf_, words);
+            position += sizeof(uint32_t) * words;
+
+            if (progress != nullptr) {
+                *progress += sizeof(uint32_t) * words;
+                progress->display();
+            }
+        }
+    } catch (const std::ios::failure&) {
+        std::stringstream ss;
+        ss << "Failed to read from input file " << program_args_.file_path_in;
+        throw std::runtime_error(ss.str());
+    }
+    output->written += extent.end - extent.begin;
+}
+
 }  // namespace vrt::truncate
@@ -2,12 +2,23 @@
 #define VRT_TRUNCATE_SRC_PROCESS_H_
 
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
 #include <tuple>
+#include <vector>
+
+#include "common/output_stream.h"
+#include "range.h"
 
 namespace vrt::truncate {
 struct ProgramArguments;
 }
 
+namespace progresscpp {
+class ProgressBar;
+}
+
 namespace vrt::truncate {
 
 class Processor {
@@ -17,9 +28,32 @@ class Processor {
     void process();
 
    private:
+    /**
+     * Output file, with the ranges of packets written to it.
+     */
+    struct Output {
+        std::vector<Interval>                 indices;        /**< Packet indices, sorted and coalesced. */
+        std::vector<Interval>                 bytes;          /**< Byte positions in input, sorted and coalesced. */
+        size_t                                index_it{0};    /**< First index range not yet passed. */
+        size_t                                byte_it{0};     /**< First byte range not yet passed. */
+        bool                                  is_kept{false}; /**< True if current packet is in a range. */
+        Interval                              extent{0, 0};   /**< Run of kept bytes not yet copied. */
+        uint64_t                              written{0};     /**< Number of bytes written. */
+        std::vector<Interval>                 kept;           /**< Kept byte positions, if editing in place. */
+        std::unique_ptr<common::OutputStream> stream;         /**< Output stream. */
+    };
+
     std::tuple<uint64_t, uint64_t> calculate_begin_end() const;
+    std::vector<RangeSpec>         collect_ranges() const;
+    std::vector<Output>            resolve_ranges(const std::vector<RangeSpec>& ranges) const;
+    void                           process_packets(std::vector<Output>* outputs);
+
+    void copy_extent(const Interval& extent, Output* output, progresscpp::ProgressBar* progress);
 
     const ProgramArguments& program_args_;
+
+    std::ifstream         file_; /**< Input file, for copying extents. */
+    std::vector<uint32_t> buf_;  /**< Buffer for copying extents. */
 };
 
 }  // namespace vrt::truncate
@@ -2,6 +2,9 @@
 #define VRT_TRUNCATE_SRC_PROGRAM_ARGUMENTS_H_
 
 #include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
 
 namespace vrt::truncate {
 
@@ -9,12 +12,19 @@ namespace vrt::truncate {
  * Input arguments to program.
  */
 struct ProgramArguments {
-    std::filesystem::path file_path_in{};
-    std::filesystem::path file_path_out{};
-    uint64_t              begin{0};
-    uint64_t              end{std::numeric_limits<uint64_t>::max()};
-    uint64_t              count{std::numeric_limits<uint64_t>::max()};
-    bool                  do_byte_swap{false};
+    std::filesystem::path    file_path_in{};
+    std::filesystem::path    file_path_out{};
+    uint64_t                 begin{0};
+    uint64_t                 end{std::numeric_limits<uint64_t>::max()};
+    uint64_t                 count{std::numeric_limits<uint64_t>::max()};
+    bool                     do_byte_swap{false};
+    std::string              filter{};
+    std::string              start_time{};
+    std::string              end_time{};
+    std::vector<std::string> ranges{};
+    std::filesystem::path    range_file{};
+    bool                     do_split_ranges{false};
+    bool                     is_in_place{false};
 };
 
 }  // namespace vrt::truncate
@@ -0,0 +1,139 @@
+#include "range.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vrt::truncate {
+
+/**
+ * Parse packet index.
+ *
+ * \param str   Index string, or empty.
+ * \param value Default value if empty, and parsed value.
+ *
+ * \return True if valid.
+ */
+static bool ParseIndex(const std::string& str, uint64_t* value) {
+    if (str.empty()) {
+        return true;
+    }
+    if (str.size() > 19 ||
+        !std::all_of(str.begin(), str.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; })) {
+        return false;
+    }
+    *value = std::stoull(str);
+    return true;
+}
+
+/**
+ * Parse range, either of packet indices, e.g. "100,200", or of times prefixed by '@', e.g. "@+10,+20.5", in the same
+ * format as --start-time. The end is exclusive, and either side may be empty to range from start or to end. Times are
+ * validated when resolved.
+ *
+ * \param str Range string.
+ *
+ * \return Range.
+ *
+ * \throw std::runtime_error If string is invalid.
+ */
+RangeSpec ParseRange(const std::string& str) {
+    RangeSpec range;
+    range.is_time = !str.empty() && str.front() == '@';
+
+    std::string s{range.is_time ? str.substr(1) : str};
+    size_t      comma{s.find(',')};
+    bool        is_valid{comma != std::string::npos && s.find(',', comma + 1) == std::string::npos};
+    if (is_valid) {
+        std::string first{s.substr(0, comma)};
+        std::string last{s.substr(comma + 1)};
+        if (range.is_time) {
+            range.start_time = first;
+            range.end_time   = last;
+        } else {
+            is_valid = ParseIndex(first, &range.indices.begin) && ParseIndex(last, &range.indices.end) &&
+                       range.indices.begin <= range.indices.end;
+        }
+    }
+    if (!is_valid) {
+        std::stringstream ss;
+        ss << "Invalid range '" << str << "'. Use packet indices, e.g. 100,200, or times, e.g. @+10,+20.5, where the "
+           << "end is exclusive";
+        throw std::runtime_error(ss.str());
+    }
+
+    return range;
+}
+
+/**
+ * Read file of ranges, with one range per line in the same format as ParseRange(). Empty lines, and anything after #,
+ * are ignored.
+ *
+ * \param file_path File path.
+ *
+ * \return Ranges, in file order.
+ *
+ * \throw std::runtime_error If file can't be read, or a range is invalid.
+ */
+std::vector<RangeSpec> ReadRangeFile(const std::filesystem::path& file_path) {
+    std::ifstream file(file_path);
+    if (!file) {
+        std::stringstream ss;
+        ss << "Failed to open range file " << file_path;
+        throw std::runtime_error(ss.str());
+    }
+
+    std::vector<RangeSpec> ranges;
+    std::string            line;
+    for (uint64_t line_number{1}; std::getline(file, line); ++line_number) {
+        line = line.substr(0, line.find('#'));
+
+        // Trim whitespace
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty()) {
+            continue;
+        }
+        try {
+            ranges.push_back(ParseRange(line));
+        } catch (const std::runtime_error& exc) {
+            std::stringstream ss;
+            ss << "Range file " << file_path << " line " << line_number << ": " << exc.what();
+            throw std::runtime_error(ss.str());
+        }
+    }
+
+    return ranges;
+}
+
+/**
+ * Sort intervals, and merge those that overlap or touch. Empty intervals are removed.
+ *
+ * \param intervals Intervals.
+ */
+void Coalesce(std::vector<Interval>* intervals) {
+    intervals->erase(std::remove_if(intervals->begin(), intervals->end(),
+                                    [](const Interval& interval) { return interval.begin >= interval.end; }),
+                     intervals->end());
+    std::sort(intervals->begin(), intervals->end(),
+              [](const Interval& a, const Interval& b) { return a.begin < b.begin; });
+
+    std::vector<Interval> merged;
+    for (const Interval& interval : *intervals) {
+        if (!merged.empty() && interval.begin <= merged.back().end) {
+            merged.back().end = std::max(merged.back().end, interval.end);
+        } else {
+            merged.push_back(interval);
+        }
+    }
+    *intervals = std::move(merged);
+}
+
+}  // namespace vrt::truncate
@@ -0,0 +1,36 @@
+#ifndef VRT_TRUNCATE_SRC_RANGE_H_
+#define VRT_TRUNCATE_SRC_RANGE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace vrt::truncate {
+
+/**
+ * Interval, with inclusive begin and exclusive end.
+ */
+struct Interval {
+    uint64_t begin{0};                                   /**< First value (inclusive). */
+    uint64_t end{std::numeric_limits<uint64_t>::max()}; /**< Last value (exclusive). */
+};
+
+/**
+ * Range of packets to keep, either by packet index or by time.
+ */
+struct RangeSpec {
+    bool        is_time{false}; /**< True if range is by time. */
+    Interval    indices{};      /**< Packet indices, if not by time. */
+    std::string start_time{};   /**< Time of first packet, or empty if from start, if by time. */
+    std::string end_time{};     /**< Time of last packet (exclusive), or empty if to end, if by time. */
+};
+
+RangeSpec              ParseRange(const std::string& str);
+std::vector<RangeSpec> ReadRangeFile(const std::filesystem::path& file_path);
+void                   Coalesce(std::vector<Interval>* intervals);
+
+}  // namespace vrt::truncate
+
+#endif
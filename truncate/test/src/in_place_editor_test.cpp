@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "../../src/in_place_editor.h"
+#include "../../src/range.h"
+
+namespace fs = ::std::filesystem;
+
+static const fs::path TMP_DIR{"test_tmp"};
+static const fs::path TMP_FILE{TMP_DIR / "file.bin"};
+
+/**
+ * File of 16 blocks of 4096 bytes, where each byte is its position modulo 251.
+ */
+class InPlaceEditorTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+        fs::create_directory(TMP_DIR);
+
+        data_.resize(16 * 4096);
+        for (size_t i{0}; i < data_.size(); ++i) {
+            data_[i] = static_cast<char>(i % 251);
+        }
+        std::ofstream file(TMP_FILE, std::ios::binary);
+        file.write(data_.data(), static_cast<std::streamsize>(data_.size()));
+    }
+
+    void TearDown() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+    }
+
+    /**
+     * Keep extents of file, and check that the file then only contains them.
+     */
+    void keep(const std::vector<vrt::truncate::Interval>& extents) {
+        std::vector<char> expected;
+        for (const vrt::truncate::Interval& extent : extents) {
+            expected.insert(expected.end(), data_.begin() + static_cast<std::ptrdiff_t>(extent.begin),
+                            data_.begin() + static_cast<std::ptrdiff_t>(extent.end));
+        }
+
+        {
+            vrt::truncate::InPlaceEditor editor(TMP_FILE);
+            editor.keep(extents);
+            ASSERT_LE(editor.get_bytes_moved(), expected.size());
+        }
+
+        std::ifstream     file(TMP_FILE, std::ios::binary);
+        std::vector<char> actual{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        ASSERT_EQ(actual, expected);
+    }
+
+    std::vector<char> data_;
+};
+
+TEST_F(InPlaceEditorTest, Trailing) {
+    keep({{0, 10000}});
+}
+
+TEST_F(InPlaceEditorTest, Unaligned) {
+    keep({{100, 5000}, {5004, 5008}, {9000, 30000}, {60000, 65000}});
+}
+
+TEST_F(InPlaceEditorTest, Aligned) {
+    // Collapsed if the file system supports it, and moved otherwise
+    keep({{4096, 8192}, {16384, 20480}, {40960, 65536}});
+}
+
+TEST_F(InPlaceEditorTest, Mixed) {
+    keep({{4096, 8192}, {8200, 12288}, {24576, 30000}});
+}
+
+TEST_F(InPlaceEditorTest, Nothing) {
+    keep({});
+}
@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "../../src/process.h"
+#include "../../src/program_arguments.h"
+#include "../../src/range.h"
+#include "common/generate_packet_sequence.h"
+#include "common/input_stream.h"
+
+namespace fs = ::std::filesystem;
+
+static const uint64_t N_PACKETS{1000};
+static const fs::path TMP_DIR{"test_tmp"};
+static const fs::path TMP_FILE_IN{TMP_DIR / "in.vrt"};
+static const fs::path TMP_FILE_OUT{TMP_DIR / "out.vrt"};
+
+/**
+ * Packets are 10 ms apart, starting at 1600000000 s. Even packets have Stream ID 1 and odd packets 2.
+ */
+class RangeTest : public ::testing::Test {
+   protected:
+    RangeTest() : p_() {}
+
+    void SetUp() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+        fs::create_directory(TMP_DIR);
+
+        vrt_init_packet(&p_);
+        p_.header.packet_type = VRT_PT_IF_DATA_WITH_STREAM_ID;
+        p_.header.tsi         = VRT_TSI_UTC;
+        p_.header.tsf         = VRT_TSF_REAL_TIME;
+        p_.words_body         = 8;
+        std::vector<uint32_t> body(p_.words_body);
+        p_.body = body.data();
+        vrt::common::generate_packet_sequence(TMP_FILE_IN, &p_, N_PACKETS, [&](uint64_t i) {
+            p_.fields.stream_id                    = 1 + i % 2;
+            p_.fields.integer_seconds_timestamp    = static_cast<uint32_t>(1600000000 + i / 100);
+            p_.fields.fractional_seconds_timestamp = (i % 100) * 10000000000;
+        });
+    }
+
+    void TearDown() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+    }
+
+    /**
+     * Run truncate with ranges.
+     */
+    static void run(const std::vector<std::string>& ranges,
+                    const std::string&              filter          = "",
+                    bool                            do_split_ranges = false,
+                    const fs::path&                 range_file      = {},
+                    bool                            is_in_place     = false) {
+        vrt::truncate::ProgramArguments args;
+        args.file_path_in    = TMP_FILE_IN;
+        args.file_path_out   = is_in_place ? fs::path() : TMP_FILE_OUT;
+        args.ranges          = ranges;
+        args.filter          = filter;
+        args.do_split_ranges = do_split_ranges;
+        args.range_file      = range_file;
+        args.is_in_place     = is_in_place;
+        vrt::truncate::Processor processor(args);
+        processor.process();
+    }
+
+    /**
+     * Read indices of packets in file.
+     */
+    static std::vector<uint64_t> read_indices(const fs::path& file_path = TMP_FILE_OUT) {
+        std::vector<uint64_t>    ret;
+        vrt::common::InputStream input_stream(file_path, false);
+        while (input_stream.read_next_packet()) {
+            const auto& p{*input_stream.get_packet()};
+            ret.push_back((p.fields.integer_seconds_timestamp - 1600000000) * 100 +
+                          p.fields.fractional_seconds_timestamp / 10000000000);
+        }
+        return ret;
+    }
+
+    /**
+     * \return Indices in [begin, end).
+     */
+    static std::vector<uint64_t> iota(uint64_t begin, uint64_t end) {
+        std::vector<uint64_t> ret;
+        for (uint64_t i{begin}; i < end; ++i) {
+            ret.push_back(i);
+        }
+        return ret;
+    }
+
+    vrt_packet p_;
+};
+
+TEST_F(RangeTest, Parse) {
+    vrt::truncate::RangeSpec range{vrt::truncate::ParseRange("100,200")};
+    ASSERT_FALSE(range.is_time);
+    ASSERT_EQ(range.indices.begin, 100);
+    ASSERT_EQ(range.indices.end, 200);
+    range = vrt::truncate::ParseRange(",5");
+    ASSERT_EQ(range.indices.begin, 0);
+    ASSERT_EQ(range.indices.end, 5);
+    range = vrt::truncate::ParseRange("@+1.5,");
+    ASSERT_TRUE(range.is_time);
+    ASSERT_EQ(range.start_time, "+1.5");
+    ASSERT_TRUE(range.end_time.empty());
+
+    ASSERT_THROW(vrt::truncate::ParseRange("100"), std::runtime_error);
+    ASSERT_THROW(vrt::truncate::ParseRange("1,2,3"), std::runtime_error);
+    ASSERT_THROW(vrt::truncate::ParseRange("a,2"), std::runtime_error);
+    ASSERT_THROW(vrt::truncate::ParseRange("5,2"), std::runtime_error);
+}
+
+TEST_F(RangeTest, Coalesce) {
+    std::vector<vrt::truncate::Interval> intervals{{50, 60}, {10, 20}, {15, 30}, {30, 40}, {45, 45}};
+    vrt::truncate::Coalesce(&intervals);
+    ASSERT_EQ(intervals.size(), 2);
+    ASSERT_EQ(intervals[0].begin, 10);
+    ASSERT_EQ(intervals[0].end, 40);
+    ASSERT_EQ(intervals[1].begin, 50);
+    ASSERT_EQ(intervals[1].end, 60);
+}
+
+TEST_F(RangeTest, Indices) {
+    run({"500,510", "10,20", "15,25", "998,"});
+    std::vector<uint64_t> expected{iota(10, 25)};
+    std::vector<uint64_t> v{iota(500, 510)};
+    expected.insert(expected.end(), v.begin(), v.end());
+    expected.push_back(998);
+    expected.push_back(999);
+    ASSERT_EQ(read_indices(), expected);
+}
+
+TEST_F(RangeTest, IndicesAndTimes) {
+    // Time ranges are found as byte positions, and packets in either kind of range are kept once
+    run({"@1600000001,1600000001.05", "102,110", "@+9.98,"});
+    std::vector<uint64_t> expected{iota(100, 110)};
+    expected.push_back(998);
+    expected.push_back(999);
+    ASSERT_EQ(read_indices(), expected);
+}
+
+TEST_F(RangeTest, Times) {
+    run({"@+2,+2.03", "@+1,+1.02"});
+    ASSERT_EQ(read_indices(), (std::vector<uint64_t>{100, 101, 200, 201, 202}));
+}
+
+TEST_F(RangeTest, Filter) {
+    run({"10,20", "@+5,+5.1"}, "stream_id==1");
+    ASSERT_EQ(read_indices(), (std::vector<uint64_t>{10, 12, 14, 16, 18, 500, 502, 504, 506, 508}));
+}
+
+TEST_F(RangeTest, Split) {
+    run({"10,20", "15,25", "@+1,+1.02"}, "", true);
+    ASSERT_EQ(read_indices(TMP_DIR / "out_0.vrt"), iota(10, 20));
+    ASSERT_EQ(read_indices(TMP_DIR / "out_1.vrt"), iota(15, 25));
+    ASSERT_EQ(read_indices(TMP_DIR / "out_2.vrt"), iota(100, 102));
+    ASSERT_FALSE(fs::exists(TMP_FILE_OUT));
+}
+
+TEST_F(RangeTest, File) {
+    fs::path      range_file{TMP_DIR / "ranges.txt"};
+    std::ofstream file(range_file);
+    file << "# Events\n"
+         << "40,42  # First\n"
+         << "\n"
+         << "@+3,+3.01\n";
+    file.close();
+    run({"1,2"}, "", false, range_file);
+    ASSERT_EQ(read_indices(), (std::vector<uint64_t>{1, 40, 41, 300}));
+
+    std::ofstream invalid(range_file);
+    invalid << "40-42\n";
+    invalid.close();
+    ASSERT_THROW(run({}, "", false, range_file), std::runtime_error);
+}
+
+TEST_F(RangeTest, InPlace) {
+    run({"500,510", "10,20", "@+9.98,"}, "", false, {}, true);
+    std::vector<uint64_t> expected{iota(10, 20)};
+    std::vector<uint64_t> v{iota(500, 510)};
+    expected.insert(expected.end(), v.begin(), v.end());
+    expected.push_back(998);
+    expected.push_back(999);
+    ASSERT_EQ(read_indices(TMP_FILE_IN), expected);
+    ASSERT_FALSE(fs::exists(TMP_FILE_OUT));
+}
+
+TEST_F(RangeTest, InPlaceFilter) {
+    run({"10,20"}, "stream_id==1", false, {}, true);
+    ASSERT_EQ(read_indices(TMP_FILE_IN), (std::vector<uint64_t>{10, 12, 14, 16, 18}));
+}
+
+TEST_F(RangeTest, InPlaceNothing) {
+    // Input file is left as is if nothing is kept
+    uint64_t size{fs::file_size(TMP_FILE_IN)};
+    ASSERT_THROW(run({"10,20"}, "stream_id==3", false, {}, true), std::runtime_error);
+    ASSERT_THROW(run({"2000,"}, "", false, {}, true), std::runtime_error);
+    ASSERT_THROW(run({"@1700000000,"}, "", false, {}, true), std::runtime_error);
+    ASSERT_EQ(fs::file_size(TMP_FILE_IN), size);
+    ASSERT_EQ(read_indices(TMP_FILE_IN), iota(0, N_PACKETS));
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vrt/vrt_init.h"
+#include "vrt/vrt_types.h"
+
+#include "../../src/process.h"
+#include "../../src/program_arguments.h"
+#include "common/generate_packet_sequence.h"
+#include "common/input_stream.h"
+#include "common/time_search.h"
+
+namespace fs = ::std::filesystem;
+
+static const uint64_t N_PACKETS{100000};
+static const fs::path TMP_DIR{"test_tmp"};
+static const fs::path TMP_FILE_IN{TMP_DIR / "in.vrt"};
+static const fs::path TMP_FILE_OUT{TMP_DIR / "out.vrt"};
+
+/**
+ * Packets are 10 ms apart, starting at 1600000000 s, and every tenth packet is a context packet without timestamp.
+ */
+class TimeRangeTest : public ::testing::Test {
+   protected:
+    TimeRangeTest() : p_() {}
+
+    void SetUp() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+        fs::create_directory(TMP_DIR);
+
+        vrt_init_packet(&p_);
+        p_.fields.stream_id = 0xDEADBEEF;
+        p_.words_body       = 16;
+        std::vector<uint32_t> body(p_.words_body);
+        p_.body = body.data();
+        vrt::common::generate_packet_sequence(TMP_FILE_IN, &p_, N_PACKETS, [&](uint64_t i) {
+            bool is_context{i % 10 == 9};
+            p_.header.packet_type                  = is_context ? VRT_PT_IF_CONTEXT : VRT_PT_IF_DATA_WITH_STREAM_ID;
+            p_.header.tsi                          = is_context ? VRT_TSI_NONE : VRT_TSI_UTC;
+            p_.header.tsf                          = is_context ? VRT_TSF_NONE : VRT_TSF_REAL_TIME;
+            p_.words_body                          = is_context ? 0 : 16;
+            p_.fields.integer_seconds_timestamp    = static_cast<uint32_t>(1600000000 + i / 100);
+            p_.fields.fractional_seconds_timestamp = (i % 100) * 10000000000;
+        });
+    }
+
+    void TearDown() override {
+        try {
+            fs::remove_all(TMP_DIR);
+        } catch (const fs::filesystem_error&) {
+            // Do nothing
+        }
+    }
+
+    /**
+     * Run truncate and read times of output packets with a timestamp, as 10 ms ticks since start.
+     */
+    static std::vector<uint64_t> run(const std::string& start_time,
+                                     const std::string& end_time,
+                                     const std::string& filter = "") {
+        vrt::truncate::ProgramArguments args;
+        args.file_path_in  = TMP_FILE_IN;
+        args.file_path_out = TMP_FILE_OUT;
+        args.start_time    = start_time;
+        args.end_time      = end_time;
+        args.filter        = filter;
+        vrt::truncate::Processor processor(args);
+        processor.process();
+
+        std::vector<uint64_t>    ret;
+        vrt::common::InputStream input_stream(TMP_FILE_OUT, false);
+        while (input_stream.read_next_packet()) {
+            const auto& p{*input_stream.get_packet()};
+            if (p.header.tsi != VRT_TSI_NONE) {
+                ret.push_back((p.fields.integer_seconds_timestamp - 1600000000) * 100 +
+                              p.fields.fractional_seconds_timestamp / 10000000000);
+            }
+        }
+        return ret;
+    }
+
+    vrt_packet p_;
+};
+
+TEST_F(TimeRangeTest, Absolute) {
+    std::vector<uint64_t> v{run("1600000100.5", "1600000110")};
+    ASSERT_EQ(v.size(), 950 * 9 / 10);
+    ASSERT_EQ(v.front(), 10050);
+    ASSERT_EQ(v.back(), 10998);
+}
+
+TEST_F(TimeRangeTest, Calendar) {
+    // 1600000000 is 2020-09-13T12:26:40Z
+    std::vector<uint64_t> v{run("2020-09-13T12:26:41Z", "2020-09-13T12:26:42.25Z")};
+    ASSERT_EQ(v.front(), 100);
+    ASSERT_EQ(v.back(), 224);
+}
+
+TEST_F(TimeRangeTest, Relative) {
+    std::vector<uint64_t> v{run("+0.02", "+0.05")};
+    ASSERT_EQ(v, (std::vector<uint64_t>{2, 3, 4}));
+}
+
+TEST_F(TimeRangeTest, OpenEnded) {
+    ASSERT_EQ(run("", "1600000000.03").size(), 3);
+    std::vector<uint64_t> v{run("1600000999.97", "")};
+    ASSERT_EQ(v, (std::vector<uint64_t>{99997, 99998}));
+}
+
+TEST_F(TimeRangeTest, Empty) {
+    ASSERT_TRUE(run("1700000000", "").empty());
+    ASSERT_TRUE(run("1600000005", "1600000001").empty());
+}
+
+TEST_F(TimeRangeTest, NotWordAligned) {
+    uint64_t size{fs::file_size(TMP_FILE_IN)};
+
+    // Trailing bytes, and then also a partial packet, are not copied
+    for (size_t n : {2, 4 + 2}) {
+        std::ofstream file(TMP_FILE_IN, std::ios::binary | std::ios::app);
+        file.write("\x51\x60\x00\x14\xAB\xCD", static_cast<std::streamsize>(n));
+        file.close();
+
+        std::vector<uint64_t> v{run("+10", "")};
+        ASSERT_EQ(v.size(), (N_PACKETS - 1000) * 9 / 10);
+        ASSERT_EQ(v.front(), 1000);
+        ASSERT_EQ(v.back(), 99998);
+        ASSERT_EQ(run("", "").size(), N_PACKETS * 9 / 10);
+        ASSERT_EQ(fs::file_size(TMP_FILE_OUT), size);
+
+        vrt::common::TimeSearch search(TMP_FILE_IN, false);
+        ASSERT_EQ(search.find_end(), size);
+
+        fs::resize_file(TMP_FILE_IN, size);
+    }
+}
+
+TEST_F(TimeRangeTest, Filter) {
+    // Only packets in the time range that match the filter are kept
+    std::vector<uint64_t> v{run("1600000100", "1600000102", "tsf<500000000000")};
+    ASSERT_EQ(v.size(), 2 * 45);
+    ASSERT_EQ(v.front(), 10000);
+    ASSERT_EQ(v[44], 10048);
+    ASSERT_EQ(v[45], 10100);
+    ASSERT_EQ(v.back(), 10148);
+}
+
+TEST_F(TimeRangeTest, Invalid) {
+    ASSERT_THROW(run("soon", ""), std::runtime_error);
+    ASSERT_THROW(run("1.0000000000001", ""), std::runtime_error);
+    ASSERT_THROW(run("2020-13-01T00:00:00Z", ""), std::runtime_error);
+}
+
+TEST_F(TimeRangeTest, Resync) {
+    vrt::common::TimeSearch search(TMP_FILE_IN, false);
+    vrt::common::InputStream input_stream(TMP_FILE_IN, false);
+    uint64_t position{0};
+    for (int i{0}; i < 20; ++i) {
+        // Packet starts are found as is. Offsets within a packet resync to a word within it that happens to look like
+        // a packet header followed by valid packets, or to the start of the next one.
+        auto start{static_cast<uint64_t>(input_stream.tell())};
+        ASSERT_TRUE(input_stream.read_next_packet());
+        auto end{static_cast<uint64_t>(input_stream.tell())};
+        ASSERT_EQ(search.resync(start), start);
+        for (position = start + 1; position < end; ++position) {
+            uint64_t r{search.resync(position)};
+            ASSERT_GE(r, position);
+            ASSERT_LE(r, end);
+            ASSERT_EQ(r % sizeof(uint32_t), 0);
+        }
+    }
+}
+
+TEST_F(TimeRangeTest, ReadLittle) {
+    vrt::common::TimeSearch search(TMP_FILE_IN, false);
+    uint64_t                position{search.find({1600000500, 0})};
+    ASSERT_GT(position, 0);
+    ASSERT_LT(search.get_bytes_read(), search.get_file_size() / 20);
+}